@@ -30,6 +30,8 @@
 
 #include <curses.h>
 
+#include "TerminalLog.h"
+
 extern std::string CPP_APP_VERSION;
 
 template <typename T>
@@ -112,7 +114,8 @@ class Terminal{
   private:
 	std::map< std::string, int > attrMap;
 	std::streambuf *pbuf, *original;
-	std::stringstream stream;
+	LogStreamBuf logBuf_; ///<The queue of lines written to std::cout.
+	LogFilter logFilter_; ///<Collapses repeated lines and limits the rate of each source on the screen, the log file gets every line.
 	std::string historyFilename_;
 	WINDOW *main;
 	WINDOW *output_window;
@@ -201,6 +204,9 @@ class Terminal{
 	///Initalize terminal debug mode.
 	void SetDebug(bool debug=true) {debug_=debug;};
 
+	///Set the number of lines per second printed from a message source, zero for no limit.
+	void SetLogRateLimit(unsigned int linesPerSecond) {logFilter_.SetLinesPerSecond(linesPerSecond);};
+
 	/// Initalizes a status window under the input temrinal.
 	void AddStatusWindow(unsigned short numLines = 1);
 	
@@ -234,7 +240,7 @@ class Terminal{
 	/// Disrupt ncurses while boolean is true
 	void pause(bool &flag);
 
-	/// Dump all text in the stream to the output screen
+	/// Dump all lines in the queue to the output screen and the log file
 	void flush();
 
 	/// Print a command to the terminal output.
@@ -0,0 +1,127 @@
+/** \file TerminalLog.h
+  *
+  * \brief Lock free path for the text written to std::cout while the Terminal is open
+  *
+  * Any thread may write to std::cout. Complete lines are pushed onto a lock free
+  * queue and never wait on the Terminal, ncurses or the log file. The command thread
+  * drains the queue when the Terminal is flushed, collapses repeated lines into a
+  * single line with a count and limits the number of lines per second from each
+  * message source on the screen. The log file still gets every line. If the queue is full the line is dropped and counted instead of
+  * blocking the writer.
+  *
+  * \date Oct. 19th, 2026
+*/
+
+#ifndef TERMINALLOG_H
+#define TERMINALLOG_H
+
+#include <atomic>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+///Default number of lines that may wait in the queue before lines are dropped.
+#define LOG_QUEUE_SIZE 10000
+
+///Default number of lines printed per second from a single message source.
+#define LOG_LINES_PER_SECOND 50
+
+class LogStreamBuf : public std::streambuf {
+  private:
+	/// A line waiting in the queue.
+	struct Node{
+		std::atomic<Node*> next; /// The next (newer) line in the queue.
+		std::string text; /// The text of the line.
+
+		Node() : next(NULL) { }
+	};
+
+	std::atomic<Node*> head_; /// The newest line, producers push here.
+	Node *tail_; /// The oldest line, only used by the consumer.
+	Node stub_; /// Placeholder node that keeps the queue from being empty.
+
+	std::atomic<size_t> pending_; /// The number of lines in the queue.
+	std::atomic<unsigned long> dropped_; /// The number of lines dropped since the last drain.
+	size_t maxPending_; /// The number of lines allowed in the queue.
+
+	/// Push a node onto the queue. Safe to call from any thread.
+	void push_(Node *node_);
+
+	/// Remove the oldest node from the queue. Only called by the consumer.
+	Node *pop_();
+
+	/// Move the text of the calling thread onto the queue.
+	void commit_(std::string &text_);
+
+	/// Return the text of the calling thread which has not been committed.
+	std::string &thread_text_();
+
+  protected:
+	/// Append a single character.
+	virtual int_type overflow(int_type c_);
+
+	/// Append a sequence of characters, every complete line is committed.
+	virtual std::streamsize xsputn(const char *s_, std::streamsize n_);
+
+	/// Commit the partial line of the calling thread.
+	virtual int sync();
+
+  public:
+	LogStreamBuf(size_t maxLines_=LOG_QUEUE_SIZE);
+
+	~LogStreamBuf();
+
+	/// Move all of the lines in the queue into lines_, oldest first. Only one thread may drain.
+	size_t Drain(std::vector<std::string> &lines_);
+
+	/// Return the number of lines dropped because the queue was full and reset the count.
+	unsigned long TakeDropped(){ return dropped_.exchange(0); }
+};
+
+class LogFilter{
+  private:
+	/// The lines recently printed from a message source.
+	struct Source{
+		double windowStart; /// The time the current one second window started.
+		unsigned int numLines; /// The number of lines printed in the window.
+		unsigned long numSuppressed; /// The number of lines suppressed in the window.
+
+		Source() : windowStart(0), numLines(0), numSuppressed(0) { }
+	};
+
+	std::map<std::string, Source> sources_; /// The message sources seen so far.
+	std::string lastLine_; /// The last line that was printed.
+	unsigned long numRepeats_; /// The number of times lastLine_ was repeated since it was printed.
+	unsigned int linesPerSecond_; /// The number of lines per second allowed from a source.
+
+	/// Print the number of repeats of the last line, if any.
+	void flush_repeats_(std::string &output_);
+
+	/// Start a new window for a source once a second has passed.
+	void update_window_(const std::string &name_, Source &source_, const double &now_, std::string &output_);
+
+  public:
+	LogFilter(unsigned int lines_=LOG_LINES_PER_SECOND) : numRepeats_(0), linesPerSecond_(lines_) { }
+
+	/// Set the number of lines per second allowed from a source, zero for no limit.
+	void SetLinesPerSecond(unsigned int lines_){ linesPerSecond_ = lines_; }
+
+	/// Return the source of a line, the single word before a ':' near the start of the line, or an empty string if the line is not tagged.
+	static std::string GetSource(const std::string &line_);
+
+	/** Filter lines and append the text to print to output_. A tagged line that is the same
+	  * as the one before it is counted instead of printed and shows up as "line (xN)"
+	  * once a different line arrives or Finish is called. Lines without a source, such
+	  * as the output of a command, are never collapsed or limited.
+	  * \param[in]  lines_  The lines to filter, oldest first.
+	  * \param[in]  now_    The current time in seconds.
+	  * \param[out] output_ The text to print.
+	  */
+	void Process(const std::vector<std::string> &lines_, const double &now_, std::string &output_);
+
+	/// Append the pending repeat count and the number of suppressed lines of every source to output_.
+	void Finish(const double &now_, std::string &output_);
+};
+
+#endif
@@ -549,7 +549,7 @@ void Terminal::Initialize(){
 	if(init){ return; }
 	
 	original = std::cout.rdbuf(); // Back-up cout's streambuf
-	pbuf = stream.rdbuf(); // Get stream's streambuf
+	pbuf = &logBuf_; // Every thread writes its lines into the queue
 	std::cout.flush();
 	std::cout.rdbuf(pbuf); // Assign streambuf to cout
 	
@@ -686,17 +686,35 @@ void Terminal::print(WINDOW* window, std::string input_){
 	refresh_();
 }
 
-// Dump all text in the stream to the output screen
+// Dump all lines in the queue to the output screen and the log file
 void Terminal::flush(){
-	std::string stream_contents = stream.str();
-	if(stream_contents.size() > 0){
-		print(output_window, stream_contents);
-		if (logFile.good()) {
-			logFile << stream.str();
-			logFile.flush();
+	double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	std::vector<std::string> lines;
+	std::string output;
+	std::string raw;
+	if(logBuf_.Drain(lines) > 0){
+		logFilter_.Process(lines, now, output);
+
+		// The log file keeps every line, only the screen is filtered
+		if(logFile.good()){
+			for(std::vector<std::string>::iterator it = lines.begin(); it != lines.end(); ++it){ raw += *it; }
 		}
-		stream.str("");
-		stream.clear();
+	}
+	logFilter_.Finish(now, output);
+
+	unsigned long dropped = logBuf_.TakeDropped();
+	if(dropped > 0){
+		std::string note = "Terminal: dropped " + to_str(dropped) + " lines, the output queue was full\n";
+		output += note;
+		raw += note;
+	}
+
+	// Print and log the whole batch at once, a single refresh and file write per flush
+	if(!output.empty()){ print(output_window, output); }
+	if(!raw.empty() && logFile.good()){
+		logFile << raw;
+		logFile.flush();
 	}
 }
 
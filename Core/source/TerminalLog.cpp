@@ -0,0 +1,219 @@
+/** \file TerminalLog.cpp
+  *
+  * \brief Lock free path for the text written to std::cout while the Terminal is open
+  *
+  * The queue is the intrusive multi-producer single-consumer queue of D. Vyukov. A
+  * producer only swaps the head pointer and links the previous head to its node,
+  * so writing a line never waits on another thread.
+  *
+  * \date Oct. 19th, 2026
+*/
+
+#include <sstream>
+
+#include <cctype>
+
+#include "TerminalLog.h"
+
+namespace{
+	/// The partial line of a thread, lines are only committed once they are complete.
+	struct ThreadText{
+		const LogStreamBuf *owner; /// The buffer the text was written to.
+		std::string text; /// The text which has not been committed.
+	};
+
+	thread_local ThreadText threadText = {NULL, ""};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LogStreamBuf
+///////////////////////////////////////////////////////////////////////////////
+
+LogStreamBuf::LogStreamBuf(size_t maxLines_/*=LOG_QUEUE_SIZE*/) :
+	head_(&stub_),
+	tail_(&stub_),
+	pending_(0),
+	dropped_(0),
+	maxPending_(maxLines_)
+{
+}
+
+LogStreamBuf::~LogStreamBuf(){
+	std::vector<std::string> lines;
+	Drain(lines);
+	if(threadText.owner == this){
+		threadText.owner = NULL;
+		threadText.text.clear();
+	}
+}
+
+void LogStreamBuf::push_(Node *node_){
+	node_->next.store(NULL, std::memory_order_relaxed);
+	Node *prev = head_.exchange(node_, std::memory_order_acq_rel);
+	prev->next.store(node_, std::memory_order_release);
+}
+
+LogStreamBuf::Node *LogStreamBuf::pop_(){
+	Node *tail = tail_;
+	Node *next = tail->next.load(std::memory_order_acquire);
+	if(tail == &stub_){
+		if(!next){ return NULL; }
+		tail_ = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+	if(next){
+		tail_ = next;
+		return tail;
+	}
+	
+	// A producer has swapped the head but not linked its node yet, try again later.
+	if(tail != head_.load(std::memory_order_acquire)){ return NULL; }
+
+	// The tail is the only node left, put the stub behind it so that it can be removed.
+	push_(&stub_);
+	next = tail->next.load(std::memory_order_acquire);
+	if(next){
+		tail_ = next;
+		return tail;
+	}
+	return NULL;
+}
+
+std::string &LogStreamBuf::thread_text_(){
+	if(threadText.owner != this){
+		threadText.owner = this;
+		threadText.text.clear();
+	}
+	return threadText.text;
+}
+
+void LogStreamBuf::commit_(std::string &text_){
+	if(pending_.load(std::memory_order_relaxed) >= maxPending_){
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		text_.clear();
+		return;
+	}
+	Node *node = new Node();
+	node->text.swap(text_);
+	pending_.fetch_add(1, std::memory_order_relaxed);
+	push_(node);
+}
+
+LogStreamBuf::int_type LogStreamBuf::overflow(int_type c_){
+	if(traits_type::eq_int_type(c_, traits_type::eof())){ return traits_type::not_eof(c_); }
+	std::string &text = thread_text_();
+	text += traits_type::to_char_type(c_);
+	if(traits_type::to_char_type(c_) == '\n'){ commit_(text); }
+	return c_;
+}
+
+std::streamsize LogStreamBuf::xsputn(const char *s_, std::streamsize n_){
+	std::string &text = thread_text_();
+	std::streamsize start = 0;
+	for(std::streamsize i = 0; i < n_; i++){
+		if(s_[i] != '\n'){ continue; }
+		text.append(s_ + start, i + 1 - start);
+		commit_(text);
+		start = i + 1;
+	}
+	text.append(s_ + start, n_ - start);
+	return n_;
+}
+
+int LogStreamBuf::sync(){
+	std::string &text = thread_text_();
+	if(!text.empty()){ commit_(text); }
+	return 0;
+}
+
+size_t LogStreamBuf::Drain(std::vector<std::string> &lines_){
+	size_t count = 0;
+	Node *node;
+	while((node = pop_()) != NULL){
+		lines_.push_back(std::string());
+		lines_.back().swap(node->text);
+		delete node;
+		pending_.fetch_sub(1, std::memory_order_relaxed);
+		count++;
+	}
+	return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LogFilter
+///////////////////////////////////////////////////////////////////////////////
+
+std::string LogFilter::GetSource(const std::string &line_){
+	size_t pos = line_.find(':');
+	if(pos == std::string::npos || pos == 0 || pos > 32){ return ""; }
+
+	// A tag is a single word, anything else is plain output that happens to contain a ':'.
+	for(size_t i = 0; i < pos; i++){
+		if(isspace(line_[i])){ return ""; }
+	}
+	return line_.substr(0, pos);
+}
+
+void LogFilter::flush_repeats_(std::string &output_){
+	if(numRepeats_ == 0){ return; }
+	std::stringstream stream;
+	size_t length = lastLine_.size();
+	if(length > 0 && lastLine_[length-1] == '\n'){ length--; }
+	stream << lastLine_.substr(0, length) << " (x" << numRepeats_ << ")\n";
+	output_ += stream.str();
+	numRepeats_ = 0;
+}
+
+void LogFilter::update_window_(const std::string &name_, Source &source_, const double &now_, std::string &output_){
+	if(now_ - source_.windowStart < 1.0){ return; }
+	if(source_.numSuppressed > 0){
+		std::stringstream stream;
+		if(!name_.empty()){ stream << name_ << ": "; }
+		stream << "suppressed " << source_.numSuppressed << " lines\n";
+		output_ += stream.str();
+	}
+	source_.windowStart = now_;
+	source_.numLines = 0;
+	source_.numSuppressed = 0;
+}
+
+void LogFilter::Process(const std::vector<std::string> &lines_, const double &now_, std::string &output_){
+	for(std::vector<std::string>::const_iterator it = lines_.begin(); it != lines_.end(); ++it){
+		std::string name = GetSource(*it);
+		if(!name.empty() && *it == lastLine_){
+			numRepeats_++;
+			continue;
+		}
+		flush_repeats_(output_);
+
+		// Untagged lines are command output, they are printed as they are.
+		if(name.empty()){
+			output_ += *it;
+			lastLine_.clear();
+			continue;
+		}
+
+		Source &source = sources_[name];
+		update_window_(name, source, now_, output_);
+		if(linesPerSecond_ > 0 && source.numLines >= linesPerSecond_){
+			source.numSuppressed++;
+			continue;
+		}
+		source.numLines++;
+		output_ += *it;
+		lastLine_ = *it;
+	}
+}
+
+void LogFilter::Finish(const double &now_, std::string &output_){
+	flush_repeats_(output_);
+	bool isQuiet = true;
+	for(std::map<std::string, Source>::iterator it = sources_.begin(); it != sources_.end(); ++it){
+		update_window_(it->first, it->second, now_, output_);
+		if(it->second.numSuppressed > 0){ isQuiet = false; }
+	}
+
+	// Forget the sources once they are all quiet so the map does not keep growing.
+	if(isQuiet && sources_.size() > 1000){ sources_.clear(); }
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TerminalLog.h"
+
+/// Number of threads writing to the queue.
+const unsigned int numThreads = 4;
+
+/// Number of lines written by each thread.
+const unsigned int numLines = 20000;
+
+/// Write numbered lines from a thread, split over several writes so that the
+/// partial lines of the threads have to be kept apart.
+void write_lines(std::streambuf *buf_, unsigned int thread_){
+	std::ostream out(buf_);
+	for(unsigned int i = 0; i < numLines; i++){
+		out << "thread " << thread_ << " ";
+		out << "line " << i << "\n";
+	}
+}
+
+int main(int argc, char *argv[]){
+	int retval = 0;
+
+	// Every line has to come out once, whole and in the order of its thread.
+	LogStreamBuf buf(numThreads * numLines);
+	std::vector<std::thread> threads;
+	for(unsigned int i = 0; i < numThreads; i++){
+		threads.push_back(std::thread(write_lines, &buf, i));
+	}
+
+	std::vector<std::string> lines;
+	while(lines.size() < numThreads * numLines){
+		buf.Drain(lines);
+	}
+	for(unsigned int i = 0; i < numThreads; i++){ threads[i].join(); }
+	buf.Drain(lines);
+
+	std::vector<unsigned int> next(numThreads, 0);
+	for(std::vector<std::string>::iterator it = lines.begin(); it != lines.end(); ++it){
+		std::stringstream expected;
+		unsigned int thread = (*it)[7] - '0';
+		if(thread < numThreads){ expected << "thread " << thread << " line " << next[thread]++ << "\n"; }
+		if(*it != expected.str()){
+			std::cout << "Unexpected line '" << *it << "'\n";
+			retval = 1;
+			break;
+		}
+	}
+	if(lines.size() != numThreads * numLines || buf.TakeDropped() != 0){
+		std::cout << "Received " << lines.size() << " of " << numThreads * numLines << " lines\n";
+		retval = 1;
+	}
+
+	// A full queue drops lines instead of blocking.
+	LogStreamBuf small(10);
+	std::ostream out(&small);
+	for(unsigned int i = 0; i < 15; i++){ out << "line " << i << "\n"; }
+	lines.clear();
+	if(small.Drain(lines) != 10 || small.TakeDropped() != 5){
+		std::cout << "The full queue did not drop the extra lines\n";
+		retval = 1;
+	}
+
+	// Repeated lines are counted and each source is limited per second.
+	LogFilter filter(3);
+	std::vector<std::string> input;
+	input.push_back("Trace: bad trace\n");
+	input.push_back("Trace: bad trace\n");
+	input.push_back("Trace: bad trace\n");
+	input.push_back("Trace: short trace\n");
+	for(unsigned int i = 0; i < 5; i++){ input.push_back("Trace: trace " + std::to_string(i) + "\n"); }
+	input.push_back("Other: message\n");
+	std::string output;
+	filter.Process(input, 0.5, output);
+	filter.Finish(2.0, output);
+	std::string expected = "Trace: bad trace\nTrace: bad trace (x2)\nTrace: short trace\nTrace: trace 0\nOther: message\nTrace: suppressed 4 lines\n";
+	if(output != expected){
+		std::cout << "Unexpected filter output:\n" << output;
+		retval = 1;
+	}
+
+	// Untagged lines, like the output of a command, pass through unchanged.
+	LogFilter plain(3);
+	input.clear();
+	for(unsigned int i = 0; i < 5; i++){ input.push_back("Module 0 channel " + std::to_string(i) + " TRIGGER_THRESHOLD: 20\n"); }
+	input.push_back("\n");
+	input.push_back("\n");
+	input.push_back("  pread <mod> <chan> <param>\n");
+	input.push_back("  pread <mod> <chan> <param>\n");
+	output.clear();
+	expected.clear();
+	for(std::vector<std::string>::iterator it = input.begin(); it != input.end(); ++it){ expected += *it; }
+	plain.Process(input, 0.5, output);
+	plain.Finish(2.0, output);
+	if(output != expected){
+		std::cout << "Untagged lines were filtered:\n" << output;
+		retval = 1;
+	}
+
+	std::cout << (retval == 0 ? "TerminalLog test passed\n" : "TerminalLog test failed\n");
+	return retval;
+}
@@ -11,6 +11,7 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <utility>
 #include "DrrBlock.h" 
 
 /**
@@ -52,8 +53,9 @@ public:
     /** Constructor creating and opening new his and drr using definition from input file. */
     HisDrr(const string &drr, const string &his, const string &input);
 
-    /** Dtor, closing files and deleting memory. */
+    /** Dtor, writing back the changes held in memory, closing files and deleting memory. */
     virtual ~HisDrr() {
+                flush();
                 drrFile->close();
                 hisFile->close();
                 delete drrFile;
@@ -84,6 +86,14 @@ public:
     /** Replaces histogram id values by ones given in a vector. The 2-bytes long word version.  */
     virtual void setValue(const int id, vector<unsigned short> &value);
 
+    /** Reads the whole his file into memory. Afterwards the histograms are
+     * changed in memory and only the changed part of each histogram is
+     * written to the file by flush(). */
+    void loadToMemory();
+
+    /** Writes the changes made in memory since the last flush to the his file. */
+    void flush();
+
 private:
     /** Vector holding all the histogram info read from drr file. */
     vector<DrrHisRecordExtended> hisList;
@@ -94,6 +104,20 @@ private:
     /** Pointer to his file containg data. */
     fstream* hisFile;
 
+    /** True if the his file is held in memory by hisImage. */
+    bool inMemory;
+
+    /** Copy of the his file, used after loadToMemory(). */
+    vector<char> hisImage;
+
+    /** Range of bytes of each histogram changed since the last flush,
+     * (begin, end) relative to the start of the histogram. */
+    vector< pair<size_t, size_t> > dirty;
+
+    /** Writes size bytes of data into histogram index at byte start,
+     * in memory if the file is held there, otherwise in the file. */
+    void storeData(int index, size_t start, const char *data, size_t size);
+
     /** Reads block of data from drr file. */
     void readBlock(drrBlock *block);
 
@@ -2,6 +2,12 @@
 #define MCA_H
 
 #include <ctime>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "PixieSupport.h"
 
@@ -9,11 +15,22 @@ class PixieInterface;
 
 ///Abstract MCA class
 class MCA {
+	public:
+		///The time spent in the last update of the histograms.
+		struct StepTiming{
+			double readTime; ///Time spent reading statistics and histograms from the modules in seconds.
+			double storeWait; ///Time spent waiting on the storage workers after the last read in seconds.
+			double flushTime; ///Time spent flushing the storage in seconds.
+			double totalTime; ///Total time of the update in seconds.
+			unsigned int numRead; ///Number of channels read.
+			unsigned int numSkipped; ///Number of channels skipped as unchanged.
+		};
+
 	protected:
 		/// Timers for the MCA object
 		time_t start_time;
 		time_t stop_time;
-	
+
 		///Default number of bins in histogram.
 		static const size_t HIS_SIZE = 16384;
 		///Default number of channels in ADC.
@@ -23,15 +40,63 @@ class MCA {
 		bool _isOpen;
 		///Pointer to the PixieInterface
 		PixieInterface *_pif;
+		///The largest number of storage workers StoreHistogram may be called from at once.
+		size_t _maxWorkers;
+
+		///Store a histogram read from the modules. Called by the storage workers,
+		///different channels may be stored at the same time.
+		virtual bool StoreHistogram(int mod, int ch, const PixieInterface::word_t *histo) = 0;
+
+	private:
+		///A channel waiting to be stored.
+		struct StoreJob{
+			int mod;
+			int ch;
+			size_t slot; ///The module buffer holding the histogram.
+			const PixieInterface::word_t *histo;
+		};
+
+		std::vector<std::thread> _workers; ///The storage workers.
+		std::deque<StoreJob> _jobs; ///The channels waiting to be stored.
+		std::mutex _jobMutex; ///Protects the jobs and the pending counts.
+		std::condition_variable _jobReady; ///Signalled when a job is added or the workers stop.
+		std::condition_variable _jobDone; ///Signalled when a buffer has no more pending jobs.
+		size_t _pending[2]; ///The number of jobs not yet finished for each module buffer.
+		bool _stopWorkers; ///Set to stop the workers.
+		size_t _numWorkers; ///The requested number of storage workers.
+		bool _storeFailed; ///Set when storing a histogram threw, protected by _jobMutex.
+		std::string _storeError; ///The message of the first failed store, protected by _jobMutex.
+
+		std::vector<PixieInterface::word_t> _buffers[2]; ///Histograms of a module, one module is read while the other is stored.
+		std::vector<double> _lastCounts; ///Output counts of each channel at its last read, -1 if never read.
+		bool _skipUnchanged; ///Skip channels whose output counts did not change.
+		unsigned int _fullRefresh; ///Read every channel each this many updates.
+		unsigned int _numUpdates; ///The number of updates so far.
+		StepTiming _timing; ///The timing of the last update.
+		std::mutex _timingMutex; ///Protects the timing, which is read from other threads.
+
+		///Loop of a storage worker.
+		void RunWorker();
+		///Start the workers if they are not running.
+		void StartWorkers();
+		///Stop and join the workers.
+		void StopWorkers();
+		///Wait until no jobs are pending for a module buffer.
+		void WaitForSlot(size_t slot_);
+		///Store a histogram, a GenError is caught and kept so the update can report it.
+		void Store(int mod, int ch, const PixieInterface::word_t *histo);
+		///Read the histograms of every module and store them, then flush. Return false if a histogram could not be stored.
+		bool Update();
+
 	public:
 		///Default constructor.
 		MCA(PixieInterface *pif);
 		///Default destructor.
-		virtual ~MCA() {};
+		virtual ~MCA();
 		///Return the length of time the MCA has been running.
 		double GetRunTime();
-		///Abstract method describing how the MCA data is stored.
-		virtual bool StoreData(int mod, int ch) = 0;
+		///Read a single histogram from the module and store it.
+		virtual bool StoreData(int mod, int ch);
 		///Abstract method to open a storage file.
 		virtual bool OpenFile(const char *basename) = 0;
 		///Flush the current memory to disk.
@@ -42,6 +107,12 @@ class MCA {
 		virtual void Run(float duration, bool *stop=NULL);
 		///Update the MCA histograms.
 		virtual bool Step();
+		///Set the number of storage workers, 0 stores every histogram in the calling thread.
+		void SetNumWorkers(size_t workers_);
+		///Set whether channels whose output counts did not change are skipped.
+		void SetSkipUnchanged(bool skip_=true){ _skipUnchanged = skip_; }
+		///Return the timing of the last update of the histograms, may be called from any thread.
+		StepTiming GetStepTiming();
 };
 
-#endif 
+#endif
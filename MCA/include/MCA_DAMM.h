@@ -2,18 +2,23 @@
 #define MCA_DAMM_H
 
 #include "MCA.h"
+#include "PixieInterface.h"
 
 class HisDrr;
 
 class MCA_DAMM : public MCA {
 	private:
 		HisDrr *_histogram;
+		///Sum the ADC channels into the histogram bins.
+		static void Rebin(const PixieInterface::word_t *in, unsigned int *out);
+	protected:
+		bool StoreHistogram(int mod, int ch, const PixieInterface::word_t *histo);
 	public:
 		MCA_DAMM(PixieInterface *pif, const char* basename);
 		~MCA_DAMM();
 		bool OpenFile(const char* basename);
-		bool StoreData(int mod, int ch);
-		void Flush() {};
+		///Write the changed parts of the histograms to the his file.
+		void Flush();
 };
 
 #endif
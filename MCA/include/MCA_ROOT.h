@@ -43,12 +43,14 @@ class MCA_ROOT : public MCA {
 
 		};
 
+	protected:
+		bool StoreHistogram(int mod, int ch, const PixieInterface::word_t *histo);
+
 	public:
 		///Default constructor
 		MCA_ROOT(PixieInterface *pif, const char* basename);
 		///Defaul destructor
 		~MCA_ROOT();
-		bool StoreData(int mod, int ch);
 		void Flush();
 		bool OpenFile(const char* basename);
 		TH1F* GetHistogram(int mod, int ch);
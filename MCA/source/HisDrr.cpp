@@ -5,12 +5,14 @@
  * Distributed under GNU General Public Licence v3
  */
 
+#include <algorithm>
 #include <vector>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
 #include <sstream>
 #include <ctime>
+#include <cstring>
 #include "HisDrr.h"
 #include "DrrBlock.h"
 #include "Exceptions.h"
@@ -44,6 +46,7 @@ HisDrr::HisDrr(fstream* drr, fstream* his) {
         throw IOError(msg);
     }
 
+    inMemory = false;
     loadDrr();
 }
 
@@ -74,6 +77,7 @@ HisDrr::HisDrr(const string &drr, const string &his) {
         throw IOError(msg);
     }
 
+    inMemory = false;
     loadDrr();
 }
 
@@ -273,6 +277,7 @@ HisDrr::HisDrr(const string &drr, const string &his, const string &input) {
 
     // And now constructors loads freshly created files
     // so it follows a logic scheme of constructor(drr, his)
+    inMemory = false;
     loadDrr();
 }
 
@@ -387,9 +392,14 @@ void HisDrr::getHistogram(vector<unsigned int> &rtn, int id) {
         // which is given in 2 bytes units
         // We cast this value on unsigned int, which is zeroed first
         // It is a safe cast then.
+        // If the file is held in memory the channels are copied from there
+        const char *image = inMemory ? &hisImage[hisList[index].offset*2] : NULL;
         for (unsigned int i = 0; i < length; ++i) {
             unsigned int u = 0;
-            hisFile->read((char*)&u, hisList[index].halfWords*2);
+            if (image)
+                memcpy(&u, image + i*hisList[index].halfWords*2, hisList[index].halfWords*2);
+            else
+                hisFile->read((char*)&u, hisList[index].halfWords*2);
             r.push_back(u);
         }
     }
@@ -441,10 +451,6 @@ void HisDrr::zeroHistogram(int id) {
     }
     
     if (hisFile->good()) {
-        // Set position of pointer in file to the beginning
-        hisFile->seekg(0, ios::beg);
-        // We jump to location specified by offset (given in units of 2 bytes)
-        hisFile->seekp(hisList[index].offset*2);
         // Lenght of data is equal to product of all histogram dimensions lengths
         unsigned int length = 1;
         for (int i = 0; i < hisList[index].hisDim; ++i)
@@ -455,7 +461,7 @@ void HisDrr::zeroHistogram(int id) {
         //Initialization of array to 0
         char *zeroarray = new char[size]();
 //        cout << "# 0 put from " << hisFile->tellp();
-        hisFile->write(zeroarray,size);
+        storeData(index, 0, zeroarray, size);
 //        cout << " to " << hisFile->tellp() << ", size = " << size << " bytes" << endl;
         delete []zeroarray;
     }
@@ -485,10 +491,6 @@ void HisDrr::setValue(const int id, unsigned pos, unsigned value){
             throw GenError(msg);
         }
 
-        // Set position of pointer in file to the beginning
-        hisFile->seekg(0, ios::beg);
-        // We jump to location specified by offset (given in units of 2 bytes) plus i
-        hisFile->seekp(hisList[index].offset*2 + pos*hisList[index].halfWords*2);
         // Lenght of data is equal to product of all histogram dimensions lengths
         unsigned int length = 1;
         for (int i = 0; i < hisList[index].hisDim; ++i)
@@ -500,7 +502,7 @@ void HisDrr::setValue(const int id, unsigned pos, unsigned value){
             throw GenError(msg);
         }
         // Write value 
-        hisFile->write((char *)&value, sizeof(value));
+        storeData(index, pos*hisList[index].halfWords*2, (char *)&value, sizeof(value));
     }
 
 }
@@ -529,10 +531,6 @@ void HisDrr::setValue(const int id, unsigned pos, unsigned short value){
             throw GenError(msg);
         }
 
-        // Set position of pointer in file to the beginning
-        hisFile->seekg(0, ios::beg);
-        // We jump to location specified by offset (given in units of 2 bytes) plus i
-        hisFile->seekp(hisList[index].offset*2 + pos*hisList[index].halfWords*2);
         // Lenght of data is equal to product of all histogram dimensions lengths
         unsigned int length = 1;
         for (int i = 0; i < hisList[index].hisDim; ++i)
@@ -544,7 +542,7 @@ void HisDrr::setValue(const int id, unsigned pos, unsigned short value){
             throw GenError(msg);
         }
         // Write value 
-        hisFile->write((char *)&value, sizeof(value));
+        storeData(index, pos*hisList[index].halfWords*2, (char *)&value, sizeof(value));
     }
 }
 
@@ -571,10 +569,6 @@ void HisDrr::setValue(const int id, vector<unsigned> &value){
             string msg = err.str();
             throw GenError(msg);
         }
-        // Set position of pointer in file to the beginning
-        hisFile->seekg(0, ios::beg);
-        // We jump to location specified by offset (given in units of 2 bytes) plus pos
-        hisFile->seekp(hisList[index].offset*2);
         // Lenght of data is equal to product of all histogram dimensions lengths
         unsigned int length = 1;
         for (int i = 0; i < hisList[index].hisDim; ++i)
@@ -586,18 +580,10 @@ void HisDrr::setValue(const int id, vector<unsigned> &value){
             string msg = err.str();
             throw GenError(msg);
         }
-        // Write value 
-        // First cast from vector to array
-        unsigned int *newvalue = new unsigned int[length];
-        for (unsigned int i = 0; i < length; ++i) {
-            newvalue[i] = value[i];
-        }
-
-        // Now put array into the file
+        // Write value, the vector already holds the channels in file order
         unsigned int size = hisList[index].halfWords*2*length;
-        hisFile->write((char *)newvalue, size);
+        storeData(index, 0, (char *)&value[0], size);
 
-        delete []newvalue;
     }
 
 }
@@ -625,10 +611,6 @@ void HisDrr::setValue(const int id, vector<unsigned short> &value){
             string msg = err.str();
             throw GenError(msg);
         }
-        // Set position of pointer in file to the beginning
-        hisFile->seekg(0, ios::beg);
-        // We jump to location specified by offset (given in units of 2 bytes) plus pos
-        hisFile->seekp(hisList[index].offset*2);
         // Lenght of data is equal to product of all histogram dimensions lengths
         unsigned int length = 1;
         for (int i = 0; i < hisList[index].hisDim; ++i)
@@ -639,18 +621,80 @@ void HisDrr::setValue(const int id, vector<unsigned short> &value){
             string msg = err.str();
             throw GenError(msg);
         }
-        // Write value 
-        // First cast from vector to array
-        unsigned short *newvalue = new unsigned short[length];
-        for (unsigned int i = 0; i < length; ++i) {
-            newvalue[i] = value[i];
-        }
-
-        // Now put array into the file
+        // Write value, the vector already holds the channels in file order
         unsigned int size = hisList[index].halfWords*2*length;
-        hisFile->write((char *)newvalue, size);
-        delete []newvalue;
+        storeData(index, 0, (char *)&value[0], size);
     }
 
 }
 
+
+void HisDrr::loadToMemory() {
+    if (inMemory)
+        return;
+
+    // The his file is as long as the last histogram ends
+    size_t size = 0;
+    for (unsigned int i = 0; i < hisList.size(); ++i) {
+        size_t length = 1;
+        for (int j = 0; j < hisList[i].hisDim; ++j)
+            length = length * hisList[i].scaled[j];
+        size = max(size, (size_t)(hisList[i].offset + length*hisList[i].halfWords)*2);
+    }
+
+    hisImage.assign(size, 0);
+    if (size > 0) {
+        hisFile->seekg(0, ios::beg);
+        hisFile->read(&hisImage[0], size);
+        if (!hisFile->good()) {
+            stringstream err;
+            err << "HisDrr:26: Could not read " << size << " bytes from his file";
+            string msg = err.str();
+            throw IOError(msg);
+        }
+    }
+    dirty.assign(hisList.size(), make_pair((size_t)0, (size_t)0));
+    inMemory = true;
+}
+
+void HisDrr::flush() {
+    if (!inMemory)
+        return;
+
+    for (unsigned int i = 0; i < dirty.size(); ++i) {
+        if (dirty[i].first >= dirty[i].second)
+            continue;
+        size_t start = hisList[i].offset*2 + dirty[i].first;
+        hisFile->seekp(start);
+        hisFile->write(&hisImage[start], dirty[i].second - dirty[i].first);
+        dirty[i] = make_pair((size_t)0, (size_t)0);
+    }
+    hisFile->flush();
+}
+
+void HisDrr::storeData(int index, size_t start, const char *data, size_t size) {
+    if (!inMemory) {
+        // We jump to location specified by offset (given in units of 2 bytes) plus start
+        hisFile->seekp(hisList[index].offset*2 + start);
+        hisFile->write(data, size);
+        return;
+    }
+
+    // Only the bytes between the first and the last change are marked for writing
+    char *image = &hisImage[hisList[index].offset*2 + start];
+    size_t low = 0;
+    while (low < size && image[low] == data[low])
+        ++low;
+    if (low == size)
+        return;
+    size_t high = size;
+    while (image[high - 1] == data[high - 1])
+        --high;
+    memcpy(image + low, data + low, high - low);
+
+    pair<size_t, size_t> &range = dirty[index];
+    if (range.first >= range.second)
+        range = make_pair(start + low, start + high);
+    else
+        range = make_pair(min(range.first, start + low), max(range.second, start + high));
+}
@@ -1,18 +1,36 @@
 #include "MCA.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <unistd.h>
 
 #include "PixieInterface.h"
 #include "Display.h"
+#include "Exceptions.h"
 #include "Utility.h"
 
+///Return the time since t_ in seconds.
+static double secondsSince(const std::chrono::steady_clock::time_point &t_){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_).count();
+}
+
 ///Default constructor
-MCA::MCA(PixieInterface *pif) : _pif(pif){
+MCA::MCA(PixieInterface *pif) : _pif(pif), _maxWorkers(static_cast<size_t>(-1)),
+	_stopWorkers(false), _numWorkers(2), _storeFailed(false), _skipUnchanged(true), _fullRefresh(10), _numUpdates(0)
+{
+	_pending[0] = _pending[1] = 0;
+	_timing = StepTiming();
 	time(&start_time);
 }
 
+///Default destructor, the storage workers are stopped.
+MCA::~MCA(){
+	StopWorkers();
+}
+
 ///Return the length of time the MCA has been running.
 double MCA::GetRunTime(){ 
 	time(&stop_time);
@@ -21,7 +39,7 @@ double MCA::GetRunTime(){
 
 /**The MCA is initialized and run for the specified duration or until a
  * stop command is received. At specific intervals the MCA output is
- * updated via MCA::StoreData(). Will continue until external bool (stop)
+ * updated via MCA::Update(). Will continue until external bool (stop)
  * is set to false. If this pointer is set to NULL, will continue uninterrupted.
  *
  * \param[in] duration Amount of time to run the MCA.
@@ -49,16 +67,14 @@ void MCA::Run(float duration, bool *stop) {
 			break;
 		}
 
-		//Store the MCA data via the inherited method StoreData()
-		for (int mod = 0;mod < _pif->GetNumberCards(); mod++) {
-			for (unsigned int ch = 0; ch < _pif->GetNumberChannels(); ch++) {
-				StoreData(mod, ch);
-			}
+		//Read the histograms, store them and flush the data to disk.
+		if(!Update()){
+			std::cout << Display::ErrorStr("Run TERMINATED") << std::endl;
+			break;
 		}
-		
-		//Flush the data to disk.
-		Flush();
-		
+		std::cout << "|" << std::fixed << std::setprecision(2) << GetRunTime() << " s | update "
+			<< std::setprecision(1) << GetStepTiming().totalTime * 1e3 << " ms |\r" << std::flush;
+
 		//Update the timer.
 		time(&stop_time);
 	}
@@ -81,17 +97,175 @@ void MCA::Run(float duration, bool *stop) {
 bool MCA::Step(){
 	if(!_pif || !_pif->CheckRunStatus()){ return false; }
 
-	//Store the MCA data via the inherited method StoreData()
-	for (int mod = 0; mod < _pif->GetNumberCards(); mod++) {
-		for (unsigned int ch = 0; ch < _pif->GetNumberChannels(); ch++) {
-			StoreData(mod, ch);
+	//Read the histograms, store them and flush the data to disk.
+	bool stored = Update();
+
+	time(&stop_time);
+
+	return stored;
+}
+
+bool MCA::StoreData(int mod, int ch){
+	std::vector<PixieInterface::word_t> histo(ADC_SIZE);
+	if(!_pif->ReadHistogram(&histo[0], ADC_SIZE, mod, ch)){ return false; }
+	return StoreHistogram(mod, ch, &histo[0]);
+}
+
+void MCA::SetNumWorkers(size_t workers_){
+	StopWorkers();
+	_numWorkers = workers_;
+}
+
+MCA::StepTiming MCA::GetStepTiming(){
+	std::lock_guard<std::mutex> lock(_timingMutex);
+	return _timing;
+}
+
+/**The histograms of a module are read into one of two buffers. While the next
+ * module is read into the other buffer the storage workers store the channels of
+ * the previous one, so reading the modules and storing the spectra overlap. The
+ * modules are only ever accessed from the calling thread.
+ *
+ * If skipping is enabled the statistics of each module are read first and a
+ * channel whose output counts did not change since its last read is skipped.
+ * Every channel is still read once every _fullRefresh updates.
+ *
+ * A GenError thrown while storing a histogram, by a worker or by the calling
+ * thread, does not stop the update. The remaining channels are still read and
+ * stored, then the first error is printed and false is returned.
+ */
+bool MCA::Update(){
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	StepTiming timing = StepTiming();
+
+	size_t nCards = _pif->GetNumberCards();
+	size_t nChan = _pif->GetNumberChannels();
+	if(_lastCounts.size() != nCards * nChan){ _lastCounts.assign(nCards * nChan, -1); }
+	bool fullRead = (_fullRefresh > 0 && _numUpdates % _fullRefresh == 0);
+	_numUpdates++;
+
+	bool useWorkers = (_numWorkers > 0 && _maxWorkers > 0);
+	if(useWorkers){ StartWorkers(); }
+
+	for(size_t mod = 0; mod < nCards; mod++){
+		//Wait until the module that used this buffer before is stored.
+		size_t slot = mod % 2;
+		if(useWorkers){ WaitForSlot(slot); }
+		_buffers[slot].resize(nChan * ADC_SIZE);
+
+		bool haveStats = _skipUnchanged && _pif->GetStatistics(mod);
+		double realTime = haveStats ? _pif->GetRealTime(mod) : 0.0;
+
+		for(size_t ch = 0; ch < nChan; ch++){
+			size_t index = mod * nChan + ch;
+			double counts = -1;
+			if(haveStats){
+				counts = std::floor(_pif->GetOutputCountRate(mod, ch) * realTime + 0.5);
+				if(!fullRead && counts == _lastCounts[index]){
+					timing.numSkipped++;
+					continue;
+				}
+			}
+
+			PixieInterface::word_t *histo = &_buffers[slot][ch * ADC_SIZE];
+			if(!_pif->ReadHistogram(histo, ADC_SIZE, mod, ch)){ continue; }
+			_lastCounts[index] = counts;
+			timing.numRead++;
+
+			if(!useWorkers){
+				Store(mod, ch, histo);
+				continue;
+			}
+
+			StoreJob job = {(int)mod, (int)ch, slot, histo};
+			std::lock_guard<std::mutex> lock(_jobMutex);
+			_jobs.push_back(job);
+			_pending[slot]++;
+			_jobReady.notify_one();
 		}
 	}
-	
-	//Flush the data to disk.
+	timing.readTime = secondsSince(start);
+
+	if(useWorkers){
+		std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+		WaitForSlot(0);
+		WaitForSlot(1);
+		timing.storeWait = secondsSince(waitStart);
+	}
+
+	std::chrono::steady_clock::time_point flushStart = std::chrono::steady_clock::now();
 	Flush();
-	
-	time(&stop_time);
-	
-	return true;
+	timing.flushTime = secondsSince(flushStart);
+	timing.totalTime = secondsSince(start);
+
+	{
+		std::lock_guard<std::mutex> lock(_timingMutex);
+		_timing = timing;
+	}
+
+	//All of the workers are idle here, so the error is safe to read and reset.
+	std::unique_lock<std::mutex> lock(_jobMutex);
+	if(!_storeFailed){ return true; }
+	std::cout << Display::ErrorStr("Failed to store histogram: " + _storeError) << std::endl;
+	_storeFailed = false;
+	_storeError.clear();
+	return false;
+}
+
+void MCA::Store(int mod, int ch, const PixieInterface::word_t *histo){
+	try{
+		StoreHistogram(mod, ch, histo);
+	}
+	catch(GenError &err){
+		std::lock_guard<std::mutex> lock(_jobMutex);
+		if(!_storeFailed){
+			_storeFailed = true;
+			_storeError = err.show();
+		}
+	}
+}
+
+void MCA::RunWorker(){
+	std::unique_lock<std::mutex> lock(_jobMutex);
+	while(true){
+		while(!_stopWorkers && _jobs.empty()){ _jobReady.wait(lock); }
+		if(_jobs.empty()){ return; }
+
+		StoreJob job = _jobs.front();
+		_jobs.pop_front();
+
+		lock.unlock();
+		Store(job.mod, job.ch, job.histo);
+		lock.lock();
+
+		if(--_pending[job.slot] == 0){ _jobDone.notify_all(); }
+	}
+}
+
+void MCA::StartWorkers(){
+	size_t workers = std::min(_numWorkers, _maxWorkers);
+	if(_workers.size() == workers){ return; }
+
+	StopWorkers();
+	_stopWorkers = false;
+	for(size_t i = 0; i < workers; i++){
+		_workers.push_back(std::thread(&MCA::RunWorker, this));
+	}
+}
+
+void MCA::StopWorkers(){
+	{
+		std::lock_guard<std::mutex> lock(_jobMutex);
+		_stopWorkers = true;
+	}
+	_jobReady.notify_all();
+	for(size_t i = 0; i < _workers.size(); i++){
+		_workers[i].join();
+	}
+	_workers.clear();
+}
+
+void MCA::WaitForSlot(size_t slot_){
+	std::unique_lock<std::mutex> lock(_jobMutex);
+	while(_pending[slot_] > 0){ _jobDone.wait(lock); }
 }
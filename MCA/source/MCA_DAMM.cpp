@@ -25,26 +25,41 @@ bool MCA_DAMM::OpenFile(const char* basename) {
 	std::string message = std::string("Creating new empty DAMM histogram ") + basename + std::string(".his");
 	Display::LeaderPrint(message);
 	_histogram = new HisDrr(drr, his, input);
+	//Hold the histograms in memory, only the changed parts are written on Flush.
+	_histogram->loadToMemory();
 	cout << Display::OkayStr() << endl;
 
 	return (_isOpen = true);
 }
 
-bool MCA_DAMM::StoreData(int mod, int ch) {
-	PixieInterface::word_t histo[ADC_SIZE];
-
-	_pif->ReadHistogram(histo, ADC_SIZE, mod, ch);
-
+/**The histograms are held in memory by HisDrr, so different channels can be
+ * stored by several workers at once.
+ */
+bool MCA_DAMM::StoreHistogram(int mod, int ch, const PixieInterface::word_t *histo) {
 	int id = (mod + 1) * 100 + ch;
 
-	vector<unsigned int> data;
-	data.resize(HIS_SIZE, 0);
-
-	for (size_t i = 0; i < ADC_SIZE; i++) {
-		unsigned v = static_cast<unsigned>(i / (ADC_SIZE / HIS_SIZE ));
-		data[v] += histo[i];
-	}
+	vector<unsigned int> data(HIS_SIZE);
+	Rebin(histo, &data[0]);
 	_histogram->setValue(id, data);
 
 	return true;
 }
+
+/**Each bin of the output is the sum of ADC_SIZE / HIS_SIZE neighbouring ADC
+ * channels. The number of channels summed is a compile time constant so the
+ * loop is unrolled and vectorized by the compiler.
+ */
+void MCA_DAMM::Rebin(const PixieInterface::word_t *in, unsigned int *out) {
+	static const size_t factor = ADC_SIZE / HIS_SIZE;
+	for (size_t i = 0; i < HIS_SIZE; i++) {
+		unsigned int sum = 0;
+		for (size_t j = 0; j < factor; j++) {
+			sum += in[i * factor + j];
+		}
+		out[i] = sum;
+	}
+}
+
+void MCA_DAMM::Flush() {
+	_histogram->flush();
+}
@@ -8,6 +8,8 @@
 MCA_ROOT::MCA_ROOT(PixieInterface *pif, const char *basename) :
 	MCA(pif)
 {
+	//ROOT histograms are filled by a single worker.
+	_maxWorkers = 1;
 	OpenFile(basename);
 }
 MCA_ROOT::~MCA_ROOT() {
@@ -58,11 +60,7 @@ TH1F* MCA_ROOT::GetHistogram(int mod, int ch) {
 	return histogram;
 }
 
-bool MCA_ROOT::StoreData(int mod, int ch) {
-	PixieInterface::word_t histo[ADC_SIZE];
-
-	_pif->ReadHistogram(histo, ADC_SIZE, mod, ch);
-
+bool MCA_ROOT::StoreHistogram(int mod, int ch, const PixieInterface::word_t *histo) {
 	TH1F *histogram = GetHistogram(mod,ch);
 	if (!histogram) return false;
 
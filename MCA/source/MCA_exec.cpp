@@ -1,26 +1,40 @@
 #include <string>
+#include <vector>
 #include <stdio.h>
 
 #include "MCA_ROOT.h"
 #include "MCA_DAMM.h"
 
-//printf("Usage: %s <outputType> [duration] [basename]\n",argv[0]);
+//printf("Usage: %s [-w workers] [-a] <outputType> [duration] [basename]\n",argv[0]);
 //printf("\touputType\tCan be either damm or root.\n");
+//printf("\t-w workers\tNumber of threads storing the histograms, 0 stores them while reading.\n");
+//printf("\t-a\t\tRead all channels on every update, even if their counts did not change.\n");
 int main(int argc, char *argv[])
 {
   int totalTime = 0;
   const char* basename = "MCA";
   bool useRoot = false;
+  int numWorkers = -1;
+  bool skipUnchanged = true;
 
-	if (argc >= 2) {
-		std::string type = argv[1];
+	//Remove the options, what is left are the positional arguments.
+	std::vector<char*> args;
+	for (int i = 1; i < argc; i++) {
+		std::string opt = argv[i];
+		if (opt == "-w" && i + 1 < argc) numWorkers = atoi(argv[++i]);
+		else if (opt == "-a") skipUnchanged = false;
+		else args.push_back(argv[i]);
+	}
+
+	if (args.size() >= 1) {
+		std::string type = args[0];
 		if (type == "root") useRoot = true;
-		else if (type != "damm")totalTime = atoi(argv[1]);
-		if (argc >= 3) {
-			if (totalTime == 0) totalTime = atoi(argv[2]);
-			else basename = argv[2];
-			if (argc >= 4)
-				basename = argv[3];
+		else if (type != "damm")totalTime = atoi(args[0]);
+		if (args.size() >= 2) {
+			if (totalTime == 0) totalTime = atoi(args[1]);
+			else basename = args[1];
+			if (args.size() >= 3)
+				basename = args[2];
 		}
 	}
 	if (totalTime == 0) totalTime = 10;
@@ -47,6 +61,8 @@ int main(int argc, char *argv[])
 #elif defined(USE_DAMM)
 	MCA* mca = new MCA_DAMM(&pif,basename);
 #endif
+  if (numWorkers >= 0) mca->SetNumWorkers(numWorkers);
+  mca->SetSkipUnchanged(skipUnchanged);
   if (mca->IsOpen()) 
 	  mca->Run(totalTime);
   delete mca;
@@ -41,6 +41,8 @@ class MCA_args{
 	bool useRoot;
 	int totalTime;
 	std::string basename;
+	int numWorkers; /// The number of storage workers, -1 for the default of the MCA.
+	bool skipUnchanged; /// Skip channels whose counts did not change.
 	
 	MCA *mca;
 
@@ -67,6 +69,10 @@ class MCA_args{
 	
 	void SetBasename(std::string basename_){ basename = basename_; }
 
+	void SetNumWorkers(int numWorkers_){ numWorkers = numWorkers_; }
+
+	void SetSkipUnchanged(bool state_=true){ skipUnchanged = state_; }
+
 	bool Initialize(PixieInterface *pif_);
 	
 	bool Step();
@@ -3,74 +3,132 @@
 #ifndef POLL2_STATS_H
 #define POLL2_STATS_H
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+
 #define NUM_CHAN_PER_MOD 16
 
+///The size of a cache line, the counters of each module start on their own line.
+#define STATS_CACHE_LINE 64
+
+///The time between snapshots of the counters in milliseconds.
+#define STATS_TICK_MS 100
+
+///The number of bins in the dead time and FIFO occupancy distributions.
+#define STATS_HIST_BINS 20
+
+///The localhost port of the text statistics endpoint.
+#define STATS_HTTP_PORT 5557
+
 class Client;
 
+///The lengths of the rolling windows used for the rates, in seconds.
+static const unsigned int statsWindows[] = {1, 10, 60};
+static const size_t numStatsWindows = sizeof(statsWindows) / sizeof(statsWindows[0]);
+
+/** Counters of a single module. Only the readout thread writes to them, the
+  * stats thread reads them. Each module is aligned to a cache line so the
+  * modules never share a line with each other or with the rest of the handler.
+  */
+struct alignas(STATS_CACHE_LINE) ModuleCounters{
+	std::atomic<unsigned long long> events[NUM_CHAN_PER_MOD]; ///The total number of events in each channel.
+	std::atomic<unsigned long long> bytes; ///The total number of bytes read.
+	std::atomic<unsigned long long> fifoOccupancy[STATS_HIST_BINS]; ///The FIFO fill fraction at each read.
+	std::atomic<unsigned long long> deadTime[STATS_HIST_BINS]; ///The dead time fraction at each scaler read.
+
+	ModuleCounters();
+
+	///Add to a counter. Only a single thread may write, so no locked instruction is needed.
+	static void Add(std::atomic<unsigned long long> &counter_, unsigned long long value_){
+		counter_.store(counter_.load(std::memory_order_relaxed) + value_, std::memory_order_relaxed);
+	}
+
+	///Return the bin of a fraction between 0 and 1.
+	static unsigned int GetBin(double fraction_);
+};
+
 class StatsHandler{
   public:
     StatsHandler(size_t nCards = 1);
-    
+
     ~StatsHandler();
 
+	///Count an event. Called by the readout thread only.
     void AddEvent(unsigned int mod, unsigned int ch, size_t size, int delta_=1);
-    
+
+	///Record the fraction of the FIFO of a module that was filled when it was read.
+	void AddFifoOccupancy(unsigned int mod, double fraction_);
+
     bool AddTime(double dtime);
 
 	///Set the amount of time between scalers dumps in seconds.
 	void SetDumpInterval(double interval) {dumpTime = interval;};
 
     double GetDataRate(size_t mod);
-    
+
     double GetTotalDataRate();
-    
+
     double GetEventRate(size_t mod);
-    
+
 	///Return the total run time.
 	double GetTotalTime();
 
 	///Set the ICR and OCR from the XIA module.
-	void SetXiaRates(int mod, std::vector<std::pair<double,double>> *xiaRates); 
-	
+	void SetXiaRates(int mod, std::vector<std::pair<double,double>> *xiaRates);
+
 	bool CanSend(){ return is_able_to_send; }
-	
+
+	///Return true if the text endpoint is listening.
+	bool IsServing(){ return listenSock >= 0; }
+
 	///Clear the stats.
 	void Clear();
 	void ClearRates();
 	void ClearTotals();
 
     void Dump();
-	
+
+	///Return the statistics as text, one value per line.
+	std::string GetText();
+
   private:
+	///The counters of every module at one tick of the stats thread.
+	struct Snapshot{
+		double time; ///The time of the snapshot in seconds.
+		std::vector<unsigned long long> events; ///The events of each channel, NUM_CHAN_PER_MOD per module.
+		std::vector<unsigned long long> bytes; ///The bytes of each module.
+	};
+
     Client *client; // UDP client for network access
-    
-    /** number of events for each channel this tick */
-    unsigned int **nEventsDelta;
-    
-    /** total number of events for each channel */
-    unsigned int **nEventsTotal; 
-    
-    /** data in bytes this tick per module*/
-    size_t *dataDelta;
-    
-    /** total data in bytes per module*/
-    size_t *dataTotal;
-    
+
+	/** counters updated by the readout thread */
+	ModuleCounters *counters;
+
+	/** number of rejected events (bad module or channel) */
+	std::atomic<unsigned long long> badEvents;
+
+    /** total number of events for each channel at the last ClearRates */
+    std::vector<unsigned long long> eventsAtClear;
+
+    /** total data in bytes per module at the last ClearRates */
+    std::vector<unsigned long long> dataAtClear;
+
     /** calculated event rate in Hz for each channel */
     double **calcEventRate;
-    
+
     double **inputCountRate; ///<The XIA Module input count rate.
     double **outputCountRate; ///<The XIA Module output count rate.
-    
-    /** calculated data rate in bytes per second for each module */
-    size_t *calcDataRate;
 
     /** time elapsed in seconds */
     double timeElapsed;
-    
+
     /** total time in seconds */
     double totalTime;
-    
+
     /** time between data dumps in seconds */
     double dumpTime;
 
@@ -79,6 +137,23 @@ class StatsHandler{
 
 	bool is_able_to_send; /// Is StatsHandler able to send on the network?
 
+	std::vector<Snapshot> history; /// Ring of snapshots taken by the stats thread.
+	size_t historyNext; /// The next snapshot of the ring to write.
+	size_t historySize; /// The number of snapshots in the ring.
+	std::mutex historyMutex; /// Protects the ring and the XIA rates.
+
+	int listenSock; /// The socket of the text endpoint, -1 if it is not open.
+	std::atomic<bool> stopThread; /// Set to stop the stats thread.
+	std::thread statsThread; /// Takes the snapshots and answers the text endpoint.
+
+	///Main loop of the stats thread.
+	void run_stats_thread();
+
+	///Copy the counters into the next snapshot of the ring.
+	void take_snapshot(double now_);
+
+	///Answer a single connection on the text endpoint.
+	void serve_client(int sock_);
 };
 
 #endif
@@ -103,6 +103,8 @@ MCA_args::MCA_args(bool useRoot_, int totalTime_, std::string basename_){
 	useRoot = useRoot_;
 	totalTime = totalTime_;
 	basename = basename_;
+	numWorkers = -1;
+	skipUnchanged = true;
 	
 	mca = NULL;
 }
@@ -128,6 +130,9 @@ bool MCA_args::Initialize(PixieInterface *pif_){
 	mca = (MCA*)(new MCA_DAMM(pif_, basename.c_str()));
 #endif
 
+	if(numWorkers >= 0){ mca->SetNumWorkers(numWorkers); }
+	mca->SetSkipUnchanged(skipUnchanged);
+
 	pif_->StartHistogramRun();
 
 	if(!mca->IsOpen()){
@@ -153,6 +158,8 @@ void MCA_args::Zero(){
 	useRoot = false;
 	totalTime = 0; // Needs to be zero for checking of MCA arguments
 	basename = "MCA";
+	numWorkers = -1;
+	skipUnchanged = true;
 	
 	if(mca){ 
 		delete mca; 
@@ -643,6 +650,7 @@ void Poll::help(){
 		std::cout << "   reboot              - Reboot PIXIE crate\n";
 		std::cout << "   stats [time]        - Set the time delay between statistics dumps (default=-1)\n";
 		std::cout << "   mca [root|damm] [time] [filename]     - Use MCA to record data for debugging purposes\n";
+		std::cout << "       [-w workers] [-a]                 - Number of threads storing the histograms, read all channels on every update\n";
 	}
 	std::cout << "   dump [filename]                       - Dump pixie settings to file (default='Fallback.set')\n";
 	std::cout << "   pread <mod> <chan> <param>            - Read parameters from individual PIXIE channels\n";
@@ -1440,6 +1448,16 @@ void Poll::CommandControl(){
 					continue;
 				}
 
+				// Remove the options, what is left are the positional arguments.
+				std::vector<std::string> options;
+				options.swap(arguments);
+				for(size_t i = 0; i < options.size(); i++){
+					if(options[i] == "-w" && i + 1 < options.size()){ mca_args.SetNumWorkers(atoi(options[++i].c_str())); }
+					else if(options[i] == "-a"){ mca_args.SetSkipUnchanged(false); }
+					else{ arguments.push_back(options[i]); }
+				}
+				p_args = arguments.size();
+
 				if (p_args >= 1) {
 					std::string type = arguments.at(0);
 					
@@ -1661,6 +1679,8 @@ void Poll::UpdateStatus() {
 	if(do_MCA_run){
 		status << " " << (int)mca_args.GetMCA()->GetRunTime() << "s";
 		status << " of " << mca_args.GetTotalTime() << "s";
+		//Add the time of the last histogram update
+		status << " " << (int)(mca_args.GetMCA()->GetStepTiming().totalTime * 1e3) << "ms/update";
 	}
 	else{
 		//Add run time to status
@@ -1742,6 +1762,9 @@ bool Poll::ReadFIFO() {
 				continue;
 			}
 
+			//Record how full the FIFO was when it was read.
+			statsHandler->AddFifoOccupancy(mod, (double)nWords[mod] / EXTERNAL_FIFO_LENGTH);
+
 			//Check if the FIFO is overfilled
 			bool fullFIFO = (nWords[mod] >= EXTERNAL_FIFO_LENGTH);
 			if (fullFIFO) {
@@ -1,24 +1,62 @@
 #include <iostream>
+#include <sstream>
 #include <vector>
+#include <chrono>
+#include <new>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
 #include "poll2_stats.h"
 #include "poll2_socket.h"
 
+/// The number of snapshots needed to cover the longest rolling window.
+static const size_t historyLength = statsWindows[numStatsWindows - 1] * 1000 / STATS_TICK_MS + 1;
+
+/// Return the steady clock in seconds.
+static double steady_seconds(){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ModuleCounters::ModuleCounters() : bytes(0) {
+	for(unsigned int i = 0; i < NUM_CHAN_PER_MOD; i++){ events[i] = 0; }
+	for(unsigned int i = 0; i < STATS_HIST_BINS; i++){
+		fifoOccupancy[i] = 0;
+		deadTime[i] = 0;
+	}
+}
+
+unsigned int ModuleCounters::GetBin(double fraction_){
+	if(!(fraction_ > 0)){ return 0; }
+	if(fraction_ >= 1){ return STATS_HIST_BINS - 1; }
+	return (unsigned int)(fraction_ * STATS_HIST_BINS);
+}
+
 StatsHandler::StatsHandler(const size_t nCards){
 
 	numCards = nCards;
 
+	// The counters of each module are aligned to a cache line. new[] does not honour
+	// the alignment of ModuleCounters before C++17, so allocate the memory ourselves.
+	void *memory = NULL;
+	if(posix_memalign(&memory, STATS_CACHE_LINE, numCards * sizeof(ModuleCounters)) != 0){ throw std::bad_alloc(); }
+	counters = static_cast<ModuleCounters*>(memory);
+	for(size_t i = 0; i < numCards; i++){ new (&counters[i]) ModuleCounters(); }
+	badEvents = 0;
+	eventsAtClear.assign(numCards * NUM_CHAN_PER_MOD, 0);
+	dataAtClear.assign(numCards, 0);
+
 	// Define all the 2d arrays
-	nEventsDelta = new unsigned int*[numCards];
-	nEventsTotal = new unsigned int*[numCards]; 
 	calcEventRate = new double*[numCards];
 	inputCountRate = new double*[numCards];
 	outputCountRate = new double*[numCards];
 	for(unsigned int i = 0; i < numCards; i++){
-		nEventsDelta[i] = new unsigned int[NUM_CHAN_PER_MOD];
-		nEventsTotal[i] = new unsigned int[NUM_CHAN_PER_MOD];
 		calcEventRate[i] = new double[NUM_CHAN_PER_MOD];
 		inputCountRate[i] = new double[NUM_CHAN_PER_MOD];
 		outputCountRate[i] = new double[NUM_CHAN_PER_MOD];
@@ -26,22 +64,16 @@ StatsHandler::StatsHandler(const size_t nCards){
 
 	for(unsigned int i = 0; i < numCards; i++){
 		for(unsigned int j = 0; j < NUM_CHAN_PER_MOD; j++){
-			nEventsDelta[i][j] = 0;
-			nEventsTotal[i][j] = 0;
 			calcEventRate[i][j] = 0.0;
 			inputCountRate[i][j] = 0.0;
 			outputCountRate[i][j] = 0.0;
 		}
 	}
 
-	// Define all the 1d arrays
-	dataDelta = new size_t[numCards];
-	dataTotal = new size_t[numCards];
-
 	timeElapsed = 0.0;
 	totalTime = 0.0;
 	dumpTime = 3.0; // Minimum of 2 seconds between updates
-	
+
 	is_able_to_send = true;
 
 	client = new Client();
@@ -50,44 +82,79 @@ StatsHandler::StatsHandler(const size_t nCards){
 	}
 
 	Clear();
+
+	// Allocate the ring of snapshots.
+	history.resize(historyLength);
+	for(size_t i = 0; i < historyLength; i++){
+		history[i].time = 0.0;
+		history[i].events.assign(numCards * NUM_CHAN_PER_MOD, 0);
+		history[i].bytes.assign(numCards, 0);
+	}
+	historyNext = 0;
+	historySize = 0;
+
+	// Open the text endpoint on localhost.
+	listenSock = socket(AF_INET, SOCK_STREAM, 0);
+	if(listenSock >= 0){
+		int reuse = 1;
+		setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		struct sockaddr_in serv;
+		memset(&serv, 0, sizeof(serv));
+		serv.sin_family = AF_INET;
+		serv.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		serv.sin_port = htons(STATS_HTTP_PORT);
+
+		if(bind(listenSock, (struct sockaddr *)&serv, sizeof(serv)) < 0 || listen(listenSock, 4) < 0){
+			std::cout << "StatsHandler: Unable to open port " << STATS_HTTP_PORT << " for the statistics text endpoint\n";
+			close(listenSock);
+			listenSock = -1;
+		}
+	}
+
+	stopThread = false;
+	statsThread = std::thread(&StatsHandler::run_stats_thread, this);
 }
 
 StatsHandler::~StatsHandler(){
+	stopThread = true;
+	statsThread.join();
+	if(listenSock >= 0){ close(listenSock); }
+
 	client->SendMessage((char *)"$KILL_SOCKET", 13);
 	client->Close();
-	
+	delete client;
+
 	// De-allocate the 2d arrays
 	for(unsigned int i = 0; i < numCards; i++){
-		delete[] nEventsDelta[i];
-		delete[] nEventsTotal[i];
 		delete[] calcEventRate[i];
 		delete[] inputCountRate[i];
 		delete[] outputCountRate[i];
 	}
-	delete[] nEventsDelta;
-	delete[] nEventsTotal;
 	delete[] calcEventRate;
 	delete[] inputCountRate;
 	delete[] outputCountRate;
-	
-	// De-allocate the 1d arrays
-	delete[] dataDelta;
-	delete[] dataTotal;
+
+	for(size_t i = 0; i < numCards; i++){ counters[i].~ModuleCounters(); }
+	free(counters);
 }
 
+/**The counters are only written by the readout thread, so no lock or locked
+ * instruction is needed. Bad modules and channels are counted instead of printed
+ * and show up in the text endpoint.
+ */
 void StatsHandler::AddEvent(unsigned int mod, unsigned int ch, size_t size, int delta_/*=1*/){
-	if(mod >= numCards){
-		std::cout << "Bad module " << mod << ", numCards = " << numCards << std::endl;
-		return;
-	}
-	if(ch >= (unsigned)NUM_CHAN_PER_MOD){
-		std::cout << "Bad channel " << ch << std::endl;
+	if(mod >= numCards || ch >= (unsigned)NUM_CHAN_PER_MOD){
+		ModuleCounters::Add(badEvents, 1);
 		return;
 	}
-	nEventsDelta[mod][ch] += delta_;
-	nEventsTotal[mod][ch] += delta_;
-	dataDelta[mod] += size;
-	dataTotal[mod] += size;
+	ModuleCounters::Add(counters[mod].events[ch], delta_);
+	ModuleCounters::Add(counters[mod].bytes, size);
+}
+
+void StatsHandler::AddFifoOccupancy(unsigned int mod, double fraction_){
+	if(mod >= numCards){ return; }
+	ModuleCounters::Add(counters[mod].fifoOccupancy[ModuleCounters::GetBin(fraction_)], 1);
 }
 
 /**
@@ -98,7 +165,7 @@ bool StatsHandler::AddTime(double dtime) {
 	totalTime   += dtime;
 
 	return (timeElapsed >= dumpTime);
-   
+
 }
 
 void StatsHandler::Dump(void){
@@ -123,35 +190,37 @@ void StatsHandler::Dump(void){
 	// ...
 	// channel N-1, 15 rate
 	// channel N-1, 15 total
-	//msg_size = 20 fixed bytes + 4 words/card/ch * numCards * 16 ch * 8 bytes/ word
-	size_t msg_size = sizeof(numCards) + sizeof(totalTime) + sizeof(dataRate) + numCards*16*(sizeof(inputCountRate[0][0])+sizeof(outputCountRate[0][0])+sizeof(calcEventRate[0][0])+sizeof(nEventsTotal[0][0]));
+	//msg_size = 20 fixed bytes + (3 doubles + 1 int)/card/ch * numCards * 16 ch
+	size_t msg_size = sizeof(numCards) + sizeof(totalTime) + sizeof(dataRate) + numCards*16*(3*sizeof(double)+sizeof(unsigned int));
 	char *message = new char[msg_size];
 	char *ptr = message;
-	
+
 	// Construct the rate message
 	memcpy(ptr, &numCards, 4); ptr += 4;
 	memcpy(ptr, &totalTime, 8); ptr += 8;
 	memcpy(ptr, &dataRate, 8); ptr += 8;
 	for (unsigned int i=0; i < numCards; i++) {
-		for (unsigned int j=0; j < NUM_CHAN_PER_MOD; j++) {	 
-			calcEventRate[i][j] = nEventsDelta[i][j] / timeElapsed;
-			if (timeElapsed<=0) 
+		for (unsigned int j=0; j < NUM_CHAN_PER_MOD; j++) {
+			unsigned long long events = counters[i].events[j].load(std::memory_order_relaxed);
+			unsigned int total = (unsigned int)events;
+			calcEventRate[i][j] = (events - eventsAtClear[i*NUM_CHAN_PER_MOD + j]) / timeElapsed;
+			if (timeElapsed<=0)
 				calcEventRate[i][j] = 0;
 			memcpy(ptr, &inputCountRate[i][j], sizeof(inputCountRate[i][j])); ptr += sizeof(inputCountRate[i][j]);
 			memcpy(ptr, &outputCountRate[i][j], sizeof(outputCountRate[i][j])); ptr += sizeof(outputCountRate[i][j]);
 			memcpy(ptr, &calcEventRate[i][j], sizeof(calcEventRate[i][j])); ptr += sizeof(calcEventRate[i][j]);
-			memcpy(ptr, &nEventsTotal[i][j], sizeof(nEventsTotal[i][j])); ptr += sizeof(nEventsTotal[i][j]);
+			memcpy(ptr, &total, sizeof(total)); ptr += sizeof(total);
 		} //Update the status bar
 	}
-	
+
 	client->SendMessage(message, msg_size);
-	
+
 	delete[] message;
 }
 
 double StatsHandler::GetDataRate(size_t mod){
 	if(timeElapsed<=0) return 0;
-	return dataDelta[mod] / timeElapsed;
+	return (counters[mod].bytes.load(std::memory_order_relaxed) - dataAtClear[mod]) / timeElapsed;
 }
 
 double StatsHandler::GetTotalDataRate(){
@@ -162,7 +231,7 @@ double StatsHandler::GetTotalDataRate(){
 
 double StatsHandler::GetEventRate(size_t mod){
 	double output = 0.0;
-	for(unsigned int i = 0; i < numCards; i++){
+	for(unsigned int i = 0; i < NUM_CHAN_PER_MOD; i++){
 		output += calcEventRate[mod][i];
 	}
 	return output;
@@ -177,28 +246,193 @@ void StatsHandler::ClearRates(){
 
 	for(size_t i=0; i < numCards; i++){
 		for(size_t j = 0; j < NUM_CHAN_PER_MOD; j++){
-			nEventsDelta[i][j] = 0;
+			eventsAtClear[i*NUM_CHAN_PER_MOD + j] = counters[i].events[j].load(std::memory_order_relaxed);
 		}
-		dataDelta[i] = 0;
+		dataAtClear[i] = counters[i].bytes.load(std::memory_order_relaxed);
 	}
 }
 
+/**The dead time fraction of the module, 1 - OCR / ICR summed over the channels,
+ * is added to the dead time distribution of the module.
+ */
 void StatsHandler::SetXiaRates(int mod, std::vector<std::pair<double, double> > *xiaRates) {
-	for (int ch = 0; ch < NUM_CHAN_PER_MOD; ch++) {
-		inputCountRate[mod][ch] = xiaRates->at(ch).first;
-		outputCountRate[mod][ch] = xiaRates->at(ch).second;
+	double icr = 0.0, ocr = 0.0;
+	{
+		std::lock_guard<std::mutex> lock(historyMutex);
+		for (int ch = 0; ch < NUM_CHAN_PER_MOD; ch++) {
+			inputCountRate[mod][ch] = xiaRates->at(ch).first;
+			outputCountRate[mod][ch] = xiaRates->at(ch).second;
+			icr += inputCountRate[mod][ch];
+			ocr += outputCountRate[mod][ch];
+		}
 	}
+	if(icr > 0){ ModuleCounters::Add(counters[mod].deadTime[ModuleCounters::GetBin(1.0 - ocr / icr)], 1); }
 }
+
 void StatsHandler::ClearTotals(){
 	totalTime = 0;
 	for(size_t i=0; i < numCards; i++){
 		for(size_t j = 0; j < NUM_CHAN_PER_MOD; j++){
-			nEventsTotal[i][j] = 0;
+			counters[i].events[j].store(0, std::memory_order_relaxed);
+		}
+		counters[i].bytes.store(0, std::memory_order_relaxed);
+		for(size_t j = 0; j < STATS_HIST_BINS; j++){
+			counters[i].fifoOccupancy[j].store(0, std::memory_order_relaxed);
+			counters[i].deadTime[j].store(0, std::memory_order_relaxed);
 		}
 	}
+	badEvents.store(0, std::memory_order_relaxed);
 }
 
 void StatsHandler::Clear(){
-	ClearRates();
 	ClearTotals();
+	ClearRates();
+}
+
+/**Below is the text format, one value per line in the form "name{labels} value".
+ * The rates are taken over the last 1, 10 and 60 seconds, or over the time since
+ * the totals were cleared if that is shorter. The distributions list the number of
+ * samples in each bin, the label "bin" is the low edge of the bin.
+ */
+std::string StatsHandler::GetText(){
+	std::stringstream text;
+	std::lock_guard<std::mutex> lock(historyMutex);
+
+	text << "modules " << numCards << "\n";
+	text << "bad_events " << badEvents.load(std::memory_order_relaxed) << "\n";
+	if(historySize == 0){ return text.str(); }
+
+	const Snapshot &newest = history[(historyNext + historyLength - 1) % historyLength];
+	for(unsigned int mod = 0; mod < numCards; mod++){
+		text << "data_total{mod=\"" << mod << "\"} " << newest.bytes[mod] << "\n";
+		for(unsigned int ch = 0; ch < NUM_CHAN_PER_MOD; ch++){
+			text << "events_total{mod=\"" << mod << "\",ch=\"" << ch << "\"} " << newest.events[mod*NUM_CHAN_PER_MOD + ch] << "\n";
+		}
+	}
+
+	for(size_t w = 0; w < numStatsWindows; w++){
+		size_t ticks = statsWindows[w] * 1000 / STATS_TICK_MS;
+		if(ticks > historySize - 1){ ticks = historySize - 1; }
+		const Snapshot &oldest = history[(historyNext + historyLength - 1 - ticks) % historyLength];
+		double dt = newest.time - oldest.time;
+		for(unsigned int mod = 0; mod < numCards; mod++){
+			double rate = (dt > 0 ? (newest.bytes[mod] - oldest.bytes[mod]) / dt : 0.0);
+			text << "data_rate{mod=\"" << mod << "\",window=\"" << statsWindows[w] << "s\"} " << rate << "\n";
+			for(unsigned int ch = 0; ch < NUM_CHAN_PER_MOD; ch++){
+				size_t index = mod*NUM_CHAN_PER_MOD + ch;
+				rate = (dt > 0 ? (newest.events[index] - oldest.events[index]) / dt : 0.0);
+				text << "event_rate{mod=\"" << mod << "\",ch=\"" << ch << "\",window=\"" << statsWindows[w] << "s\"} " << rate << "\n";
+			}
+		}
+	}
+
+	for(unsigned int mod = 0; mod < numCards; mod++){
+		for(unsigned int ch = 0; ch < NUM_CHAN_PER_MOD; ch++){
+			text << "input_count_rate{mod=\"" << mod << "\",ch=\"" << ch << "\"} " << inputCountRate[mod][ch] << "\n";
+			text << "output_count_rate{mod=\"" << mod << "\",ch=\"" << ch << "\"} " << outputCountRate[mod][ch] << "\n";
+		}
+	}
+
+	for(unsigned int mod = 0; mod < numCards; mod++){
+		for(unsigned int bin = 0; bin < STATS_HIST_BINS; bin++){
+			text << "dead_time{mod=\"" << mod << "\",bin=\"" << (double)bin / STATS_HIST_BINS << "\"} " << counters[mod].deadTime[bin].load(std::memory_order_relaxed) << "\n";
+		}
+		for(unsigned int bin = 0; bin < STATS_HIST_BINS; bin++){
+			text << "fifo_occupancy{mod=\"" << mod << "\",bin=\"" << (double)bin / STATS_HIST_BINS << "\"} " << counters[mod].fifoOccupancy[bin].load(std::memory_order_relaxed) << "\n";
+		}
+	}
+
+	return text.str();
+}
+
+/**The counters are copied every STATS_TICK_MS milliseconds. Between the snapshots
+ * the thread waits on the text endpoint and answers any connection.
+ */
+void StatsHandler::run_stats_thread(){
+	double nextTick = steady_seconds();
+	while(!stopThread){
+		double now = steady_seconds();
+		if(now >= nextTick){
+			take_snapshot(now);
+			nextTick += STATS_TICK_MS * 1e-3;
+			if(nextTick < now){ nextTick = now + STATS_TICK_MS * 1e-3; }
+		}
+
+		double wait = nextTick - now;
+		if(wait < 0){ wait = 0; }
+		struct timeval timeout;
+		timeout.tv_sec = (long)wait;
+		timeout.tv_usec = (long)((wait - timeout.tv_sec) * 1e6);
+
+		if(listenSock < 0){
+			select(0, NULL, NULL, NULL, &timeout);
+			continue;
+		}
+
+		fd_set readfds;
+		FD_ZERO(&readfds);
+		FD_SET(listenSock, &readfds);
+		if(select(listenSock + 1, &readfds, NULL, NULL, &timeout) > 0){
+			int sock = accept(listenSock, NULL, NULL);
+			if(sock >= 0){
+				serve_client(sock);
+				close(sock);
+			}
+		}
+	}
+}
+
+/**If any counter went down the totals were cleared, the older snapshots are then
+ * discarded so the rates do not go negative.
+ */
+void StatsHandler::take_snapshot(double now_){
+	std::lock_guard<std::mutex> lock(historyMutex);
+	Snapshot &snap = history[historyNext];
+	const Snapshot &last = history[(historyNext + historyLength - 1) % historyLength];
+
+	bool cleared = false;
+	snap.time = now_;
+	for(unsigned int mod = 0; mod < numCards; mod++){
+		for(unsigned int ch = 0; ch < NUM_CHAN_PER_MOD; ch++){
+			size_t index = mod*NUM_CHAN_PER_MOD + ch;
+			snap.events[index] = counters[mod].events[ch].load(std::memory_order_relaxed);
+			if(historySize > 0 && snap.events[index] < last.events[index]){ cleared = true; }
+		}
+		snap.bytes[mod] = counters[mod].bytes.load(std::memory_order_relaxed);
+		if(historySize > 0 && snap.bytes[mod] < last.bytes[mod]){ cleared = true; }
+	}
+
+	historyNext = (historyNext + 1) % historyLength;
+	if(cleared){ historySize = 1; }
+	else if(historySize < historyLength){ historySize++; }
+}
+
+/**A request starting with "GET" is answered with a plain text HTTP response,
+ * anything else (or nothing within 100 ms) gets the bare text.
+ */
+void StatsHandler::serve_client(int sock_){
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 100000;
+	setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(sock_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	char request[1024];
+	ssize_t nRead = recv(sock_, request, sizeof(request), 0);
+
+	std::string body = GetText();
+	std::string reply;
+	if(nRead >= 3 && strncmp(request, "GET", 3) == 0){
+		std::stringstream header;
+		header << "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " << body.size() << "\r\nConnection: close\r\n\r\n";
+		reply = header.str();
+	}
+	reply += body;
+
+	size_t nSent = 0;
+	while(nSent < reply.size()){
+		ssize_t n = send(sock_, reply.data() + nSent, reply.size() - nSent, MSG_NOSIGNAL);
+		if(n <= 0){ break; }
+		nSent += n;
+	}
 }
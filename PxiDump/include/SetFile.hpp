@@ -0,0 +1,126 @@
+/** \file SetFile.hpp
+  * \brief Random access to the parameters of pixie16 binary .set files.
+  *
+  * A pixie16 dsp variable file (.var) is parsed once into a symbol table
+  * which maps every parameter name to its word offset and length within
+  * the block of a module. Binary .set files are memory mapped so that any
+  * parameter of any module may be read or compared without searching.
+  *
+  * \date Oct. 19th, 2026
+  */
+#ifndef SETFILE_HPP
+#define SETFILE_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <stdint.h>
+
+/// A single dsp parameter of the .var file.
+struct VarEntry{
+	std::string name; /// The name of the pixie16 parameter.
+	unsigned int address; /// The dsp address of the parameter.
+	unsigned int offset; /// The offset of the parameter from the start of a module block (in words).
+	unsigned int length; /// The number of words of the parameter, 16 for channel parameters.
+};
+
+/// The symbol table of a pixie16 dsp .var file.
+class VarTable{
+  public:
+	VarTable() : entries(), lookup() { }
+
+	/** Read a pixie16 .var dsp file. Return false if the file could
+	  * not be read or contains no parameters.
+	  */
+	bool Read(const char *filename_);
+
+	/// Return the number of parameters.
+	size_t Size() const { return entries.size(); }
+
+	/// Return the parameter at a given index, parameters are sorted by address.
+	const VarEntry &At(const size_t &index_) const { return entries.at(index_); }
+
+	/// Return the parameter with a given name, or NULL if there is no such parameter.
+	const VarEntry *Find(const std::string &name_) const;
+
+	/// Return the parameter containing a given word of a module block, or NULL.
+	const VarEntry *FindOffset(const unsigned int &offset_) const;
+
+	/// Return all of the parameters.
+	const std::vector<VarEntry> &GetEntries() const { return entries; }
+
+  private:
+	std::vector<VarEntry> entries; /// Parameters sorted by address.
+	std::unordered_map<std::string, size_t> lookup; /// Index of each parameter by name.
+};
+
+/// A single differing word between two .set files.
+struct SetDiff{
+	unsigned int module; /// The module number.
+	const VarEntry *entry; /// The parameter, NULL if the word is not covered by the .var file.
+	unsigned int index; /// The index of the word within the parameter, or its offset if entry is NULL.
+	uint32_t lhs; /// The value in the first file.
+	uint32_t rhs; /// The value in the second file.
+};
+
+/// A memory mapped pixie16 binary .set file.
+class SetFile{
+  public:
+	static const size_t MODULE_WORDS = 1280; /// Size of each module in the .set file (in words).
+
+	SetFile();
+
+	~SetFile();
+
+	/// Map a .set file for reading. Return false on failure.
+	bool Open(const char *filename_);
+
+	/// Unmap the file.
+	void Close();
+
+	/// Return true if a file is mapped.
+	bool IsOpen() const { return (data != NULL); }
+
+	/// Return the name of the mapped file.
+	const std::string &GetFilename() const { return filename; }
+
+	/// Return the number of modules with at least one word in the file.
+	unsigned int GetNumModules() const { return (numWords + MODULE_WORDS - 1) / MODULE_WORDS; }
+
+	/// Return the number of words of a module present in the file.
+	size_t GetModuleWords(const unsigned int &mod_) const;
+
+	/// Return the words of a module block, or NULL if the module is not in the file.
+	const uint32_t *GetModule(const unsigned int &mod_) const;
+
+	/** Return a pointer to the words of a parameter of a module, or NULL if the
+	  * parameter does not fit inside the file.
+	  */
+	const uint32_t *Get(const VarEntry &entry_, const unsigned int &mod_) const;
+
+	/** Read a single word of a parameter. Return false if it is not in the file.
+	  * \param[in]  entry_ The parameter.
+	  * \param[in]  mod_   The module number.
+	  * \param[in]  index_ The word of the parameter, the channel for channel parameters.
+	  * \param[out] value_ The value of the word.
+	  */
+	bool Get(const VarEntry &entry_, const unsigned int &mod_, const unsigned int &index_, uint32_t &value_) const;
+
+	/** Compare the module blocks of two files and append the differing words to diffs_.
+	  * Modules present in only one of the files are not compared. Return the number
+	  * of differing words.
+	  */
+	size_t Diff(const SetFile &other_, const VarTable &table_, std::vector<SetDiff> &diffs_) const;
+
+  private:
+	std::string filename; /// The name of the mapped file.
+	const uint32_t *data; /// The mapped file.
+	size_t numWords; /// The number of whole words in the file.
+	size_t mapSize; /// The number of mapped bytes.
+
+	SetFile(const SetFile &);
+	SetFile &operator = (const SetFile &);
+};
+
+#endif
@@ -0,0 +1,175 @@
+/** \file SetFile.cpp
+  * \brief Random access to the parameters of pixie16 binary .set files.
+  *
+  * \date Oct. 19th, 2026
+  */
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SetFile.hpp"
+
+bool compareAddress(const VarEntry &lhs, const VarEntry &rhs){ return lhs.address < rhs.address; }
+
+///////////////////////////////////////////////////////////////////////////////
+// class VarTable
+///////////////////////////////////////////////////////////////////////////////
+
+bool VarTable::Read(const char *filename_){
+	std::ifstream input(filename_);
+	if(!input.good()){
+		return false;
+	}
+
+	entries.clear();
+	lookup.clear();
+
+	VarEntry entry;
+	std::string hexstr;
+	while(input >> hexstr >> entry.name){
+		if(hexstr.find("0x") != std::string::npos)
+			hexstr = hexstr.substr(hexstr.find("0x")+2);
+
+		std::stringstream stream;
+		stream << std::hex << hexstr;
+		stream >> entry.address;
+
+		entries.push_back(entry);
+	}
+
+	input.close();
+
+	if(entries.empty()){ return false; }
+
+	// The module block starts at the lowest address, and each parameter
+	// extends up to the next one.
+	std::stable_sort(entries.begin(), entries.end(), compareAddress);
+	const unsigned int firstAddress = entries.front().address;
+	for(size_t i = 0; i < entries.size(); i++){
+		entries[i].offset = entries[i].address - firstAddress;
+		if(i+1 < entries.size())
+			entries[i].length = entries[i+1].address - entries[i].address;
+		else if(entries[i].offset < SetFile::MODULE_WORDS)
+			entries[i].length = SetFile::MODULE_WORDS - entries[i].offset;
+		else
+			entries[i].length = 1;
+		lookup.insert(std::make_pair(entries[i].name, i));
+	}
+
+	return true;
+}
+
+const VarEntry *VarTable::Find(const std::string &name_) const {
+	std::unordered_map<std::string, size_t>::const_iterator iter = lookup.find(name_);
+	if(iter == lookup.end()){ return NULL; }
+	return &entries[iter->second];
+}
+
+const VarEntry *VarTable::FindOffset(const unsigned int &offset_) const {
+	if(entries.empty()){ return NULL; }
+
+	// Find the last parameter starting at or before the offset.
+	size_t low = 0, high = entries.size();
+	while(high - low > 1){
+		size_t mid = (low + high) / 2;
+		if(entries[mid].offset <= offset_){ low = mid; }
+		else{ high = mid; }
+	}
+
+	const VarEntry &entry = entries[low];
+	if(offset_ < entry.offset || offset_ >= entry.offset + entry.length){ return NULL; }
+	return &entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class SetFile
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t SetFile::MODULE_WORDS;
+
+SetFile::SetFile() : filename(), data(NULL), numWords(0), mapSize(0) { }
+
+SetFile::~SetFile(){
+	Close();
+}
+
+bool SetFile::Open(const char *filename_){
+	Close();
+
+	int fd = open(filename_, O_RDONLY);
+	if(fd < 0){ return false; }
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(uint32_t)){
+		close(fd);
+		return false;
+	}
+
+	void *ptr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(ptr == MAP_FAILED){ return false; }
+
+	filename = filename_;
+	data = (const uint32_t*)ptr;
+	mapSize = info.st_size;
+	numWords = mapSize / sizeof(uint32_t);
+
+	return true;
+}
+
+void SetFile::Close(){
+	if(data){ munmap((void*)data, mapSize); }
+	filename.clear();
+	data = NULL;
+	numWords = 0;
+	mapSize = 0;
+}
+
+size_t SetFile::GetModuleWords(const unsigned int &mod_) const {
+	size_t start = mod_ * MODULE_WORDS;
+	if(start >= numWords){ return 0; }
+	return std::min(MODULE_WORDS, numWords - start);
+}
+
+const uint32_t *SetFile::GetModule(const unsigned int &mod_) const {
+	if(GetModuleWords(mod_) == 0){ return NULL; }
+	return data + mod_ * MODULE_WORDS;
+}
+
+const uint32_t *SetFile::Get(const VarEntry &entry_, const unsigned int &mod_) const {
+	if(entry_.offset + entry_.length > GetModuleWords(mod_)){ return NULL; }
+	return data + mod_ * MODULE_WORDS + entry_.offset;
+}
+
+bool SetFile::Get(const VarEntry &entry_, const unsigned int &mod_, const unsigned int &index_, uint32_t &value_) const {
+	if(index_ >= entry_.length || entry_.offset + index_ >= GetModuleWords(mod_)){ return false; }
+	value_ = data[mod_ * MODULE_WORDS + entry_.offset + index_];
+	return true;
+}
+
+size_t SetFile::Diff(const SetFile &other_, const VarTable &table_, std::vector<SetDiff> &diffs_) const {
+	size_t count = 0;
+	unsigned int numModules = std::min(GetNumModules(), other_.GetNumModules());
+	for(unsigned int mod = 0; mod < numModules; mod++){
+		const uint32_t *lhs = GetModule(mod);
+		const uint32_t *rhs = other_.GetModule(mod);
+		size_t words = std::min(GetModuleWords(mod), other_.GetModuleWords(mod));
+		for(size_t i = 0; i < words; i++){
+			if(lhs[i] == rhs[i]){ continue; }
+			SetDiff diff;
+			diff.module = mod;
+			diff.entry = table_.FindOffset(i);
+			diff.index = (diff.entry ? i - diff.entry->offset : i);
+			diff.lhs = lhs[i];
+			diff.rhs = rhs[i];
+			diffs_.push_back(diff);
+			count++;
+		}
+	}
+	return count;
+}
@@ -12,16 +12,19 @@
 #include <sstream>
 #include <fstream>
 
+#include <stdlib.h>
+
 #ifdef USE_ROOT_OUTPUT
 #include "TNamed.h"
 #include "TFile.h"
+#include "TTree.h"
 #endif
 
 #include "set2root.hpp"
+#include "SetFile.hpp"
 
 #define FILTER_CLOCK 8E-3 // Filter clock (in us)
 #define ADC_CLOCK 4E-3 // ADC clock (in us)
-#define READ_SIZE 1280 // Size of each module in the .set file.
 
 #ifdef USE_ROOT_OUTPUT
 bool parameter::write(TFile *f_, const std::string &dir_/*=""*/){
@@ -76,115 +79,160 @@ std::string parameter::print(){
 	return stream.str();
 }
 
-/** Find a parameter with a given file offset. This function returns
-  * NULL if a match was not found, and a returns a pointer to a
-  * parameter object upon success.
-  *  param[in] params   : Vector filled with parameter objects.
-  *  param[in] offset_  : Set file offset to attempt to match.
-  */
-parameter *findParameter(std::vector<parameter> &params, const unsigned int &offset_){
-	for(std::vector<parameter>::iterator iter = params.begin(); iter != params.end(); iter++){
-		if(iter->getOffset() == offset_){ return &(*iter); }
-	}	
-	return NULL;
+#ifdef USE_ROOT_OUTPUT
+void closeFile(TFile *f_){ 
+	if(!f_){ return; }
+	f_->Close(); 
 }
+#else
+void closeFile(std::ofstream &f_){ 
+	f_.close(); 
+}
+#endif
 
-/** Read a pixie16 .var dsp file and store the parameter names and
-  * offsets in a vector of parameter objects. This function returns
-  * false if an error occured, and true upon success.
-  *  param[out] params        : Vector to be filled with parameter objects.
-  *  param[in] var_filename_  : Filename of the .var file to read.
+/** Write the name of every word of a module block which is covered by the
+  * .var file as the header of a csv file.
   */
-bool readVarFile(std::vector<parameter> &params, const char *var_filename_){
-	std::ifstream input(var_filename_);
-	if(!input.good()){
-		return false;
-	}
-	
-	params.clear();
-	
-	unsigned int value;
-	std::string hexstr;
-	std::string name;
-	while(true){
-		input >> hexstr >> name;
-		if(input.eof()){ break; }
-		
-		if(hexstr.find("0x") != std::string::npos)
-			hexstr = hexstr.substr(hexstr.find("0x")+2);
-		
-		std::stringstream stream;
-		stream << std::hex << hexstr;
-		stream >> value;
-		
-		params.push_back(parameter(name, value));
+void writeCsvHeader(std::ofstream &f_, const VarTable &table_){
+	f_ << "file,module";
+	for(size_t i = 0; i < table_.Size(); i++){
+		const VarEntry &entry = table_.At(i);
+		if(entry.offset + entry.length > SetFile::MODULE_WORDS){ continue; }
+		if(entry.length == 1){
+			f_ << "," << entry.name;
+			continue;
+		}
+		for(unsigned int j = 0; j < entry.length; j++){
+			f_ << "," << entry.name << "[";
+			if(j < 10)
+				f_ << "0";
+			f_ << j << "]";
+		}
 	}
-	
-	input.close();
-	
-	return true;
+	f_ << "\n";
 }
 
-/** Read a pixie16 .set file and store the integer values in a vector
-  * of parameter objects. This function returns -1 if an error
-  * occured, and the number of entries read upon success.
-  *  param[in] params        : Vector filled with parameter objects.
-  *  param[in] set_filename_ : Filename of the .set file to read.
-  *  param[in] offset_       : The number of words to skip at the beginning of the file.
-  *  param[in] len_          : The number of words to read form the file.
+/** Write every module of a list of .set files to a single output file in one
+  * pass, one row (or tree entry) per file and module. Return the number of
+  * rows written, or -1 if the output could not be opened.
+  *  param[in] table_       : The symbol table of the .var file.
+  *  param[in] outFilename_ : Filename of the output file.
+  *  param[in] setFiles_    : Filenames of the .set files to read.
+  *  param[in] numSetFiles_ : The number of .set files.
   */
-int readSetFile(std::vector<parameter> &params, const char *set_filename_, const size_t &offset_, const size_t &len_=READ_SIZE){
-	if(params.empty()){ return -1; }
+int bulkExport(const VarTable &table_, const std::string &outFilename_, char **setFiles_, const int &numSetFiles_){
+	// Words of the current module, missing words are zero.
+	std::vector<uint32_t> buffer(SetFile::MODULE_WORDS, 0);
+	unsigned int modNum = 0;
 
-	std::ifstream input(set_filename_);
-	if(!input.good()){
-		return -1;
+#ifdef USE_ROOT_OUTPUT
+	TFile *f = new TFile(outFilename_.c_str(), "RECREATE");
+	if(!f->IsOpen()){ 
+		delete f;
+		return -1; 
 	}
-	
-	input.seekg(offset_*4);
-	if(input.eof()){
-		input.close();
-		return -1;
+	TTree *tree = new TTree("params", "Pixie16 parameters");
+	char fileBuffer[1024];
+	tree->Branch("file", fileBuffer, "file/C");
+	tree->Branch("mod", &modNum, "mod/i");
+	for(size_t i = 0; i < table_.Size(); i++){
+		const VarEntry &entry = table_.At(i);
+		if(entry.offset + entry.length > SetFile::MODULE_WORDS){ continue; }
+		std::stringstream leaf;
+		leaf << entry.name;
+		if(entry.length > 1)
+			leaf << "[" << entry.length << "]";
+		leaf << "/i";
+		tree->Branch(entry.name.c_str(), &buffer[entry.offset], leaf.str().c_str());
 	}
-	
-	unsigned int firstValue = params.front().getOffset();
-	int output = 0;
-	parameter *current_param = NULL;
-	unsigned int word;
-	
-	for(size_t i = 0; i < len_; i++){
-		input.read((char*)&word, 4);
-		if(input.eof()){ break; }
-		output++;
-		
-		parameter *param = findParameter(params, firstValue+i);
-		if(param){ 
-			current_param = param; 
+#else
+	std::ofstream f(outFilename_.c_str());
+	if(!f.good()){ return -1; }
+	writeCsvHeader(f, table_);
+#endif
+
+	int rows = 0;
+	SetFile setFile;
+	for(int i = 0; i < numSetFiles_; i++){
+		if(!setFile.Open(setFiles_[i])){
+			std::cout << " WARNING! Failed to read from .set file '" << setFiles_[i] << "'!\n";
+			continue;
 		}
-		
-		if(current_param){
-			current_param->values.push_back(word);
+		for(modNum = 0; modNum < setFile.GetNumModules(); modNum++){
+			const uint32_t *module = setFile.GetModule(modNum);
+			size_t words = setFile.GetModuleWords(modNum);
+			std::copy(module, module + words, buffer.begin());
+			std::fill(buffer.begin() + words, buffer.end(), 0);
+#ifdef USE_ROOT_OUTPUT
+			strncpy(fileBuffer, setFiles_[i], sizeof(fileBuffer)-1);
+			fileBuffer[sizeof(fileBuffer)-1] = '\0';
+			tree->Fill();
+#else
+			f << setFiles_[i] << "," << modNum;
+			for(size_t j = 0; j < table_.Size(); j++){
+				const VarEntry &entry = table_.At(j);
+				if(entry.offset + entry.length > SetFile::MODULE_WORDS){ continue; }
+				for(unsigned int k = 0; k < entry.length; k++)
+					f << "," << buffer[entry.offset + k];
+			}
+			f << "\n";
+#endif
+			rows++;
 		}
+		setFile.Close();
 	}
-	
-	input.close();
-	
-	return output;
-}
 
 #ifdef USE_ROOT_OUTPUT
-void closeFile(TFile *f_){ 
-	if(!f_){ return; }
-	f_->Close(); 
-}
+	tree->Write();
+	closeFile(f);
+	delete f;
 #else
-void closeFile(std::ofstream &f_){ 
-	f_.close(); 
-}
+	closeFile(f);
 #endif
 
+	return rows;
+}
+
+/** Print every differing parameter of two .set files. Return the number
+  * of differing words, or -1 if either file could not be read.
+  */
+int diffFiles(const VarTable &table_, const char *lhs_, const char *rhs_){
+	SetFile lhs, rhs;
+	if(!lhs.Open(lhs_)){
+		std::cout << " ERROR! Failed to read from .set file '" << lhs_ << "'!\n";
+		return -1;
+	}
+	if(!rhs.Open(rhs_)){
+		std::cout << " ERROR! Failed to read from .set file '" << rhs_ << "'!\n";
+		return -1;
+	}
+	if(lhs.GetNumModules() != rhs.GetNumModules()){
+		std::cout << " WARNING! The files contain " << lhs.GetNumModules() << " and " << rhs.GetNumModules() << " modules, comparing the first " << std::min(lhs.GetNumModules(), rhs.GetNumModules()) << ".\n";
+	}
+
+	std::vector<SetDiff> diffs;
+	lhs.Diff(rhs, table_, diffs);
+	for(std::vector<SetDiff>::iterator iter = diffs.begin(); iter != diffs.end(); iter++){
+		std::cout << "MODULE";
+		if(iter->module < 10)
+			std::cout << "0";
+		std::cout << iter->module << "\t";
+		if(!iter->entry)
+			std::cout << "word " << iter->index;
+		else if(iter->entry->length == 1)
+			std::cout << iter->entry->name;
+		else
+			std::cout << iter->entry->name << "[" << (iter->index < 10 ? "0" : "") << iter->index << "]";
+		std::cout << "\t" << iter->lhs << "\t" << iter->rhs << "\n";
+	}
+
+	return diffs.size();
+}
+
 void help(char * prog_name_){
 	std::cout << "  SYNTAX: " << prog_name_ << " <varFile> <setFile> <startMod> <stopMod> [output]\n";
+	std::cout << "          " << prog_name_ << " --bulk <varFile> <output> <setFile> [setFile ...]\n";
+	std::cout << "          " << prog_name_ << " --diff <varFile> <setFileA> <setFileB>\n";
 }
 
 int main(int argc, char *argv[]){
@@ -192,6 +240,35 @@ int main(int argc, char *argv[]){
 		help(argv[0]);
 		return 0;
 	}
+	else if(argc > 1 && (strcmp(argv[1], "--bulk") == 0 || strcmp(argv[1], "--diff") == 0)){
+		bool bulk = (strcmp(argv[1], "--bulk") == 0);
+		if((bulk && argc < 5) || (!bulk && argc != 5)){
+			std::cout << " Invalid number of arguments to " << argv[0] << " " << argv[1] << ".\n";
+			help(argv[0]);
+			return 1;
+		}
+
+		VarTable table;
+		if(!table.Read(argv[2])){
+			std::cout << " ERROR! Failed to read dsp .var file '" << argv[2] << "'!\n";
+			return 1;
+		}
+
+		if(!bulk){
+			int numDiffs = diffFiles(table, argv[3], argv[4]);
+			if(numDiffs < 0){ return 1; }
+			std::cout << "  Done! Found " << numDiffs << " differing words.\n";
+			return (numDiffs > 0 ? 2 : 0);
+		}
+
+		int rows = bulkExport(table, argv[3], argv+4, argc-4);
+		if(rows < 0){
+			std::cout << " ERROR! Failed to open output file '" << argv[3] << "'!\n";
+			return 1;
+		}
+		std::cout << "  Done! Wrote " << rows << " modules from " << argc-4 << " files to '" << argv[3] << "'.\n";
+		return 0;
+	}
 	else if(argc < 5){
 		std::cout << " Invalid number of arguments to " << argv[0] << ". Expected 4, received " << argc-1 << ".\n";
 		help(argv[0]);
@@ -246,35 +323,46 @@ int main(int argc, char *argv[]){
 #endif
 
 	// Read the .var file.
-	std::vector<parameter> params;
-	if(readVarFile(params, varFilename.c_str())){
-		std::cout << " Successfully read " << params.size() << " entries from .var file.\n";
+	VarTable table;
+	if(table.Read(varFilename.c_str())){
+		std::cout << " Successfully read " << table.Size() << " entries from .var file.\n";
 	}
 	else{
 		std::cout << " ERROR! Failed to read dsp .var file '" << varFilename << "'!\n";
 		closeFile(f);
 		return 1;
 	}
+
+	std::vector<parameter> params;
+	for(size_t i = 0; i < table.Size(); i++){
+		params.push_back(parameter(table.At(i).name, table.At(i).address));
+	}
 	
-	// Read the .set file.
-	int readEntries;
+	// Map the .set file.
+	SetFile setFile;
+	if(!setFile.Open(setFilename.c_str())){
+		std::cout << " ERROR! Failed to read from .set file '" << setFilename << "'!\n";
+		closeFile(f);
+		return 1;
+	}
+
+	size_t readEntries;
 	for(int i = start_mod; i <= stop_mod; i++){
-		for(std::vector<parameter>::iterator iter = params.begin(); iter != params.end(); iter++){
-			iter->values.clear();
-		}
-	
-		readEntries = readSetFile(params, setFilename.c_str(), i*READ_SIZE);
+		readEntries = (i >= 0 ? setFile.GetModuleWords(i) : 0);
 		if(readEntries > 0){
 			std::cout << " Successfully read " << readEntries << " words from .set file for module " << i << ".\n";
 		}
-		else if(readEntries == 0){
+		else{
 			std::cout << " ERROR! Read zero entries from .set file for module " << i << "!\n";
 			continue;
 		}
-		else{
-			std::cout << " ERROR! Failed to read from .set file '" << setFilename << "'!\n";
-			closeFile(f);
-			return 1;
+
+		const uint32_t *module = setFile.GetModule(i);
+		for(size_t j = 0; j < params.size(); j++){
+			const VarEntry &entry = table.At(j);
+			params[j].values.clear();
+			if(entry.offset < readEntries)
+				params[j].values.assign(module + entry.offset, module + std::min<size_t>(entry.offset + entry.length, readEntries));
 		}
 		
 		std::stringstream stream;
@@ -0,0 +1,163 @@
+/** \file HisClient.hpp
+ * \brief Read histogram snapshots served by a running scan.
+ *
+ * A scan may publish consistent snapshots of its histograms on a local unix
+ * domain socket. Every publication increments a sequence number, and each
+ * histogram remembers the sequence at which it last changed. A viewer may
+ * list the histograms, fetch one of them, fetch only what changed since a
+ * sequence it already has, or fetch the projection of a 2d histogram, all
+ * without reading the .his file while the scan is writing it.
+ *
+ * Every request is a single HisRequest. Every reply is a HisReply followed
+ * by HisReply::length bytes of payload:
+ *  LIST    - a HisInfo for every histogram.
+ *  GET     - the HisInfo and xbins*ybins bin values.
+ *  DELTA   - for every histogram changed since the sequence (or only hisID
+ *            when it is not zero), the HisInfo, a HisDelta, and either all
+ *            of the bin values or HisDelta::count (bin, value) pairs.
+ *  PROJECT - the HisInfo and the 64 bit sums along the requested axis.
+ * Values are in host byte order since the socket is local.
+ *
+ * \date Oct. 19th, 2026
+ */
+#ifndef HISCLIENT_HPP
+#define HISCLIENT_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#define HIS_SNAPSHOT_MAGIC 0x50414E53 /// "SNAP"
+
+/// Commands of the histogram snapshot protocol.
+enum HisCommand {HIS_LIST=1, HIS_GET=2, HIS_DELTA=3, HIS_PROJECT=4};
+
+/// Status of a reply.
+enum HisStatus {HIS_OK=0, HIS_BAD_REQUEST=-1, HIS_UNKNOWN_ID=-2, HIS_NOT_2D=-3, HIS_BAD_RANGE=-4};
+
+/// A request sent to the snapshot server.
+struct HisRequest{
+	uint32_t magic; /// Always HIS_SNAPSHOT_MAGIC.
+	uint32_t command; /// One of HisCommand.
+	uint32_t hisID; /// The histogram, zero for all histograms in a DELTA.
+	uint32_t axis; /// The axis to project onto, 0 for x and 1 for y.
+	uint64_t sequence; /// The sequence the viewer already has for a DELTA.
+	uint32_t low; /// The first bin of the other axis summed by a PROJECT.
+	uint32_t high; /// The last bin of the other axis summed by a PROJECT.
+
+	HisRequest() : magic(HIS_SNAPSHOT_MAGIC), command(0), hisID(0), axis(0), sequence(0), low(0), high(0xFFFFFFFF) { }
+};
+
+/// The header of every reply of the snapshot server.
+struct HisReply{
+	uint32_t magic; /// Always HIS_SNAPSHOT_MAGIC.
+	int32_t status; /// One of HisStatus.
+	uint64_t sequence; /// The sequence of the snapshot the reply was taken from.
+	uint64_t length; /// The number of bytes of payload following the header.
+};
+
+/// The description of a single histogram.
+struct HisInfo{
+	uint32_t hisID; /// The damm id of the histogram.
+	uint16_t dim; /// The number of dimensions.
+	uint16_t halfWords; /// 1 for 16 bit bins and 2 for 32 bit bins.
+	uint32_t xbins; /// The number of bins along x.
+	uint32_t ybins; /// The number of bins along y, 1 for a 1d histogram.
+	uint64_t sequence; /// The sequence at which the histogram last changed.
+	char title[48]; /// The title of the histogram.
+
+	/// Return the total number of bins.
+	size_t GetBins() const { return (size_t)xbins * ybins; }
+};
+
+/// The header of a single histogram of a DELTA reply.
+struct HisDelta{
+	uint32_t full; /// 1 if all bin values follow, 0 for (bin, value) pairs.
+	uint32_t count; /// The number of values or pairs which follow.
+};
+
+/// A copy of a single histogram held by the viewer.
+class HisSnapshot{
+  public:
+	HisInfo info; /// The description of the histogram.
+	uint64_t sequence; /// The sequence of the snapshot the copy is up to date with.
+	std::vector<uint32_t> data; /// The bin values, x varies fastest.
+
+	HisSnapshot() : info(), sequence(0), data() { }
+
+	/// Return the value of a bin, or zero outside of the histogram.
+	uint32_t Get(const unsigned int &x_, const unsigned int &y_=0) const {
+		return (x_ < info.xbins && y_ < info.ybins ? data[(size_t)y_ * info.xbins + x_] : 0);
+	}
+};
+
+class HisClient{
+  public:
+	HisClient();
+
+	~HisClient();
+
+	/// Connect to the socket of a scan. Return false on failure.
+	bool Connect(const std::string &path_);
+
+	/// Close the connection.
+	void Close();
+
+	/// Return true if connected to a scan.
+	bool IsConnected() const { return (sock >= 0); }
+
+	/// Return the status of the last reply.
+	int GetStatus() const { return status; }
+
+	/// Return the sequence of the last reply.
+	uint64_t GetSequence() const { return sequence; }
+
+	/// Get the description of every histogram. Return false on failure.
+	bool List(std::vector<HisInfo> &list_);
+
+	/// Get a histogram. Return false on failure.
+	bool Get(const unsigned int &hisID_, HisSnapshot &his_);
+
+	/** Bring a histogram fetched earlier with Get up to date, only the bins which
+	  * changed are sent when the snapshot is recent. Return false on failure.
+	  */
+	bool Update(HisSnapshot &his_);
+
+	/** Bring a set of histograms up to date. Histograms missing from the map are added
+	  * when they are sent whole, so an empty map with sequence_ = 0 fetches everything
+	  * which has been filled.
+	  * \param[in,out] hists_    The histograms, by id.
+	  * \param[in,out] sequence_ The sequence the map is up to date with.
+	  * \return False on failure.
+	  */
+	bool Update(std::map<unsigned int, HisSnapshot> &hists_, uint64_t &sequence_);
+
+	/** Get the projection of a 2d histogram.
+	  * \param[in]  hisID_  The histogram.
+	  * \param[in]  axis_   0 to project onto x, 1 to project onto y.
+	  * \param[in]  low_    The first bin of the other axis to sum.
+	  * \param[in]  high_   The last bin of the other axis to sum, clipped to the histogram.
+	  * \param[out] info_   The description of the histogram.
+	  * \param[out] values_ The sums, one for every bin along the axis.
+	  * \return False on failure.
+	  */
+	bool Project(const unsigned int &hisID_, const unsigned int &axis_, const unsigned int &low_, const unsigned int &high_, HisInfo &info_, std::vector<uint64_t> &values_);
+
+  private:
+	int sock; /// The socket, -1 when not connected.
+	int status; /// The status of the last reply.
+	uint64_t sequence; /// The sequence of the last reply.
+	std::vector<char> payload; /// The payload of the last reply.
+
+	/// Send a request and read the reply into payload. Return false on failure.
+	bool request_(const HisRequest &request_);
+
+	/** Apply the records of a DELTA reply. Histograms missing from hists_ are added if add_
+	  * is set, from a partial record only if fromStart_ is set since they start empty.
+	  */
+	bool applyDelta_(std::map<unsigned int, HisSnapshot> &hists_, const bool &add_, const bool &fromStart_);
+};
+
+#endif
@@ -0,0 +1,212 @@
+/** \file HisClient.cpp
+ * \brief Read histogram snapshots served by a running scan.
+ *
+ * \date Oct. 19th, 2026
+ */
+#include <cstring>
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "HisClient.hpp"
+
+/// Read exactly length_ bytes from a socket. Return false on failure.
+static bool readAll(const int &sock_, char *data_, size_t length_){
+	while(length_ > 0){
+		ssize_t n = recv(sock_, data_, length_, 0);
+		if(n < 0 && errno == EINTR){ continue; }
+		if(n <= 0){ return false; }
+		data_ += n;
+		length_ -= n;
+	}
+	return true;
+}
+
+/// Write exactly length_ bytes to a socket. Return false on failure.
+static bool writeAll(const int &sock_, const char *data_, size_t length_){
+	while(length_ > 0){
+		ssize_t n = send(sock_, data_, length_, MSG_NOSIGNAL);
+		if(n < 0 && errno == EINTR){ continue; }
+		if(n <= 0){ return false; }
+		data_ += n;
+		length_ -= n;
+	}
+	return true;
+}
+
+HisClient::HisClient() : sock(-1), status(HIS_OK), sequence(0), payload() { }
+
+HisClient::~HisClient(){
+	Close();
+}
+
+bool HisClient::Connect(const std::string &path_){
+	Close();
+
+	sockaddr_un addr;
+	if(path_.size() >= sizeof(addr.sun_path)){ return false; }
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path_.c_str());
+
+	sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(sock < 0){ return false; }
+	if(connect(sock, (sockaddr*)&addr, sizeof(addr)) != 0){
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void HisClient::Close(){
+	if(sock >= 0){ close(sock); }
+	sock = -1;
+}
+
+bool HisClient::List(std::vector<HisInfo> &list_){
+	HisRequest request;
+	request.command = HIS_LIST;
+	if(!request_(request)){ return false; }
+
+	size_t count = payload.size() / sizeof(HisInfo);
+	list_.resize(count);
+	if(count > 0){ memcpy(&list_[0], &payload[0], count * sizeof(HisInfo)); }
+
+	return true;
+}
+
+bool HisClient::Get(const unsigned int &hisID_, HisSnapshot &his_){
+	HisRequest request;
+	request.command = HIS_GET;
+	request.hisID = hisID_;
+	if(!request_(request)){ return false; }
+
+	if(payload.size() < sizeof(HisInfo)){ return false; }
+	memcpy(&his_.info, &payload[0], sizeof(HisInfo));
+	size_t bins = his_.info.GetBins();
+	if(payload.size() != sizeof(HisInfo) + bins * sizeof(uint32_t)){ return false; }
+
+	his_.data.resize(bins);
+	if(bins > 0){ memcpy(&his_.data[0], &payload[sizeof(HisInfo)], bins * sizeof(uint32_t)); }
+	his_.sequence = sequence;
+
+	return true;
+}
+
+bool HisClient::Update(HisSnapshot &his_){
+	if(his_.data.empty()){ return Get(his_.info.hisID, his_); }
+
+	HisRequest request;
+	request.command = HIS_DELTA;
+	request.hisID = his_.info.hisID;
+	request.sequence = his_.sequence;
+	if(!request_(request)){ return false; }
+
+	std::map<unsigned int, HisSnapshot> hists;
+	hists[his_.info.hisID].data.swap(his_.data);
+	hists[his_.info.hisID].info = his_.info;
+	bool retval = applyDelta_(hists, false, false);
+	his_.info = hists[his_.info.hisID].info;
+	his_.data.swap(hists[his_.info.hisID].data);
+	if(retval){ his_.sequence = sequence; }
+
+	return retval;
+}
+
+bool HisClient::Update(std::map<unsigned int, HisSnapshot> &hists_, uint64_t &sequence_){
+	HisRequest request;
+	request.command = HIS_DELTA;
+	request.sequence = sequence_;
+	if(!request_(request)){ return false; }
+
+	if(!applyDelta_(hists_, true, sequence_ == 0)){ return false; }
+	for(std::map<unsigned int, HisSnapshot>::iterator iter = hists_.begin(); iter != hists_.end(); iter++){
+		iter->second.sequence = sequence;
+	}
+	sequence_ = sequence;
+
+	return true;
+}
+
+bool HisClient::Project(const unsigned int &hisID_, const unsigned int &axis_, const unsigned int &low_, const unsigned int &high_, HisInfo &info_, std::vector<uint64_t> &values_){
+	HisRequest request;
+	request.command = HIS_PROJECT;
+	request.hisID = hisID_;
+	request.axis = axis_;
+	request.low = low_;
+	request.high = high_;
+	if(!request_(request)){ return false; }
+
+	if(payload.size() < sizeof(HisInfo)){ return false; }
+	memcpy(&info_, &payload[0], sizeof(HisInfo));
+	size_t count = (payload.size() - sizeof(HisInfo)) / sizeof(uint64_t);
+	values_.resize(count);
+	if(count > 0){ memcpy(&values_[0], &payload[sizeof(HisInfo)], count * sizeof(uint64_t)); }
+
+	return true;
+}
+
+bool HisClient::request_(const HisRequest &request_){
+	payload.clear();
+	if(sock < 0){ return false; }
+
+	HisReply reply;
+	if(!writeAll(sock, (const char*)&request_, sizeof(HisRequest)) || !readAll(sock, (char*)&reply, sizeof(HisReply)) || reply.magic != HIS_SNAPSHOT_MAGIC){
+		Close();
+		return false;
+	}
+
+	payload.resize(reply.length);
+	if(reply.length > 0 && !readAll(sock, &payload[0], reply.length)){
+		Close();
+		return false;
+	}
+
+	status = reply.status;
+	sequence = reply.sequence;
+
+	return (status == HIS_OK);
+}
+
+bool HisClient::applyDelta_(std::map<unsigned int, HisSnapshot> &hists_, const bool &add_, const bool &fromStart_){
+	size_t pos = 0;
+	while(pos + sizeof(HisInfo) + sizeof(HisDelta) <= payload.size()){
+		HisInfo info;
+		HisDelta delta;
+		memcpy(&info, &payload[pos], sizeof(HisInfo));
+		memcpy(&delta, &payload[pos+sizeof(HisInfo)], sizeof(HisDelta));
+		pos += sizeof(HisInfo) + sizeof(HisDelta);
+
+		size_t length = delta.count * (delta.full ? 1 : 2) * sizeof(uint32_t);
+		if(pos + length > payload.size()){ return false; }
+
+		std::map<unsigned int, HisSnapshot>::iterator iter = hists_.find(info.hisID);
+		if(iter == hists_.end() && add_ && (delta.full || fromStart_)){
+			iter = hists_.insert(std::make_pair(info.hisID, HisSnapshot())).first;
+		}
+		if(iter != hists_.end()){
+			HisSnapshot &his = iter->second;
+			his.info = info;
+			if(delta.full){
+				his.data.resize(delta.count);
+				if(delta.count > 0){ memcpy(&his.data[0], &payload[pos], length); }
+			}
+			else{
+				// The other bins are those of the sequence the viewer asked from,
+				// which are all zero at the start of the scan.
+				his.data.resize(info.GetBins());
+				const uint32_t *pairs = (const uint32_t*)&payload[pos];
+				for(uint32_t i = 0; i < delta.count; i++){
+					if(pairs[2*i] < his.data.size()){ his.data[pairs[2*i]] = pairs[2*i+1]; }
+				}
+			}
+		}
+
+		pos += length;
+	}
+
+	return (pos == payload.size());
+}
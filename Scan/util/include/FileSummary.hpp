@@ -0,0 +1,146 @@
+/** \file FileSummary.hpp
+  * \brief Summarize the spills of a .ldf or .pld file without a full scan.
+  *
+  * The spills are read sequentially with the ldf and pld buffer classes,
+  * which check the spill chunks, and the module buffers and event headers
+  * of the spills are checked in parallel by a pool of workers. The results
+  * of the workers are merged in file order so that the timestamps of each
+  * channel may be followed across spills.
+  *
+  * \date Oct. 19th, 2026
+  */
+#ifndef FILESUMMARY_HPP
+#define FILESUMMARY_HPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <stdint.h>
+
+/// Totals of a single pixie channel.
+struct ChannelSummary{
+	uint64_t counts; /// The number of events.
+	uint64_t firstTime; /// The first timestamp (in clock ticks).
+	uint64_t lastTime; /// The last timestamp (in clock ticks).
+	uint64_t backwards; /// The number of events earlier than the previous event of the channel.
+	uint64_t maxGap; /// The largest time between two events of the channel (in clock ticks).
+
+	ChannelSummary() : counts(0), firstTime(0), lastTime(0), backwards(0), maxGap(0) { }
+
+	/// Add an event with a given timestamp.
+	void Add(const uint64_t &time_);
+
+	/// Append the events of a later spill.
+	void Merge(const ChannelSummary &other_);
+};
+
+/// The errors found in the data.
+struct SummaryErrors{
+	uint64_t sanity; /// Module buffers with a bad length or module number, the rest of the spill is lost.
+	uint64_t missingModule; /// Module buffers which do not follow the previous module.
+	uint64_t headerLength; /// Events with an unexpected header length, the rest of the module buffer is lost.
+	uint64_t eventLength; /// Events whose length disagrees with the trace or the module buffer.
+	uint64_t backwards; /// Events earlier than the previous event of the same channel.
+
+	SummaryErrors() : sanity(0), missingModule(0), headerLength(0), eventLength(0), backwards(0) { }
+
+	/// Return the total number of errors.
+	uint64_t Total() const { return sanity + missingModule + headerLength + eventLength + backwards; }
+
+	/// Add the errors of a spill.
+	void Merge(const SummaryErrors &other_);
+};
+
+/// The result of a single spill.
+struct SpillSummary{
+	uint64_t index; /// The number of the spill in the file.
+	uint64_t offset; /// Byte offset of the file before the spill was read, ldf files are read one buffer ahead.
+	unsigned int words; /// The number of words in the spill.
+	bool full; /// False if chunks of the spill were missing.
+	bool bad; /// True if the spill was flagged as corrupt, the spill is not decoded.
+	uint64_t events; /// The number of events.
+	uint64_t firstTime; /// The earliest timestamp of the spill (in clock ticks).
+	uint64_t lastTime; /// The latest timestamp of the spill (in clock ticks).
+	SummaryErrors errors; /// The errors found in the spill.
+	std::vector<std::pair<unsigned int, unsigned int> > counts; /// Events of every channel which fired, as (module * 16 + channel, counts).
+
+	std::vector<ChannelSummary> channels; /// Totals of every channel within the spill, cleared after the spill is merged.
+
+	SpillSummary() : index(0), offset(0), words(0), full(true), bad(false), events(0), firstTime(0), lastTime(0), errors(), counts(), channels() { }
+};
+
+class FileSummary{
+  public:
+	static const unsigned int MAX_MODULES = 14; /// No more than 14 pixie modules per crate.
+	static const unsigned int MAX_CHANNELS = 16; /// Channels per module.
+
+	/** Default constructor.
+	  * \param[in] numThreads_ The number of workers checking the spills, 0 checks them while reading.
+	  */
+	FileSummary(const unsigned int &numThreads_=0);
+
+	/** Summarize a file.
+	  * \param[in] filename_ The name of the .ldf or .pld file.
+	  * \param[in] format_   0 for a .ldf file and 1 for a .pld file.
+	  * \return False if the file could not be opened or has no valid header.
+	  */
+	bool Scan(const std::string &filename_, const int &format_);
+
+	/// Set the length of a clock tick of the timestamps (in ns).
+	void SetClockTick(const double &tick_){ clockTick = tick_; }
+
+	/// Print the totals of the file.
+	void Print() const;
+
+	/// Write the totals and every spill to a JSON file. Return false if the file could not be written.
+	bool WriteJson(const std::string &filename_) const;
+
+	/** Check a spill and fill the totals of its channels. Thread safe.
+	  * \param[in]     data_   The spill data.
+	  * \param[in]     nWords_ The number of words in the spill.
+	  * \param[in,out] spill_  The result, index and offset must be set.
+	  */
+	static void CheckSpill(const unsigned int *data_, const unsigned int &nWords_, SpillSummary &spill_);
+
+  private:
+	unsigned int numThreads; /// The number of workers.
+	double clockTick; /// The length of a clock tick of the timestamps (in ns).
+
+	std::string filename; /// The name of the file.
+	int format; /// 0 for a .ldf file and 1 for a .pld file.
+	uint64_t fileLength; /// The size of the file in bytes.
+	uint64_t readBytes; /// Bytes up to the end of the last good spill, or the whole file if its end was found.
+	double scanTime; /// Time taken to summarize the file (in s).
+
+	uint64_t numSpills; /// The number of spills read.
+	uint64_t partialSpills; /// Spills with missing chunks.
+	uint64_t badSpills; /// Spills flagged as corrupt.
+	uint64_t goodChunks; /// Good ldf spill chunks.
+	uint64_t missingChunks; /// Missing or dropped ldf spill chunks.
+	uint64_t readErrors; /// Buffers which could not be read, chunks which were out of place and bad spill footers.
+	uint64_t runEnds; /// End of run buffers.
+	bool foundEnd; /// True if the end of file buffer was found.
+
+	uint64_t numEvents; /// The total number of events.
+	SummaryErrors errors; /// The total errors.
+	std::vector<ChannelSummary> channels; /// Totals of every channel, indexed by module * 16 + channel.
+	std::vector<SpillSummary> spills; /// Every spill, with the channel totals cleared.
+
+	/// Reset the totals.
+	void reset_();
+
+	/// Add a checked spill to the totals, spills must be merged in file order.
+	void merge_(SpillSummary &spill_);
+
+	/// Read the spills of a .ldf file and hand them to submit_.
+	template <typename T>
+	void readLdf_(std::ifstream &file_, T &submit_);
+
+	/// Read the spills of a .pld file and hand them to submit_.
+	template <typename T>
+	void readPld_(std::ifstream &file_, T &submit_);
+};
+
+#endif
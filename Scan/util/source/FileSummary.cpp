@@ -0,0 +1,491 @@
+/** \file FileSummary.cpp
+  * \brief Summarize the spills of a .ldf or .pld file without a full scan.
+  *
+  * \date Oct. 19th, 2026
+  */
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "FileSummary.hpp"
+#include "hribf_buffers.h"
+
+#define MAX_BUFFER_WORDS 131072 // Maximum number of words in a module buffer for revision D.
+#define LDF_SPILL_WORDS 250000 // Size of the spill array for .ldf files.
+#define MAX_SPILL_WORDS 67108864 // Largest .pld spill size accepted from the header.
+#define PLD_SPILL_WORDS 2097152 // Size of the spill array if the .pld header has none.
+#define READ_BUFFER_SIZE 4194304 // Size of the input stream buffer (in bytes).
+
+///////////////////////////////////////////////////////////////////////////////
+// struct ChannelSummary
+///////////////////////////////////////////////////////////////////////////////
+
+void ChannelSummary::Add(const uint64_t &time_){
+	if(counts == 0){
+		firstTime = time_;
+	}
+	else if(time_ < lastTime){
+		backwards++;
+	}
+	else if(time_ - lastTime > maxGap){
+		maxGap = time_ - lastTime;
+	}
+	lastTime = time_;
+	counts++;
+}
+
+void ChannelSummary::Merge(const ChannelSummary &other_){
+	if(other_.counts == 0){ return; }
+	if(counts == 0){
+		*this = other_;
+		return;
+	}
+
+	// Check the boundary between the spills.
+	if(other_.firstTime < lastTime){
+		backwards++;
+	}
+	else if(other_.firstTime - lastTime > maxGap){
+		maxGap = other_.firstTime - lastTime;
+	}
+	if(other_.maxGap > maxGap){
+		maxGap = other_.maxGap;
+	}
+
+	counts += other_.counts;
+	backwards += other_.backwards;
+	lastTime = other_.lastTime;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// struct SummaryErrors
+///////////////////////////////////////////////////////////////////////////////
+
+void SummaryErrors::Merge(const SummaryErrors &other_){
+	sanity += other_.sanity;
+	missingModule += other_.missingModule;
+	headerLength += other_.headerLength;
+	eventLength += other_.eventLength;
+	backwards += other_.backwards;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class FileSummary
+///////////////////////////////////////////////////////////////////////////////
+
+const unsigned int FileSummary::MAX_MODULES;
+const unsigned int FileSummary::MAX_CHANNELS;
+
+FileSummary::FileSummary(const unsigned int &numThreads_/*=0*/) : numThreads(numThreads_), clockTick(8.0) {
+	reset_();
+}
+
+void FileSummary::reset_(){
+	filename = "";
+	format = -1;
+	fileLength = 0;
+	readBytes = 0;
+	scanTime = 0;
+	numSpills = 0;
+	partialSpills = 0;
+	badSpills = 0;
+	goodChunks = 0;
+	missingChunks = 0;
+	readErrors = 0;
+	runEnds = 0;
+	foundEnd = false;
+	numEvents = 0;
+	errors = SummaryErrors();
+	channels.assign(MAX_MODULES * MAX_CHANNELS, ChannelSummary());
+	spills.clear();
+}
+
+/** The spill is a list of module buffers, each of which starts with its length
+  * and module number and is followed by the pixie events of the module. This
+  * follows the checks of Unpacker::ReadSpill and Unpacker::ReadBuffer.
+  */
+void FileSummary::CheckSpill(const unsigned int *data_, const unsigned int &nWords_, SpillSummary &spill_){
+	spill_.words = nWords_;
+	spill_.channels.assign(MAX_MODULES * MAX_CHANNELS, ChannelSummary());
+	spill_.counts.clear();
+	if(spill_.bad){ return; }
+
+	unsigned int pos = 0;
+	unsigned int lastVsn = 0xFFFFFFFF;
+	while(pos + 2 <= nWords_){
+		unsigned int lenRec = data_[pos];
+		unsigned int vsn = data_[pos+1];
+
+		if(vsn == 9999){ break; } // End of spill.
+
+		if(lenRec < 2 || lenRec > MAX_BUFFER_WORDS || pos + lenRec > nWords_ || (vsn >= MAX_MODULES && vsn != 1000)){
+			spill_.errors.sanity++;
+			break;
+		}
+		if(vsn == 1000){ // Wall clock time.
+			pos += lenRec;
+			continue;
+		}
+		if(lastVsn != 0xFFFFFFFF && vsn != lastVsn + 1){
+			spill_.errors.missingModule++;
+		}
+		lastVsn = vsn;
+
+		ChannelSummary *modChannels = &spill_.channels[vsn * MAX_CHANNELS];
+		const unsigned int *buf = data_ + pos + 2;
+		const unsigned int *end = data_ + pos + lenRec;
+		while(buf < end){
+			unsigned int chanNum = (buf[0] & 0x0000000F);
+			unsigned int headerLength = (buf[0] & 0x0001F000) >> 12;
+			unsigned int eventLength = (buf[0] & 0x1FFE0000) >> 17;
+
+			if(headerLength == 1){ // Statistics block inserted by poll.
+				if(eventLength == 0 || buf + eventLength > end){
+					spill_.errors.eventLength++;
+					break;
+				}
+				buf += eventLength;
+				continue;
+			}
+			if(headerLength != 4 && headerLength != 8 && headerLength != 12 && headerLength != 16){
+				spill_.errors.headerLength++;
+				break;
+			}
+			if(eventLength < headerLength || buf + eventLength > end){
+				spill_.errors.eventLength++;
+				break;
+			}
+
+			unsigned int traceLength = (buf[3] & 0xFFFF0000) >> 16;
+			if(traceLength / 2 + headerLength != eventLength){
+				spill_.errors.eventLength++;
+				buf += eventLength;
+				continue;
+			}
+
+			uint64_t time = ((uint64_t)(buf[2] & 0x0000FFFF) << 32) | buf[1];
+			modChannels[chanNum].Add(time);
+			if(spill_.events == 0 || time < spill_.firstTime){ spill_.firstTime = time; }
+			if(spill_.events == 0 || time > spill_.lastTime){ spill_.lastTime = time; }
+			spill_.events++;
+
+			buf += eventLength;
+		}
+
+		pos += lenRec;
+	}
+
+	for(size_t i = 0; i < spill_.channels.size(); i++){
+		if(spill_.channels[i].counts == 0){ continue; }
+		spill_.counts.push_back(std::make_pair((unsigned int)i, (unsigned int)spill_.channels[i].counts));
+		spill_.errors.backwards += spill_.channels[i].backwards;
+	}
+}
+
+void FileSummary::merge_(SpillSummary &spill_){
+	numSpills++;
+	if(!spill_.full){ partialSpills++; }
+	if(spill_.bad){ badSpills++; }
+
+	// The time order is checked across the spill boundary when the channels are merged.
+	uint64_t before = 0, after = 0;
+	for(size_t i = 0; i < channels.size(); i++){
+		before += channels[i].backwards;
+		channels[i].Merge(spill_.channels[i]);
+		after += channels[i].backwards;
+	}
+	spill_.errors.backwards = after - before;
+
+	numEvents += spill_.events;
+	errors.Merge(spill_.errors);
+
+	spill_.channels.clear();
+	spill_.channels.shrink_to_fit();
+	spills.push_back(spill_);
+}
+
+template <typename T>
+void FileSummary::readLdf_(std::ifstream &file_, T &submit_){
+	DIR_buffer dirBuff;
+	HEAD_buffer headBuff;
+	DATA_buffer dataBuff;
+
+	// Every poll2 ldf file starts with a DIR buffer followed by a HEAD buffer.
+	dirBuff.Read(&file_);
+	headBuff.Read(&file_);
+
+	std::vector<unsigned int> data(LDF_SPILL_WORDS);
+	unsigned int nBytes;
+	bool fullSpill;
+	bool badSpill;
+
+	uint64_t lastEnd = file_.tellg();
+	dataBuff.Reset();
+	while(true){
+		uint64_t offset = file_.tellg();
+		if(!dataBuff.Read(&file_, (char*)&data[0], nBytes, 4*LDF_SPILL_WORDS, fullSpill, badSpill)){
+			int retval = dataBuff.GetRetval();
+			if(retval == 1){ runEnds++; }
+			else if(retval == 2){
+				foundEnd = true;
+				break;
+			}
+			else if(retval == 6){ break; }
+			else{ readErrors++; }
+			continue;
+		}
+		lastEnd = file_.tellg();
+
+		SpillSummary spill;
+		spill.offset = offset;
+		spill.full = fullSpill;
+		spill.bad = badSpill;
+		submit_(spill, &data[0], nBytes/4);
+	}
+
+	readBytes = (foundEnd ? fileLength : lastEnd);
+	goodChunks = dataBuff.GetNumChunks();
+	missingChunks = dataBuff.GetNumMissing();
+}
+
+template <typename T>
+void FileSummary::readPld_(std::ifstream &file_, T &submit_){
+	PLD_header pldHead;
+	PLD_data pldData;
+	EOF_buffer eofBuff;
+
+	if(!pldHead.Read(&file_)){
+		readErrors++;
+		return;
+	}
+
+	// The maximum spill size of the header is not always filled.
+	unsigned int maxWords = pldHead.GetMaxSpillSize();
+	if(maxWords == 0 || maxWords > MAX_SPILL_WORDS){ maxWords = PLD_SPILL_WORDS; }
+	std::vector<unsigned int> data(maxWords);
+	unsigned int nBytes;
+
+	// The stream is never moved backwards while reading, which would drop its buffer.
+	uint64_t lastEnd = file_.tellg();
+	pldData.Reset();
+	while(true){
+		uint64_t offset = file_.tellg();
+		if(!pldData.Read(&file_, (char*)&data[0], nBytes, 4*maxWords)){
+			if(!file_.good()){ break; }
+			readErrors++;
+			continue;
+		}
+		lastEnd = file_.tellg();
+
+		SpillSummary spill;
+		spill.offset = offset;
+		submit_(spill, &data[0], nBytes/4);
+	}
+
+	// Every pld file ends with an end of file buffer after the last spill.
+	file_.clear();
+	file_.seekg(lastEnd);
+	foundEnd = eofBuff.ReadHeader(&file_);
+	readBytes = (foundEnd ? fileLength : lastEnd);
+}
+
+/// A spill waiting to be checked by a worker.
+struct SpillJob{
+	SpillSummary spill;
+	std::vector<unsigned int> data;
+};
+
+bool FileSummary::Scan(const std::string &filename_, const int &format_){
+	reset_();
+	filename = filename_;
+	format = format_;
+
+	if(format != 0 && format != 1){ return false; }
+
+	std::vector<char> readBuffer(READ_BUFFER_SIZE);
+	std::ifstream file;
+	file.rdbuf()->pubsetbuf(&readBuffer[0], readBuffer.size());
+	file.open(filename.c_str(), std::ios::binary);
+	if(!file.is_open() || !file.good()){ return false; }
+
+	file.seekg(0, std::ios::end);
+	fileLength = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	std::mutex queueMutex;
+	std::condition_variable jobReady; // Signalled when a job is added or the reader is finished.
+	std::condition_variable jobDone; // Signalled when a spill has been checked.
+	std::deque<SpillJob*> jobs;
+	std::map<uint64_t, SpillSummary> done; // Checked spills waiting to be merged in order.
+	uint64_t nextSubmit = 0;
+	uint64_t nextMerge = 0;
+	bool finished = false;
+	const size_t maxInFlight = 4 * numThreads;
+
+	// Merge the checked spills which are next in order, queueMutex must be held.
+	auto mergeReady = [&](){
+		std::map<uint64_t, SpillSummary>::iterator iter;
+		while((iter = done.find(nextMerge)) != done.end()){
+			merge_(iter->second);
+			done.erase(iter);
+			nextMerge++;
+		}
+	};
+
+	auto worker = [&](){
+		while(true){
+			SpillJob *job;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				jobReady.wait(lock, [&](){ return finished || !jobs.empty(); });
+				if(jobs.empty()){ return; }
+				job = jobs.front();
+				jobs.pop_front();
+			}
+			CheckSpill(job->data.empty() ? NULL : &job->data[0], job->data.size(), job->spill);
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				done.insert(std::make_pair(job->spill.index, job->spill));
+			}
+			delete job;
+			jobDone.notify_one();
+		}
+	};
+
+	auto submit = [&](SpillSummary &spill_, const unsigned int *data_, const unsigned int &nWords_){
+		spill_.index = nextSubmit++;
+		if(numThreads == 0){
+			CheckSpill(data_, nWords_, spill_);
+			merge_(spill_);
+			return;
+		}
+
+		SpillJob *job = new SpillJob();
+		job->spill = spill_;
+		job->data.assign(data_, data_ + nWords_);
+
+		std::unique_lock<std::mutex> lock(queueMutex);
+		mergeReady();
+		while(nextSubmit - nextMerge > maxInFlight){
+			jobDone.wait(lock);
+			mergeReady();
+		}
+		jobs.push_back(job);
+		lock.unlock();
+		jobReady.notify_one();
+	};
+
+	std::vector<std::thread> workers;
+	for(unsigned int i = 0; i < numThreads; i++){
+		workers.push_back(std::thread(worker));
+	}
+
+	if(format == 0){ readLdf_(file, submit); }
+	else{ readPld_(file, submit); }
+
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+		finished = true;
+	}
+	jobReady.notify_all();
+	for(size_t i = 0; i < workers.size(); i++){
+		workers[i].join();
+	}
+	mergeReady();
+
+	file.close();
+
+	scanTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	return true;
+}
+
+void FileSummary::Print() const {
+	std::cout << " Summary-\n";
+	std::cout << "  File: " << filename << " (" << fileLength << " bytes)\n";
+	std::cout << "  Scan time: " << scanTime << " s (" << (scanTime > 0 ? fileLength / scanTime / 1E6 : 0) << " MB/s)\n";
+	std::cout << "  Spills: " << numSpills << " (" << partialSpills << " partial, " << badSpills << " corrupt)\n";
+	if(format == 0){
+		std::cout << "  Chunks: " << goodChunks << " good, " << missingChunks << " missing\n";
+		std::cout << "  End of run buffers: " << runEnds << "\n";
+	}
+	std::cout << "  Read errors: " << readErrors << "\n";
+	std::cout << "  Good data: " << readBytes << " of " << fileLength << " bytes\n";
+	std::cout << "  End of file: " << (foundEnd ? "found" : "MISSING") << "\n";
+	std::cout << "  Events: " << numEvents << "\n";
+	std::cout << "  Errors: " << errors.Total() << " (sanity " << errors.sanity << ", missing module " << errors.missingModule;
+	std::cout << ", header length " << errors.headerLength << ", event length " << errors.eventLength << ", time order " << errors.backwards << ")\n";
+
+	std::cout << "  MOD\tCHAN\tCOUNTS\t\tRATE (Hz)\tBACKWARDS\tMAX GAP (s)\n";
+	for(size_t i = 0; i < channels.size(); i++){
+		const ChannelSummary &chan = channels[i];
+		if(chan.counts == 0){ continue; }
+		double span = (chan.lastTime - chan.firstTime) * clockTick * 1E-9;
+		std::cout << "  " << i / MAX_CHANNELS << "\t" << i % MAX_CHANNELS << "\t" << chan.counts << "\t\t";
+		std::cout << (span > 0 ? chan.counts / span : 0) << "\t\t" << chan.backwards << "\t\t" << chan.maxGap * clockTick * 1E-9 << "\n";
+	}
+}
+
+bool FileSummary::WriteJson(const std::string &filename_) const {
+	std::ofstream output(filename_.c_str());
+	if(!output.good()){ return false; }
+
+	output << "{\n";
+	output << " \"file\": \"" << filename << "\",\n";
+	output << " \"format\": \"" << (format == 0 ? "ldf" : "pld") << "\",\n";
+	output << " \"bytes\": " << fileLength << ",\n";
+	output << " \"readBytes\": " << readBytes << ",\n";
+	output << " \"clockTickNs\": " << clockTick << ",\n";
+	output << " \"spills\": " << numSpills << ",\n";
+	output << " \"partialSpills\": " << partialSpills << ",\n";
+	output << " \"badSpills\": " << badSpills << ",\n";
+	output << " \"goodChunks\": " << goodChunks << ",\n";
+	output << " \"missingChunks\": " << missingChunks << ",\n";
+	output << " \"readErrors\": " << readErrors << ",\n";
+	output << " \"runEnds\": " << runEnds << ",\n";
+	output << " \"foundEnd\": " << (foundEnd ? "true" : "false") << ",\n";
+	output << " \"events\": " << numEvents << ",\n";
+	output << " \"errors\": {\"sanity\": " << errors.sanity << ", \"missingModule\": " << errors.missingModule;
+	output << ", \"headerLength\": " << errors.headerLength << ", \"eventLength\": " << errors.eventLength;
+	output << ", \"backwards\": " << errors.backwards << "},\n";
+
+	output << " \"channels\": [";
+	bool first = true;
+	for(size_t i = 0; i < channels.size(); i++){
+		const ChannelSummary &chan = channels[i];
+		if(chan.counts == 0){ continue; }
+		output << (first ? "\n" : ",\n");
+		output << "  {\"mod\": " << i / MAX_CHANNELS << ", \"chan\": " << i % MAX_CHANNELS << ", \"counts\": " << chan.counts;
+		output << ", \"firstTime\": " << chan.firstTime << ", \"lastTime\": " << chan.lastTime;
+		output << ", \"backwards\": " << chan.backwards << ", \"maxGap\": " << chan.maxGap << "}";
+		first = false;
+	}
+	output << "\n ],\n";
+
+	// One row per spill, the counts are [module * 16 + channel, counts] pairs.
+	output << " \"spillColumns\": [\"offset\", \"words\", \"full\", \"bad\", \"events\", \"firstTime\", \"lastTime\", \"errors\", \"counts\"],\n";
+	output << " \"spillData\": [";
+	for(size_t i = 0; i < spills.size(); i++){
+		const SpillSummary &spill = spills[i];
+		output << (i == 0 ? "\n" : ",\n");
+		output << "  [" << spill.offset << "," << spill.words << "," << spill.full << "," << spill.bad << "," << spill.events << ",";
+		output << spill.firstTime << "," << spill.lastTime << "," << spill.errors.Total() << ",[";
+		for(size_t j = 0; j < spill.counts.size(); j++){
+			output << (j == 0 ? "" : ",") << "[" << spill.counts[j].first << "," << spill.counts[j].second << "]";
+		}
+		output << "]]";
+	}
+	output << "\n ]\n";
+	output << "}\n";
+
+	output.close();
+
+	return !output.fail();
+}
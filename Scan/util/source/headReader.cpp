@@ -1,10 +1,13 @@
 #include <iostream>
 #include <fstream>
+#include <thread>
 #include <string.h>
+#include <stdlib.h>
 
 #include "Unpacker.hpp"
 #include "ScanInterface.hpp"
 #include "hribf_buffers.h"
+#include "FileSummary.hpp"
 
 DIR_buffer ldfDir;
 HEAD_buffer ldfHead;
@@ -13,7 +16,11 @@ PLD_header pldHead;
 void help(char *name_){
 	std::cout << "  SYNTAX: " << name_ << " [options] <files ...>\n";
 	std::cout << "   Available options:\n";
-	std::cout << "    --columns | Output file information in tab-delimited columns.\n";
+	std::cout << "    --columns       | Output file information in tab-delimited columns.\n";
+	std::cout << "    --summary       | Check every spill and print the totals of each file.\n";
+	std::cout << "    --json          | Also write the totals and every spill to <file>.json (implies --summary).\n";
+	std::cout << "    --threads <num> | Number of threads checking the spills (default is the number of cores).\n";
+	std::cout << "    --tick <ns>     | Length of a timestamp clock tick in ns (default is 8).\n";
 }
 
 int main(int argc, char *argv[]){
@@ -24,6 +31,10 @@ int main(int argc, char *argv[]){
 	}
 
 	bool col_output = false;
+	bool summary = false;
+	bool json_output = false;
+	unsigned int num_threads = std::thread::hardware_concurrency();
+	double clock_tick = 8.0;
 	int file_format = -1;
 	int file_count = 1;
 	std::string dummy, extension;
@@ -33,6 +44,27 @@ int main(int argc, char *argv[]){
 			col_output = true;
 			continue;
 		}
+		else if(strcmp(argv[i], "--summary") == 0){
+			summary = true;
+			continue;
+		}
+		else if(strcmp(argv[i], "--json") == 0){
+			summary = true;
+			json_output = true;
+			continue;
+		}
+		else if(strcmp(argv[i], "--threads") == 0 || strcmp(argv[i], "--tick") == 0){
+			if(i + 1 >= argc){
+				std::cout << " Error: Missing argument to " << argv[i] << ".\n";
+				help(argv[0]);
+				return 1;
+			}
+			if(strcmp(argv[i], "--threads") == 0)
+				num_threads = atoi(argv[++i]);
+			else
+				clock_tick = atof(argv[++i]);
+			continue;
+		}
 
 		if(!col_output)
 			std::cout << "File no. " << file_count++ << ": " << argv[i] << std::endl;
@@ -87,6 +119,24 @@ int main(int argc, char *argv[]){
 		}
 		
 		file.close();
+
+		if(summary){
+			FileSummary fileSummary(num_threads);
+			fileSummary.SetClockTick(clock_tick);
+			if(!fileSummary.Scan(argv[i], file_format)){
+				std::cout << " ERROR! Failed to summarize input file!\n\n";
+				continue;
+			}
+			fileSummary.Print();
+			if(json_output){
+				std::string json_filename = std::string(argv[i]) + ".json";
+				if(fileSummary.WriteJson(json_filename))
+					std::cout << "  Wrote summary to '" << json_filename << "'.\n";
+				else
+					std::cout << " ERROR! Failed to write summary to '" << json_filename << "'!\n";
+			}
+			std::cout << std::endl;
+		}
 	}
 	
 	return 0;
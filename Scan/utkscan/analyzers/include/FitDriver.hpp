@@ -68,7 +68,7 @@ public:
     };
 
     /// An enum listing the known Fitter types for use with the FittingAnalyzer
-    enum FITTER_TYPE{GSL, UNKNOWN};
+    enum FITTER_TYPE{GSL, ANALYTIC, UNKNOWN};
 protected:
     std::vector<double> data_;//!< Vector of data to fit
     std::pair<double,double> pars_;//!< parameters for the fit function
@@ -2,7 +2,7 @@
  * \brief Class to fit functions to waveforms
  *
  * Obtains the phase of a waveform using a Chi^2 fitting algorithm
- * implemented through the GSL libraries.
+ * implemented through the GSL libraries, or with the fast AnalyticFitter.
  *
  * \author S. V. Paulauskas
  * \date 22 July 2011
@@ -10,32 +10,105 @@
 #ifndef __FITTINGANALYZER_HPP_
 #define __FITTINGANALYZER_HPP_
 
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "AnalyticFitter.hpp"
 #include "FitDriver.hpp"
+#include "ThreadPool.hpp"
 #include "Trace.hpp"
 #include "TraceAnalyzer.hpp"
 
 //! Analyzer that handles the fitting of traces for High Resolution Timing
 class FittingAnalyzer : public TraceAnalyzer {
 public:
-    ///Default Constructor
-    FittingAnalyzer(const std::string &s);
+    /** Default Constructor
+     * \param [in] s : the type of fitter to use (gsl or analytic) for the
+     * detector types that do not request one in the Fitting parameters
+     * \param [in] isBatch : true if the fits should be queued and performed
+     * in parallel when the event is flushed
+     * \param [in] numThreads : the number of threads used for the batch
+     * fits, 0 uses all of the hardware threads */
+    FittingAnalyzer(const std::string &s, const bool &isBatch = false,
+                    const unsigned int &numThreads = 0);
 
     /** Default Destructor */
-    ~FittingAnalyzer() {};
+    ~FittingAnalyzer();
+    /** Resolves the fitting parameters for all the channels in the map
+     * \return True if the init was successful */
+    virtual bool Init(void);
     /** Declare plots for the analyzer */
     virtual void DeclarePlots(void);
     /** Analyzes the traces
      * \param [in] trace : the trace to analyze
      * \param [in] detType : the detector type we have
-     * \param [in] detSubtype : the subtype of the detector 
+     * \param [in] detSubtype : the subtype of the detector
      * \param [in] tagMap : the map of tags for the channel */
     virtual void Analyze(Trace &trace, const std::string &detType,
                          const std::string &detSubtype,
                          const std::map<std::string, int> & tagMap);
+    /** Performs the fits that were queued during the event when running in
+     * batch mode. The results are written into the traces in the same order
+     * that they were queued. */
+    virtual void Flush(void);
 private:
-    FitDriver::FITTER_TYPE fitterType_;
+    /** The fitting information for a given type:subtype */
+    struct FitConfiguration {
+        std::pair<double, double> pars; //!< the standard fit parameters
+        std::pair<double, double> timingPars; //!< pars for the SiPM timing
+        FitDriver::FITTER_TYPE fitter; //!< the fitter for the standard fit
+        FitDriver::FITTER_TYPE timingFitter; //!< the fitter for SiPM timing
+        const PulseShapeTable *table; //!< tabulated standard pulse shape
+        const PulseShapeTable *timingTable; //!< tabulated SiPM pulse shape
+        bool isDoubleBeta; //!< true if this is a beta:double detector
+    };
+
+    /** All of the information needed to perform one fit and to record it */
+    struct FitJob {
+        Trace *trace; //!< the trace that we are fitting
+        const std::pair<double, double> *pars; //!< the fitting parameters
+        FitDriver::FITTER_TYPE fitter; //!< the fitter to use
+        const PulseShapeTable *table; //!< the pulse table for the analytic fit
+        bool isFastSipm; //!< true if we fit with the SiPM function
+        double sigmaBaseline; //!< std. deviation of the baseline
+        double qdc; //!< the qdc of the waveform
+        double maxPos; //!< position of the maximum in the trace
+        double maxVal; //!< the maximum value of the trace
+        double phase; //!< the phase found by the fit
+        double amplitude; //!< the amplitude found by the fit
+        double chiSqPerDof; //!< the chi^2/dof of the fit
+    };
+
+    /** \return the fitting information for the requested type and subtype
+     * \param [in] type : the detector type
+     * \param [in] subtype : the detector subtype */
+    const FitConfiguration &GetConfiguration(const std::string &type,
+                                             const std::string &subtype);
+
+    /** \return the fitter requested for the type:subtype in the
+     * configuration, or the default fitter if none was requested
+     * \param [in] key : the type:subtype to look for */
+    FitDriver::FITTER_TYPE GetFitterType(const std::string &key) const;
+
+    /** Performs the fit. This only touches the job so it can be called
+     * concurrently for different jobs.
+     * \param [in,out] job : the fit to perform */
+    void Fit(FitJob &job) const;
+
+    /** Writes the results of the fit into the trace and plots them
+     * \param [in] job : the fit that was performed */
+    void Record(const FitJob &job);
+
+    FitDriver::FITTER_TYPE fitterType_; //!< the fitter that we are using
+    bool isBatch_; //!< true if we are queueing fits for the flush
+    ThreadPool *pool_; //!< the thread pool for the batch fits
+    StageTimer flushTimer_; //!< the time spent in the batch fits
+
+    std::vector<FitJob> jobs_; //!< the fits queued for this event
+    std::vector<PulseShapeTable *> tables_; //!< the tables that we own
+    std::map<std::pair<std::string, std::string>, FitConfiguration>
+            configs_; //!< the resolved fitting information per type:subtype
 };
 #endif // __FITTINGANALYZER_HPP_
-// David is awesome.
@@ -8,6 +8,9 @@
 
 #include "FitDriver.hpp"
 
+/// Fits the waveforms using the GSL Levenberg-Marquardt solver. The solver and
+/// matrices are kept in a per-thread cache bucketed by the size of the fit,
+/// so they are only allocated the first time a given size is seen on a thread.
 class GslFitter : public FitDriver{
 public:
     ///Default Constructor
@@ -0,0 +1,48 @@
+/// \file GslWorkspaceCache.hpp
+/// \brief Keeps the GSL workspaces of the fits of a thread for reuse
+/// \date October 19, 2026
+#ifndef PIXIESUITE_GSLWORKSPACECACHE_HPP
+#define PIXIESUITE_GSLWORKSPACECACHE_HPP
+
+#include <map>
+#include <utility>
+
+/// The workspaces owned by a single thread, bucketed by the size of the
+/// fit. Traces of a given detector type always have the same waveform
+/// length so in practice there are only a handful of buckets. The workspace
+/// differs between the GSL versions, it only needs a constructor taking the
+/// number of points and the number of parameters of the fit.
+template<class Workspace>
+class GslWorkspaceCache {
+public:
+    /// Default constructor
+    GslWorkspaceCache() {}
+
+    /// Destructor freeing all of the workspaces
+    ~GslWorkspaceCache() {
+        for (typename std::map<std::pair<size_t, size_t>, Workspace *>::iterator
+                     it = workspaces_.begin(); it != workspaces_.end(); it++)
+            delete it->second;
+    }
+
+    /// \return the workspace for a fit of size n with p parameters
+    /// \param[in] n The number of points in the fit
+    /// \param[in] p The number of parameters in the fit
+    Workspace *Get(const size_t &n, const size_t &p) {
+        std::pair<size_t, size_t> key = std::make_pair(n, p);
+        typename std::map<std::pair<size_t, size_t>, Workspace *>::iterator it =
+                workspaces_.find(key);
+        if (it != workspaces_.end())
+            return it->second;
+        Workspace *ws = new Workspace(n, p);
+        workspaces_.insert(std::make_pair(key, ws));
+        return ws;
+    }
+private:
+    GslWorkspaceCache(const GslWorkspaceCache &); //!< Not copyable
+    GslWorkspaceCache &operator=(const GslWorkspaceCache &); //!< Not copyable
+
+    std::map<std::pair<size_t, size_t>, Workspace *> workspaces_;//!< the buckets
+};
+
+#endif //PIXIESUITE_GSLWORKSPACECACHE_HPP
@@ -7,9 +7,9 @@
 #define __TRACEANALYZER_HPP_
 
 #include <string>
-#include <sys/times.h>
 
 #include "Plots.hpp"
+#include "StageProfiler.hpp"
 #include "Trace.hpp"
 
 ///Abstract class that all trace analyzers are derived from
@@ -40,6 +40,10 @@ public:
     virtual void Analyze(Trace &trace, const std::string &type,
                          const std::string &subtype,
                          const std::map<std::string, int> & tagMap);
+    /** Complete any analysis that was deferred until the end of the event.
+     * Called by the DetectorDriver once all of the traces in an event have
+     * been analyzed. Does nothing by default. */
+    virtual void Flush(void) {};
     /** End the analysis and record the analyzer level in the trace
      * \param [in] trace : the trace */
     void EndAnalyze(Trace &trace);
@@ -55,9 +59,6 @@ protected:
     static int numTracesAnalyzed;    ///< rownumber for DAMM spectrum 850
     std::string name;         ///< name of the analyzer
 private:
-    tms tmsBegin;             ///< time at which the analyzer began
-    double userTime;          ///< user time used by this class
-    double systemTime;        ///< system time used by this class
-    double clocksPerSecond;   ///< frequency of system clock
+    StageTimer timer_;        ///< time spent in the analyzer
 };
 #endif // __TRACEANALYZER_HPP_
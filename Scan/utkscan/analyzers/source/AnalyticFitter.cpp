@@ -0,0 +1,216 @@
+/// \file AnalyticFitter.cpp
+/// \brief A fast timing fit using a tabulated pulse shape
+/// \date October 19, 2026
+#include <algorithm>
+#include <iostream>
+
+#include <cmath>
+
+#include "AnalyticFitter.hpp"
+
+using namespace std;
+
+PulseShapeTable::PulseShapeTable(const std::pair<double, double> &pars,
+                                 const bool &isFastSipm,
+                                 const double &length,
+                                 const unsigned int &nodesPerSample) {
+    pars_ = pars;
+    isFastSipm_ = isFastSipm;
+    step_ = 1. / nodesPerSample;
+    invStep_ = nodesPerSample;
+
+    //The Gaussian is centered on the phase, the PMT pulse starts at it.
+    if (isFastSipm_)
+        start_ = -0.5 * length;
+    else
+        start_ = 0.;
+
+    unsigned int numNodes = (unsigned int) (length * nodesPerSample) + 1;
+    values_.resize(numNodes);
+    derivs_.resize(numNodes);
+
+    norm_ = 0.;
+    peak_ = 0.;
+    for (unsigned int i = 0; i < numNodes; i++) {
+        double t = start_ + i * step_;
+        Evaluate(t, values_[i], derivs_[i]);
+        if (values_[i] > norm_) {
+            norm_ = values_[i];
+            peak_ = t;
+        }
+    }
+
+    if (norm_ <= 0.)
+        norm_ = 1.;
+
+    for (unsigned int i = 0; i < numNodes; i++) {
+        values_[i] /= norm_;
+        derivs_[i] /= norm_;
+    }
+}
+
+void PulseShapeTable::Evaluate(const double &t, double &val,
+                               double &deriv) const {
+    const double beta = pars_.first;
+    const double gamma = pars_.second;
+
+    if (isFastSipm_) {
+        val = exp(-t * t / (2 * gamma * gamma)) / (gamma * sqrt(2 * M_PI));
+        deriv = -t / (gamma * gamma) * val;
+        return;
+    }
+
+    if (t <= 0.) {
+        val = deriv = 0.;
+        return;
+    }
+
+    double decay = exp(-beta * t);
+    double gaussSq = exp(-pow(gamma * t, 4.));
+    val = decay * (1 - gaussSq);
+    deriv = -beta * val + 4 * pow(gamma, 4.) * pow(t, 3.) * decay * gaussSq;
+}
+
+void PulseShapeTable::Get(const double &t, double &val, double &deriv) const {
+    double x = (t - start_) * invStep_;
+    unsigned int i = (unsigned int) x;
+
+    //Outside of the table we evaluate the function directly. For the PMT
+    // shape everything before the start of the table is simply zero.
+    if (x < 0. || i + 1 >= values_.size()) {
+        if (!isFastSipm_ && x < 0.) {
+            val = deriv = 0.;
+            return;
+        }
+        Evaluate(t, val, deriv);
+        val /= norm_;
+        deriv /= norm_;
+        return;
+    }
+
+    //Cubic Hermite interpolation between the two nodes
+    double u = x - i;
+    double u2 = u * u;
+    double u3 = u2 * u;
+    double v0 = values_[i], v1 = values_[i + 1];
+    double d0 = derivs_[i] * step_, d1 = derivs_[i + 1] * step_;
+
+    val = (2 * u3 - 3 * u2 + 1) * v0 + (u3 - 2 * u2 + u) * d0 +
+          (-2 * u3 + 3 * u2) * v1 + (u3 - u2) * d1;
+    deriv = ((6 * u2 - 6 * u) * v0 + (3 * u2 - 4 * u + 1) * d0 +
+             (-6 * u2 + 6 * u) * v1 + (3 * u2 - 2 * u) * d1) * invStep_;
+}
+
+AnalyticFitter::AnalyticFitter(const bool &isFastSipm) : FitDriver() {
+    isFastSipm_ = isFastSipm;
+    ownsTable_ = true;
+    table_ = NULL;
+    maxIterations_ = 8;
+    iterations_ = 0;
+    amp_ = chi_ = dof_ = phase_ = 0.;
+}
+
+AnalyticFitter::AnalyticFitter(const PulseShapeTable *table) : FitDriver() {
+    isFastSipm_ = table->IsFastSipm();
+    ownsTable_ = false;
+    table_ = table;
+    maxIterations_ = 8;
+    iterations_ = 0;
+    amp_ = chi_ = dof_ = phase_ = 0.;
+}
+
+AnalyticFitter::~AnalyticFitter() {
+    if (ownsTable_)
+        delete table_;
+}
+
+void AnalyticFitter::PerformFit(const std::vector<double> &data,
+                                const std::pair<double, double> &pars,
+                                const double &weight/* = 1.*/,
+                                const double &area/* = 1.*/) {
+    if (ownsTable_ && (table_ == NULL || table_->GetParameters() != pars)) {
+        delete table_;
+        table_ = new PulseShapeTable(pars, isFastSipm_);
+    }
+
+    const size_t n = data.size();
+    const size_t p = isFastSipm_ ? 1 : 2;
+    dof_ = n - p;
+    iterations_ = 0;
+
+    //The initial guess puts the peak of the template on the largest sample
+    size_t maxPos = max_element(data.begin(), data.end()) - data.begin();
+    double phi = maxPos - table_->GetPeakPosition();
+
+    //For the SiPM the amplitude is fixed by the qdc, the PMT amplitude is
+    // found together with the phase.
+    double amp = area * table_->GetNormalization();
+
+    double val, deriv;
+    if (!isFastSipm_) {
+        double sumYS = 0., sumSS = 0.;
+        for (size_t i = 0; i < n; i++) {
+            table_->Get(i - phi, val, deriv);
+            sumYS += data[i] * val;
+            sumSS += val * val;
+        }
+        if (sumSS > 0.)
+            amp = sumYS / sumSS;
+    }
+
+    for (; iterations_ < maxIterations_; iterations_++) {
+        //Gauss-Newton step for the model amp*S(i - phi)
+        double sumSS = 0., sumDD = 0., sumDS = 0., sumDR = 0., sumSR = 0.;
+        for (size_t i = 0; i < n; i++) {
+            table_->Get(i - phi, val, deriv);
+            double res = data[i] - amp * val;
+            sumSS += val * val;
+            sumDD += deriv * deriv;
+            sumDS += deriv * val;
+            sumDR += deriv * res;
+            sumSR += val * res;
+        }
+
+        double dPhi, dAmp = 0.;
+        if (isFastSipm_) {
+            if (sumDD <= 0. || amp == 0.)
+                break;
+            dPhi = -sumDR / (amp * sumDD);
+        } else {
+            //The 2x2 normal equations for (phi, amp)
+            double a11 = amp * amp * sumDD, a12 = -amp * sumDS, a22 = sumSS;
+            double b1 = -amp * sumDR, b2 = sumSR;
+            double det = a11 * a22 - a12 * a12;
+            if (det == 0.)
+                break;
+            dPhi = (b1 * a22 - a12 * b2) / det;
+            dAmp = (a11 * b2 - a12 * b1) / det;
+        }
+
+        //Keep a bad starting point from throwing us off of the pulse.
+        if (dPhi > 1.)
+            dPhi = 1.;
+        else if (dPhi < -1.)
+            dPhi = -1.;
+
+        phi += dPhi;
+        amp += dAmp;
+
+        if (fabs(dPhi) < 1e-6)
+            break;
+    }
+
+    double chiSq = 0.;
+    for (size_t i = 0; i < n; i++) {
+        table_->Get(i - phi, val, deriv);
+        double res = (data[i] - amp * val) / weight;
+        chiSq += res * res;
+    }
+    chi_ = sqrt(chiSq);
+    phase_ = phi;
+
+    if (!isFastSipm_)
+        amp_ = amp / (area * table_->GetNormalization());
+    else
+        amp_ = 0.0;
+}
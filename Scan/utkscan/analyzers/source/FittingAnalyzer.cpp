@@ -5,6 +5,8 @@
  * implemented through the GSL libraries. We have now set up two different
  * functions for this processor. One of them handles the fast SiPMT signals,
  * which tend to be more Gaussian in shape than the standard PMT signals.
+ * Each detector type may choose between the GSL fitter and the fast
+ * AnalyticFitter using the Fitter node of its fitting parameters.
  *
  * \author S. V. Paulauskas
  * \date 22 July 2011
@@ -16,14 +18,33 @@
 #include <ctime>
 
 #include "Globals.hpp"
+#include "AnalyticFitter.hpp"
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
+#include "Exceptions.hpp"
 #include "FitDriver.hpp"
 #include "FittingAnalyzer.hpp"
+#include "Messenger.hpp"
+
+#ifdef usegsl
 #include "GslFitter.hpp"
+#endif
 
 using namespace std;
 using namespace dammIds::trace::waveformanalyzer;
 
+namespace {
+    /** \return the fitter type for the given name
+     * \param [in] s : the name of the fitter */
+    FitDriver::FITTER_TYPE ToFitterType(const std::string &s) {
+        if(s == "GSL" || s == "gsl")
+            return(FitDriver::GSL);
+        if(s == "analytic" || s == "Analytic")
+            return(FitDriver::ANALYTIC);
+        return(FitDriver::UNKNOWN);
+    }
+}
+
 void FittingAnalyzer::DeclarePlots(void) {
     Trace sample_trace = Trace();
     sample_trace.DeclareHistogram2D(DD_TRACES, S7, S5, "traces data FitAnalyzer");
@@ -33,13 +54,89 @@ void FittingAnalyzer::DeclarePlots(void) {
     sample_trace.DeclareHistogram1D(D_SIGMA, SE, "Std Dev Baseline");
 }
 
-FittingAnalyzer::FittingAnalyzer(const std::string &s) {
+FittingAnalyzer::FittingAnalyzer(const std::string &s, const bool &isBatch,
+                                 const unsigned int &numThreads) :
+    flushTimer_(name, "Flush") {
     name = "FittingAnalyzer";
-    if(s == "GSL" || s == "gsl") {
-        fitterType_ = FitDriver::GSL;
-    } else {
-        fitterType_ = FitDriver::UNKNOWN;
+    fitterType_ = ToFitterType(s);
+#ifndef usegsl
+    if(fitterType_ == FitDriver::GSL)
+        throw GeneralException("FittingAnalyzer: the GSL fitter was "
+                                   "requested but the scan was compiled "
+                                   "without GSL. Use type=\"analytic\".");
+#endif
+
+    isBatch_ = isBatch;
+    pool_ = NULL;
+    if(isBatch_)
+        pool_ = new ThreadPool(numThreads);
+}
+
+FittingAnalyzer::~FittingAnalyzer() {
+    delete(pool_);
+    for(vector<PulseShapeTable *>::iterator it = tables_.begin();
+        it != tables_.end(); it++)
+        delete(*it);
+}
+
+bool FittingAnalyzer::Init(void) {
+    DetectorLibrary *lib = DetectorLibrary::get();
+    for(DetectorLibrary::size_type i = 0; i < lib->size(); i++) {
+        if(!lib->HasValue(i))
+            continue;
+        GetConfiguration(lib->at(i).GetType(), lib->at(i).GetSubtype());
     }
+    return(true);
+}
+
+const FittingAnalyzer::FitConfiguration &FittingAnalyzer::GetConfiguration(
+        const std::string &type, const std::string &subtype) {
+    pair<string, string> key = make_pair(type, subtype);
+    map<pair<string, string>, FitConfiguration>::iterator it =
+            configs_.find(key);
+    if(it != configs_.end())
+        return(it->second);
+
+    Globals *globals = Globals::get();
+    FitConfiguration config;
+    config.pars = globals->fitPars(type+":"+subtype);
+    config.timingPars = globals->fitPars(type+":"+subtype+":timing");
+    config.fitter = GetFitterType(type+":"+subtype);
+    config.timingFitter = GetFitterType(type+":"+subtype+":timing");
+    config.isDoubleBeta = type == "beta" && subtype == "double";
+
+    //The pulse shapes are tabulated once per detector type.
+    config.table = config.timingTable = NULL;
+    if(config.fitter == FitDriver::ANALYTIC) {
+        tables_.push_back(new PulseShapeTable(config.pars, false));
+        config.table = tables_.back();
+    }
+    if(config.isDoubleBeta && config.timingFitter == FitDriver::ANALYTIC) {
+        tables_.push_back(new PulseShapeTable(config.timingPars, true));
+        config.timingTable = tables_.back();
+    }
+
+    return(configs_.insert(make_pair(key, config)).first->second);
+}
+
+FitDriver::FITTER_TYPE FittingAnalyzer::GetFitterType(
+        const std::string &key) const {
+    string requested = Globals::get()->fitter(key);
+    if(requested == "")
+        return(fitterType_);
+
+    FitDriver::FITTER_TYPE type = ToFitterType(requested);
+#ifndef usegsl
+    if(type == FitDriver::GSL)
+        type = FitDriver::UNKNOWN;
+#endif
+    if(type == FitDriver::UNKNOWN) {
+        Messenger m;
+        m.warning("FittingAnalyzer: unusable fitter \"" + requested +
+                  "\" requested for " + key + ", using the default.", 1);
+        return(fitterType_);
+    }
+    return(type);
 }
 
 void FittingAnalyzer::Analyze(Trace &trace, const std::string &detType,
@@ -54,51 +151,106 @@ void FittingAnalyzer::Analyze(Trace &trace, const std::string &detType,
     }
 
     Globals *globals = Globals::get();
+    const FitConfiguration &config = GetConfiguration(detType, detSubtype);
 
-    const double sigmaBaseline = trace.GetValue("sigmaBaseline");
-    const double maxVal = trace.GetValue("maxval");
-    const double qdc = trace.GetValue("qdc");
-    const double maxPos = trace.GetValue("maxpos");
-    const vector<double> waveform = trace.GetWaveform();
-    bool isDblBeta = detType == "beta" && detSubtype == "double";
-    bool isDblBetaT = isDblBeta && tagMap.find("timing") != tagMap.end();
+    FitJob job;
+    job.trace = &trace;
+    job.sigmaBaseline = trace.GetValue("sigmaBaseline");
+    job.maxVal = trace.GetValue("maxval");
+    job.qdc = trace.GetValue("qdc");
+    job.maxPos = trace.GetValue("maxpos");
+    job.isFastSipm = config.isDoubleBeta &&
+        tagMap.find("timing") != tagMap.end();
 
-    trace.plot(D_SIGMA, sigmaBaseline*100);
+    trace.plot(D_SIGMA, job.sigmaBaseline*100);
 
-    if(!isDblBetaT) {
-        if(sigmaBaseline > globals->sigmaBaselineThresh()) {
+    if(!job.isFastSipm) {
+        if(job.sigmaBaseline > globals->sigmaBaselineThresh()) {
             EndAnalyze();
             return;
         }
     } else {
-        if(sigmaBaseline > globals->siPmtSigmaBaselineThresh()) {
+        if(job.sigmaBaseline > globals->siPmtSigmaBaselineThresh()) {
             EndAnalyze();
             return;
         }
     }
 
-    pair<double,double> pars =  globals->fitPars(detType+":"+detSubtype);
-    if(isDblBetaT)
-	    pars = globals->fitPars(detType+":"+detSubtype+":timing");
+    if(job.isFastSipm) {
+        job.pars = &config.timingPars;
+        job.fitter = config.timingFitter;
+        job.table = config.timingTable;
+    } else {
+        job.pars = &config.pars;
+        job.fitter = config.fitter;
+        job.table = config.table;
+    }
+
+    if(job.fitter == FitDriver::UNKNOWN) {
+        EndAnalyze();
+        return;
+    }
+
+    if(isBatch_) {
+        jobs_.push_back(job);
+    } else {
+        Fit(job);
+        Record(job);
+    }
+
+    EndAnalyze();
+}
+
+void FittingAnalyzer::Flush(void) {
+    if(jobs_.empty())
+        return;
+
+    //The fits were only queued by Analyze, so their time is counted here
+    flushTimer_.Start();
+    pool_->ParallelFor(jobs_.size(), [this](const size_t &i) {
+        Fit(jobs_[i]);
+    });
 
-    FitDriver *driver;
-    switch(fitterType_) {
-        case FitDriver::GSL:
-            driver = new GslFitter(isDblBetaT);
+    for(vector<FitJob>::const_iterator it = jobs_.begin();
+        it != jobs_.end(); it++)
+        Record(*it);
+    jobs_.clear();
+    flushTimer_.Stop();
+}
+
+void FittingAnalyzer::Fit(FitJob &job) const {
+    switch(job.fitter) {
+#ifdef usegsl
+        case FitDriver::GSL: {
+            GslFitter fitter(job.isFastSipm);
+            fitter.PerformFit(job.trace->GetWaveform(), *job.pars,
+                              job.sigmaBaseline, job.qdc);
+            job.phase = fitter.GetPhase();
+            job.amplitude = fitter.GetAmplitude();
+            job.chiSqPerDof = fitter.GetChiSqPerDof();
+            break;
+        }
+#endif
+        case FitDriver::ANALYTIC: {
+            AnalyticFitter fitter(job.table);
+            fitter.PerformFit(job.trace->GetWaveform(), *job.pars,
+                              job.sigmaBaseline, job.qdc);
+            job.phase = fitter.GetPhase();
+            job.amplitude = fitter.GetAmplitude();
+            job.chiSqPerDof = fitter.GetChiSqPerDof();
             break;
+        }
         case FitDriver::UNKNOWN:
         default:
-            EndAnalyze();
-            return;
+            break;
     }
+}
 
-    driver->PerformFit(waveform, pars, sigmaBaseline, qdc);
-    trace.InsertValue("phase", driver->GetPhase()+maxPos);
-    
-    trace.plot(DD_AMP, driver->GetAmplitude(), maxVal);
-    trace.plot(D_PHASE, driver->GetPhase()*1000+100);
-    trace.plot(D_CHISQPERDOF, driver->GetChiSqPerDof());
+void FittingAnalyzer::Record(const FitJob &job) {
+    Trace &trace = *job.trace;
+    trace.InsertValue("phase", job.phase+job.maxPos);
 
-    delete(driver);
-    EndAnalyze();
-}
\ No newline at end of file
+    trace.plot(DD_AMP, job.amplitude, job.maxVal);
+    trace.plot(D_PHASE, job.phase*1000+100);
+    trace.plot(D_CHISQPERDOF, job.chiSqPerDof);
+}
@@ -3,6 +3,7 @@
 /// \author S. V. Paulauskas
 /// \date August 8, 2016
 #include <iostream>
+#include <vector>
 
 #include <cmath>
 
@@ -11,6 +12,7 @@
 #include <gsl/gsl_multifit_nlin.h>
 
 #include "GslFitter.hpp"
+#include "GslWorkspaceCache.hpp"
 
 /** Defines the GSL fitting function for standard PMTs
  * \param [in] x : the vector of gsl starting parameters
@@ -55,6 +57,39 @@ int SiPmtFunctionDerivative(const gsl_vector *x, void *FitData, gsl_vector *f,
 
 using namespace std;
 
+namespace {
+    /// The GSL solver and covariance matrix needed for a fit with n data
+    /// points and p parameters. These are expensive to allocate, so we keep
+    /// them around and reuse them for every fit of the same size.
+    struct GslWorkspace {
+        /// Constructor allocating the solver and the matrices
+        /// \param[in] n The number of points in the fit
+        /// \param[in] p The number of parameters in the fit
+        GslWorkspace(const size_t &n, const size_t &p) : y(n), sigma(n) {
+            solver = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder,
+                                                  n, p);
+            covar = gsl_matrix_alloc(p, p);
+        }
+
+        /// Destructor freeing the GSL allocations
+        ~GslWorkspace() {
+            gsl_multifit_fdfsolver_free(solver);
+            gsl_matrix_free(covar);
+        }
+
+        gsl_multifit_fdfsolver *solver; //!< the lmsder solver
+        gsl_matrix *covar; //!< the covariance matrix of the fit
+        vector<double> y; //!< the data being fitted
+        vector<double> sigma; //!< the weights for the data
+    private:
+        GslWorkspace(const GslWorkspace &); //!< Not copyable
+        GslWorkspace &operator=(const GslWorkspace &); //!< Not copyable
+    };
+
+    /// Every thread gets its own cache so that fits can run concurrently
+    thread_local GslWorkspaceCache<GslWorkspace> workspaceCache;
+}
+
 void GslFitter::PerformFit(const std::vector<double> &data,
                             const std::pair<double, double> &pars,
                             const double &weight/* = 1.*/,
@@ -65,18 +100,6 @@ void GslFitter::PerformFit(const std::vector<double> &data,
     size_t numParams;
     double xInit[3];
 
-    double y[sizeFit], sigma[sizeFit];
-    for(unsigned int i = 0; i < sizeFit; i++) {
-        y[i] = data.at(i);
-        sigma[i] = weight;
-    }
-
-    struct FitDriver::FitData fitData =
-            {sizeFit, y, sigma, pars.first, pars.second, area};
-
-    f.n = sizeFit;
-    f.params = &fitData;
-
     if(!isFastSipm_) {
         numParams = 2;
         xInit[0] = 0.0;
@@ -93,11 +116,23 @@ void GslFitter::PerformFit(const std::vector<double> &data,
     }
     dof_ = sizeFit - numParams;
 
-    const gsl_multifit_fdfsolver_type *T = gsl_multifit_fdfsolver_lmsder;
-    gsl_vector_view x = gsl_vector_view_array (xInit, numParams);
-    gsl_multifit_fdfsolver *s = gsl_multifit_fdfsolver_alloc (T, sizeFit, numParams);
-    gsl_matrix *covar = gsl_matrix_alloc (numParams, numParams);
+    GslWorkspace *ws = workspaceCache.Get(sizeFit, numParams);
+    double *y = &ws->y[0];
+    double *sigma = &ws->sigma[0];
+    for(unsigned int i = 0; i < sizeFit; i++) {
+        y[i] = data[i];
+        sigma[i] = weight;
+    }
+
+    struct FitDriver::FitData fitData =
+            {sizeFit, y, sigma, pars.first, pars.second, area};
+
+    f.n = sizeFit;
     f.p = numParams;
+    f.params = &fitData;
+
+    gsl_vector_view x = gsl_vector_view_array (xInit, numParams);
+    gsl_multifit_fdfsolver *s = ws->solver;
     gsl_multifit_fdfsolver_set (s, &f, &x.vector);
 
     for(unsigned int iter = 0; iter < 1e8; iter++) {
@@ -109,7 +144,7 @@ void GslFitter::PerformFit(const std::vector<double> &data,
             break;
     }
 
-    gsl_multifit_covar (s->J, 0.0, covar);
+    gsl_multifit_covar (s->J, 0.0, ws->covar);
     chi_ = gsl_blas_dnrm2(s->f);
 
     if(!isFastSipm_) {
@@ -119,9 +154,6 @@ void GslFitter::PerformFit(const std::vector<double> &data,
         phase_ = gsl_vector_get(s->x,0);
         amp_ = 0.0;
     }
-
-    gsl_multifit_fdfsolver_free (s);
-    gsl_matrix_free (covar);
 }
 
 int PmtFunction (const gsl_vector * x, void *FitData, gsl_vector * f) {
@@ -3,6 +3,8 @@
 /// \author S. V. Paulauskas
 /// \date August 8, 2016
 #include <iostream>
+#include <vector>
+
 #include <cmath>
 
 #include <gsl/gsl_blas.h>
@@ -10,6 +12,7 @@
 #include <gsl/gsl_multifit_nlin.h>
 
 #include "GslFitter.hpp"
+#include "GslWorkspaceCache.hpp"
 
 /** Defines the GSL fitting function for standard PMTs
  * \param [in] x : the vector of gsl starting parameters
@@ -38,6 +41,42 @@ int CalcSiPmtJacobian(const gsl_vector *x, void *FitData, gsl_matrix *J);
 
 using namespace std;
 
+namespace {
+    /// The GSL solver and matrices needed for a fit with n data points and p
+    /// parameters. These are expensive to allocate, so we keep them around and
+    /// reuse them for every fit of the same size.
+    struct GslWorkspace {
+        /// Constructor allocating the solver and the matrices
+        /// \param[in] n The number of points in the fit
+        /// \param[in] p The number of parameters in the fit
+        GslWorkspace(const size_t &n, const size_t &p) : y(n), weights(n) {
+            solver = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder,
+                                                  n, p);
+            jac = gsl_matrix_alloc(n, p);
+            covar = gsl_matrix_alloc(p, p);
+        }
+
+        /// Destructor freeing the GSL allocations
+        ~GslWorkspace() {
+            gsl_multifit_fdfsolver_free(solver);
+            gsl_matrix_free(covar);
+            gsl_matrix_free(jac);
+        }
+
+        gsl_multifit_fdfsolver *solver; //!< the lmsder solver
+        gsl_matrix *jac; //!< the jacobian of the fit
+        gsl_matrix *covar; //!< the covariance matrix of the fit
+        vector<double> y; //!< the data being fitted
+        vector<double> weights; //!< the weights for the data
+    private:
+        GslWorkspace(const GslWorkspace &); //!< Not copyable
+        GslWorkspace &operator=(const GslWorkspace &); //!< Not copyable
+    };
+
+    /// Every thread gets its own cache so that fits can run concurrently
+    thread_local GslWorkspaceCache<GslWorkspace> workspaceCache;
+}
+
 void GslFitter::PerformFit(const std::vector<double> &data,
                             const std::pair<double, double> &pars,
                             const double &weight/* = 1.*/,
@@ -65,11 +104,10 @@ void GslFitter::PerformFit(const std::vector<double> &data,
 
     dof_ = n - p;
 
-    const gsl_multifit_fdfsolver_type *T = gsl_multifit_fdfsolver_lmsder;
-    gsl_multifit_fdfsolver *s = gsl_multifit_fdfsolver_alloc(T, n, p);
-    gsl_matrix *jac=gsl_matrix_alloc(n,p);
-    gsl_matrix *covar = gsl_matrix_alloc (p,p);
-    double y[n], weights[n];
+    GslWorkspace *ws = workspaceCache.Get(n, p);
+    gsl_multifit_fdfsolver *s = ws->solver;
+    double *y = &ws->y[0];
+    double *weights = &ws->weights[0];
     struct FitDriver::FitData fitData = {n, y, weights, pars.first,
                                          pars.second, area};
     gsl_vector_view x = gsl_vector_view_array (xInit,p);
@@ -90,8 +128,8 @@ void GslFitter::PerformFit(const std::vector<double> &data,
 
     gsl_multifit_fdfsolver_wset (s, &f, &x.vector, &w.vector);
     gsl_multifit_fdfsolver_driver(s, 1000, xtol, gtol, ftol, &info);
-    gsl_multifit_fdfsolver_jac(s,jac);
-    gsl_multifit_covar (jac, 0.0, covar);
+    gsl_multifit_fdfsolver_jac(s, ws->jac);
+    gsl_multifit_covar (ws->jac, 0.0, ws->covar);
 
     gsl_vector *res_f = gsl_multifit_fdfsolver_residual(s);
     chi_ = gsl_blas_dnrm2(res_f);
@@ -103,10 +141,6 @@ void GslFitter::PerformFit(const std::vector<double> &data,
         phase_ = gsl_vector_get(s->x,0);
         amp_ = 0.0;
     }
-
-    gsl_multifit_fdfsolver_free (s);
-    gsl_matrix_free (covar);
-    gsl_matrix_free(jac);
 }
 
 int PmtFunction (const gsl_vector * x, void *FitData, gsl_vector * f) {
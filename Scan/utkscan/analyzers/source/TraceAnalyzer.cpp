@@ -11,8 +11,6 @@
 #include <iostream>
 #include <string>
 
-#include <unistd.h>
-
 #include "DammPlotIds.hpp"
 #include "Trace.hpp"
 #include "TraceAnalyzer.hpp"
@@ -25,24 +23,17 @@ int TraceAnalyzer::numTracesAnalyzed = 0; //!< number of analyzed traces
 
 using namespace dammIds::trace;
 
-TraceAnalyzer::TraceAnalyzer() : userTime(0.), systemTime(0.) {
-    name = "Trace";
+TraceAnalyzer::TraceAnalyzer() : name("Trace"), timer_(name) {
     // start at -1 so that when incremented on first trace analysis,
     //   row 0 is respectively filled in the trace spectrum of inheritees
     numTracesAnalyzed = -1;
-    clocksPerSecond = sysconf(_SC_CLK_TCK);
 }
 
-TraceAnalyzer::~TraceAnalyzer()
-{
-    cout << name << " analyzer : "
-	 << userTime << " user time, "
-	 << systemTime << " system time" << endl;
-}
+TraceAnalyzer::~TraceAnalyzer() {}
 
 void TraceAnalyzer::Analyze(Trace &trace,
 			    const std::string &detType, const std::string &detSubtype) {
-    times(&tmsBegin);
+    timer_.Start();
     numTracesAnalyzed++;
     EndAnalyze(trace);
     return;
@@ -52,7 +43,7 @@ void TraceAnalyzer::Analyze(Trace &trace,
 void TraceAnalyzer::Analyze(Trace &trace,
 			    const std::string &detType, const std::string &detSubtype,
                             const std::map<std::string, int> & tagMap) {
-    times(&tmsBegin);
+    timer_.Start();
     numTracesAnalyzed++;
     EndAnalyze(trace);
     return;
@@ -64,13 +55,7 @@ void TraceAnalyzer::EndAnalyze(Trace &trace) {
 }
 
 void TraceAnalyzer::EndAnalyze(void) {
-    tms tmsEnd;
-    times(&tmsEnd);
-
-    userTime += (tmsEnd.tms_utime - tmsBegin.tms_utime) / clocksPerSecond;
-    systemTime += (tmsEnd.tms_stime - tmsBegin.tms_stime) / clocksPerSecond;
-
-    // reset the beginning time so multiple calls of EndAnalyze from
+    // the timer restarts from here so multiple calls of EndAnalyze from
     //   derived classes work properly
-    times(&tmsBegin);
+    timer_.Stop();
 }
@@ -0,0 +1,222 @@
+///\file test_analyticfitter.cpp
+///\brief Benchmarks the AnalyticFitter and compares its timing resolution to
+/// the GslFitter on synthetic pulses, the recorded VANDLE pulse and pulses
+/// made from it with known changes.
+///\date October 19, 2026
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <cmath>
+#include <cstdlib>
+
+#include "AnalyticFitter.hpp"
+#include "MersenneTwister.hpp"
+
+#ifdef usegsl
+#include "GslFitter.hpp"
+#endif
+
+using namespace std;
+
+///Holds a set of synthetic pulses along with their true phases
+struct PulseSet {
+    vector<vector<double> > data;//!< the baseline subtracted waveforms
+    vector<double> qdc;//!< the qdc of each waveform
+    vector<double> phase;//!< the true phase of each waveform
+};
+
+///Summary of the fits to a set of pulses
+struct FitSummary {
+    double bias;//!< mean of the fitted - true phase
+    double resolution;//!< std. dev. of the fitted - true phase
+    double timePerFit;//!< the average time per fit in microseconds
+};
+
+///Makes the synthetic pulses using the same function as the fitters
+PulseSet MakePulses(const pair<double,double> &pars, const unsigned int &num,
+                    const unsigned int &size, const double &noise) {
+    MTRand rand(12345);
+    PulseSet set;
+    for(unsigned int i = 0; i < num; i++) {
+        double phi = rand.rand() - 0.5;
+        double amp = 5000. + 10000.*rand.rand();
+        vector<double> data(size);
+        double qdc = 0;
+        for(unsigned int j = 0; j < size; j++) {
+            double diff = j - phi;
+            if(diff > 0)
+                data[j] = amp * exp(-pars.first*diff) *
+                    (1 - exp(-pow(pars.second*diff, 4.)));
+            data[j] += rand.randNorm(0., noise);
+            qdc += data[j];
+        }
+        set.data.push_back(data);
+        set.qdc.push_back(qdc);
+        set.phase.push_back(phi);
+    }
+    return set;
+}
+
+///Fits all the pulses in the set and summarizes the results
+FitSummary FitPulses(FitDriver &fitter, const PulseSet &set,
+                     const pair<double,double> &pars, const double &noise) {
+    vector<double> diffs(set.data.size());
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(unsigned int i = 0; i < set.data.size(); i++) {
+        fitter.PerformFit(set.data[i], pars, noise, set.qdc[i]);
+        diffs[i] = fitter.GetPhase() - set.phase[i];
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+    FitSummary summary;
+    double sum = 0, sumSq = 0;
+    for(unsigned int i = 0; i < diffs.size(); i++) {
+        sum += diffs[i];
+        sumSq += diffs[i]*diffs[i];
+    }
+    summary.bias = sum / diffs.size();
+    summary.resolution = sqrt(sumSq/diffs.size() - summary.bias*summary.bias);
+    summary.timePerFit =
+        chrono::duration<double, micro>(stop - start).count() / diffs.size();
+    return summary;
+}
+
+///Prints out a line of the results table
+void PrintSummary(const string &name, const FitSummary &summary) {
+    cout << setw(10) << name << setw(14) << summary.bias
+         << setw(14) << summary.resolution
+         << setw(14) << summary.timePerFit << endl;
+}
+
+int main(int argc, char* argv[]){
+    cout << "Comparing the AnalyticFitter to the GslFitter" << endl;
+
+    //Set the <beta, gamma> for the fitting, this is a VANDLE bar
+    pair<double,double> pars = make_pair(0.2659404170, 0.208054799179688);
+    PulseShapeTable table(pars, false);
+
+    unsigned int numPulses = 20000;
+    if(argc > 1)
+        numPulses = atoi(argv[1]);
+
+    //----------- Synthetic pulses with a few different noise levels ---------
+    cout << fixed << setprecision(5) << endl
+         << "Synthetic pulses (" << numPulses << " per noise level)" << endl;
+    double noiseLevels[] = {1., 2., 5., 10.};
+    bool isBiased = false;
+    for(unsigned int i = 0; i < 4; i++) {
+        PulseSet set = MakePulses(pars, numPulses, 16, noiseLevels[i]);
+        cout << "Baseline sigma = " << noiseLevels[i] << endl
+             << setw(10) << "Fitter" << setw(14) << "Bias"
+             << setw(14) << "Resolution" << setw(14) << "us/fit" << endl;
+
+        AnalyticFitter analytic(&table);
+        FitSummary summary = FitPulses(analytic, set, pars, noiseLevels[i]);
+        PrintSummary("Analytic", summary);
+        if(fabs(summary.bias) > 1e-3)
+            isBiased = true;
+#ifdef usegsl
+        GslFitter gsl(false);
+        PrintSummary("GSL", FitPulses(gsl, set, pars, noiseLevels[i]));
+#endif
+    }
+
+    //--------------- The recorded VANDLE trace from test_gslfitter ----------
+    double baseline = 436.742857142857;
+    vector<double> data {
+            437, 501, 1122, 2358, 3509, 3816, 3467, 2921, 2376,
+            1914, 1538, 1252, 1043, 877, 750, 667
+    };
+    for(vector<double>::iterator it = data.begin(); it != data.end(); it++ )
+        (*it) -= baseline;
+    double weight = 1.9761847389475;
+    double area = 21329.85714285;
+
+    AnalyticFitter analytic(&table);
+    analytic.PerformFit(data, pars, weight, area);
+    double phase = analytic.GetPhase();
+    double amplitude = analytic.GetAmplitude();
+    cout << endl << "Recorded VANDLE pulse" << endl
+         << "Analytic : Phase = " << phase
+         << " Amplitude = " << amplitude
+         << " Chi^2/dof = " << analytic.GetChiSqPerDof()
+         << " Steps = " << analytic.GetIterations() << endl;
+#ifdef usegsl
+    GslFitter gsl(false);
+    gsl.PerformFit(data, pars, weight, area);
+    cout << "GSL      : Phase = " << gsl.GetPhase()
+         << " Amplitude = " << gsl.GetAmplitude()
+         << " Chi^2/dof = " << gsl.GetChiSqPerDof() << endl;
+#endif
+    cout << "Gnuplot  : Phase = -0.0826487 Amplitude = 0.8565802" << endl;
+
+    //------ Pulses made from the recorded one with known changes --------
+    // Scaling the pulse must not move it nor change its amplitude, which is
+    // relative to the qdc. Delaying it by whole samples must move it by that
+    // many samples, and adding baseline noise must only move it by about the
+    // timing resolution.
+    cout << endl << "Pulses made from the recorded VANDLE pulse" << endl
+         << setw(22) << "Pulse" << setw(14) << "Phase"
+         << setw(14) << "Expected" << setw(14) << "Amplitude" << endl;
+    double qdc = 0;
+    for(unsigned int j = 0; j < data.size(); j++)
+        qdc += data[j];
+    analytic.PerformFit(data, pars, weight, qdc);
+    amplitude = analytic.GetAmplitude();
+
+    bool isWrong = false;
+    MTRand rand(24680);
+    for(unsigned int i = 0; i < 12; i++) {
+        vector<double> pulse = data;
+        double expected = phase, expectedAmp = amplitude;
+        double tolerance = 1e-3;
+        stringstream name;
+        if(i < 4) {
+            double scale[] = {0.25, 0.5, 2., 4.};
+            for(unsigned int j = 0; j < pulse.size(); j++)
+                pulse[j] *= scale[i];
+            name << "scaled by " << scale[i];
+        } else if(i < 6) {
+            unsigned int delay = i - 3;
+            pulse.insert(pulse.begin(), delay, data[0]);
+            pulse.resize(data.size());
+            expected += delay;
+            expectedAmp = NAN;
+            tolerance = 0.01;
+            name << "delayed by " << delay;
+        } else {
+            for(unsigned int j = 0; j < pulse.size(); j++)
+                pulse[j] += rand.randNorm(0., weight);
+            expectedAmp = NAN;
+            tolerance = 0.05;
+            name << "noise " << i - 5;
+        }
+
+        qdc = 0;
+        for(unsigned int j = 0; j < pulse.size(); j++)
+            qdc += pulse[j];
+        analytic.PerformFit(pulse, pars, weight, qdc);
+        cout << setw(22) << name.str() << setw(14) << analytic.GetPhase()
+             << setw(14) << expected << setw(14)
+             << analytic.GetAmplitude() << endl;
+        if(fabs(analytic.GetPhase() - expected) > tolerance ||
+           (!std::isnan(expectedAmp) &&
+            fabs(analytic.GetAmplitude() / expectedAmp - 1) > 1e-3))
+            isWrong = true;
+    }
+
+    if(isWrong) {
+        cerr << "The analytic fitter does not follow the changes of the "
+             << "recorded pulse!" << endl;
+        return 1;
+    }
+    if(isBiased) {
+        cerr << "The analytic fitter is biased on the synthetic pulses!"
+             << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+///\file test_fittinganalyzer.cpp
+///\brief Checks that the batch mode of the FittingAnalyzer gives exactly the
+/// same phases as the serial mode.
+///\date October 19, 2026
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "FittingAnalyzer.hpp"
+#include "Globals.hpp"
+#include "MersenneTwister.hpp"
+
+using namespace std;
+
+///Writes the smallest configuration that the Globals will accept
+string WriteConfig(void) {
+    char name[] = "/tmp/test_fittinganalyzer_XXXXXX";
+    int fd = mkstemp(name);
+    if(fd < 0)
+        return("");
+    close(fd);
+
+    ofstream config(name);
+    config << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << endl
+           << "<Configuration>" << endl
+           << "  <Global>" << endl
+           << "    <Revision version=\"F\"/>" << endl
+           << "    <EventWidth unit=\"s\" value=\"1e-6\"/>" << endl
+           << "  </Global>" << endl
+           << "  <Fitting>" << endl
+           << "    <SigmaBaselineThresh value=\"3.0\"/>" << endl
+           << "    <SiPmtSigmaBaselineThresh value=\"25.0\"/>" << endl
+           << "    <Parameters>" << endl
+           << "      <Pars name=\"vandle:small\">" << endl
+           << "        <Beta value=\"0.32969\"/>" << endl
+           << "        <Gamma value=\"0.212945\"/>" << endl
+           << "        <Fitter value=\"analytic\"/>" << endl
+           << "      </Pars>" << endl
+           << "      <Pars name=\"vandle:medium\">" << endl
+           << "        <Beta value=\"0.254373\"/>" << endl
+           << "        <Gamma value=\"0.208072\"/>" << endl
+#ifdef usegsl
+           << "        <Fitter value=\"gsl\"/>" << endl
+#else
+           << "        <Fitter value=\"analytic\"/>" << endl
+#endif
+           << "      </Pars>" << endl
+           << "    </Parameters>" << endl
+           << "  </Fitting>" << endl
+           << "</Configuration>" << endl;
+    return(name);
+}
+
+///Makes a trace holding a synthetic pulse and the values the
+/// WaveformAnalyzer would have given it
+Trace MakeTrace(MTRand &rand, const pair<double,double> &pars) {
+    double phi = rand.rand() - 0.5;
+    double amp = 5000. + 10000.*rand.rand();
+    vector<double> waveform(16);
+    double qdc = 0, maxVal = 0, maxPos = 0;
+    for(unsigned int j = 0; j < waveform.size(); j++) {
+        double diff = j - phi;
+        if(diff > 0)
+            waveform[j] = amp * exp(-pars.first*diff) *
+                (1 - exp(-pow(pars.second*diff, 4.)));
+        waveform[j] += rand.randNorm(0., 1.);
+        qdc += waveform[j];
+        if(waveform[j] > maxVal) {
+            maxVal = waveform[j];
+            maxPos = j;
+        }
+    }
+
+    Trace trace(vector<int>(waveform.size(), 0));
+    trace.SetWaveform(waveform);
+    trace.InsertValue("sigmaBaseline", 1.);
+    trace.InsertValue("qdc", qdc);
+    trace.InsertValue("maxval", maxVal);
+    trace.InsertValue("maxpos", maxPos);
+    return(trace);
+}
+
+int main(int argc, char* argv[]){
+    cout << "Comparing the batch and serial modes of the FittingAnalyzer"
+         << endl;
+
+    string config = WriteConfig();
+    if(config.empty()) {
+        cerr << "Could not write the configuration" << endl;
+        return 1;
+    }
+    Globals *globals = Globals::get(config);
+    unlink(config.c_str());
+
+    const char *subtypes[] = {"small", "medium"};
+    unsigned int numEvents = 500;
+    unsigned int tracesPerEvent = 6;
+
+    MTRand rand(98765);
+    vector<Trace> serial, batch;
+    for(unsigned int i = 0; i < numEvents * tracesPerEvent; i++)
+        serial.push_back(MakeTrace(rand, globals->fitPars(
+            string("vandle:") + subtypes[i % 2])));
+    batch = serial;
+
+    map<string, int> tagMap;
+    FittingAnalyzer serialAnalyzer("analytic");
+    FittingAnalyzer batchAnalyzer("analytic", true, 4);
+    for(unsigned int i = 0; i < numEvents; i++) {
+        for(unsigned int j = 0; j < tracesPerEvent; j++) {
+            unsigned int k = i * tracesPerEvent + j;
+            serialAnalyzer.Analyze(serial[k], "vandle", subtypes[k % 2],
+                                   tagMap);
+            batchAnalyzer.Analyze(batch[k], "vandle", subtypes[k % 2],
+                                  tagMap);
+            if(batch[k].HasValue("phase")) {
+                cerr << "Trace " << k << " was fitted before the flush"
+                     << endl;
+                return 1;
+            }
+        }
+        batchAnalyzer.Flush();
+    }
+
+    unsigned int numDifferent = 0, numFitted = 0;
+    for(unsigned int i = 0; i < serial.size(); i++) {
+        if(!serial[i].HasValue("phase") || !batch[i].HasValue("phase") ||
+           serial[i].GetValue("phase") != batch[i].GetValue("phase"))
+            numDifferent++;
+        else
+            numFitted++;
+    }
+
+    cout << numFitted << " of " << serial.size()
+         << " traces have identical phases" << endl;
+    if(numDifferent != 0) {
+        cerr << numDifferent << " traces differ between the modes!" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -52,4 +52,15 @@ int main(int argc, char* argv[]){
          << "Chi^2 = " << fitter.GetChiSq() << endl
          << "Phase = " << fitter.GetPhase() << endl
          << "Phase from Gnuplot = -0.0826487" << endl;
+
+    //The solver workspace is reused between fits of the same size, a second
+    // fit of the same data must give exactly the same answer.
+    GslFitter refit(isSiPmTiming);
+    refit.PerformFit(data, pars, weight, area);
+    if(refit.GetPhase() != fitter.GetPhase() ||
+       refit.GetAmplitude() != fitter.GetAmplitude()) {
+        cerr << "Reusing the GSL workspace changed the fit results!" << endl;
+        return 1;
+    }
+    cout << "Reusing the GSL workspace gives identical results" << endl;
 }
\ No newline at end of file
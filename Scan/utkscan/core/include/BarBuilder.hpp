@@ -16,14 +16,42 @@ public:
     BarBuilder(){};
     /** Constructor taking the map of channels to build bars with
      * \param [in] vec : Reference to the vector to build channels with */
-    BarBuilder(const std::vector<ChanEvent*> vec){list_ = vec;};
+    BarBuilder(const std::vector<ChanEvent*> &vec){list_ = vec;};
     /** Default destructor */
     virtual ~BarBuilder(){};
 
     /** Gets the built bar map. If you have used the default constructor
      * you must call the BuildBars method <strong> first </strong>.
      * \return A BarMap of the bars having traces. */
-    BarMap GetBarMap(void) {return(hrtBars_);};
+    BarMap GetBarMap(void) const {
+        BarMap bars;
+        for(BarList::const_iterator it = hrtBars_.begin();
+            it != hrtBars_.end(); it++)
+            bars.insert(bars.end(), std::make_pair(it->GetKey(), *it));
+        return(bars);
+    };
+
+    /** Gets the built bars as a flat list ordered by bar number. This does
+     * not copy the bars, the list is valid until the next call to BuildBars.
+     * \return A BarList of the bars having traces. */
+    const BarList &GetBarList(void) const {return(hrtBars_);};
+
+    /** Gets the position of each bar in the list of GetBarList.
+     * \return The position indexed by bar number, -1 if the bar was not
+     * built */
+    const std::vector<int> &GetBarIndex(void) const {return(index_);};
+
+    /** Hands the built bars and their index over without copying them. The
+     * builder takes the storage of the given list and index in exchange and
+     * reuses it at the next BuildBars, so swapping every event does not
+     * allocate once the lists have grown to the largest event.
+     * \param [in,out] bars : receives the bars having traces
+     * \param [in,out] index : receives the position of each bar in bars
+     * indexed by bar number, -1 if the bar was not built */
+    void SwapBarList(BarList &bars, std::vector<int> &index) {
+        hrtBars_.swap(bars);
+        index_.swap(index);
+    };
     
     /** Gets the built bar map. If you have used the default constructor
      * you must call the BuildBars method <strong> first </strong>.
@@ -39,7 +67,7 @@ public:
     /** Sets the channel list to build bars out of. This list <strong>
      * must </strong> contain both ends of the detector.
      * \param [in] a : The channel list to build bars out of. */
-    void SetChannelList(const std::vector<ChanEvent*> a){list_ = a;};
+    void SetChannelList(const std::vector<ChanEvent*> &a){list_ = a;};
 private:
     /** The bar number calculated from the location. We assume here
      * that the bars are located in adjacent slots so that they are always
@@ -52,17 +80,19 @@ private:
     /** Clears out the data maps from any previously built bars and ends */
     void ClearMaps(void);
 
-    /** Fills the ends of the detector into two separate maps. Things labeled
-     * {left, up,top} are filled into one map, and things labeled {right, down,bottom}
-     * are filled into another map. Currently these are the only six
-     * recognized end types that one may have, this can be expanded later if
-     * others should arise. */
+    /** Fills the ends of the detector into two separate tables indexed by
+     * bar number. Things labeled {left, up,top} are filled into one table,
+     * and things labeled {right, down,bottom} are filled into another table.
+     * Currently these are the only six recognized end types that one may
+     * have, this can be expanded later if others should arise. */
     void FillMaps(void);
 
-    BarMap hrtBars_; //!< Map containing bars with high resolution timing..
+    BarList hrtBars_; //!< List containing bars with high resolution timing..
     std::map<unsigned int, std::pair<double,double> > lrtBars_; //!<Map with low res bars
-    std::map<unsigned int, unsigned int> lefts_; //!< Map containing the left sides of bars
-    std::map<unsigned int, unsigned int> rights_; //!< Map containing the left sides of bars
+    std::vector<int> lefts_; //!< Index in list_ of the left side of each bar, -1 if none
+    std::vector<int> rights_; //!< Index in list_ of the right side of each bar, -1 if none
+    std::vector<int> index_; //!< Index in hrtBars_ of each bar, -1 if none
+    BarList lastBars_; //!< The last bar built for each bar number, to reuse its calibration
     std::vector<ChanEvent*> list_; //!< Vector of events to build bars out of.
 };
 #endif // __BARBUILDER_HPP_
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <vector>
 
 #include "HighResTimingData.hpp"
 #include "TimingCalibrator.hpp"
@@ -17,53 +18,55 @@
 class BarDetector {
 public:
     /** Default constructor */
-    BarDetector() {};
+    BarDetector() {
+        cal_ = NULL;
+        hasLength_ = false;
+        maxTimeDiff_ = 0.0;
+        speedOfLight_ = std::numeric_limits<double>::quiet_NaN();
+    };
     /** Default destructor */
     ~BarDetector() {};
 
     /** \brief The constructor for the structure
-    * \param [in] Right : The right side of the bar
     * \param [in] Left : The left side of the bar
+    * \param [in] Right : The right side of the bar
     * \param [in] key : The TimingIdentifier for the bar */
-    BarDetector(HighResTimingData Left, HighResTimingData Right,
-                TimingDefs::TimingIdentifier &key) {
+    BarDetector(const HighResTimingData &Left, const HighResTimingData &Right,
+                const TimingDefs::TimingIdentifier &key) {
         left_ = Left;
         right_ = Right;
         key_ = key;
+        cal_ = &TimingCalibrator::get()->GetCalibration(key_);
+        SetTypeConstants();
+    }
+
+    /** \brief The constructor reusing the bar number, calibration and type
+    * constants of an earlier bar, so that nothing is looked up again
+    * \param [in] Left : The left side of the bar
+    * \param [in] Right : The right side of the bar
+    * \param [in] prev : An earlier bar with the same TimingIdentifier */
+    BarDetector(const HighResTimingData &Left, const HighResTimingData &Right,
+                const BarDetector &prev) {
+        *this = prev;
+        left_ = Left;
+        right_ = Right;
     }
 
     /** \return the true if there was an event in the bar */
     bool GetHasEvent(void) const {
-        if(GetType() == "small") {
-            double lengthSmallTime = Globals::get()->smallLengthTime();
-            return(fabs(GetTimeDifference()) < lengthSmallTime+20 &&
+        if(hasLength_)
+            return(fabs(GetTimeDifference()) < maxTimeDiff_ &&
                    GetRightSide().GetIsValid() && GetLeftSide().GetIsValid());
-        } else if(GetType() == "big") {
-            double lengthBigTime = Globals::get()->bigLengthTime();
-            return(fabs(GetTimeDifference()) < lengthBigTime+20 &&
-                   GetRightSide().GetIsValid() && GetLeftSide().GetIsValid());
-        } else if (GetType() == "medium") {
-            double lengthMediumTime = Globals::get()->mediumLengthTime();
-            return(fabs(GetTimeDifference()) < lengthMediumTime+20 &&
-                   GetRightSide().GetIsValid() && GetLeftSide().GetIsValid());
-        }
         return(GetRightSide().GetIsValid() && GetLeftSide().GetIsValid());
     }
     /** \return the flight path of the particle to the detector */
     double GetFlightPath(void) const {
-        if(GetType() == "small")
-            return(sqrt(GetCalibration().GetZ0()*GetCalibration().GetZ0()+
-                pow(Globals::get()->speedOfLightSmall()*0.5*GetTimeDifference()+
-                    GetCalibration().GetXOffset(),2)));
-        else if(GetType() == "big")
-            return(sqrt(GetCalibration().GetZ0()*GetCalibration().GetZ0() +
-                pow(Globals::get()->speedOfLightBig()*0.5*GetTimeDifference()+
-                    GetCalibration().GetXOffset(),2)));
-        else if(GetType() == "medium")
-            return(sqrt(GetCalibration().GetZ0()*GetCalibration().GetZ0() +
-                pow(Globals::get()->speedOfLightMedium()*0.5*GetTimeDifference()+
-                    GetCalibration().GetXOffset(),2)));
-        return(std::numeric_limits<double>::quiet_NaN());
+        if(!hasLength_)
+            return(std::numeric_limits<double>::quiet_NaN());
+        const TimingCalibration &cal = GetCalibration();
+        return(sqrt(cal.GetZ0()*cal.GetZ0() +
+                    pow(speedOfLight_*0.5*GetTimeDifference() +
+                        cal.GetXOffset(),2)));
     }
     /** \return the position independent qdc for the bar */
     double GetQdc() const {
@@ -101,17 +104,52 @@ public:
     /** \return the right_ var */
     const HighResTimingData& GetRightSide() const {return(right_);}
     /** \return the type of bar detector */
-    std::string GetType() const {return(key_.second);}
-    /** \return the time calibration var */
-    const TimingCalibration GetCalibration() const {
-        return(TimingCalibrator::get()->GetCalibration(key_));
+    const std::string &GetType() const {return(key_.second);}
+    /** \return the bar number */
+    unsigned int GetNumber() const {return(key_.first);}
+    /** \return the TimingIdentifier for the bar */
+    const TimingDefs::TimingIdentifier &GetKey() const {return(key_);}
+    /** \return the time calibration var, resolved once when the bar was
+     * built */
+    const TimingCalibration &GetCalibration() const {
+        if(cal_ == NULL)
+            return(TimingCalibrator::get()->GetCalibration(key_));
+        return(*cal_);
     }
 private:
+    /** Looks up the length and speed of light for our type of bar once,
+     * so that the per event methods do not need to compare strings. */
+    void SetTypeConstants(void) {
+        Globals *globals = Globals::get();
+        hasLength_ = true;
+        if(key_.second == "small") {
+            maxTimeDiff_ = globals->smallLengthTime() + 20;
+            speedOfLight_ = globals->speedOfLightSmall();
+        } else if(key_.second == "big") {
+            maxTimeDiff_ = globals->bigLengthTime() + 20;
+            speedOfLight_ = globals->speedOfLightBig();
+        } else if(key_.second == "medium") {
+            maxTimeDiff_ = globals->mediumLengthTime() + 20;
+            speedOfLight_ = globals->speedOfLightMedium();
+        } else {
+            hasLength_ = false;
+            maxTimeDiff_ = 0.0;
+            speedOfLight_ = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+
     HighResTimingData right_; //!< The Right side of the detector
     HighResTimingData left_; //!< The Left side of the detector
     TimingDefs::TimingIdentifier key_; //!< The key for the detector 
+    const TimingCalibration *cal_; //!< The calibration for the detector
+    bool hasLength_; //!< True if the type of bar has a known length
+    double maxTimeDiff_; //!< The largest time difference for a real event
+    double speedOfLight_; //!< The speed of light in the bar
 };
 
 /** Defines a map to hold Bar Detectors */
 typedef std::map<TimingDefs::TimingIdentifier, BarDetector> BarMap;
+/** Defines a flat list of Bar Detectors ordered by bar number */
+typedef std::vector<BarDetector> BarList;
 #endif // __BARDETECTOR_HPP__
@@ -0,0 +1,102 @@
+/** \file CoincidenceKernel.hpp
+ * \brief Finds the coincidences between time sorted hits with a sliding
+ * window
+ *
+ * Instead of testing the time difference of every pair of hits, the hits are
+ * swept once with two pointers. Each hit is only compared to the hits that
+ * are inside of the window, so the cost is linear in the number of hits plus
+ * the number of coincidences found.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __COINCIDENCEKERNEL_HPP__
+#define __COINCIDENCEKERNEL_HPP__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//! A hit that can take part in a coincidence
+struct CoincidenceHit {
+    double time; //!< the time of the hit, in the same units as the window
+    double energy; //!< the energy of the hit
+    int group; //!< the group of the hit (e.g. clover), -1 if it has none
+};
+
+//! A coincidence matrix declared in the configuration
+struct CoincidenceMatrix {
+    int id; //!< the histogram id relative to the processor offset
+    std::string title; //!< the title of the histogram
+    double window; //!< the coincidence window in seconds
+    bool isBetaGated; //!< true if the matrix requires a beta in the event
+    bool isCrossGroup; //!< true if hits in the same group are not paired
+};
+
+//! Sweeps time sorted hits and hands the coincidences to a callback
+class CoincidenceKernel {
+public:
+    /** Callback receiving a pair of coincident hits, the first argument is
+     * always the earlier one */
+    typedef std::function<void(const CoincidenceHit &,
+                               const CoincidenceHit &)> PairCallback;
+    /** Callback receiving a fold of coincident hits in time order */
+    typedef std::function<void(const std::vector<const CoincidenceHit*> &)>
+        FoldCallback;
+
+    /** Constructor
+     * \param [in] window : the largest time difference between two hits that
+     * are considered to be in coincidence, in the units of the hit times */
+    CoincidenceKernel(const double &window = 0.0) {window_ = window;}
+
+    /** Default Destructor */
+    ~CoincidenceKernel() {};
+
+    /** \return the coincidence window */
+    double GetWindow(void) const {return(window_);}
+
+    /** Sets the coincidence window
+     * \param [in] a : the window in the units of the hit times */
+    void SetWindow(const double &a) {window_ = a;}
+
+    /** Calls func for every pair of hits in the list that are within the
+     * window of each other.
+     * \param [in] hits : the hits, which must be sorted by time
+     * \param [in] func : the function to call for each pair
+     * \return the number of pairs that were found */
+    unsigned int Pairs(const std::vector<CoincidenceHit> &hits,
+                       const PairCallback &func) const;
+
+    /** Calls func for every pair made from one hit of each list that are
+     * within the window of each other, e.g. beta-gamma.
+     * \param [in] a : the first list of hits, sorted by time
+     * \param [in] b : the second list of hits, sorted by time
+     * \param [in] func : the function to call with (hit from a, hit from b)
+     * \return the number of pairs that were found */
+    unsigned int Pairs(const std::vector<CoincidenceHit> &a,
+                       const std::vector<CoincidenceHit> &b,
+                       const PairCallback &func) const;
+
+    /** Calls func for every combination of fold hits that are all within the
+     * window of the earliest of them, e.g. fold = 3 for triples.
+     * \param [in] hits : the hits, which must be sorted by time
+     * \param [in] fold : the number of hits in each combination
+     * \param [in] func : the function to call for each combination
+     * \return the number of combinations that were found */
+    unsigned int Folds(const std::vector<CoincidenceHit> &hits,
+                       const unsigned int &fold,
+                       const FoldCallback &func) const;
+
+    /** Sorts the hits by time so that they may be used with the kernel
+     * \param [in,out] hits : the hits to sort */
+    static void Sort(std::vector<CoincidenceHit> &hits);
+private:
+    /** Recursively builds the combinations for the Folds method */
+    unsigned int Combine(const std::vector<CoincidenceHit> &hits,
+                         const size_t &first, const size_t &end,
+                         const unsigned int &needed,
+                         std::vector<const CoincidenceHit*> &current,
+                         const FoldCallback &func) const;
+
+    double window_; //!< the coincidence window
+};
+#endif // __COINCIDENCEKERNEL_HPP__
@@ -7,6 +7,8 @@
 #ifndef __CORRELATOR_PROCESSOR_HPP_
 #define __CORRELATOR_PROCESSOR_HPP_
 
+#include <fstream>
+#include <ostream>
 #include <utility>
 #include <vector>
 
@@ -15,6 +17,7 @@
 #include "Plots.hpp"
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
+#include "PixelHistory.hpp"
 
 class LogicProcessor;
 class RawEvent;
@@ -58,27 +61,6 @@ struct EventInfo {
     EventInfo(double t, double e, LogicProcessor *lp);
 };
 
-//! The list of correlations
-class CorrelationList : public std::vector<EventInfo> {
-private:
-    bool flagged;//!< flag telling if something has been flagged
-public:
-    /** Default Constructor */
-    CorrelationList();
-    /** \return the decay time */
-    double GetDecayTime(void) const;
-    /** \return the implant time */
-    double GetImplantTime(void) const;
-    /** flag an event */
-    void Flag(void);
-    /** \return true if something is flagged */
-    bool IsFlagged(void) const;
-    //! overide the vector clear function so that the flag is also removed
-    void clear(void);
-    /** Print the decay list */
-    void PrintDecayList(void) const;
-};
-
 /*!
   \brief correlate decays with previous implants
 
@@ -90,6 +72,10 @@ public:
   correlator checks to make sure that the time between implants is
   sufficiently long and that the correlation time has not been exceeded
   before correlating an implant with a decay.
+
+  The events of each pixel are kept in a fixed size history, once it is full
+  the later decays of the chain are counted as overflows and dropped so that
+  the implant and the first generations are always kept.
 */
 class Correlator {
 public:
@@ -101,7 +87,9 @@ public:
 		      DECAY_TOO_LATE       = 48,
 		      IMPLANT_TOO_SOON     = 52,
 		      UNKNOWN_CONDITION    = 100};
-    /** Default Constructor */
+    /** Default Constructor, the maximum number of events kept per pixel is
+     * read from the depth of the Correlator node of the configuration (64 by
+     * default) */
     Correlator();
     /** Default Destructor */
     virtual ~Correlator();
@@ -160,6 +148,12 @@ public:
      * \return true if it is flagged */
     bool IsFlagged(int fch, int bch);
 
+    /** \return the number of decays dropped because the history of their
+     * pixel was full */
+    unsigned long GetOverflows(void) const {
+        return decaylist.GetOverflows();
+    }
+
     /** \return The conditions for correlation */
     EConditions GetCondition(void) const {
         return condition;
@@ -208,10 +202,25 @@ private:
     static const double fastTime;   /**< Times shorter than this are output as
                                          a fast decay */
 
-    EventInfo   *lastImplant;  ///< last implant processed by correlator
-    EventInfo   *lastDecay;    ///< last decay procssed by correlator
+    PixelHistory<EventInfo>::Handle lastImplant; ///< last implant processed by correlator
+    PixelHistory<EventInfo>::Handle lastDecay;   ///< last decay procssed by correlator
+
+    /** \return the index of the pixel in the decay lists
+     * \param [in] fch : the front channel
+     * \param [in] bch : the back channel */
+    size_t Pixel(unsigned int fch, unsigned int bch) const {
+        return fch * arraySize + bch;
+    }
+
+    /** Removes the events and the flag of a pixel
+     * \param [in] pixel : the pixel to clear */
+    void Clear(const size_t &pixel);
 
     EConditions condition;     ///< condition for last processed event
-    CorrelationList decaylist[arraySize][arraySize]; ///< list of event data for a particular pixel since implant
+    PixelHistory<EventInfo> decaylist; ///< list of event data for a particular pixel since implant
+    std::vector<bool> flagged; ///< true if the decay list of the pixel is flagged
+
+    std::vector<char> logBuffer; ///< buffer for the full decay log
+    mutable std::ofstream fullLog; ///< the full decay log, HIS/full_decays.txt
 };
 #endif // __CORRELATOR_PROCESSOR_HPP_
@@ -44,6 +44,7 @@ namespace dammIds {
         const int DD_RUNTIME_MSEC = 1810;//!< Run Time in ms
         const int D_NUMBER_OF_EVENTS = 1811;//!< Number of processed events
         const int D_HAS_TRACE = 1812;//!< Plot for Channels w/ Traces
+        const int DD_STAGE_TIMES = 1813;//!< Time per call of each stage
     }
 
     /// in PspmtProcessor.cpp
@@ -104,6 +105,7 @@ namespace dammIds {
     namespace logic {
         const int OFFSET = 3000;//!< Offset for LogicProcessor
         const int RANGE = 150;//!< Range for the Logic Processor
+        const unsigned int MAX_LOGIC = 10; //!< Maximum Number of Logic Signals
     }
 
     ///in VandleProcessor.cpp
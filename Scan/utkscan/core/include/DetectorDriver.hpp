@@ -43,6 +43,7 @@
 #include "Globals.hpp"
 #include "Messenger.hpp"
 #include "Plots.hpp"
+#include "StageProfiler.hpp"
 #include "WalkCorrector.hpp"
 
 class Calibration;
@@ -90,9 +91,16 @@ public:
     * \param [in] rawev : the raw event to process */
     void ProcessEvent(RawEvent& rawev);
 
+    /*! \brief Runs all of the trace analyzers on the channel's trace.
+     * Analyzers working in batch mode may defer their results until they
+     * are flushed at the end of the trace analysis for the event.
+     * \param [in] chan : the channel whose trace we will analyze */
+    void AnalyzeTrace(ChanEvent *chan);
+
     /*! \brief Check threshold and calibrate each channel.
      * Check the thresholds and calibrate the energy for each channel using the
      * calibrations contained in the calibration vector filled during ReadCal()
+     * The trace must already have been analyzed with AnalyzeTrace().
      * \param [in] chan : the channel to do the calibration on
      * \param [in] rawev : the raw event to write the information into
      * \return an unused integer (maybe change to void) */
@@ -167,8 +175,9 @@ private:
                    energy and time information */
     std::set<std::string> knownDetectors; /**< list of valid detectors that can
                    be used as detector types */
-    std::string cfg_; //!< The configuration file to read
     std::pair<double, time_t> pixieToWallClock; /**< rough estimate of pixie to wall clock */
+    bool plotStageTimes_; //!< true to write the stage times into DAMM
+    StageTimer processTimer_; //!< the time spent in ProcessEvent
 
 
     /*! Declares a 1D histogram calls the C++ wrapper for DAMM
@@ -0,0 +1,125 @@
+/** \file EventSkimmer.hpp
+ * \brief Writes the events passing a selection into a new list mode file
+ *
+ * The selection is read from the Skim node of the configuration file. It is
+ * made of conditions on the channels of the event, given by detector type
+ * and subtype, energy range and multiplicity, and of conditions on the
+ * result of the processors. Processors may also keep or veto the current
+ * event directly. The channels of the kept events are encoded back into
+ * pixie16 list mode words and written as spills of a .pld file, which can
+ * be read again by any of the scan codes.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __EVENTSKIMMER_HPP__
+#define __EVENTSKIMMER_HPP__
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+#include "pugixml.hpp"
+
+class EventProcessor;
+class PollOutputFile;
+class RawEvent;
+class XiaData;
+
+//! A single condition of the skim selection
+struct SkimCondition {
+    std::string type; //!< the detector type
+    std::string subtype; //!< the detector subtype, any subtype if empty
+    std::string processor; //!< the name of the processor, for processor conditions
+    EventProcessor *proc; //!< the processor, resolved on the first event
+    double minEnergy; //!< the lowest accepted energy
+    double maxEnergy; //!< the highest accepted energy
+    bool useRaw; //!< true to cut on the raw energy instead of the calibrated one
+    unsigned int minMult; //!< the least number of channels in the energy range
+    unsigned int maxMult; //!< the most number of channels in the energy range
+    bool veto; //!< true if the condition must not be met
+    std::vector<bool> channels; //!< true for the ids of the type and subtype
+};
+
+//! Selects events and writes them into a new .pld file
+class EventSkimmer {
+public:
+    /** \return the only instance of the skimmer */
+    static EventSkimmer *get(void);
+
+    /** Default Destructor, closes the output file */
+    ~EventSkimmer();
+
+    /** Reads the Skim node and opens the output file. Does nothing if the
+     * node is not in the configuration.
+     * \param [in] node : the Skim node of the configuration */
+    void Init(const pugi::xml_node &node);
+
+    /** \return true if events are being skimmed */
+    bool IsEnabled(void) const {return isEnabled_;}
+
+    /** Keeps the current event whatever the conditions, for processors */
+    void Keep(void) {keep_ = true;}
+    /** Drops the current event whatever the conditions, for processors */
+    void Veto(void) {veto_ = true;}
+
+    /** Evaluates the selection on a processed event and stores its
+     * channels if the event is kept
+     * \param [in] event : the event after the processors
+     * \param [in] channels : the channels of the event as unpacked */
+    void Process(const RawEvent &event,
+                 const std::deque<XiaData*> &channels);
+
+    /** Writes out the stored events, closes the file and prints the
+     * number of kept events */
+    void Close(void);
+
+    /** Encodes a channel into pixie16 list mode words. The onboard QDCs
+     * are written if any is set, the partial sums of the energy filter are
+     * not kept by the unpacker and are lost.
+     * \param [in] chan : the channel to encode
+     * \param [out] words : the words are appended to this */
+    static void Encode(const XiaData &chan, std::vector<uint32_t> &words);
+
+private:
+    /** Default Constructor */
+    EventSkimmer();
+    EventSkimmer(const EventSkimmer&); //!< Not implemented
+    EventSkimmer& operator=(const EventSkimmer&); //!< Not implemented
+
+    /** Resolves the ids and the processors of the conditions */
+    void Resolve(void);
+    /** \return true if the event passes the conditions
+     * \param [in] event : the event after the processors */
+    bool Select(const RawEvent &event);
+    /** Writes out the stored events as one spill per crate */
+    void Flush(void);
+
+    static EventSkimmer *instance_; //!< the only instance
+
+    bool isEnabled_; //!< true if events are being skimmed
+    bool isResolved_; //!< true once the conditions were resolved
+    bool requireAll_; //!< true if all of the conditions must be met
+    bool keep_; //!< set by a processor to keep the current event
+    bool veto_; //!< set by a processor to drop the current event
+
+    std::vector<SkimCondition> conditions_; //!< the conditions of the selection
+    std::vector<unsigned int> counts_; //!< channels in range, per condition
+
+    PollOutputFile *output_; //!< the output file
+    unsigned int spillWords_; //!< the size at which a spill is written
+    unsigned int storedWords_; //!< the number of stored words
+    std::vector<std::vector<uint32_t> > modules_; //!< the stored words of each module
+    std::vector<uint32_t> words_; //!< the encoded channels of the current event
+    std::vector<std::pair<unsigned int, size_t> > ends_; //!< the module and the end in words_ of each channel
+    std::vector<size_t> eventWords_; //!< the words of the current event in each module
+    std::vector<uint32_t> spill_; //!< the spill being written
+
+    uint64_t numEvents_; //!< the number of events seen
+    uint64_t numKept_; //!< the number of events kept
+    double firstTime_; //!< the time of the first kept channel
+    double lastTime_; //!< the time of the last kept channel
+};
+#endif //__EVENTSKIMMER_HPP__
@@ -257,6 +257,14 @@ public:
         return (std::make_pair(0.254373, 0.208072));
     }
 
+    /** \return the name of the fitter requested for the type:subtype, an
+     * empty string if none was given in the configuration */
+    std::string fitter(const std::string &str) const {
+        if (fitters_.find(str) != fitters_.end())
+            return (fitters_.find(str)->second);
+        return ("");
+    }
+
     /** \return the trapezoidal filter parameters for the requested detector type:subtype */
     std::pair<TrapFilterParameters, TrapFilterParameters>
     trapFiltPars(const std::string &str) const {
@@ -281,6 +289,13 @@ public:
     /** \return the configuration file */
     std::string configfile() const { return (configFile_); }
 
+    /** \return the Configuration node of the configuration file. The file
+     * is parsed and checked once when the Globals are created, the other
+     * classes read their sections from here instead of parsing it again. */
+    pugi::xml_node configuration() const {
+        return (configDoc_.child("Configuration"));
+    }
+
     /** \return the maximum words */
     unsigned int maxWords() const { return maxWords_; }
 
@@ -335,9 +350,11 @@ private:
 
     std::map<std::string, std::pair<unsigned int, unsigned int> > waveformRanges_; //!< Map containing ranges for the waveforms
     std::map<std::string, std::pair<double, double> > fitPars_; //!< Map containing all of the parameters to be used in the fitting analyzer for a type:subtype
+    std::map<std::string, std::string> fitters_; //!< Map containing the fitter requested for a type:subtype
     std::map<std::string, std::pair<TrapFilterParameters, TrapFilterParameters> > trapFiltPars_; //!<Map containing all of the trapezoidal filter parameters for a given type:subtype
 
     std::string configFile_;//!< The configuration file
+    pugi::xml_document configDoc_;//!< The parsed configuration file
     std::string outputPath_;//!< The path to additional configuration files
     std::string revision_;//!< the pixie revision
 
@@ -132,4 +132,7 @@ private:
 
 /** Defines a map to hold timing data for a channel. */
 typedef std::map<TimingDefs::TimingIdentifier, HighResTimingData> TimingMap;
+/** Defines a flat list of timing data ordered by the TimingIdentifier */
+typedef std::vector<std::pair<TimingDefs::TimingIdentifier, HighResTimingData> >
+    TimingList;
 #endif // __HIGHRESTIMINGDATA_HPP__
@@ -19,6 +19,8 @@
 #include <set>
 #include <vector>
 
+class HisServer;
+
 /// Create a DAMM 1D histogram
 void hd1d_(int dammId, int nHalfWords, int rawlen, int histlen, int min, int max,
            const char *title, unsigned int length);
@@ -329,9 +331,10 @@ private:
     bool existing_file; /// True if the .his file was a previously existing file
     unsigned int Flush_wait; /// Number of fills to wait between Flushes
     unsigned int Flush_count; /// Number of fills since last Flush
-    std::vector<fill_queue*> fills_waiting; /// Vector containing list of histograms to be filled
+    std::vector<fill_queue> fills_waiting; /// Vector containing list of histograms to be filled
     std::set<unsigned int> failed_fills; /// Vector containing list of histogram fills into an invalid his id
     std::streampos total_his_size; /// Total size of .his file
+    HisServer *server; /// Serves snapshots of the histograms to viewers, if set
     
     /// Find the specified .drr entry in the drr list using its histogram id
     drr_entry *find_drr_in_list(unsigned int hisID_);
@@ -352,6 +355,11 @@ public:
     /// Set the number of fills to wait between file Flushes
     void SetFlushWait(unsigned int wait_){ Flush_wait = wait_; }
     
+    /* Send the fills to a snapshot server as well. The histograms which were
+     * already declared are added to the server, which is not owned.
+     */
+    void SetServer(HisServer *server_);
+    
     /* Push back with another histogram entry. This command will also
      * extend the length of the .his file (if possible). DO NOT delete
      * the passed drr_entry after calling. OutputHisFile will handle cleanup.
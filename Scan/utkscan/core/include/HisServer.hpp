@@ -0,0 +1,164 @@
+/** \file HisServer.hpp
+ * \brief Serves snapshots of the histograms on a unix domain socket
+ *
+ * The fills of the OutputHisFile are also queued here, and every so often
+ * they are published as a new snapshot. The bins of a histogram are kept in
+ * immutable pages which are shared between snapshots, so publishing copies
+ * only the pages that were filled and a viewer holding an older snapshot
+ * never blocks the scan. The lock is only held while the page tables are
+ * swapped. The requests of the viewers are answered by a thread of its own,
+ * see HisClient.hpp for the protocol. The sockets of the viewers never
+ * block, so a viewer which stalls only delays its own replies.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __HISSERVER_HPP__
+#define __HISSERVER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include "HisClient.hpp"
+
+struct drr_entry;
+
+//! Publishes the histograms of the scan to viewers
+class HisServer {
+public:
+    static const unsigned int pageBins = 4096; //!< bins in a page
+
+    /** Default Constructor */
+    HisServer();
+
+    /** Default Destructor, stops the server */
+    ~HisServer();
+
+    /** Adds a histogram. All of the histograms must be added before the
+     * server is started.
+     * \param [in] entry : the drr entry of the histogram */
+    void Add(const drr_entry *entry);
+
+    /** Queues a fill of a histogram
+     * \param [in] id : the id of the histogram
+     * \param [in] bin : the global bin
+     * \param [in] weight : the weight of the fill */
+    void Fill(const unsigned int &id, const unsigned int &bin,
+              const unsigned int &weight) {
+        HisFill fill = {id, bin, weight};
+        queue_.push_back(fill);
+        if (queue_.size() % checkFills == 0)
+            CheckPublish();
+    }
+
+    /** Queues the zeroing of a histogram
+     * \param [in] id : the id of the histogram */
+    void Zero(const unsigned int &id) {
+        HisFill fill = {id, zeroBin, 0};
+        queue_.push_back(fill);
+    }
+
+    /** Publishes the queued fills as a new snapshot */
+    void Publish(void);
+
+    /** Sets the longest time between two snapshots
+     * \param [in] seconds : the time in seconds */
+    void SetInterval(const double &seconds) {
+        interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(seconds));
+    }
+
+    /** Opens the socket and starts answering requests
+     * \param [in] path : the path of the socket, an existing socket is
+     * replaced
+     * \return true on success */
+    bool Start(const std::string &path);
+
+    /** Stops answering requests and removes the socket */
+    void Stop(void);
+
+    /** \return the sequence of the last snapshot */
+    uint64_t GetSequence(void) const {return sequence_;}
+
+private:
+    HisServer(const HisServer&); //!< Not implemented
+    HisServer& operator=(const HisServer&); //!< Not implemented
+
+    typedef std::vector<uint32_t> Page; //!< a page of bins
+    typedef std::shared_ptr<const Page> PagePtr; //!< a shared page
+
+    //! A histogram as it was at one snapshot
+    struct Block {
+        HisInfo info; //!< the description, with the sequence it changed at
+        uint64_t previous; //!< the sequence of the block it replaced
+        bool sparse; //!< true if changed holds the bins changed since previous
+        std::vector<uint32_t> changed; //!< the sorted bins changed since previous
+        std::vector<PagePtr> pages; //!< the bins
+    };
+    typedef std::shared_ptr<const Block> BlockPtr; //!< a shared block
+
+    //! A queued fill
+    struct HisFill {
+        uint32_t id; //!< the id of the histogram
+        uint32_t bin; //!< the global bin, or zeroBin to zero the histogram
+        uint32_t weight; //!< the weight of the fill
+    };
+
+    static const unsigned int checkFills = 4096; //!< fills between clock checks
+    static const uint32_t zeroBin = 0xFFFFFFFF; //!< marks the zeroing of a histogram
+    static const size_t maxPending = 1 << 20; //!< fills forcing a snapshot
+
+    /** Publishes a snapshot if the interval has passed or too many fills
+     * are queued */
+    void CheckPublish(void);
+
+    /** Answers requests until stopped, reading and writing each viewer
+     * only as far as its socket allows */
+    void Run(void);
+
+    /** Answers a single request
+     * \param [in] request : the request
+     * \param [out] reply : the header of the reply
+     * \param [out] payload : the payload of the reply
+     * \param [in,out] blocks : scratch space for the snapshot */
+    void Answer(const HisRequest &request, HisReply &reply,
+                std::vector<char> &payload, std::vector<BlockPtr> &blocks);
+
+    /** Takes the current snapshot
+     * \param [out] blocks : the blocks of every histogram
+     * \return the sequence of the snapshot */
+    uint64_t Snapshot(std::vector<BlockPtr> &blocks);
+
+    /** \return the value of a bin of a block */
+    static uint32_t GetBin(const Block &block, const size_t &bin) {
+        return (*block.pages[bin / pageBins])[bin % pageBins];
+    }
+
+    std::vector<bool> useInt_; //!< true for 32 bit histograms
+    std::map<uint32_t, size_t> ids_; //!< the index of each histogram id
+    std::vector<BlockPtr> blocks_; //!< the current snapshot, under lock_
+    std::mutex lock_; //!< guards blocks_ and sequence_
+    std::atomic<uint64_t> sequence_; //!< the sequence of the last snapshot
+    PagePtr zeroPage_; //!< a page of zeros shared by all empty pages
+
+    std::vector<HisFill> queue_; //!< fills since the last snapshot, in order
+    std::vector<std::vector<std::pair<uint32_t, uint32_t> > > pending_; //!< fills of each histogram while publishing
+    std::vector<bool> zeroed_; //!< true if the histogram is zeroed while publishing
+    std::vector<bool> isDirty_; //!< true if the histogram changed while publishing
+    std::vector<size_t> dirty_; //!< histograms changed while publishing
+    std::chrono::steady_clock::duration interval_; //!< the longest time between snapshots
+    std::chrono::steady_clock::time_point lastPublish_; //!< the time of the last snapshot
+
+    std::string path_; //!< the path of the socket
+    int listenSock_; //!< the listening socket
+    std::atomic<bool> running_; //!< false to stop the thread
+    std::thread thread_; //!< the thread answering the requests
+};
+#endif //__HISSERVER_HPP__
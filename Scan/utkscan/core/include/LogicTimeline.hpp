@@ -0,0 +1,113 @@
+/** \file LogicTimeline.hpp
+ * \brief Keeps the history of a logic signal as a list of on intervals
+ *
+ * The current level and the last edges are kept separately from the
+ * history, so the question "is the signal on at time t" costs nothing for
+ * times after the last edge, which is the case for all of the detectors
+ * in the current event. Older times are found with a binary search over
+ * the intervals that are still kept.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __LOGICTIMELINE_HPP__
+#define __LOGICTIMELINE_HPP__
+
+#include <deque>
+
+#include <cmath>
+
+//! The history of a single logic signal
+class LogicTimeline {
+public:
+    //! A period during which the signal was on, stop is INFINITY while open
+    struct Interval {
+        double start; //!< the time of the leading edge
+        double stop; //!< the time of the trailing edge
+    };
+
+    /** Constructor
+     * \param [in] maxIntervals : the number of intervals kept in the history,
+     * the oldest ones are dropped beyond this */
+    LogicTimeline(const size_t &maxIntervals = 1024);
+
+    /** Default Destructor */
+    ~LogicTimeline() {}
+
+    /** Records a leading edge. A start while the signal is already on
+     * closes the current interval and opens a new one.
+     * \param [in] time : the time of the edge */
+    void Start(const double &time);
+
+    /** Records a trailing edge
+     * \param [in] time : the time of the edge */
+    void Stop(const double &time);
+
+    /** Changes the level of the signal to the opposite one
+     * \param [in] time : the time of the edge */
+    void Toggle(const double &time) {
+        if (isOn_)
+            Stop(time);
+        else
+            Start(time);
+    }
+
+    /** \return true if the signal is currently on */
+    bool IsOn(void) const {return isOn_;}
+
+    /** \return true if the signal was on at the given time, false for
+     * times before the oldest interval that is kept
+     * \param [in] time : the time to look at */
+    bool IsOn(const double &time) const;
+
+    /** \return the time of the last leading edge, NAN if there was none */
+    double GetLastStart(void) const {return lastStart_;}
+    /** \return the time of the last trailing edge, NAN if there was none */
+    double GetLastStop(void) const {return lastStop_;}
+
+    /** \return the time since the last start if the signal is on, 0
+     * otherwise
+     * \param [in] time : the current time */
+    double TimeOn(const double &time) const {
+        return isOn_ ? time - lastStart_ : 0.;
+    }
+    /** \return the time since the last stop if the signal is off, 0
+     * otherwise
+     * \param [in] time : the current time */
+    double TimeOff(const double &time) const {
+        return !isOn_ ? time - lastStop_ : 0.;
+    }
+
+    /** \return the total time the signal was on between two times, using
+     * the intervals that are kept. The cost is one step per interval.
+     * \param [in] from : the beginning of the range
+     * \param [in] to : the end of the range */
+    double TimeOnBetween(const double &from, const double &to) const;
+
+    /** \return the number of leading edges seen */
+    unsigned long GetStarts(void) const {return starts_;}
+    /** \return the number of trailing edges seen */
+    unsigned long GetStops(void) const {return stops_;}
+
+    /** \return the intervals that are kept, oldest first */
+    const std::deque<Interval> &GetIntervals(void) const {return intervals_;}
+
+    /** Forgets the history and the current level */
+    void Clear(void);
+
+private:
+    /** Adds an interval, dropping the oldest one when the list is full
+     * \param [in] start : the start of the new interval */
+    void Open(const double &start);
+
+    size_t maxIntervals_; //!< the number of intervals kept
+    std::deque<Interval> intervals_; //!< the on intervals, oldest first
+
+    bool isOn_; //!< the current level of the signal
+    double lastStart_; //!< the time of the last leading edge
+    double lastStop_; //!< the time of the last trailing edge
+    double lastEdge_; //!< the time of the last edge of either kind
+
+    unsigned long starts_; //!< the number of leading edges
+    unsigned long stops_; //!< the number of trailing edges
+};
+#endif //__LOGICTIMELINE_HPP__
@@ -0,0 +1,269 @@
+/** \file PixelHistory.hpp
+ * \brief Fixed size event histories for every pixel of a detector
+ *
+ * The histories of all of the pixels live in a single contiguous block of
+ * memory, each pixel owns a ring buffer of a fixed depth inside of it. This
+ * puts a hard limit on the memory used by the correlators no matter how long
+ * the run is.
+ *
+ * The oldest events of a pixel can be pinned (e.g. the implant that starts a
+ * decay chain), they are then never evicted by a full history or by a time
+ * window. Events may be referred to with a Handle, which is checked against
+ * the serial number of the event so that it never points to an event that
+ * has since replaced it.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __PIXELHISTORY_HPP__
+#define __PIXELHISTORY_HPP__
+
+#include <vector>
+
+#include "Exceptions.hpp"
+
+//! A ring buffer of events for each pixel of a detector
+template<class T>
+class PixelHistory {
+public:
+    /** A reference to a stored event that survives the reuse of its slot */
+    struct Handle {
+        size_t pixel; //!< the pixel of the event
+        size_t slot; //!< the slot in the slab that held the event
+        unsigned long serial; //!< the serial number of the event, 0 if none
+
+        /** Default Constructor, refers to no event */
+        Handle() : pixel(0), slot(0), serial(0) {}
+    };
+
+    /** Constructor
+     * \param [in] numPixels : the number of pixels to keep histories for
+     * \param [in] depth : the maximum number of events kept per pixel
+     * \param [in] overwrite : if true the oldest event of a full pixel is
+     * replaced by the new one, otherwise the new event is dropped */
+    PixelHistory(const size_t &numPixels, const size_t &depth,
+                 const bool &overwrite = true) {
+        if (depth == 0)
+            throw GeneralException("PixelHistory : The depth of the "
+                                   "histories has to be at least one.");
+        depth_ = depth;
+        overwrite_ = overwrite;
+        slab_.resize(numPixels * depth);
+        serial_.resize(numPixels * depth, 0);
+        head_.resize(numPixels, 0);
+        count_.resize(numPixels, 0);
+        pinned_.resize(numPixels, 0);
+        overflows_.resize(numPixels, 0);
+        totalOverflows_ = 0;
+        nextSerial_ = 1;
+    }
+
+    /** Default Destructor */
+    ~PixelHistory() {}
+
+    /** \return the number of pixels */
+    size_t GetNumPixels(void) const {return count_.size();}
+    /** \return the maximum number of events kept per pixel */
+    size_t GetDepth(void) const {return depth_;}
+
+    /** \return the number of events stored for the pixel
+     * \param [in] pixel : the pixel to look at */
+    size_t size(const size_t &pixel) const {return count_[pixel];}
+    /** \return true if there are no events stored for the pixel
+     * \param [in] pixel : the pixel to look at */
+    bool empty(const size_t &pixel) const {return count_[pixel] == 0;}
+    /** \return true if the history of the pixel is full
+     * \param [in] pixel : the pixel to look at */
+    bool full(const size_t &pixel) const {return count_[pixel] == depth_;}
+
+    /** \return the i-th event of the pixel, 0 is the oldest
+     * \param [in] pixel : the pixel to look at
+     * \param [in] i : the position of the event in the history */
+    T &at(const size_t &pixel, const size_t &i) {
+        return slab_[Slot(pixel, i)];
+    }
+    /** \return the i-th event of the pixel, 0 is the oldest
+     * \param [in] pixel : the pixel to look at
+     * \param [in] i : the position of the event in the history */
+    const T &at(const size_t &pixel, const size_t &i) const {
+        return slab_[Slot(pixel, i)];
+    }
+
+    /** \return the oldest event of the pixel
+     * \param [in] pixel : the pixel to look at */
+    T &front(const size_t &pixel) {return at(pixel, 0);}
+    /** \return the oldest event of the pixel
+     * \param [in] pixel : the pixel to look at */
+    const T &front(const size_t &pixel) const {return at(pixel, 0);}
+    /** \return the newest event of the pixel
+     * \param [in] pixel : the pixel to look at */
+    T &back(const size_t &pixel) {return at(pixel, count_[pixel] - 1);}
+    /** \return the newest event of the pixel
+     * \param [in] pixel : the pixel to look at */
+    const T &back(const size_t &pixel) const {
+        return at(pixel, count_[pixel] - 1);
+    }
+
+    /** Adds an event to the history of the pixel. When the history is full
+     * and overwrite is set the oldest event that is not pinned is replaced,
+     * if all of the events are pinned the new event is dropped.
+     * \param [in] pixel : the pixel to add the event to
+     * \param [in] event : the event to add
+     * \return false if the history was full and an event was lost */
+    bool push_back(const size_t &pixel, const T &event) {
+        if (full(pixel)) {
+            overflows_[pixel]++;
+            totalOverflows_++;
+            if (!overwrite_ || pinned_[pixel] == count_[pixel])
+                return false;
+            Evict(pixel);
+            Store(pixel, event);
+            return false;
+        }
+        Store(pixel, event);
+        return true;
+    }
+
+    /** Pins all of the events that are currently stored for the pixel, they
+     * will only be removed by pop_front or clear.
+     * \param [in] pixel : the pixel to pin the events of */
+    void pin(const size_t &pixel) {pinned_[pixel] = count_[pixel];}
+
+    /** \return the number of pinned events of the pixel
+     * \param [in] pixel : the pixel to look at */
+    size_t pinned(const size_t &pixel) const {return pinned_[pixel];}
+
+    /** Removes the oldest event from the history of the pixel, even if it
+     * is pinned
+     * \param [in] pixel : the pixel to remove the event from */
+    void pop_front(const size_t &pixel) {
+        if (count_[pixel] == 0)
+            return;
+        head_[pixel] = (head_[pixel] + 1) % depth_;
+        count_[pixel]--;
+        if (pinned_[pixel] > 0)
+            pinned_[pixel]--;
+    }
+
+    /** Removes the oldest events that are not pinned as long as the
+     * predicate is true for them, this is used to drop the events that fell
+     * out of a time window.
+     * \param [in] pixel : the pixel to remove the events from
+     * \param [in] isExpired : predicate that is true for expired events
+     * \return the number of events that were removed */
+    template<class Predicate>
+    size_t pop_front_while(const size_t &pixel, Predicate isExpired) {
+        size_t removed = 0;
+        while (count_[pixel] > pinned_[pixel] &&
+               isExpired(at(pixel, pinned_[pixel]))) {
+            Evict(pixel);
+            removed++;
+        }
+        return removed;
+    }
+
+    /** Removes all of the events of the pixel, including the pinned ones
+     * \param [in] pixel : the pixel to clear */
+    void clear(const size_t &pixel) {
+        head_[pixel] = count_[pixel] = pinned_[pixel] = 0;
+    }
+
+    /** Removes all of the events of all of the pixels */
+    void clear(void) {
+        for (size_t i = 0; i < count_.size(); i++)
+            clear(i);
+    }
+
+    /** \return the number of events lost on the pixel because its history
+     * was full
+     * \param [in] pixel : the pixel to look at */
+    unsigned long GetOverflows(const size_t &pixel) const {
+        return overflows_[pixel];
+    }
+    /** \return the number of events lost on all of the pixels */
+    unsigned long GetOverflows(void) const {return totalOverflows_;}
+
+    /** \return a handle to the i-th event of the pixel
+     * \param [in] pixel : the pixel to look at
+     * \param [in] i : the position of the event in the history */
+    Handle handle(const size_t &pixel, const size_t &i) const {
+        Handle h;
+        h.pixel = pixel;
+        h.slot = Slot(pixel, i);
+        h.serial = serial_[h.slot];
+        return h;
+    }
+
+    /** \return the event that the handle refers to, or NULL if the event
+     * was removed from the history
+     * \param [in] h : the handle of the event */
+    T *get(const Handle &h) {
+        if (h.serial == 0)
+            return NULL;
+        if (serial_[h.slot] == h.serial && IsStored(h.pixel, h.slot))
+            return &slab_[h.slot];
+        //Pinned events move by one slot when an event behind them is evicted
+        for (size_t i = 0; i < pinned_[h.pixel]; i++)
+            if (serial_[Slot(h.pixel, i)] == h.serial)
+                return &slab_[Slot(h.pixel, i)];
+        return NULL;
+    }
+    /** \return the event that the handle refers to, or NULL if the event
+     * was removed from the history
+     * \param [in] h : the handle of the event */
+    const T *get(const Handle &h) const {
+        return const_cast<PixelHistory *>(this)->get(h);
+    }
+
+private:
+    /** Puts an event after the newest one, the history must not be full
+     * \param [in] pixel : the pixel to add the event to
+     * \param [in] event : the event to add */
+    void Store(const size_t &pixel, const T &event) {
+        size_t slot = Slot(pixel, count_[pixel]++);
+        slab_[slot] = event;
+        serial_[slot] = nextSerial_++;
+    }
+
+    /** Removes the oldest event that is not pinned. The pinned events in
+     * front of it are moved up by one slot to close the gap.
+     * \param [in] pixel : the pixel to remove the event from */
+    void Evict(const size_t &pixel) {
+        for (size_t i = pinned_[pixel]; i > 0; i--) {
+            slab_[Slot(pixel, i)] = slab_[Slot(pixel, i - 1)];
+            serial_[Slot(pixel, i)] = serial_[Slot(pixel, i - 1)];
+        }
+        serial_[Slot(pixel, 0)] = 0;
+        head_[pixel] = (head_[pixel] + 1) % depth_;
+        count_[pixel]--;
+    }
+
+    /** \return true if the slot holds one of the events of the pixel
+     * \param [in] pixel : the pixel to look at
+     * \param [in] slot : the position in the slab */
+    bool IsStored(const size_t &pixel, const size_t &slot) const {
+        if (slot < pixel * depth_ || slot >= (pixel + 1) * depth_)
+            return false;
+        size_t i = (slot - pixel * depth_ + depth_ - head_[pixel]) % depth_;
+        return i < count_[pixel];
+    }
+
+    /** \return the position in the slab of the i-th event of the pixel
+     * \param [in] pixel : the pixel to look at
+     * \param [in] i : the position of the event in the history */
+    size_t Slot(const size_t &pixel, const size_t &i) const {
+        return pixel * depth_ + (head_[pixel] + i) % depth_;
+    }
+
+    size_t depth_; //!< the maximum number of events per pixel
+    bool overwrite_; //!< true if a full pixel replaces its oldest event
+
+    std::vector<T> slab_; //!< the events of all of the pixels
+    std::vector<unsigned long> serial_; //!< the serial number of each slot
+    std::vector<size_t> head_; //!< the slot of the oldest event per pixel
+    std::vector<size_t> count_; //!< the number of events per pixel
+    std::vector<size_t> pinned_; //!< the number of pinned events per pixel
+    std::vector<unsigned long> overflows_; //!< events lost per pixel
+    unsigned long totalOverflows_; //!< events lost on all of the pixels
+    unsigned long nextSerial_; //!< the serial number of the next event
+};
+#endif //__PIXELHISTORY_HPP__
@@ -0,0 +1,123 @@
+/** \file PlaceHandle.hpp
+ * \brief Handles to places of the TreeCorrelator that are resolved once
+ *
+ * Looking up a place by name searches the map of the TreeCorrelator each
+ * time. The processors resolve their handles in the constructor or in Init
+ * instead, so that a missing place (or a place of the wrong kind) is
+ * reported when the scan starts and using the place costs a pointer
+ * dereference.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __PLACEHANDLE_HPP__
+#define __PLACEHANDLE_HPP__
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Exceptions.hpp"
+#include "TreeCorrelator.hpp"
+
+//! A place of the TreeCorrelator of the given kind, resolved once
+template<class T = Place>
+class PlaceHandle {
+public:
+    /** Default Constructor, the handle has to be resolved before use */
+    PlaceHandle() : place_(NULL) {}
+
+    /** Constructor that resolves the place right away
+     * \param [in] name : the name of the place */
+    PlaceHandle(const std::string &name) : place_(NULL) {Resolve(name);}
+
+    /** Finds the place in the TreeCorrelator
+     * \param [in] name : the name of the place
+     * \throw TreeCorrelatorException if the place does not exist or is not
+     * of the requested kind */
+    void Resolve(const std::string &name) {
+        name_ = name;
+        place_ = dynamic_cast<T *>(TreeCorrelator::get()->place(name));
+        if (place_ == NULL) {
+            std::stringstream ss;
+            ss << "PlaceHandle : The place " << name
+               << " is not of the kind required by the processor.";
+            throw TreeCorrelatorException(ss.str());
+        }
+    }
+
+    /** \return true if the handle was resolved */
+    bool IsResolved(void) const {return place_ != NULL;}
+    /** \return the name of the place */
+    const std::string &GetName(void) const {return name_;}
+    /** \return a pointer to the place */
+    T *get(void) const {return place_;}
+    /** \return a pointer to the place */
+    T *operator->(void) const {return place_;}
+    /** \return a reference to the place */
+    T &operator*(void) const {return *place_;}
+
+private:
+    std::string name_; //!< the name of the place
+    T *place_; //!< the place
+};
+
+/** A family of places named prefix_N, e.g. Neutron_0 ... Neutron_N, indexed
+ * by N. Usually N is the location of the channels of a detector type. */
+template<class T = Place>
+class PlaceFamily {
+public:
+    /** Default Constructor, the family has to be resolved before use */
+    PlaceFamily() {}
+
+    /** Finds the places prefix_N for all of the given indices
+     * \param [in] prefix : the name of the places without the _N
+     * \param [in] indices : the indices of the places to find
+     * \throw TreeCorrelatorException if one of the places does not exist
+     * or is not of the requested kind */
+    void Resolve(const std::string &prefix, const std::set<int> &indices) {
+        prefix_ = prefix;
+        places_.clear();
+        if (indices.empty())
+            return;
+        places_.assign(*indices.rbegin() + 1, NULL);
+        for (std::set<int>::const_iterator it = indices.begin();
+             it != indices.end(); it++) {
+            if (*it < 0)
+                continue;
+            std::stringstream name;
+            name << prefix << "_" << *it;
+            places_[*it] = PlaceHandle<T>(name.str()).get();
+        }
+    }
+
+    /** \return the place with index i, NULL if it was not resolved
+     * \param [in] i : the index of the place */
+    T *operator[](const int &i) const {
+        if (i < 0 || (size_t)i >= places_.size())
+            return NULL;
+        return places_[i];
+    }
+
+    /** \return the place with index i
+     * \param [in] i : the index of the place
+     * \throw TreeCorrelatorException if the place was not resolved */
+    T *at(const int &i) const {
+        T *place = (*this)[i];
+        if (place == NULL) {
+            std::stringstream ss;
+            ss << "PlaceFamily : The place " << prefix_ << "_" << i
+               << " was not resolved.";
+            throw TreeCorrelatorException(ss.str());
+        }
+        return place;
+    }
+
+    /** \return the name of the places without the _N */
+    const std::string &GetPrefix(void) const {return prefix_;}
+
+private:
+    std::string prefix_; //!< the name of the places without the _N
+    std::vector<T *> places_; //!< the places by index
+};
+#endif //__PLACEHANDLE_HPP__
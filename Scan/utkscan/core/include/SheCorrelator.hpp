@@ -6,9 +6,10 @@
 #define __SHECORRELATOR_HPP_
 
 #include <vector>
-#include <deque> 
 #include <sstream>
 
+#include "PixelHistory.hpp"
+
 ///An enumeration of the different super heavy event types
 enum SheEventType {
     alpha,
@@ -83,20 +84,36 @@ private:
 ///Class to handle correlations for super heavy event experiments
 class SheCorrelator {
 public:
-    /** Constructor taking x and y size */ 
+    /** Constructor taking x and y size. The depth of the chains and their
+     * time window are read from the SheCorrelator node of the configuration:
+     * depth is the maximum number of events kept per pixel (32 by default),
+     * the oldest decays of a longer chain are dropped but the heavy ion that
+     * started it is kept. Decays older than window (in seconds, 0 by
+     * default to keep them all) with respect to the newest event in the
+     * pixel are dropped as well.
+     * \param [in] size_x : the number of x strips
+     * \param [in] size_y : the number of y strips */
     SheCorrelator(int size_x, int size_y);
     /** Default Destructor */
     ~SheCorrelator();
-    /** adds an event to the deque */
+    /** adds an event to the pixel history */
     bool add_event(SheEvent& event, int x, int y);
     /** provides human readable event info */
     void human_event_info(SheEvent& event, std::stringstream& ss, 
 			  double clockStart);
+    /** \return the number of events dropped because a chain was full */
+    unsigned long get_overflows() const {return pixels_.GetOverflows();}
+    /** \return the number of events dropped by the time window */
+    unsigned long get_expired() const {return expired_;}
 private:
     int size_x_; //!< size in the x direction
     int size_y_; //!< size in the y direction 
-    std::deque<SheEvent>** pixels_; //!< deque of the pixels hit
+    double timeWindow_; //!< the time window in clock ticks, 0 if unused
+    unsigned long expired_; //!< number of events dropped by the window
+    PixelHistory<SheEvent> pixels_; //!< the events of the pixels hit
     /** flushes the chain */
     bool flush_chain(int x, int y); 
+    /** \return the index of the pixel in the histories */
+    size_t pixel(int x, int y) const {return x * size_y_ + y;}
 };
 #endif
@@ -0,0 +1,177 @@
+/** \file StageProfiler.hpp
+ * \brief Timing of the processors and analyzers
+ *
+ * Every processor step and trace analyzer owns a StageTimer that reads the
+ * steady clock when the step starts and stops. The durations of the calls
+ * are kept in a histogram with logarithmic bins, so that the mean and the
+ * percentiles can be reported at the end of the run. A timer is only ever
+ * used by the thread that runs its stage, so the counters are not shared
+ * and need no locking. When profiling is disabled starting a timer is a
+ * single test of a flag.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __STAGEPROFILER_HPP__
+#define __STAGEPROFILER_HPP__
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class Plots;
+
+//! The timing of a single stage of the analysis
+class StageTimer {
+public:
+    static const unsigned int numBins = 128; //!< number of histogram bins
+
+    /** Constructor
+     * \param [in] owner : the name of the processor or analyzer, it is kept
+     * by reference since analyzers set their name after construction
+     * \param [in] stage : the name of the stage, may be empty */
+    StageTimer(const std::string &owner, const std::string &stage = "");
+
+    /** Default Destructor */
+    ~StageTimer();
+
+    /** Starts a new call of the stage */
+    inline void Start(void);
+
+    /** Adds the time since the start, or since the last stop, to the
+     * current call. Calling it more than once adds the time in between. */
+    inline void Stop(void);
+
+    /** Closes the current call and records it in the histogram */
+    void Commit(void) {
+        if (hasPending_) {
+            Record(pending_);
+            pending_ = 0;
+            hasPending_ = false;
+        }
+    }
+
+    /** \return the name of the stage for the summary */
+    std::string GetName(void) const;
+    /** \return the number of calls recorded */
+    uint64_t GetCount(void) const {return count_;}
+    /** \return the total time of all calls in nanoseconds */
+    uint64_t GetTotal(void) const {return total_;}
+    /** \return the mean time of a call in nanoseconds */
+    double GetMean(void) const {return count_ ? double(total_) / count_ : 0;}
+    /** \return the time in nanoseconds below which the fraction p of the
+     * calls is found, taken from the middle of the histogram bin
+     * \param [in] p : the fraction between 0 and 1 */
+    double GetPercentile(const double &p) const;
+    /** \return the histogram of the call times
+     * \param [in] bin : the bin, see GetBinLow */
+    uint64_t GetBin(const unsigned int &bin) const {return bins_[bin];}
+
+    /** \return the histogram bin for a time, there are four bins per
+     * factor of two and the last bin holds all times above ~4 s
+     * \param [in] ns : the time in nanoseconds */
+    static unsigned int GetBinOf(const uint64_t &ns);
+    /** \return the lowest time in nanoseconds of a bin
+     * \param [in] bin : the bin */
+    static uint64_t GetBinLow(const unsigned int &bin);
+
+private:
+    StageTimer(const StageTimer&); //!< Not implemented
+    StageTimer& operator=(const StageTimer&); //!< Not implemented
+
+    /** \return the steady clock in nanoseconds */
+    static uint64_t Now(void) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** Adds a call to the histogram
+     * \param [in] ns : the time of the call in nanoseconds */
+    void Record(const uint64_t &ns) {
+        bins_[GetBinOf(ns)]++;
+        count_++;
+        total_ += ns;
+    }
+
+    const std::string &owner_; //!< the name of the processor or analyzer
+    std::string stage_; //!< the name of the stage
+
+    bool isRunning_; //!< true between a start and the next commit
+    bool hasPending_; //!< true if the current call has time in it
+    uint64_t start_; //!< the time of the start or the last stop
+    uint64_t pending_; //!< the time of the current call so far
+
+    uint64_t count_; //!< the number of calls
+    uint64_t total_; //!< the total time of the calls
+    uint64_t bins_[numBins]; //!< the histogram of the call times
+};
+
+//! Keeps track of all of the stage timers and reports on them
+class StageProfiler {
+public:
+    /** \return the only instance of the profiler */
+    static StageProfiler *get(void);
+
+    /** \return true if the timers are recording */
+    static bool IsEnabled(void) {return isEnabled_;}
+    /** Turns the timers on or off
+     * \param [in] a : true to record the timing */
+    static void SetEnabled(const bool &a) {isEnabled_ = a;}
+
+    /** Adds a timer to the report
+     * \param [in] timer : the timer to add */
+    void Register(StageTimer *timer) {timers_.push_back(timer);}
+    /** Removes a timer from the report
+     * \param [in] timer : the timer to remove */
+    void Unregister(StageTimer *timer);
+
+    /** Prints a table with the calls, total, mean, median and 99th
+     * percentile of every stage that was called
+     * \param [in] out : the stream to print to */
+    void PrintSummary(std::ostream &out);
+
+    /** Writes the histograms of the call times into a 2D histogram, the
+     * x axis is the bin of the time and y is the stage in the order of
+     * the summary
+     * \param [in] histo : the plots to write into
+     * \param [in] dammId : the id of the histogram */
+    void Plot(Plots &histo, const int &dammId);
+
+    /** Closes the current call of every timer so that their counts and
+     * histograms include it */
+    void CommitAll(void);
+
+    /** \return the timers that recorded any calls, in the order of the
+     * summary. The current call of each timer is closed first. */
+    std::vector<StageTimer*> GetUsedTimers(void);
+
+private:
+    /** Default Constructor */
+    StageProfiler() {}
+    StageProfiler(const StageProfiler&); //!< Not implemented
+    StageProfiler& operator=(const StageProfiler&); //!< Not implemented
+
+    static StageProfiler *instance_; //!< the only instance
+    static bool isEnabled_; //!< true if the timers are recording
+    std::vector<StageTimer*> timers_; //!< all of the timers
+};
+
+void StageTimer::Start(void) {
+    if (!StageProfiler::IsEnabled())
+        return;
+    Commit();
+    isRunning_ = true;
+    start_ = Now();
+}
+
+void StageTimer::Stop(void) {
+    if (!isRunning_)
+        return;
+    uint64_t now = Now();
+    pending_ += now - start_;
+    hasPending_ = true;
+    start_ = now;
+}
+#endif //__STAGEPROFILER_HPP__
@@ -0,0 +1,106 @@
+/** \file StripEdgeTable.hpp
+ * \brief The edge signals of position sensitive strips sorted by location
+ *
+ * The table has a small fixed number of slots for every location and is
+ * filled with a single pass over the edge channels of the event. Finding
+ * the edge that goes with a sum signal only looks at the slots of its
+ * location instead of searching through all of the edges of the event.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __STRIPEDGETABLE_HPP__
+#define __STRIPEDGETABLE_HPP__
+
+#include <vector>
+
+#include <cmath>
+
+#include "ChanEvent.hpp"
+
+//! Edge signals of a strip detector indexed by location
+class StripEdgeTable {
+public:
+    static const unsigned int depth = 4; //!< number of edges kept per location
+
+    //! The edges found at a single location
+    struct Slot {
+        ChanEvent *edges[depth]; //!< the first edges seen at the location
+        unsigned int num; //!< the number of edges seen, may be above depth
+    };
+
+    /** Constructor
+     * \param [in] numLocations : the number of locations of the detector */
+    StripEdgeTable(const unsigned int &numLocations = 0) {
+        Resize(numLocations);
+    }
+
+    /** Default Destructor */
+    ~StripEdgeTable() {}
+
+    /** Sets the number of locations and empties the table
+     * \param [in] numLocations : the number of locations of the detector */
+    void Resize(const unsigned int &numLocations) {
+        slots_.resize(numLocations);
+        Clear();
+    }
+
+    /** Empties all of the slots */
+    void Clear(void) {
+        for (std::vector<Slot>::iterator it = slots_.begin();
+             it != slots_.end(); it++)
+            it->num = 0;
+    }
+
+    /** Empties the table and sorts the edges into it, edges with a location
+     * outside of the table are ignored
+     * \param [in] edges : the edge channels of the event */
+    void Fill(const std::vector<ChanEvent *> &edges) {
+        Clear();
+        for (std::vector<ChanEvent *>::const_iterator it = edges.begin();
+             it != edges.end(); it++) {
+            unsigned int location = (*it)->GetChanID().GetLocation();
+            if (location >= slots_.size())
+                continue;
+            Slot &slot = slots_[location];
+            if (slot.num < depth)
+                slot.edges[slot.num] = *it;
+            slot.num++;
+        }
+    }
+
+    /** Finds the edge at the location of the sum signal that is within the
+     * time cut. If more edges than fit into the slot were seen at the
+     * location the match is reported as a multiple, since the edges that
+     * were not kept could match as well.
+     * \param [in] sum : the sum signal to match
+     * \param [in] timeCut : the maximum time difference in clock ticks
+     * \param [out] isMultiple : true if more than one edge could match
+     * \return the first matching edge, NULL if there is none */
+    ChanEvent *Match(const ChanEvent *sum, const double &timeCut,
+                     bool &isMultiple) const {
+        isMultiple = false;
+        unsigned int location = sum->GetChanID().GetLocation();
+        if (location >= slots_.size())
+            return NULL;
+
+        const Slot &slot = slots_[location];
+        unsigned int kept = slot.num < depth ? slot.num : depth;
+        ChanEvent *match = NULL;
+        for (unsigned int i = 0; i < kept; i++) {
+            if (fabs(slot.edges[i]->GetTime() - sum->GetTime()) >= timeCut)
+                continue;
+            if (match != NULL) {
+                isMultiple = true;
+                break;
+            }
+            match = slot.edges[i];
+        }
+        if (match != NULL && slot.num > depth)
+            isMultiple = true;
+        return match;
+    }
+
+private:
+    std::vector<Slot> slots_; //!< the slots for each location
+};
+#endif //__STRIPEDGETABLE_HPP__
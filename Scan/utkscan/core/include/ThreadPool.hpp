@@ -0,0 +1,69 @@
+/** \file ThreadPool.hpp
+ * \brief A small pool of worker threads used to parallelize loops in the scan
+ *
+ * The pool is created once and reused for every call to ParallelFor, so the
+ * cost of starting threads is not paid for each event.
+ *
+ * \date October 19, 2026
+ */
+#ifndef __THREADPOOL_HPP__
+#define __THREADPOOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! A fixed size pool of threads that can execute an indexed loop in parallel
+class ThreadPool {
+public:
+    /** Constructor that starts the workers
+     * \param [in] numThreads : the total number of threads that will work
+     * on a loop, including the calling thread. If 0 we use the number of
+     * hardware threads available. */
+    ThreadPool(const unsigned int &numThreads = 0);
+
+    /** Default Destructor, stops and joins all the workers */
+    ~ThreadPool();
+
+    /** \return the number of threads working on a loop, including the
+     * calling thread */
+    unsigned int GetNumberOfThreads(void) const {
+        return (unsigned int)workers_.size() + 1;
+    }
+
+    /** Calls func(i) for every i in [0, n) spread across the pool. The
+     * calling thread participates in the work and the function only returns
+     * once every index has been processed. The order in which the indices
+     * are processed is not defined, func must only touch data owned by the
+     * index that it was given.
+     * \param [in] n : the number of indices to process
+     * \param [in] func : the function to call for each index */
+    void ParallelFor(const size_t &n,
+                     const std::function<void(const size_t &)> &func);
+
+private:
+    ThreadPool(const ThreadPool &); //!< Not copyable
+    ThreadPool &operator=(const ThreadPool &); //!< Not copyable
+
+    /** The loop that each of the workers executes */
+    void Work(void);
+    /** Processes indices of the current task until none are left */
+    void RunTasks(void);
+
+    std::vector<std::thread> workers_; //!< the worker threads
+    std::mutex mutex_; //!< protects the task and the bookkeeping below
+    std::condition_variable start_; //!< signals workers that a task is ready
+    std::condition_variable done_; //!< signals that all workers finished
+
+    const std::function<void(const size_t &)> *task_; //!< the current task
+    size_t numTasks_; //!< the number of indices in the current task
+    std::atomic<size_t> next_; //!< the next index to be processed
+    unsigned int busy_; //!< number of workers still on the current task
+    unsigned long generation_; //!< incremented for every new task
+    bool stop_; //!< true when the workers should exit
+};
+
+#endif //__THREADPOOL_HPP__
@@ -80,9 +80,11 @@ public:
     /** \return Instance of the TimingCalibrator class */
     static TimingCalibrator* get();
 
-    /** \return The calibration for the requested bar
+    /** \return The calibration for the requested bar. The reference stays
+     * valid for the lifetime of the calibrator, so it may be cached.
      * \param [in] id : the id of the bar that you want the calibration for */
-    TimingCalibration GetCalibration(const TimingDefs::TimingIdentifier &id);
+    const TimingCalibration &GetCalibration(
+        const TimingDefs::TimingIdentifier &id) const;
 private:
     TimingCalibrator() {ReadTimingCalXml();}; //!<Default constructor
     TimingCalibrator (const TimingCalibrator&);//!< Overload of the constructor
@@ -21,13 +21,27 @@ public:
      * \param [in] evts : The list of events */
     TimingMapBuilder(const std::vector<ChanEvent*> &evts);
 
+    /** Finds all of the events that had high resolution timing data in the
+     * vector of channel events. The storage is reused between calls, so a
+     * builder that is kept around does not allocate for every event.
+     * \param [in] evts : The vector of Channel events to sort through */
+    void Build(const std::vector<ChanEvent*> &evts);
+
     /** \return The map of events that had high resolution timing data. */
-    TimingMap GetMap(void){return(map_);};
+    TimingMap GetMap(void) const {
+        return(TimingMap(list_.begin(), list_.end()));
+    };
+
+    /** \return The flat list of events that had high resolution timing data
+     * ordered by their TimingIdentifier. */
+    const TimingList &GetList(void) const {return(list_);};
+
+    /** Hands the built list over without copying it. The builder takes the
+     * storage of the given list in exchange and reuses it at the next Build.
+     * \param [in,out] list : receives the events that had high resolution
+     * timing data */
+    void SwapList(TimingList &list) {list_.swap(list);};
 private:
-    /** Fills finds all of the events that had high resolution timing data in
-     * the vector of channel events
-     * \param [in] evts : The vector of Channel events to sort through */
-    void FillMaps(const std::vector<ChanEvent*> &evts);
-    TimingMap map_;//!< A map to store all of the timing events that were found
+    TimingList list_;//!< A list to store all of the timing events that were found
 };
 #endif // __TIMINGMAPBUILDER_HPP__
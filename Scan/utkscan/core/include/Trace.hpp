@@ -22,6 +22,13 @@
 //! \brief Store the information for a trace
 class Trace : public std::vector<int> {
 public:
+    /** The filter information for one of the pulses found in the trace */
+    struct Pulse {
+        double energy; //!< the filter energy of the pulse
+        double calEnergy; //!< the calibrated filter energy of the pulse
+        double time; //!< the filter time of the pulse
+    };
+
     /** Default constructor */
     Trace() : std::vector<int>() {}
 
@@ -75,15 +82,37 @@ public:
     * \param [in] name : the name of the parameter to get for
     * \return the requested value */
     double GetValue(const std::string &name) const {
-        if(doubleTraceData.count(name) > 0)
-            return (*doubleTraceData.find(name)).second;
-        if(intTraceData.count(name) > 0)
-            return (*intTraceData.find(name)).second;
+        std::map<std::string, double>::const_iterator itDouble =
+            doubleTraceData.find(name);
+        if(itDouble != doubleTraceData.end())
+            return (*itDouble).second;
+        std::map<std::string, int>::const_iterator itInt =
+            intTraceData.find(name);
+        if(itInt != intTraceData.end())
+            return (*itInt).second;
         return(NAN);
     }
 
+    /** Adds a pulse to the list of pulses found in the trace
+    * \param [in] energy : the filter energy of the pulse
+    * \param [in] calEnergy : the calibrated filter energy of the pulse
+    * \param [in] time : the filter time of the pulse */
+    void AddPulse(const double &energy, const double &calEnergy,
+                  const double &time) {
+        Pulse p;
+        p.energy = energy;
+        p.calEnergy = calEnergy;
+        p.time = time;
+        pulses_.push_back(p);
+    }
+
+    /** \return The pulses found in the trace, the first pulse is at index
+    * 0. These hold the same values as the filterEnergyN, filterEnergyNCal
+    * and filterTimeN entries without having to look them up by name. */
+    const std::vector<Pulse> &GetPulses() const {return(pulses_);}
+
     /** \return Returns the waveform found inside the trace */
-    std::vector<double> GetWaveform() {return(waveform_);}
+    const std::vector<double> &GetWaveform() const {return(waveform_);}
 
     /*! \brief Declares a 1D histogram calls the C++ wrapper for DAMM
     * \param [in] dammId : The histogram number to define
@@ -157,6 +186,7 @@ private:
     std::vector<double> waveform_; //!< The waveform inside the trace
     std::vector<double> trigFilter_; //!< The trigger filter for the trace
     std::vector<double> esums_; //!< The Energy sums calculated from the trace
+    std::vector<Pulse> pulses_; //!< The pulses found in the trace
 
     std::map<std::string, double> doubleTraceData; //!< Trace data stored as doubles
     std::map<std::string, int>    intTraceData;//!< Trace data stored as ints
@@ -7,6 +7,8 @@
 #include <ScanInterface.hpp>
 #include <XiaData.hpp>
 
+class HisServer;
+
 ///Class derived from ScanInterface to handle UI for the scan.
 class UtkScanInterface : public ScanInterface {
 public:
@@ -32,6 +34,12 @@ public:
      * \param[in] argv[] : The arrary containing all command line arguments */
     virtual void ExtraArguments(int argc, char *argv[]) {}
 
+    /** ExtraArguments is used to send command line arguments to classes derived
+     * from ScanInterface. This method loops over the optionExt elements
+     * in the vector userOpts and checks for those options which have been
+     * flagged as active by ::Setup(). */
+    virtual void ExtraArguments(void);
+
     /** Initialize the map file, the config file, the processor handler, 
      * and add all of the required processors.
      * \param[in]  prefix_ String to append to the beginning of system output.
@@ -58,11 +66,11 @@ public:
      * \return Nothing. */
     virtual void CmdHelp(void);
 
-    /** ArgHelp is used to allow a derived class to print a help statment about
-     * its own command line arguments. This method is called at the end of
-     * the ScanInterface::help method.
+    /** ArgHelp is used to allow a derived class to add a command line option
+     * to the main list of options. This method is called at the end of
+     * the ::Setup method.
      * \return Nothing. */
-    virtual void ArgHelp(void) {}
+    virtual void ArgHelp(void);
 
     /** SyntaxStr is used to print a linux style usage message to the screen.
      * \param[in]  name_ The name of the program.
@@ -88,6 +96,8 @@ public:
 private:
     bool init_; /// Set to true when the initialization process successfully completes.
     std::string outputFname_; /// The output histogram filename prefix.
+    std::string hisSocket_; /// The socket to serve histogram snapshots on, if any.
+    HisServer *hisServer_; /// Serves histogram snapshots to viewers.
 };
 
 #endif //__UTK_SCAN_INTERFACE_HPP__
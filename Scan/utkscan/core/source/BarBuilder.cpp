@@ -11,29 +11,53 @@
 
 using namespace std;
 
+namespace {
+    /** Records the index of an end of a bar, keeping the first end that we
+     * find as the map used to do.
+     * \param [in,out] ends : the table of ends indexed by bar number
+     * \param [in] barNum : the bar number of the end
+     * \param [in] idx : the index of the end in the channel list */
+    void SetEnd(vector<int> &ends, const unsigned int &barNum, const int &idx) {
+	if(barNum >= ends.size())
+	    ends.resize(barNum + 1, -1);
+	if(ends[barNum] < 0)
+	    ends[barNum] = idx;
+    }
+}
+
 void BarBuilder::BuildBars(void) {
     ClearMaps();
     FillMaps();
+    index_.assign(lefts_.size(), -1);
 
-    for(map<unsigned int, unsigned int>::const_iterator it = lefts_.begin();
-        it != lefts_.end(); it++) {
-	map<unsigned int, unsigned int>::const_iterator mate = rights_.find(it->first);
-	if(mate == rights_.end())
+    for(unsigned int barNum = 0; barNum < lefts_.size(); barNum++) {
+	if(lefts_[barNum] < 0 || barNum >= rights_.size() ||
+	   rights_[barNum] < 0)
 	    continue;
 
-	if(list_.at(it->second)->GetTrace().size() != 0 &&
-	   list_.at(mate->second)->GetTrace().size() != 0) {
-	    TimingDefs::TimingIdentifier key =
-	     	make_pair(it->first, list_.at(it->second)->GetChanID().GetSubtype());
-	    hrtBars_.insert(make_pair(key,
-            BarDetector(HighResTimingData(list_.at(it->second)),
-                        HighResTimingData(list_.at(mate->second)), key)));
+	ChanEvent *left = list_[lefts_[barNum]];
+	ChanEvent *right = list_[rights_[barNum]];
+
+	if(left->GetTrace().size() != 0 && right->GetTrace().size() != 0) {
+	    //The calibration of a bar is only looked up the first time it fires
+	    const string &type = left->GetChanID().GetSubtype();
+	    if(barNum >= lastBars_.size())
+		lastBars_.resize(barNum + 1);
+	    if(lastBars_[barNum].GetNumber() != barNum ||
+	       lastBars_[barNum].GetType() != type)
+		lastBars_[barNum] =
+		    BarDetector(HighResTimingData(left), HighResTimingData(right),
+				make_pair(barNum, type));
+	    index_[barNum] = (int)hrtBars_.size();
+	    hrtBars_.push_back(
+		BarDetector(HighResTimingData(left), HighResTimingData(right),
+			    lastBars_[barNum]));
 	} else {
-	    lrtBars_.insert(make_pair(it->first,
-				      make_pair(0.5*(list_.at(it->second)->GetCorrectedTime()+
-						     list_.at(mate->second)->GetCorrectedTime()),
-						sqrt(list_.at(it->second)->GetCalEnergy()*
-						     list_.at(mate->second)->GetCalEnergy()))));
+	    lrtBars_.insert(make_pair(barNum,
+				      make_pair(0.5*(left->GetCorrectedTime()+
+						     right->GetCorrectedTime()),
+						sqrt(left->GetCalEnergy()*
+						     right->GetCalEnergy()))));
 	}
     }
 }
@@ -45,19 +69,20 @@ unsigned int BarBuilder::CalcBarNumber(const unsigned int &loc) {
 void BarBuilder::ClearMaps(void){
     lrtBars_.clear();
     hrtBars_.clear();
-    lefts_.clear();
-    rights_.clear();
+    lefts_.assign(lefts_.size(), -1);
+    rights_.assign(rights_.size(), -1);
 }
 
 void BarBuilder::FillMaps(void) {
     for(vector<ChanEvent*>::const_iterator it = list_.begin();
     it != list_.end(); it++) {
-	Identifier id = (*it)->GetChanID();
+	const Identifier &id = (*it)->GetChanID();
 	unsigned int barNum = CalcBarNumber(id.GetLocation());
-	unsigned int idx = (unsigned int)(it - list_.begin());
+	int idx = (int)(it - list_.begin());
+
 	if(id.HasTag("left") || id.HasTag("up") || id.HasTag("top"))
-	    lefts_.insert(make_pair(barNum,idx));
+	    SetEnd(lefts_, barNum, idx);
 	if(id.HasTag("right") || id.HasTag("down") || id.HasTag("bottom"))
-	    rights_.insert(make_pair(barNum,idx));
+	    SetEnd(rights_, barNum, idx);
     }
 }
@@ -0,0 +1,97 @@
+/** \file CoincidenceKernel.cpp
+ * \brief Finds the coincidences between time sorted hits with a sliding
+ * window
+ * \date October 19, 2026
+ */
+#include <algorithm>
+
+#include "CoincidenceKernel.hpp"
+
+using namespace std;
+
+namespace {
+    /** \return true if hit a is earlier than hit b */
+    bool CompareTime(const CoincidenceHit &a, const CoincidenceHit &b) {
+        return(a.time < b.time);
+    }
+}
+
+unsigned int CoincidenceKernel::Pairs(const std::vector<CoincidenceHit> &hits,
+                                      const PairCallback &func) const {
+    unsigned int numPairs = 0;
+    for (size_t i = 0; i < hits.size(); i++) {
+        for (size_t j = i + 1; j < hits.size(); j++) {
+            if (hits[j].time - hits[i].time > window_)
+                break;
+            func(hits[i], hits[j]);
+            numPairs++;
+        }
+    }
+    return(numPairs);
+}
+
+unsigned int CoincidenceKernel::Pairs(const std::vector<CoincidenceHit> &a,
+                                      const std::vector<CoincidenceHit> &b,
+                                      const PairCallback &func) const {
+    unsigned int numPairs = 0;
+    size_t low = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        //The start of the window only moves forward since a is sorted.
+        while (low < b.size() && b[low].time < a[i].time - window_)
+            low++;
+        for (size_t j = low; j < b.size(); j++) {
+            if (b[j].time - a[i].time > window_)
+                break;
+            func(a[i], b[j]);
+            numPairs++;
+        }
+    }
+    return(numPairs);
+}
+
+unsigned int CoincidenceKernel::Folds(const std::vector<CoincidenceHit> &hits,
+                                      const unsigned int &fold,
+                                      const FoldCallback &func) const {
+    if (fold == 0)
+        return(0);
+
+    unsigned int numFolds = 0;
+    vector<const CoincidenceHit*> current;
+    current.reserve(fold);
+    size_t end = 0;
+    for (size_t i = 0; i < hits.size(); i++) {
+        //The end of the window only moves forward since the hits are sorted.
+        if (end < i + 1)
+            end = i + 1;
+        while (end < hits.size() && hits[end].time - hits[i].time <= window_)
+            end++;
+
+        current.clear();
+        current.push_back(&hits[i]);
+        numFolds += Combine(hits, i + 1, end, fold - 1, current, func);
+    }
+    return(numFolds);
+}
+
+unsigned int CoincidenceKernel::Combine(
+        const std::vector<CoincidenceHit> &hits, const size_t &first,
+        const size_t &end, const unsigned int &needed,
+        std::vector<const CoincidenceHit*> &current,
+        const FoldCallback &func) const {
+    if (needed == 0) {
+        func(current);
+        return(1);
+    }
+
+    unsigned int numFolds = 0;
+    for (size_t j = first; j + needed <= end; j++) {
+        current.push_back(&hits[j]);
+        numFolds += Combine(hits, j + 1, end, needed - 1, current, func);
+        current.pop_back();
+    }
+    return(numFolds);
+}
+
+void CoincidenceKernel::Sort(std::vector<CoincidenceHit> &hits) {
+    stable_sort(hits.begin(), hits.end(), CompareTime);
+}
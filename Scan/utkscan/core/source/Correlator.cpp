@@ -45,8 +45,19 @@ const double Correlator::minImpTime = 5e-3;
 const double Correlator::corrTime   = 60; // used to be 3300
 const double Correlator::fastTime   = 40e-6;
 
-Correlator::Correlator() : histo(OFFSET, RANGE, "correlator"),
-    lastImplant(NULL), lastDecay(NULL), condition(UNKNOWN_CONDITION) {
+Correlator::Correlator() :
+    histo(OFFSET, RANGE, "correlator"),
+    condition(UNKNOWN_CONDITION),
+    decaylist(arraySize * arraySize,
+              Globals::get()->configuration().child("Correlator").
+              attribute("depth").as_uint(64), false),
+    flagged(arraySize * arraySize, false) {
+#ifndef ONLINE
+    // The log is kept open for the whole run and written in large blocks
+    logBuffer.resize(1 << 16);
+    fullLog.rdbuf()->pubsetbuf(&logBuffer[0], logBuffer.size());
+    fullLog.open("HIS/full_decays.txt", ios::app);
+#endif
 }
 
 EventInfo::EventInfo() {
@@ -64,67 +75,38 @@ EventInfo::EventInfo() {
     generation = 0;
 }
 
-CorrelationList::CorrelationList() : std::vector<EventInfo>() {
-    flagged = false;
-}
-
-double CorrelationList::GetDecayTime() const {
-    if(empty() || back().type == EventInfo::IMPLANT_EVENT) {
-            return NAN;
-        }
-    else {
-            return back().dtime;
-        }
-}
-
-double CorrelationList::GetImplantTime() const {
-    if(empty() || front().type != EventInfo::IMPLANT_EVENT) {
-            return NAN;
-        }
-    else {
-            return front().time;
-        }
-}
-
-void CorrelationList::Flag() {
-    if(!empty())
-        back().flagged = true;
-    flagged = true;
-}
-
-bool CorrelationList::IsFlagged() const {
-    return flagged;
+void Correlator::Clear(const size_t &pixel) {
+    flagged[pixel] = false;
+    decaylist.clear(pixel);
 }
 
-void CorrelationList::clear() {
-    flagged = false;
-    vector<EventInfo>::clear();
-}
-
-void CorrelationList::PrintDecayList() const {
-    ofstream fullLog("HIS/full_decays.txt", ios::app);
+void Correlator::PrintDecayList(unsigned int fch, unsigned int bch) const {
+    cout << "Current decay list for " << fch << " , " << bch << " : " << endl;
+    size_t pixel = Pixel(fch, bch);
     stringstream str;
     DetectorDriver* driver = DetectorDriver::get();
     const double printTimeResolution = 1e-3;
-    if(empty()) {
+    if(decaylist.empty(pixel)) {
             cout << "    EMPTY" << endl;
             return;
         }
-    double firstTime = front().time;
+    const EventInfo &front = decaylist.front(pixel);
+    double firstTime = front.time;
     double lastTime = firstTime;
     time_t theTime = driver->GetWallTime(firstTime);
     str  << " " << ctime(&theTime)
-         << "    TAC: " << setw(8) << front().tof
+         << "    TAC: " << setw(8) << front.tof
          << ",    ts: " << fixed << setprecision(8)
          << (firstTime * Globals::get()->clockInSeconds())
          << ",    cc: " << scientific << setprecision(3)
-         << front().clockCount << endl;
+         << front.clockCount << endl;
     cout << str.str();
 #ifndef ONLINE
     fullLog << str.str();
 #endif
     str.str("");
-    for(const_iterator it = begin(); it != end(); it++) {
+    for(size_t i = 0; i < decaylist.size(pixel); i++) {
+            const EventInfo *it = &decaylist.at(pixel, i);
             double dt   = ((*it).time - firstTime) *
                           Globals::get()->clockInSeconds() / printTimeResolution;
             double dt2 = ((*it).time - lastTime) *
@@ -178,6 +160,10 @@ Correlator::~Correlator() {
                         PrintDecayList(i,j);
                 }
         }
+    if(decaylist.GetOverflows() > 0)
+        cout << "Correlator: " << decaylist.GetOverflows()
+             << " decays were dropped from full decay lists" << endl;
+    fullLog.close();
 }
 
 void Correlator::DeclarePlots() {
@@ -199,19 +185,22 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
             plot(D_CONDITION, INVALID_LOCATION);
             return;
         }
-    CorrelationList &theList = decaylist[fch][bch];
+    size_t pixel = Pixel(fch, bch);
     double lastTime = NAN;
+    double lastAllTime = NAN;
     double clockInSeconds = Globals::get()->clockInSeconds();
     switch(event.type) {
             case EventInfo::IMPLANT_EVENT:
-                if(theList.IsFlagged()) {
+                if(flagged[pixel]) {
                         PrintDecayList(fch, bch);
                     }
                 lastTime = GetImplantTime(fch, bch);
-                theList.clear();
+                // the last implant may be in this pixel so take it first
+                lastAllTime = GetImplantTime();
+                Clear(pixel);
                 condition = VALID_IMPLANT;
-                if(lastImplant != NULL) {
-                        double dt = event.time - lastImplant->time;
+                if(!isnan(lastAllTime)) {
+                        double dt = event.time - lastAllTime;
                         plot(D_TIME_BW_ALL_IMPLANTS, dt * clockInSeconds / 1e-6);
                     }
                 if(!isnan(lastTime)) {
@@ -223,14 +212,14 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
                         event.dtime = INFINITY;
                     }
                 event.generation = 0;
-                theList.push_back(event);
-                lastImplant = &theList.back();
+                decaylist.push_back(pixel, event);
+                lastImplant = decaylist.handle(pixel, 0);
                 break;
             default:
-                if(theList.empty()) {
+                if(decaylist.empty(pixel)) {
                         break;
                     }
-                if(isnan(theList.GetImplantTime())) {
+                if(isnan(GetImplantTime(fch, bch))) {
                         cout << "No implant time for decay list" << endl;
                         break;
                     }
@@ -241,13 +230,13 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
                         condition = VALID_DECAY;
                     }
                 condition = VALID_DECAY; // tmp -- DTM
-                lastTime = theList.back().time;
-                double dt = event.time - theList.GetImplantTime();
+                lastTime = decaylist.back(pixel).time;
+                double dt = event.time - GetImplantTime(fch, bch);
                 if(dt < 0) {
                         if(dt < -5e11 && event.time < 1e9) {
                                 cout << "Decay following pixie clock reset, clearing decay lists!" << endl;
                                 cout << "  Event time: " << event.time
-                                     << "\n  Implant time: " << theList.GetImplantTime()
+                                     << "\n  Implant time: " << GetImplantTime(fch, bch)
                                      << "\n  DT: " << dt << endl;
                                 // PIXIE's clock has most likely been zeroed due to a file marker
                                 //   no chance of doing correlations
@@ -256,30 +245,30 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
                                                 if(IsFlagged(i,j)) {
                                                         PrintDecayList(i, j);
                                                     }
-                                                decaylist[i][j].clear();
+                                                Clear(Pixel(i, j));
                                             }
                                     }
                             }
                         else if(event.type != EventInfo::GAMMA_EVENT) {
                                 // since gammas are processed at a different time than everything else
                                 cout << "negative correlation time, DECAY: " << event.time
-                                     << " IMPLANT: " << theList.GetImplantTime()
+                                     << " IMPLANT: " << GetImplantTime(fch, bch)
                                      << " DT: " << dt << endl;
                             }
                         event.dtime = NAN;
                         break;
                     } // negative correlation itme
-                if(theList.front().dtime * clockInSeconds >= minImpTime) {
+                if(decaylist.front(pixel).dtime * clockInSeconds >= minImpTime) {
                         if(dt * clockInSeconds < corrTime) {
                                 // event.dtime = event.time - lastTime; // (FOR CHAINS)
-                                event.dtime = event.time - theList.front().time; // FOR LERIBSS
+                                event.dtime = event.time - decaylist.front(pixel).time; // FOR LERIBSS
                                 if(event.dtime * clockInSeconds < fastTime && event.dtime > 0) {
                                         // event.flagged = true;
                                     }
                             }
                         else {
                                 // event.dtime = event.time - lastTime; // (FOR CHAINS)
-                                event.dtime = event.time - theList.front().time; // FOR LERIBSS
+                                event.dtime = event.time - decaylist.front(pixel).time; // FOR LERIBSS
                                 condition = DECAY_TOO_LATE;
                             }
                     }
@@ -287,18 +276,21 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
                         condition = IMPLANT_TOO_SOON;
                     }
                 if(condition == VALID_DECAY) {
-                        event.generation = theList.back().generation + 1;
+                        event.generation = decaylist.back(pixel).generation + 1;
                     }
-                theList.push_back(event);
+                // a full list keeps its earlier generations and drops this one
+                bool isStored = decaylist.push_back(pixel, event);
                 if(event.energy == 0 && isnan(event.time))
                     cout << " Adding zero decay event " << endl;
                 if(event.flagged)
-                    theList.Flag();
+                    flagged[pixel] = true;
                 if(condition == VALID_DECAY) {
-                        lastDecay = &theList.back();
+                        lastDecay = isStored ?
+                            decaylist.handle(pixel, decaylist.size(pixel) - 1) :
+                            PixelHistory<EventInfo>::Handle();
                     }
                 else if(condition == DECAY_TOO_LATE) {
-                        theList.clear();
+                        Clear(pixel);
                     }
                 break;
         }
@@ -308,9 +300,9 @@ void Correlator::Correlate(EventInfo &event, unsigned int fch,
 void Correlator::CorrelateAll(EventInfo &event) {
     for(unsigned int fch=0; fch < arraySize; fch++) {
             for(unsigned int bch=0; bch < arraySize; bch++) {
-                    if(decaylist[fch][bch].size() == 0)
+                    if(decaylist.empty(Pixel(fch, bch)))
                         continue;
-                    if(event.time - decaylist[fch][bch].back().time <
+                    if(event.time - decaylist.back(Pixel(fch, bch)).time <
                             10e-6 / Globals::get()->clockInSeconds()) {
                             // only correlate fast events for now
                             Correlate(event, fch, bch);
@@ -332,41 +324,55 @@ void Correlator::CorrelateAllY(EventInfo &event, unsigned int fch) {
 }
 
 double Correlator::GetDecayTime(void) const {
-    if(lastDecay == NULL) {
+    const EventInfo *decay = decaylist.get(lastDecay);
+    if(decay == NULL) {
             return NAN;
         }
     else {
-            return lastDecay->dtime;
+            return decay->dtime;
         }
 }
 
 double Correlator::GetDecayTime(int fch, int bch) const {
-    return decaylist[fch][bch].GetDecayTime();
+    size_t pixel = Pixel(fch, bch);
+    if(decaylist.empty(pixel) ||
+       decaylist.back(pixel).type == EventInfo::IMPLANT_EVENT) {
+            return NAN;
+        }
+    else {
+            return decaylist.back(pixel).dtime;
+        }
 }
 
 double Correlator::GetImplantTime(void) const {
-    if(lastImplant == NULL) {
+    const EventInfo *implant = decaylist.get(lastImplant);
+    if(implant == NULL) {
             return NAN;
         }
     else {
-            return lastImplant->time;
+            return implant->time;
         }
 }
 
 double Correlator::GetImplantTime(int fch, int bch) const {
-    return decaylist[fch][bch].GetImplantTime();
+    size_t pixel = Pixel(fch, bch);
+    if(decaylist.empty(pixel) ||
+       decaylist.front(pixel).type != EventInfo::IMPLANT_EVENT) {
+            return NAN;
+        }
+    else {
+            return decaylist.front(pixel).time;
+        }
 }
 
 void Correlator::Flag(int fch, int bch) {
-    if(!decaylist[fch][bch].empty())
-        decaylist[fch][bch].Flag();
+    size_t pixel = Pixel(fch, bch);
+    if(decaylist.empty(pixel))
+        return;
+    decaylist.back(pixel).flagged = true;
+    flagged[pixel] = true;
 }
 
 bool Correlator::IsFlagged(int fch, int bch) {
-    return decaylist[fch][bch].IsFlagged();
-}
-
-void Correlator::PrintDecayList(unsigned int fch, unsigned int bch) const {
-    cout << "Current decay list for " << fch << " , " << bch << " : " << endl;
-    decaylist[fch][bch].PrintDecayList();
+    return flagged[Pixel(fch, bch)];
 }
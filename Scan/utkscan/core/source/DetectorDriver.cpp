@@ -20,6 +20,7 @@
 #include "HighResTimingData.hpp"
 #include "RandomPool.hpp"
 #include "RawEvent.hpp"
+#include "StageProfiler.hpp"
 #include "TreeCorrelator.hpp"
 
 #include "BetaScintProcessor.hpp"
@@ -66,8 +67,11 @@ DetectorDriver* DetectorDriver::get() {
     return instance;
 }
 
-DetectorDriver::DetectorDriver() : histo(OFFSET, RANGE, "DetectorDriver") {
-    cfg_ = Globals::get()->configfile();
+///The name of the DetectorDriver in the stage timing summary
+static const string driverName = "DetectorDriver";
+
+DetectorDriver::DetectorDriver() : histo(OFFSET, RANGE, "DetectorDriver"),
+    plotStageTimes_(false), processTimer_(driverName, "ProcessEvent") {
     Messenger m;
     try {
         m.start("Loading Processors");
@@ -88,6 +92,11 @@ DetectorDriver::DetectorDriver() : histo(OFFSET, RANGE, "DetectorDriver") {
 }
 
 DetectorDriver::~DetectorDriver() {
+    StageProfiler *profiler = StageProfiler::get();
+    if (plotStageTimes_)
+        profiler->Plot(histo, DD_STAGE_TIMES);
+    profiler->PrintSummary(cout);
+
     for (vector<EventProcessor *>::iterator it = vecProcess.begin();
 	 it != vecProcess.end(); it++)
         delete(*it);
@@ -101,18 +110,14 @@ DetectorDriver::~DetectorDriver() {
 }
 
 void DetectorDriver::LoadProcessors(Messenger& m) {
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(cfg_.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file " << cfg_;
-        ss << " : " << result.description();
-        throw IOException(ss.str());
-    }
-
     DetectorLibrary::get();
 
-    pugi::xml_node driver = doc.child("Configuration").child("DetectorDriver");
+    pugi::xml_node driver =
+        Globals::get()->configuration().child("DetectorDriver");
+    StageProfiler::SetEnabled(driver.attribute("profile").as_bool(true));
+    plotStageTimes_ = StageProfiler::IsEnabled() &&
+        driver.attribute("profile_histogram").as_bool(false);
+
     for (pugi::xml_node processor = driver.child("Processor"); processor;
         processor = processor.next_sibling("Processor")) {
         string name = processor.attribute("name").value();
@@ -170,10 +175,23 @@ void DetectorDriver::LoadProcessors(Messenger& m) {
                 processor.attribute("cycle_gate2_max").as_double(0.0);
             if (cycle_gate2_max == 0.0)
                 m.warning("Using default cycle_gate2_max = 0.0", 1);
-            vecProcess.push_back(new GeProcessor(gamma_threshold, low_ratio,
+            GeProcessor *ge = new GeProcessor(gamma_threshold, low_ratio,
                 high_ratio, sub_event, gamma_beta_limit, gamma_gamma_limit,
                 cycle_gate1_min, cycle_gate1_max, cycle_gate2_min,
-                cycle_gate2_max));
+                cycle_gate2_max);
+            for (pugi::xml_node matrix = processor.child("Matrix"); matrix;
+                 matrix = matrix.next_sibling("Matrix")) {
+                CoincidenceMatrix cm;
+                cm.id = matrix.attribute("id").as_int(-1);
+                cm.title = matrix.attribute("title").as_string("Gamma gamma");
+                cm.window = matrix.attribute("window").as_double(
+                    gamma_gamma_limit);
+                cm.isBetaGated = matrix.attribute("beta_gated").as_bool(false);
+                cm.isCrossGroup =
+                    matrix.attribute("cross_clover").as_bool(true);
+                ge->AddCoincidenceMatrix(cm);
+            }
+            vecProcess.push_back(ge);
         } else if (name == "GeCalibProcessor") {
             double gamma_threshold =
                 processor.attribute("gamma_threshold").as_double(1);
@@ -210,7 +228,9 @@ void DetectorDriver::LoadProcessors(Messenger& m) {
         } else if (name == "DoubleBetaProcessor") {
             vecProcess.push_back(new DoubleBetaProcessor());
         } else if (name == "PspmtProcessor") {
-                vecProcess.push_back(new PspmtProcessor());
+            string correction =
+                processor.attribute("correction_map").as_string("");
+            vecProcess.push_back(new PspmtProcessor(correction));
         } else if (name == "TemplateProcessor") {
             vecProcess.push_back(new TemplateProcessor());
         } else if (name == "TemplateExpProcessor") {
@@ -261,7 +281,10 @@ void DetectorDriver::LoadProcessors(Messenger& m) {
             vecAnalyzer.push_back(new WaaAnalyzer());
         } else if (name == "FittingAnalyzer") {
             string type = analyzer.attribute("type").as_string();
-            vecAnalyzer.push_back(new FittingAnalyzer(type));
+            bool isBatch = analyzer.attribute("batch").as_bool(false);
+            unsigned int numThreads = analyzer.attribute("threads").as_uint(0);
+            vecAnalyzer.push_back(new FittingAnalyzer(type, isBatch,
+                                                      numThreads));
         } else {
             stringstream ss;
             ss << "DetectorDriver: unknown analyzer type" << name;
@@ -311,11 +334,23 @@ void DetectorDriver::Init(RawEvent& rawev) {
 }
 
 void DetectorDriver::ProcessEvent(RawEvent& rawev) {
+    processTimer_.Start();
     plot(dammIds::raw::D_NUMBER_OF_EVENTS, dammIds::GENERIC_CHANNEL);
     try {
+        //!The traces are analyzed for the whole event before any calibration
+        //!so that analyzers can defer their work and do it in one batch.
         for (vector<ChanEvent*>::const_iterator it = rawev.GetEventList().begin();
              it != rawev.GetEventList().end(); ++it) {
             PlotRaw((*it));
+            AnalyzeTrace((*it));
+        }
+
+        for (vector<TraceAnalyzer *>::iterator it = vecAnalyzer.begin();
+             it != vecAnalyzer.end(); it++)
+            (*it)->Flush();
+
+        for (vector<ChanEvent*>::const_iterator it = rawev.GetEventList().begin();
+             it != rawev.GetEventList().end(); ++it) {
             ThreshAndCal((*it), rawev);
             PlotCal((*it));
 
@@ -337,15 +372,27 @@ void DetectorDriver::ProcessEvent(RawEvent& rawev) {
         //!First round is preprocessing, where process result must be guaranteed
         //!to not to be dependent on results of other Processors.
         for (vector<EventProcessor*>::iterator iProc = vecProcess.begin();
-        iProc != vecProcess.end(); iProc++)
-            if ( (*iProc)->HasEvent() )
+        iProc != vecProcess.end(); iProc++) {
+            if ( (*iProc)->HasEvent() ) {
+                StageTimer &timer = (*iProc)->GetPreProcessTimer();
+                timer.Start();
                 (*iProc)->PreProcess(rawev);
+                timer.Stop();
+            }
+        }
         ///In the second round the Process is called, which may depend on other
         ///Processors.
         for (vector<EventProcessor *>::iterator iProc = vecProcess.begin();
-        iProc != vecProcess.end(); iProc++)
-            if ( (*iProc)->HasEvent() )
-                (*iProc)->Process(rawev);
+        iProc != vecProcess.end(); iProc++) {
+            bool didProcess = false;
+            if ( (*iProc)->HasEvent() ) {
+                StageTimer &timer = (*iProc)->GetProcessTimer();
+                timer.Start();
+                didProcess = (*iProc)->Process(rawev);
+                timer.Stop();
+            }
+            (*iProc)->SetDidProcess(didProcess);
+        }
         // Clear all places in correlator (if of resetable type)
 	for (map<string, Place*>::iterator it = 
 		 TreeCorrelator::get()->places_.begin(); 
@@ -362,6 +409,7 @@ void DetectorDriver::ProcessEvent(RawEvent& rawev) {
         cout << "Warning caught at DetectorDriver::ProcessEvent" << endl;
         cout << "\t" << w.what() << endl;
     }
+    processTimer_.Stop();
 }
 
 void DetectorDriver::DeclarePlots() {
@@ -369,6 +417,9 @@ void DetectorDriver::DeclarePlots() {
         DeclareHistogram1D(D_HIT_SPECTRUM, S7, "channel hit spectrum");
         DeclareHistogram2D(DD_RUNTIME_SEC, SE, S6, "run time - s");
         DeclareHistogram2D(DD_RUNTIME_MSEC, SE, S7, "run time - ms");
+        if (plotStageTimes_)
+            DeclareHistogram2D(DD_STAGE_TIMES, S7, S6,
+                               "time per call (4 bins/octave ns) vs stage");
 
         if(Globals::get()->hasRaw()) {
             DetectorLibrary* modChan = DetectorLibrary::get();
@@ -430,12 +481,28 @@ void DetectorDriver::DeclarePlots() {
     }
 }
 
+void DetectorDriver::AnalyzeTrace(ChanEvent *chan) {
+    const Identifier &chanId = chan->GetChanID();
+    const string &type = chanId.GetType();
+    Trace &trace = chan->GetTrace();
+
+    if (type == "ignore" || type == "" || trace.empty())
+        return;
+
+    plot(D_HAS_TRACE, chan->GetID());
+
+    map<string, int> tags = chanId.GetTagMap();
+    for (vector<TraceAnalyzer *>::iterator it = vecAnalyzer.begin();
+         it != vecAnalyzer.end(); it++) {
+        (*it)->Analyze(trace, type, chanId.GetSubtype(), tags);
+    }
+}
+
 int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev) {
     Identifier chanId = chan->GetChanID();
     int id            = chan->GetID();
     string type       = chanId.GetType();
     string subtype    = chanId.GetSubtype();
-    map<string, int> tags = chanId.GetTagMap();
     bool hasStartTag  = chanId.HasTag("start");
     Trace &trace      = chan->GetTrace();
 
@@ -447,34 +514,38 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev) {
         return(0);
 
     if ( !trace.empty() ) {
-        plot(D_HAS_TRACE, id);
-
-        for (vector<TraceAnalyzer *>::iterator it = vecAnalyzer.begin();
-            it != vecAnalyzer.end(); it++) {
-            (*it)->Analyze(trace, type, subtype, tags);
-        }
-
         if (trace.HasValue("filterEnergy") ) {
+            /** filterEnergyCal is only set for a positive filter energy,
+             * the first pulse then keeps a calibrated energy of zero. */
+            double calEnergy = 0.0;
             if (trace.GetValue("filterEnergy") > 0) {
                 energy = trace.GetValue("filterEnergy");
                 plot(D_FILTER_ENERGY + id, energy);
-                trace.SetValue("filterEnergyCal",
-                    cali.GetCalEnergy(chanId, trace.GetValue("filterEnergy")));
+                calEnergy = cali.GetCalEnergy(chanId, energy);
+                trace.SetValue("filterEnergyCal", calEnergy);
             } else {
                 energy = 0.0;
             }
 
             /** Calibrate pulses numbered 2 and forth,
-             * add filterEnergyXCal to the trace */
+             * add filterEnergyXCal to the trace. All of the pulses are
+             * also stored by index so that the processors do not need to
+             * format the names again. */
+            trace.AddPulse(trace.GetValue("filterEnergy"), calEnergy,
+                           trace.GetValue("filterTime"));
             int pulses = trace.GetValue("numPulses");
             for (int i = 1; i < pulses; ++i) {
                 stringstream energyName;
                 energyName << "filterEnergy" << i + 1;
                 stringstream energyCalName;
                 energyCalName << "filterEnergy" << i + 1 << "Cal";
-                trace.SetValue(energyCalName.str(),
-                    cali.GetCalEnergy(chanId,
-                                      trace.GetValue(energyName.str())));
+                stringstream timeName;
+                timeName << "filterTime" << i + 1;
+                double pulseEnergy = trace.GetValue(energyName.str());
+                double pulseCalEnergy = cali.GetCalEnergy(chanId, pulseEnergy);
+                trace.SetValue(energyCalName.str(), pulseCalEnergy);
+                trace.AddPulse(pulseEnergy, pulseCalEnergy,
+                               trace.GetValue(timeName.str()));
             }
         }
 
@@ -549,19 +620,10 @@ EventProcessor* DetectorDriver::GetProcessor(const std::string& name) const {
 }
 
 void DetectorDriver::ReadCalXml() {
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(cfg_.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file" << cfg_;
-        ss << " : " << result.description();
-        throw GeneralException(ss.str());
-    }
-
     Messenger m;
     m.start("Loading Calibration");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node map = Globals::get()->configuration().child("Map");
 
     /** Note that before this reading in of the xml file, it was already
      * processed for the purpose of creating the channels map.
@@ -621,20 +683,10 @@ void DetectorDriver::ReadCalXml() {
 }
 
 void DetectorDriver::ReadWalkXml() {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file(cfg_.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file " << cfg_;
-        ss << " : " << result.description();
-        throw GeneralException(ss.str());
-    }
-
     Messenger m;
     m.start("Loading Walk Corrections");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node map = Globals::get()->configuration().child("Map");
     /** See comment in the similiar place at ReadCalXml() */
     bool verbose = map.attribute("verbose_walk").as_bool();
     for (pugi::xml_node module = map.child("Module"); module;
@@ -45,16 +45,6 @@ DetectorLibrary::DetectorLibrary() : vector<Identifier>(), locations(),
 }
 
 void DetectorLibrary::LoadXml() {
-    string cfg = Globals::get()->configfile();
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(cfg.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorLibrary: error parsing file " << cfg;
-        ss << " : " << result.description();
-        cout << ss.str() << endl;
-    }
-
     Messenger m;
     m.start("Loading channels map");
 
@@ -67,9 +57,10 @@ void DetectorLibrary::LoadXml() {
     reserved.insert("location");
     reserved.insert("tags");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node config = Globals::get()->configuration();
+    pugi::xml_node map = config.child("Map");
     bool verbose = map.attribute("verbose_map").as_bool();
-    pugi::xml_node tree = doc.child("Configuration").child("TreeCorrelator");
+    pugi::xml_node tree = config.child("TreeCorrelator");
     bool verbose_tree = tree.attribute("verbose").as_bool(false);
     for (pugi::xml_node module = map.child("Module"); module;
          module = module.next_sibling("Module")) {
@@ -0,0 +1,358 @@
+/** \file EventSkimmer.cpp
+ * \brief Writes the events passing a selection into a new list mode file
+ * \date October 19, 2026
+ */
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "hribf_buffers.h"
+#include "XiaData.hpp"
+
+#include "DetectorDriver.hpp"
+#include "DetectorLibrary.hpp"
+#include "EventProcessor.hpp"
+#include "EventSkimmer.hpp"
+#include "Exceptions.hpp"
+#include "Globals.hpp"
+#include "Messenger.hpp"
+#include "RawEvent.hpp"
+
+using namespace std;
+
+namespace skim {
+    /** The largest module buffer accepted by the unpacker */
+    const unsigned int maxModuleWords = 131072;
+    /** The largest spill accepted by the unpacker, with the end of spill */
+    const unsigned int maxSpillWords = 1000000 - 2;
+    /** The number of modules in a crate */
+    const unsigned int maxVsn = 14;
+}
+
+EventSkimmer *EventSkimmer::instance_ = NULL;
+
+EventSkimmer *EventSkimmer::get(void) {
+    if (!instance_)
+        instance_ = new EventSkimmer();
+    return instance_;
+}
+
+EventSkimmer::EventSkimmer() : isEnabled_(false), isResolved_(false),
+    requireAll_(true), keep_(false), veto_(false), output_(NULL),
+    spillWords_(500000), storedWords_(0), numEvents_(0), numKept_(0),
+    firstTime_(0), lastTime_(0) {
+}
+
+EventSkimmer::~EventSkimmer() {
+    Close();
+}
+
+void EventSkimmer::Init(const pugi::xml_node &node) {
+    if (!node || isEnabled_)
+        return;
+
+    Messenger m;
+    m.start("Loading the event skim");
+    stringstream ss;
+
+    string logic = node.attribute("logic").as_string("all");
+    if (logic != "all" && logic != "any")
+        throw GeneralException("EventSkimmer::Init : The logic of the Skim "
+                               "must be all or any, not " + logic);
+    requireAll_ = (logic == "all");
+
+    spillWords_ = node.attribute("spill_words").as_uint(spillWords_);
+    if (spillWords_ < skim::maxModuleWords / 4 ||
+        spillWords_ > skim::maxSpillWords) {
+        ss << "EventSkimmer::Init : spill_words must be between "
+           << skim::maxModuleWords / 4 << " and " << skim::maxSpillWords;
+        throw GeneralException(ss.str());
+    }
+
+    for (pugi::xml_node_iterator it = node.begin(); it != node.end(); ++it) {
+        string name = it->name();
+        SkimCondition cond;
+        cond.proc = NULL;
+        cond.minEnergy = it->attribute("min").as_double(
+            -numeric_limits<double>::max());
+        cond.maxEnergy = it->attribute("max").as_double(
+            numeric_limits<double>::max());
+        cond.useRaw = it->attribute("raw").as_bool(false);
+        cond.minMult = it->attribute("min_mult").as_uint(1);
+        cond.maxMult = it->attribute("max_mult").as_uint(
+            numeric_limits<unsigned int>::max());
+        cond.veto = it->attribute("veto").as_bool(false);
+
+        if (name == "Channel") {
+            cond.type = it->attribute("type").as_string();
+            cond.subtype = it->attribute("subtype").as_string();
+            if (cond.type.empty())
+                throw GeneralException("EventSkimmer::Init : A Channel "
+                                       "condition needs a type");
+            ss << (cond.veto ? "Veto " : "Require ") << cond.minMult;
+            if (cond.maxMult != numeric_limits<unsigned int>::max())
+                ss << " to " << cond.maxMult;
+            ss << " of " << cond.type;
+            if (!cond.subtype.empty())
+                ss << ":" << cond.subtype;
+            if (it->attribute("min") || it->attribute("max"))
+                ss << " from " << cond.minEnergy << " to " << cond.maxEnergy
+                   << (cond.useRaw ? " (raw)" : "");
+        } else if (name == "Processor") {
+            cond.processor = it->attribute("name").as_string();
+            if (cond.processor.empty())
+                throw GeneralException("EventSkimmer::Init : A Processor "
+                                       "condition needs a name");
+            ss << (cond.veto ? "Veto " : "Require ") << cond.processor;
+        } else {
+            ss << "Unknown parameter in Skim : " << name;
+            m.warning(ss.str());
+            ss.str("");
+            continue;
+        }
+        m.detail(ss.str());
+        ss.str("");
+        conditions_.push_back(cond);
+    }
+    counts_.resize(conditions_.size());
+
+    output_ = new PollOutputFile();
+    output_->SetFileFormat(1);
+    unsigned int run = node.attribute("run").as_uint(1);
+    string prefix = node.attribute("output").as_string("skim");
+    string dir = node.attribute("directory").as_string("./");
+    if (!dir.empty() && dir[dir.size() - 1] != '/')
+        dir += "/";
+    if (!output_->OpenNewFile(node.attribute("title").as_string("utkscan skim"),
+                              run, prefix, dir)) {
+        delete output_;
+        output_ = NULL;
+        throw GeneralException("EventSkimmer::Init : Could not open the "
+                               "skim output " + dir + prefix);
+    }
+
+    ss << "Writing the events with " << logic << " of the conditions to "
+       << output_->GetCurrentFilename();
+    m.detail(ss.str());
+    if (conditions_.empty())
+        m.detail("No conditions, only events kept by a processor are written");
+    m.done();
+
+    isEnabled_ = true;
+}
+
+void EventSkimmer::Resolve(void) {
+    DetectorLibrary *modChan = DetectorLibrary::get();
+    for (vector<SkimCondition>::iterator it = conditions_.begin();
+         it != conditions_.end(); it++) {
+        if (!it->processor.empty()) {
+            it->proc = DetectorDriver::get()->GetProcessor(it->processor);
+            if (!it->proc)
+                throw GeneralException("EventSkimmer::Resolve : The skim "
+                                       "uses " + it->processor +
+                                       " which is not in the analysis");
+            continue;
+        }
+        it->channels.assign(modChan->size(), false);
+        for (size_t id = 0; id < modChan->size(); id++) {
+            const Identifier &chan = (*modChan)[id];
+            it->channels[id] = chan.GetType() == it->type &&
+                (it->subtype.empty() || chan.GetSubtype() == it->subtype);
+        }
+    }
+    isResolved_ = true;
+}
+
+bool EventSkimmer::Select(const RawEvent &event) {
+    if (conditions_.empty())
+        return false;
+
+    fill(counts_.begin(), counts_.end(), 0);
+    const vector<ChanEvent*> &list = event.GetEventList();
+    for (vector<ChanEvent*>::const_iterator it = list.begin();
+         it != list.end(); it++) {
+        size_t id = (*it)->GetID();
+        for (size_t i = 0; i < conditions_.size(); i++) {
+            const SkimCondition &cond = conditions_[i];
+            if (cond.proc || id >= cond.channels.size() || !cond.channels[id])
+                continue;
+            double energy = cond.useRaw ? (*it)->GetEnergy() :
+                            (*it)->GetCalEnergy();
+            if (energy >= cond.minEnergy && energy <= cond.maxEnergy)
+                counts_[i]++;
+        }
+    }
+
+    for (size_t i = 0; i < conditions_.size(); i++) {
+        const SkimCondition &cond = conditions_[i];
+        bool pass;
+        if (cond.proc)
+            pass = cond.proc->DidProcess();
+        else
+            pass = counts_[i] >= cond.minMult && counts_[i] <= cond.maxMult;
+        if (cond.veto)
+            pass = !pass;
+        if (requireAll_ && !pass)
+            return false;
+        if (!requireAll_ && pass)
+            return true;
+    }
+    return requireAll_;
+}
+
+void EventSkimmer::Process(const RawEvent &event,
+                           const deque<XiaData*> &channels) {
+    if (!isEnabled_)
+        return;
+    if (!isResolved_)
+        Resolve();
+
+    numEvents_++;
+    bool kept = !veto_ && (keep_ || Select(event));
+    keep_ = veto_ = false;
+    if (!kept)
+        return;
+
+    // Encode the whole event first so that it is never split between spills
+    words_.clear();
+    ends_.clear();
+    double first = numeric_limits<double>::max();
+    double last = -numeric_limits<double>::max();
+    for (deque<XiaData*>::const_iterator it = channels.begin();
+         it != channels.end(); it++) {
+        if (!*it)
+            continue;
+        Encode(**it, words_);
+        ends_.push_back(make_pair((*it)->modNum, words_.size()));
+        first = min(first, (*it)->time);
+        last = max(last, (*it)->time);
+    }
+    if (ends_.empty())
+        return;
+
+    // The channels of a module all go into its block, so the limit on the
+    // block is checked against their sum
+    eventWords_.clear();
+    size_t start = 0;
+    for (size_t i = 0; i < ends_.size(); i++) {
+        unsigned int mod = ends_[i].first;
+        if (mod >= eventWords_.size())
+            eventWords_.resize(mod + 1, 0);
+        eventWords_[mod] += ends_[i].second - start;
+        start = ends_[i].second;
+    }
+
+    bool isFull = storedWords_ + words_.size() > spillWords_;
+    for (size_t mod = 0; mod < eventWords_.size() && !isFull; mod++) {
+        if (eventWords_[mod] == 0)
+            continue;
+        size_t stored = mod < modules_.size() ? modules_[mod].size() : 0;
+        isFull = stored + 2 + eventWords_[mod] > skim::maxModuleWords;
+    }
+    if (isFull)
+        Flush();
+
+    start = 0;
+    for (size_t i = 0; i < ends_.size(); i++) {
+        unsigned int mod = ends_[i].first;
+        if (mod >= modules_.size())
+            modules_.resize(mod + 1);
+        modules_[mod].insert(modules_[mod].end(), words_.begin() + start,
+                             words_.begin() + ends_[i].second);
+        start = ends_[i].second;
+    }
+    storedWords_ += words_.size();
+
+    if (numKept_ == 0)
+        firstTime_ = first;
+    lastTime_ = max(lastTime_, last);
+    numKept_++;
+}
+
+void EventSkimmer::Encode(const XiaData &chan, vector<uint32_t> &words) {
+    bool hasQdc = false;
+    for (int i = 0; i < XiaData::numQdcs && !hasQdc; i++)
+        hasQdc = chan.qdcValue[i] != 0;
+
+    unsigned int headerLength = hasQdc ? 12 : 4;
+    unsigned int traceLength = chan.adcTrace.size();
+    traceLength += traceLength % 2;
+    unsigned int eventLength = headerLength + traceLength / 2;
+
+    unsigned int crate = chan.modNum / 100;
+    unsigned int slot = chan.slotNum ? chan.slotNum : chan.modNum % 100 + 2;
+
+    uint32_t word0 = (chan.chanNum & 0xF) | ((slot & 0xF) << 4) |
+        ((crate & 0xF) << 8) | (headerLength << 12) |
+        ((eventLength & 0xFFF) << 17);
+    if (chan.virtualChannel)
+        word0 |= 0x20000000;
+    if (chan.saturatedBit)
+        word0 |= 0x40000000;
+    if (chan.pileupBit)
+        word0 |= 0x80000000;
+
+    words.push_back(word0);
+    words.push_back(chan.eventTimeLo);
+    words.push_back((chan.eventTimeHi & 0xFFFF) | (chan.cfdTime << 16));
+    words.push_back(((uint32_t)chan.energy & 0xFFFF) | (traceLength << 16));
+    if (hasQdc)
+        words.insert(words.end(), chan.qdcValue,
+                     chan.qdcValue + XiaData::numQdcs);
+
+    // Two samples per word, the first sample in the low half
+    const vector<int> &trace = chan.adcTrace;
+    for (size_t i = 0; i + 1 < trace.size(); i += 2)
+        words.push_back((trace[i] & 0xFFFF) | ((trace[i + 1] & 0xFFFF) << 16));
+    if (trace.size() % 2)
+        words.push_back(trace.back() & 0xFFFF);
+}
+
+void EventSkimmer::Flush(void) {
+    if (storedWords_ == 0 || !output_)
+        return;
+
+    // The unpacker expects the modules of a spill to follow each other
+    // from the first one, so every crate is written into its own spill.
+    for (size_t first = 0; first < modules_.size(); first += 100) {
+        size_t last = min(modules_.size(), first + skim::maxVsn);
+        size_t used = first;
+        for (size_t mod = first; mod < last; mod++)
+            if (!modules_[mod].empty())
+                used = mod + 1;
+        if (used == first)
+            continue;
+
+        spill_.clear();
+        for (size_t mod = first; mod < used; mod++) {
+            spill_.push_back(modules_[mod].size() + 2);
+            spill_.push_back(mod - first);
+            spill_.insert(spill_.end(), modules_[mod].begin(),
+                         modules_[mod].end());
+            modules_[mod].clear();
+        }
+        if (output_->Write((char*)&spill_[0], spill_.size()) < 0)
+            throw GeneralException("EventSkimmer::Flush : Could not write "
+                                   "to " + output_->GetCurrentFilename());
+    }
+    storedWords_ = 0;
+}
+
+void EventSkimmer::Close(void) {
+    if (!isEnabled_)
+        return;
+    isEnabled_ = false;
+
+    Flush();
+    double runTime = (lastTime_ - firstTime_) *
+        Globals::get()->clockInSeconds();
+    output_->CloseFile(runTime);
+
+    cout << "EventSkimmer : Kept " << numKept_ << " of " << numEvents_
+         << " events in " << output_->GetNumberSpills() << " spills of "
+         << output_->GetCurrentFilename() << endl;
+
+    delete output_;
+    output_ = NULL;
+}
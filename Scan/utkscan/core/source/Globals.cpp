@@ -24,8 +24,8 @@ Globals::Globals(const std::string &file) {
     numTraces_ = 16;
 
     try {
-        pugi::xml_document doc;
-        pugi::xml_parse_result result = doc.load_file(configFile_.c_str());
+        pugi::xml_parse_result result =
+            configDoc_.load_file(configFile_.c_str());
 
         std::stringstream ss;
         if (!result) {
@@ -33,15 +33,20 @@ Globals::Globals(const std::string &file) {
             ss << " : " << result.description();
             throw GeneralException(ss.str());
         }
+        if (!configuration()) {
+            ss << "Globals : the file " << configFile_
+               << " has no Configuration node.";
+            throw GeneralException(ss.str());
+        }
 
         Messenger m;
         pugi::xml_node description =
-                doc.child("Configuration").child("Description");
+                configuration().child("Description");
         std::string desc_text = description.text().get();
         m.detail("Experiment: " + desc_text);
 
         m.start("Loading global parameters");
-        pugi::xml_node global = doc.child("Configuration").child("Global");
+        pugi::xml_node global = configuration().child("Global");
         for (pugi::xml_node_iterator it = global.begin();
              it != global.end(); ++it) {
             if (std::string(it->name()).compare("Revision") == 0) {
@@ -116,7 +121,7 @@ Globals::Globals(const std::string &file) {
         numTraces_ = power2;
 
         m.detail("Loading rejection regions");
-        pugi::xml_node reject = doc.child("Configuration").child("Reject");
+        pugi::xml_node reject = configuration().child("Reject");
         for (pugi::xml_node time = reject.child("Time"); time;
              time = time.next_sibling("Time")) {
             int start = time.attribute("start").as_int(-1);
@@ -138,7 +143,7 @@ Globals::Globals(const std::string &file) {
             hasReject_ = true;
         }
 
-        pugi::xml_node phys = doc.child("Configuration").child("Physical");
+        pugi::xml_node phys = configuration().child("Physical");
         for (pugi::xml_node_iterator it = phys.begin();
              it != phys.end(); ++it) {
             if (std::string(it->name()).compare("NeutronMass") == 0)
@@ -161,7 +166,7 @@ Globals::Globals(const std::string &file) {
                 WarnOfUnknownParameter(m, it);
         }
 
-        pugi::xml_node trc = doc.child("Configuration").child("Trace");
+        pugi::xml_node trc = configuration().child("Trace");
         for (pugi::xml_node_iterator it = trc.begin(); it != trc.end(); ++it) {
             if (std::string(it->name()).compare("DiscriminationStart") == 0)
                 discriminationStart_ = it->attribute("value").as_double(3);
@@ -200,7 +205,7 @@ Globals::Globals(const std::string &file) {
                 WarnOfUnknownParameter(m, it);
         }
 
-        pugi::xml_node fit = doc.child("Configuration").child("Fitting");
+        pugi::xml_node fit = configuration().child("Fitting");
         for (pugi::xml_node_iterator it = fit.begin(); it != fit.end(); ++it) {
             if (std::string(it->name()).compare("SigmaBaselineThresh") == 0)
                 sigmaBaselineThresh_ = it->attribute("value").as_double(3.0);
@@ -220,6 +225,11 @@ Globals::Globals(const std::string &file) {
                                                                   "Gamma").attribute(
                                                                   "value").as_double(
                                                                   0.))));
+                    if (parit->child("Fitter"))
+                        fitters_.insert(std::make_pair(
+                                parit->attribute("name").as_string(),
+                                parit->child("Fitter").attribute(
+                                        "value").as_string()));
                 }
             } else
                 WarnOfUnknownParameter(m, it);
@@ -10,6 +10,7 @@
  * \author C. R. Thornsberry
  * \date Feb. 12th, 2016
  */
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -21,6 +22,7 @@
 #include <math.h>
 
 #include "HisFile.hpp"
+#include "HisServer.hpp"
 
 /// Create a DAMM 1D histogram (implemented for backwards compatibility)
 void hd1d_(int dammId, int nHalfWords, int rawlen, int histlen, int min, int max,
@@ -705,6 +707,16 @@ void HisFile::PrintEntry(){
 // class OutputHisFile
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Order the waiting fills by their position in the .his file, the fills out
+/// of range first
+static bool fill_before(const fill_queue &a, const fill_queue &b){
+    if(a.good != b.good)
+        return(!a.good);
+    if(a.entry->offset != b.entry->offset)
+        return(a.entry->offset < b.entry->offset);
+    return(a.byte < b.byte);
+}
+
 drr_entry *OutputHisFile::find_drr_in_list(unsigned int hisId){
     std::map<unsigned int, drr_entry*>::iterator it = drrMap_.find(hisId);
     if(it != drrMap_.end())
@@ -718,17 +730,29 @@ void OutputHisFile::Flush(){
         std::cout << "debug: Flushing histogram entries to file.\n";
     
     if(writable){ // Do the filling
-        for(std::vector<fill_queue*>::iterator iter = fills_waiting.begin();
-            iter != fills_waiting.end(); iter++){
-
-            if(!(*iter)->good)
+        // Going through the file in order, with the fills of a bin added up,
+        // reads and writes each bin once instead of once per fill
+        std::sort(fills_waiting.begin(), fills_waiting.end(), fill_before);
+        
+        std::vector<fill_queue>::iterator iter = fills_waiting.begin();
+        while(iter != fills_waiting.end()){
+            if(!iter->good){
+                iter++;
                 continue;
+            }
             
-            current_entry = (*iter)->entry;
-            current_entry->good_counts++;
+            current_entry = iter->entry;
+            unsigned int byte = iter->byte;
+            std::streampos pos = current_entry->offset*2 + byte;
+            unsigned int weight = 0;
+            for(; iter != fills_waiting.end() && iter->good &&
+                    iter->entry == current_entry && iter->byte == byte; iter++){
+                current_entry->good_counts++;
+                weight += iter->weight;
+            }
             
             // Seek to the specified bin
-            ofile.seekg(current_entry->offset*2 + (*iter)->byte, std::ios::beg); // input offset
+            ofile.seekg(pos, std::ios::beg); // input offset
             
             unsigned short sval = 0;
             unsigned int ival = 0;
@@ -737,32 +761,32 @@ void OutputHisFile::Flush(){
             if(current_entry->use_int){
                 // Get the original value of the bin
                 ofile.read((char*)&ival, 4);
-                ival += (*iter)->weight;
+                ival += weight;
 		
                 // Set the new value of the bin
-                ofile.seekp(current_entry->offset*2 + (*iter)->byte, std::ios::beg); // output offset
+                ofile.seekp(pos, std::ios::beg); // output offset
                 ofile.write((char*)&ival, 4);
             }
             else{
                 // Get the original value of the bin
                 ofile.read((char*)&sval, 2);
-                sval += (short)(*iter)->weight;
+                sval += (short)weight;
 		
                 // Set the new value of the bin
-                ofile.seekp(current_entry->offset*2 + (*iter)->byte, std::ios::beg); // output offset
+                ofile.seekp(pos, std::ios::beg); // output offset
                 ofile.write((char*)&sval, 2);
             }
         }
     }
     else if(debug_mode){ std::cout << "debug: Output file is not writable!\n"; }
     
-    // Delete the drr_entries in the fill_queue vector
-    for(std::vector<fill_queue*>::iterator iter = fills_waiting.begin(); iter != fills_waiting.end(); iter++){
-        delete (*iter);
-    }
     fills_waiting.clear();
     
     Flush_count = 0;
+    
+    // Viewers see at least what is in the file
+    if(server)
+        server->Publish();
 }
 
 OutputHisFile::OutputHisFile(){
@@ -773,6 +797,7 @@ OutputHisFile::OutputHisFile(){
     Flush_wait = 100000;
     Flush_count = 0;
     total_his_size = 0;
+    server = NULL;
     
     initialize();
 }
@@ -785,6 +810,7 @@ OutputHisFile::OutputHisFile(std::string fname_prefix){
     Flush_wait = 100000;
     Flush_count = 0;
     total_his_size = 0;
+    server = NULL;
     
     initialize();
     Open(fname_prefix);
@@ -794,6 +820,15 @@ OutputHisFile::~OutputHisFile(){
     Close();
 }
 
+void OutputHisFile::SetServer(HisServer *server_){
+    server = server_;
+    if(!server)
+        return;
+    for(std::map<unsigned int, drr_entry*>::iterator iter = drrMap_.begin();
+        iter != drrMap_.end(); iter++)
+        server->Add((*iter).second);
+}
+
 size_t OutputHisFile::push_back(drr_entry *entry){
     if(!entry){ 
         if(debug_mode)
@@ -816,6 +851,8 @@ size_t OutputHisFile::push_back(drr_entry *entry){
     ofile.seekp(0, std::ios::end);
     entry->offset = (size_t)ofile.tellp()/2; // Set the file offset (in 2 byte words)
     drrMap_.insert(std::make_pair(entry->hisID,entry));
+    if(server)
+        server->Add(entry);
     
     if(debug_mode)
         std::cout << "debug: Extending .his file by " << entry->total_size
@@ -940,8 +977,9 @@ bool OutputHisFile::Fill(unsigned int hisID_, unsigned int x_, unsigned int y_,
             return(false);
         
         // Push this fill into the queue
-        fill_queue *fill = new fill_queue(temp_drr, bin, weight_);
-        fills_waiting.push_back(fill);
+        fills_waiting.push_back(fill_queue(temp_drr, bin, weight_));
+        if(server && fills_waiting.back().good)
+            server->Fill(hisID_, bin, weight_);
         
         if(++Flush_count >= Flush_wait)
             Flush();
@@ -960,8 +998,9 @@ bool OutputHisFile::FillBin(unsigned int hisID_, unsigned int x_, unsigned int y
         if(!temp_drr->get_bin(x_, y_, bin)){ return false; }
 	
         // Push this fill into the queue
-        fill_queue *fill = new fill_queue(temp_drr, bin, weight_);
-        fills_waiting.push_back(fill);
+        fills_waiting.push_back(fill_queue(temp_drr, bin, weight_));
+        if(server && fills_waiting.back().good)
+            server->Fill(hisID_, bin, weight_);
         
         if(++Flush_count >= Flush_wait){ Flush(); }
         return true;
@@ -975,6 +1014,8 @@ bool OutputHisFile::Zero(unsigned int hisID_){
     
     drr_entry *temp_drr = find_drr_in_list(hisID_);
     if(temp_drr){
+        if(server)
+            server->Zero(hisID_);
         ofile.seekp(temp_drr->offset*2, std::ios::beg);
 	
         char *block = new char[temp_drr->total_size];	
@@ -994,6 +1035,8 @@ bool OutputHisFile::Zero(){
     
     for(std::map<unsigned int, drr_entry*>::iterator iter = drrMap_.begin();
         iter != drrMap_.end(); iter++){
+        if(server)
+            server->Zero((*iter).first);
         ofile.seekp((*iter).second->offset*2, std::ios::beg);
         char *block = new char[(*iter).second->total_size];	
         memset(block, 0x0, (*iter).second->total_size);
@@ -0,0 +1,466 @@
+/** \file HisServer.cpp
+ * \brief Serves snapshots of the histograms on a unix domain socket
+ * \date October 19, 2026
+ */
+#include <algorithm>
+#include <iostream>
+
+#include <cstring>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "HisFile.hpp"
+#include "HisServer.hpp"
+
+using namespace std;
+
+namespace {
+    /** The most viewers connected at once */
+    const size_t maxClients = 64;
+
+    //! A connected viewer, its socket never blocks the server
+    struct Viewer {
+        int sock; //!< the socket
+        HisRequest request; //!< the request being read
+        size_t received; //!< the bytes of the request read so far
+        HisReply reply; //!< the header of the reply being written
+        vector<char> payload; //!< the payload of the reply being written
+        size_t sent; //!< the bytes of the reply written so far, header first
+        bool isWriting; //!< true while a reply is being written
+    };
+
+    /** Reads what has arrived of the request of a viewer
+     * \return false if the socket failed or was closed */
+    bool Receive(Viewer &viewer) {
+        while (viewer.received < sizeof(HisRequest)) {
+            ssize_t n = recv(viewer.sock, (char*)&viewer.request + viewer.received,
+                             sizeof(HisRequest) - viewer.received, 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return true;
+            if (n <= 0)
+                return false;
+            viewer.received += n;
+        }
+        return true;
+    }
+
+    /** Writes as much of the reply of a viewer as its socket takes
+     * \return false if the socket failed or was closed */
+    bool Send(Viewer &viewer) {
+        size_t total = sizeof(HisReply) + viewer.payload.size();
+        while (viewer.sent < total) {
+            const char *data;
+            size_t length;
+            if (viewer.sent < sizeof(HisReply)) {
+                data = (const char*)&viewer.reply + viewer.sent;
+                length = sizeof(HisReply) - viewer.sent;
+            } else {
+                data = viewer.payload.data() + viewer.sent - sizeof(HisReply);
+                length = total - viewer.sent;
+            }
+            ssize_t n = send(viewer.sock, data, length, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return true;
+            if (n <= 0)
+                return false;
+            viewer.sent += n;
+        }
+        viewer.isWriting = false;
+        return true;
+    }
+
+    /** Appends raw bytes to a payload */
+    void Append(vector<char> &payload, const void *data, const size_t &length) {
+        const char *bytes = (const char*)data;
+        payload.insert(payload.end(), bytes, bytes + length);
+    }
+}
+
+HisServer::HisServer() : sequence_(0), zeroPage_(new Page(pageBins, 0)),
+    interval_(chrono::seconds(1)),
+    lastPublish_(chrono::steady_clock::now()), listenSock_(-1),
+    running_(false) {
+}
+
+HisServer::~HisServer() {
+    Stop();
+}
+
+void HisServer::Add(const drr_entry *entry) {
+    shared_ptr<Block> block(new Block());
+    memset(&block->info, 0, sizeof(HisInfo));
+    block->info.hisID = entry->hisID;
+    block->info.dim = entry->hisDim;
+    block->info.halfWords = entry->halfWords;
+    block->info.xbins = entry->scaled[0];
+    block->info.ybins = entry->hisDim >= 2 ? entry->scaled[1] : 1;
+    memcpy(block->info.title, entry->title, sizeof(entry->title) - 1);
+    for (int i = strlen(block->info.title) - 1;
+         i >= 0 && block->info.title[i] == ' '; i--)
+        block->info.title[i] = '\0';
+    block->previous = 0;
+    block->sparse = false;
+    block->pages.assign((entry->total_bins + pageBins - 1) / pageBins,
+                        zeroPage_);
+
+    ids_[entry->hisID] = blocks_.size();
+    useInt_.push_back(entry->use_int);
+    blocks_.push_back(block);
+    pending_.push_back(vector<pair<uint32_t, uint32_t> >());
+    zeroed_.push_back(false);
+    isDirty_.push_back(false);
+}
+
+void HisServer::CheckPublish(void) {
+    if (queue_.size() >= maxPending ||
+        chrono::steady_clock::now() - lastPublish_ >= interval_)
+        Publish();
+}
+
+void HisServer::Publish(void) {
+    lastPublish_ = chrono::steady_clock::now();
+    if (queue_.empty())
+        return;
+
+    // Sort the fills by histogram, a zeroing drops the earlier fills
+    for (vector<HisFill>::iterator it = queue_.begin(); it != queue_.end();
+         it++) {
+        map<uint32_t, size_t>::const_iterator id = ids_.find(it->id);
+        if (id == ids_.end())
+            continue;
+        size_t index = id->second;
+        if (!isDirty_[index]) {
+            isDirty_[index] = true;
+            dirty_.push_back(index);
+        }
+        if (it->bin == zeroBin) {
+            pending_[index].clear();
+            zeroed_[index] = true;
+        } else
+            pending_[index].push_back(make_pair(it->bin, it->weight));
+    }
+    queue_.clear();
+    if (dirty_.empty())
+        return;
+
+    // Only this thread changes blocks_, so it is read without the lock
+    uint64_t sequence = sequence_ + 1;
+    vector<BlockPtr> updates;
+    updates.reserve(dirty_.size());
+    vector<shared_ptr<Page> > copies;
+    for (vector<size_t>::iterator it = dirty_.begin(); it != dirty_.end();
+         it++) {
+        const Block &old = *blocks_[*it];
+        vector<pair<uint32_t, uint32_t> > &fills = pending_[*it];
+        sort(fills.begin(), fills.end());
+
+        shared_ptr<Block> block(new Block());
+        block->info = old.info;
+        block->info.sequence = sequence;
+        block->previous = old.info.sequence;
+        block->sparse = !zeroed_[*it];
+        if (zeroed_[*it])
+            block->pages.assign(old.pages.size(), zeroPage_);
+        else
+            block->pages = old.pages;
+
+        // Copy every filled page once, the others stay shared
+        size_t numBins = old.info.GetBins();
+        copies.assign(block->pages.size(), shared_ptr<Page>());
+        for (vector<pair<uint32_t, uint32_t> >::iterator fill = fills.begin();
+             fill != fills.end(); fill++) {
+            if (fill->first >= numBins)
+                continue;
+            size_t page = fill->first / pageBins;
+            if (!copies[page]) {
+                copies[page].reset(new Page(*block->pages[page]));
+                block->pages[page] = copies[page];
+            }
+            uint32_t &value = (*copies[page])[fill->first % pageBins];
+            if (useInt_[*it])
+                value += fill->second;
+            else
+                value = (uint16_t)(value + fill->second);
+            if (block->sparse &&
+                (block->changed.empty() || block->changed.back() != fill->first))
+                block->changed.push_back(fill->first);
+        }
+        // Sending every bin is cheaper than sending most of them in pairs
+        if (block->changed.size() > numBins / 4) {
+            block->sparse = false;
+            vector<uint32_t>().swap(block->changed);
+        }
+
+        updates.push_back(block);
+        vector<pair<uint32_t, uint32_t> >().swap(fills);
+        zeroed_[*it] = false;
+        isDirty_[*it] = false;
+    }
+
+    {
+        lock_guard<mutex> guard(lock_);
+        for (size_t i = 0; i < dirty_.size(); i++)
+            blocks_[dirty_[i]] = updates[i];
+        sequence_ = sequence;
+    }
+
+    dirty_.clear();
+}
+
+uint64_t HisServer::Snapshot(vector<BlockPtr> &blocks) {
+    lock_guard<mutex> guard(lock_);
+    blocks = blocks_;
+    return sequence_;
+}
+
+bool HisServer::Start(const string &path) {
+    if (running_)
+        return false;
+
+    sockaddr_un addr;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        cout << "HisServer::Start : Bad socket path '" << path << "'" << endl;
+        return false;
+    }
+
+    // Replace the socket of an earlier scan, but never another file
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            cout << "HisServer::Start : " << path << " exists and is not a "
+                 << "socket" << endl;
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+
+    listenSock_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSock_ < 0 ||
+        bind(listenSock_, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(listenSock_, 8) != 0) {
+        cout << "HisServer::Start : Could not open " << path << " : "
+             << strerror(errno) << endl;
+        if (listenSock_ >= 0)
+            close(listenSock_);
+        listenSock_ = -1;
+        return false;
+    }
+
+    path_ = path;
+    running_ = true;
+    thread_ = thread(&HisServer::Run, this);
+    return true;
+}
+
+void HisServer::Stop(void) {
+    if (!running_)
+        return;
+    running_ = false;
+    thread_.join();
+    close(listenSock_);
+    listenSock_ = -1;
+    unlink(path_.c_str());
+}
+
+void HisServer::Run(void) {
+    vector<Viewer> viewers;
+    vector<pollfd> fds;
+    vector<BlockPtr> blocks;
+
+    while (running_) {
+        fds.clear();
+        pollfd listener = {listenSock_, POLLIN, 0};
+        fds.push_back(listener);
+        // A viewer is not read from until it has taken the whole reply
+        for (size_t i = 0; i < viewers.size(); i++) {
+            pollfd client = {viewers[i].sock,
+                             short(viewers[i].isWriting ? POLLOUT : POLLIN), 0};
+            fds.push_back(client);
+        }
+
+        if (poll(&fds[0], fds.size(), 200) <= 0)
+            continue;
+
+        // Serve the viewers as far as their sockets allow, a viewer which
+        // fails is dropped
+        for (size_t i = fds.size() - 1; i > 0; i--) {
+            if (!fds[i].revents)
+                continue;
+            Viewer &viewer = viewers[i - 1];
+            bool good = !(fds[i].revents & (POLLERR | POLLNVAL));
+            if (good && viewer.isWriting) {
+                good = Send(viewer);
+            } else if (good) {
+                good = Receive(viewer);
+                if (good && viewer.received == sizeof(HisRequest)) {
+                    Answer(viewer.request, viewer.reply, viewer.payload,
+                           blocks);
+                    blocks.clear();
+                    viewer.received = 0;
+                    viewer.sent = 0;
+                    viewer.isWriting = true;
+                    good = Send(viewer);
+                }
+            }
+            if (!good) {
+                close(viewer.sock);
+                viewers.erase(viewers.begin() + i - 1);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int sock = accept(listenSock_, NULL, NULL);
+            if (sock >= 0 && viewers.size() < maxClients &&
+                fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK) == 0) {
+                Viewer viewer;
+                viewer.sock = sock;
+                viewer.received = 0;
+                viewer.sent = 0;
+                viewer.isWriting = false;
+                viewers.push_back(viewer);
+            } else if (sock >= 0) {
+                close(sock);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < viewers.size(); i++)
+        close(viewers[i].sock);
+}
+
+void HisServer::Answer(const HisRequest &request, HisReply &reply,
+                       vector<char> &payload, vector<BlockPtr> &blocks) {
+    payload.clear();
+    reply.magic = HIS_SNAPSHOT_MAGIC;
+    reply.status = HIS_OK;
+    reply.sequence = 0;
+    reply.length = 0;
+
+    if (request.magic != HIS_SNAPSHOT_MAGIC) {
+        reply.status = HIS_BAD_REQUEST;
+        return;
+    }
+
+    // The histogram of the request, if any
+    const Block *block = NULL;
+    if (request.hisID != 0) {
+        map<uint32_t, size_t>::const_iterator it = ids_.find(request.hisID);
+        if (it == ids_.end()) {
+            reply.status = HIS_UNKNOWN_ID;
+            return;
+        }
+        blocks.resize(1);
+        lock_guard<mutex> guard(lock_);
+        blocks[0] = blocks_[it->second];
+        reply.sequence = sequence_;
+        block = blocks[0].get();
+    }
+
+    switch (request.command) {
+        case HIS_LIST:
+            reply.sequence = Snapshot(blocks);
+            for (size_t i = 0; i < blocks.size(); i++)
+                Append(payload, &blocks[i]->info, sizeof(HisInfo));
+            break;
+        case HIS_GET: {
+            if (!block) {
+                reply.status = HIS_UNKNOWN_ID;
+                break;
+            }
+            size_t numBins = block->info.GetBins();
+            payload.reserve(sizeof(HisInfo) + numBins * sizeof(uint32_t));
+            Append(payload, &block->info, sizeof(HisInfo));
+            for (size_t page = 0; page < block->pages.size(); page++) {
+                size_t count = min((size_t)pageBins, numBins - page * pageBins);
+                Append(payload, block->pages[page]->data(),
+                       count * sizeof(uint32_t));
+            }
+            break;
+        }
+        case HIS_DELTA:
+            if (!block)
+                reply.sequence = Snapshot(blocks);
+            for (size_t i = 0; i < blocks.size(); i++) {
+                const Block &current = *blocks[i];
+                if (current.info.sequence <= request.sequence)
+                    continue;
+                HisDelta delta;
+                delta.full = !current.sparse ||
+                    current.previous > request.sequence;
+                size_t numBins = current.info.GetBins();
+                delta.count = delta.full ? numBins : current.changed.size();
+                Append(payload, &current.info, sizeof(HisInfo));
+                Append(payload, &delta, sizeof(HisDelta));
+                if (delta.full) {
+                    for (size_t page = 0; page < current.pages.size(); page++) {
+                        size_t count = min((size_t)pageBins,
+                                           numBins - page * pageBins);
+                        Append(payload, current.pages[page]->data(),
+                               count * sizeof(uint32_t));
+                    }
+                } else {
+                    for (size_t j = 0; j < current.changed.size(); j++) {
+                        uint32_t pair[2] = {current.changed[j],
+                                            GetBin(current, current.changed[j])};
+                        Append(payload, pair, sizeof(pair));
+                    }
+                }
+            }
+            break;
+        case HIS_PROJECT: {
+            if (!block) {
+                reply.status = HIS_UNKNOWN_ID;
+                break;
+            }
+            const HisInfo &info = block->info;
+            if (info.dim < 2) {
+                reply.status = HIS_NOT_2D;
+                break;
+            }
+            if (request.axis > 1) {
+                reply.status = HIS_BAD_REQUEST;
+                break;
+            }
+            // Sum the bins of the other axis from low to high
+            uint32_t other = request.axis == 0 ? info.ybins : info.xbins;
+            if (request.low > request.high || request.low >= other) {
+                reply.status = HIS_BAD_RANGE;
+                break;
+            }
+            uint32_t high = min(request.high, other - 1);
+            vector<uint64_t> sums(request.axis == 0 ? info.xbins : info.ybins,
+                                  0);
+            for (uint32_t j = request.low; j <= high; j++) {
+                for (uint32_t i = 0; i < sums.size(); i++) {
+                    size_t bin = request.axis == 0 ?
+                        (size_t)j * info.xbins + i : (size_t)i * info.xbins + j;
+                    sums[i] += GetBin(*block, bin);
+                }
+            }
+            Append(payload, &info, sizeof(HisInfo));
+            Append(payload, sums.data(), sums.size() * sizeof(uint64_t));
+            break;
+        }
+        default:
+            reply.status = HIS_BAD_REQUEST;
+            break;
+    }
+
+    if (reply.status != HIS_OK)
+        payload.clear();
+    reply.length = payload.size();
+}
@@ -0,0 +1,85 @@
+/** \file LogicTimeline.cpp
+ * \brief Keeps the history of a logic signal as a list of on intervals
+ * \date October 19, 2026
+ */
+#include <algorithm>
+
+#include "LogicTimeline.hpp"
+
+using namespace std;
+
+namespace {
+    /** \return true if the time is before the start of the interval */
+    bool IsBeforeStart(const double &time,
+                       const LogicTimeline::Interval &interval) {
+        return(time < interval.start);
+    }
+}
+
+LogicTimeline::LogicTimeline(const size_t &maxIntervals) {
+    maxIntervals_ = max(maxIntervals, (size_t)1);
+    Clear();
+}
+
+void LogicTimeline::Clear(void) {
+    intervals_.clear();
+    isOn_ = false;
+    lastStart_ = lastStop_ = lastEdge_ = NAN;
+    starts_ = stops_ = 0;
+}
+
+void LogicTimeline::Open(const double &start) {
+    if (intervals_.size() >= maxIntervals_)
+        intervals_.pop_front();
+    Interval interval;
+    interval.start = start;
+    interval.stop = INFINITY;
+    intervals_.push_back(interval);
+}
+
+void LogicTimeline::Start(const double &time) {
+    if (isOn_)
+        intervals_.back().stop = time;
+    Open(time);
+    isOn_ = true;
+    lastStart_ = lastEdge_ = time;
+    starts_++;
+}
+
+void LogicTimeline::Stop(const double &time) {
+    if (isOn_)
+        intervals_.back().stop = time;
+    isOn_ = false;
+    lastStop_ = lastEdge_ = time;
+    stops_++;
+}
+
+bool LogicTimeline::IsOn(const double &time) const {
+    if (time >= lastEdge_)
+        return(isOn_);
+    if (intervals_.empty() || time < intervals_.front().start)
+        return(false);
+
+    deque<Interval>::const_iterator it =
+            upper_bound(intervals_.begin(), intervals_.end(), time,
+                        IsBeforeStart);
+    --it;
+    return(time < it->stop);
+}
+
+double LogicTimeline::TimeOnBetween(const double &from,
+                                    const double &to) const {
+    double total = 0.;
+    deque<Interval>::const_iterator it =
+            upper_bound(intervals_.begin(), intervals_.end(), from,
+                        IsBeforeStart);
+    if (it != intervals_.begin())
+        --it;
+    for (; it != intervals_.end() && it->start < to; ++it) {
+        double start = max(it->start, from);
+        double stop = min(it->stop, to);
+        if (stop > start)
+            total += stop - start;
+    }
+    return(total);
+}
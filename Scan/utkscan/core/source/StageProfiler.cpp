@@ -0,0 +1,134 @@
+/** \file StageProfiler.cpp
+ * \brief Timing of the processors and analyzers
+ * \date October 19, 2026
+ */
+#include <algorithm>
+#include <iomanip>
+
+#include <cmath>
+
+#include "Plots.hpp"
+#include "StageProfiler.hpp"
+
+using namespace std;
+
+StageProfiler *StageProfiler::instance_ = NULL;
+bool StageProfiler::isEnabled_ = true;
+
+StageTimer::StageTimer(const std::string &owner, const std::string &stage) :
+    owner_(owner), stage_(stage), isRunning_(false), hasPending_(false),
+    start_(0), pending_(0), count_(0), total_(0) {
+    fill(bins_, bins_ + numBins, 0);
+    StageProfiler::get()->Register(this);
+}
+
+StageTimer::~StageTimer() {
+    StageProfiler::get()->Unregister(this);
+}
+
+string StageTimer::GetName(void) const {
+    if (stage_.empty())
+        return(owner_);
+    return(owner_ + "::" + stage_);
+}
+
+unsigned int StageTimer::GetBinOf(const uint64_t &ns) {
+    if (ns < 4)
+        return((unsigned int)ns);
+    unsigned int msb = 63 - __builtin_clzll(ns);
+    unsigned int bin = 4 * (msb - 1) + ((ns >> (msb - 2)) & 3);
+    return(min(bin, numBins - 1));
+}
+
+uint64_t StageTimer::GetBinLow(const unsigned int &bin) {
+    if (bin < 4)
+        return(bin);
+    unsigned int msb = bin / 4 + 1;
+    return((uint64_t)(4 + bin % 4) << (msb - 2));
+}
+
+double StageTimer::GetPercentile(const double &p) const {
+    if (count_ == 0)
+        return(0);
+    uint64_t target = (uint64_t)ceil(p * count_);
+    if (target == 0)
+        target = 1;
+    uint64_t sum = 0;
+    for (unsigned int i = 0; i < numBins; i++) {
+        sum += bins_[i];
+        if (sum >= target) {
+            if (i == numBins - 1)
+                return(GetBinLow(i));
+            return(0.5 * (GetBinLow(i) + GetBinLow(i + 1)));
+        }
+    }
+    return(GetBinLow(numBins - 1));
+}
+
+StageProfiler *StageProfiler::get(void) {
+    if (!instance_)
+        instance_ = new StageProfiler();
+    return(instance_);
+}
+
+void StageProfiler::Unregister(StageTimer *timer) {
+    vector<StageTimer*>::iterator it =
+        find(timers_.begin(), timers_.end(), timer);
+    if (it != timers_.end())
+        timers_.erase(it);
+}
+
+void StageProfiler::CommitAll(void) {
+    for (vector<StageTimer*>::iterator it = timers_.begin();
+         it != timers_.end(); it++)
+        (*it)->Commit();
+}
+
+vector<StageTimer*> StageProfiler::GetUsedTimers(void) {
+    CommitAll();
+    vector<StageTimer*> used;
+    for (vector<StageTimer*>::iterator it = timers_.begin();
+         it != timers_.end(); it++) {
+        if ((*it)->GetCount() > 0)
+            used.push_back(*it);
+    }
+    return(used);
+}
+
+void StageProfiler::PrintSummary(std::ostream &out) {
+    vector<StageTimer*> used = GetUsedTimers();
+    if (used.empty())
+        return;
+
+    size_t width = 5;
+    for (vector<StageTimer*>::iterator it = used.begin();
+         it != used.end(); it++)
+        width = max(width, (*it)->GetName().size());
+
+    out << "Time spent in the processors and analyzers" << endl
+        << left << setw(width) << "Stage" << right
+        << setw(12) << "Calls" << setw(12) << "Total (s)"
+        << setw(12) << "Mean (us)" << setw(12) << "p50 (us)"
+        << setw(12) << "p99 (us)" << endl;
+    out << fixed;
+    for (vector<StageTimer*>::iterator it = used.begin();
+         it != used.end(); it++) {
+        const StageTimer &t = **it;
+        out << left << setw(width) << t.GetName() << right
+            << setw(12) << t.GetCount()
+            << setw(12) << setprecision(3) << t.GetTotal() * 1e-9
+            << setw(12) << setprecision(3) << t.GetMean() * 1e-3
+            << setw(12) << setprecision(3) << t.GetPercentile(0.5) * 1e-3
+            << setw(12) << setprecision(3) << t.GetPercentile(0.99) * 1e-3
+            << endl;
+    }
+    out.unsetf(ios_base::fixed);
+}
+
+void StageProfiler::Plot(Plots &histo, const int &dammId) {
+    vector<StageTimer*> used = GetUsedTimers();
+    for (unsigned int y = 0; y < used.size(); y++)
+        for (unsigned int x = 0; x < StageTimer::numBins; x++)
+            if (used[y]->GetBin(x) > 0)
+                histo.Plot(dammId, x, y, used[y]->GetBin(x));
+}
@@ -0,0 +1,88 @@
+/** \file ThreadPool.cpp
+ * \brief Implementation of a small pool of worker threads
+ * \date October 19, 2026
+ */
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+ThreadPool::ThreadPool(const unsigned int &numThreads) :
+        task_(NULL), numTasks_(0), next_(0), busy_(0), generation_(0),
+        stop_(false) {
+    unsigned int total = numThreads;
+    if (total == 0)
+        total = thread::hardware_concurrency();
+    if (total == 0)
+        total = 1;
+
+    //The calling thread is always one of the workers.
+    for (unsigned int i = 1; i < total; i++)
+        workers_.push_back(thread(&ThreadPool::Work, this));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (vector<thread>::iterator it = workers_.begin();
+         it != workers_.end(); it++)
+        it->join();
+}
+
+void ThreadPool::ParallelFor(const size_t &n,
+                             const function<void(const size_t &)> &func) {
+    if (n == 0)
+        return;
+
+    //There is no point waking anybody up for a single index.
+    if (workers_.empty() || n == 1) {
+        for (size_t i = 0; i < n; i++)
+            func(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(mutex_);
+        task_ = &func;
+        numTasks_ = n;
+        next_ = 0;
+        busy_ = (unsigned int)workers_.size();
+        generation_++;
+    }
+    start_.notify_all();
+
+    RunTasks();
+
+    unique_lock<mutex> lock(mutex_);
+    while (busy_ != 0)
+        done_.wait(lock);
+    task_ = NULL;
+}
+
+void ThreadPool::RunTasks(void) {
+    size_t idx;
+    while ((idx = next_++) < numTasks_)
+        (*task_)(idx);
+}
+
+void ThreadPool::Work(void) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(mutex_);
+            while (!stop_ && generation_ == seen)
+                start_.wait(lock);
+            if (stop_)
+                return;
+            seen = generation_;
+        }
+
+        RunTasks();
+
+        lock_guard<mutex> lock(mutex_);
+        if (--busy_ == 0)
+            done_.notify_one();
+    }
+}
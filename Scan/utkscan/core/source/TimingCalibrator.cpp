@@ -16,8 +16,9 @@ using namespace std;
 
 TimingCalibrator* TimingCalibrator::instance = NULL;
 
-TimingCalibration TimingCalibrator::GetCalibration(const TimingDefs::TimingIdentifier &id) {
-    map<TimingDefs::TimingIdentifier, TimingCalibration>::iterator it =
+const TimingCalibration &TimingCalibrator::GetCalibration(
+    const TimingDefs::TimingIdentifier &id) const {
+    map<TimingDefs::TimingIdentifier, TimingCalibration>::const_iterator it =
         calibrations_.find(id);
 
     if(it == calibrations_.end())
@@ -32,21 +33,11 @@ TimingCalibrator* TimingCalibrator::get() {
 }
 
 void TimingCalibrator::ReadTimingCalXml() {
-    string cfg = Globals::get()->configfile();
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(cfg.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "TimingCalibrator: error parsing file " << cfg;
-        ss << " : " << result.description();
-        throw GeneralException(ss.str());
-    }
-
     Messenger m;
     m.start("Loading Time Calibrations");
 
     pugi::xml_node timeCals =
-        doc.child("Configuration").child("TimeCalibration");
+        Globals::get()->configuration().child("TimeCalibration");
 
     isVerbose_ = timeCals.attribute("verbose_timing").as_bool();
 
@@ -3,6 +3,7 @@
  *  \author S. V. Paulauskas
  *  \date December 16, 2014
 */
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -10,20 +11,43 @@
 
 using namespace std;
 
+namespace {
+    /** \return true if the TimingIdentifier of a is less than that of b */
+    bool CompareKeys(const pair<TimingDefs::TimingIdentifier,
+                         HighResTimingData> &a,
+                     const pair<TimingDefs::TimingIdentifier,
+                         HighResTimingData> &b) {
+        return(a.first < b.first);
+    }
+
+    /** \return true if a and b have the same TimingIdentifier */
+    bool EqualKeys(const pair<TimingDefs::TimingIdentifier,
+                       HighResTimingData> &a,
+                   const pair<TimingDefs::TimingIdentifier,
+                       HighResTimingData> &b) {
+        return(a.first == b.first);
+    }
+}
+
 TimingMapBuilder::TimingMapBuilder(const std::vector<ChanEvent*> &evts) {
-    FillMaps(evts);
+    Build(evts);
 }
 
-void TimingMapBuilder::FillMaps(const std::vector<ChanEvent*> &evts) {
-    map_.clear();
+void TimingMapBuilder::Build(const std::vector<ChanEvent*> &evts) {
+    list_.clear();
     for(vector<ChanEvent*>::const_iterator it = evts.begin();
     it != evts.end(); it++) {
-        Identifier id = (*it)->GetChanID();
-        TimingDefs::TimingIdentifier key(id.GetLocation(), id.GetSubtype());
-
+        const Identifier &id = (*it)->GetChanID();
         HighResTimingData data((*it));
         if(!data.GetIsValid())
             continue;
-        map_.insert(make_pair(key,data));
+        list_.push_back(make_pair(
+            TimingDefs::TimingIdentifier(id.GetLocation(), id.GetSubtype()),
+            data));
     }
+
+    //Keep the ordering and the first entry for a duplicated key, as the map
+    // used to do.
+    stable_sort(list_.begin(), list_.end(), CompareKeys);
+    list_.erase(unique(list_.begin(), list_.end(), EqualKeys), list_.end());
 }
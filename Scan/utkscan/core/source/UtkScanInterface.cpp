@@ -1,6 +1,7 @@
 
 
 #include "DetectorDriver.hpp"
+#include "HisServer.hpp"
 #include "UtkScanInterface.hpp"
 #include "UtkUnpacker.hpp"
 
@@ -10,12 +11,15 @@ OutputHisFile *output_his = NULL;
 /// Default constructor.
 UtkScanInterface::UtkScanInterface() : ScanInterface() {
     init_ = false;
+    hisServer_ = NULL;
 }
 
 /// Destructor.
 UtkScanInterface::~UtkScanInterface() {
     if (init_)
         delete (output_his);
+    // The his file publishes its last fills when it closes
+    delete (hisServer_);
 }
 
 /** ExtraCommands is used to send command strings to classes derived
@@ -48,6 +52,26 @@ void UtkScanInterface::CmdHelp() {
     std::cout << "   mycmd <param> - Do something useful.\n";
 }
 
+/** ExtraArguments is used to send command line arguments to classes derived
+ * from ScanInterface. This method loops over the optionExt elements
+ * in the vector userOpts and checks for those options which have been
+ * flagged as active by ::Setup(). */
+void UtkScanInterface::ExtraArguments() {
+    for (std::vector<optionExt>::iterator it = userOpts.begin();
+         it != userOpts.end(); it++) {
+        if (it->active && std::string(it->name) == "his-socket")
+            hisSocket_ = it->argument;
+    }
+}
+
+/** ArgHelp is used to allow a derived class to add a command line option
+ * to the main list of options. This method is called at the end of
+ * the ::Setup method. */
+void UtkScanInterface::ArgHelp() {
+    AddOption(optionExt("his-socket", required_argument, NULL, 0, "<path>",
+                        "Serve histogram snapshots to viewers on a unix socket"));
+}
+
 /** SyntaxStr is used to print a linux style usage message to the screen.
  * \param[in]  name_ The name of the program.
  * \return Nothing. */
@@ -69,6 +93,10 @@ bool UtkScanInterface::Initialize(std::string prefix_) {
         // Read in the name of the his file.
         output_his = new OutputHisFile(GetOutputFilename().c_str());
         output_his->SetDebugMode(false);
+        if (!hisSocket_.empty()) {
+            hisServer_ = new HisServer();
+            output_his->SetServer(hisServer_);
+        }
 
         /** The DetectorDriver constructor will load processors
          *  from the xml configuration file upon first call.
@@ -83,6 +111,17 @@ bool UtkScanInterface::Initialize(std::string prefix_) {
          */
         DetectorDriver::get()->DeclarePlots();
         output_his->Finalize();
+
+        if (hisServer_) {
+            if (hisServer_->Start(hisSocket_))
+                std::cout << prefix_ << "Serving histogram snapshots on "
+                          << hisSocket_ << std::endl;
+            else {
+                output_his->SetServer(NULL);
+                delete (hisServer_);
+                hisServer_ = NULL;
+            }
+        }
     } catch (std::exception &e) {
         // Any exceptions will be intercepted here
         std::cout << prefix_ << "Exception caught at Initialize:" << std::endl;
@@ -10,6 +10,7 @@
 
 
 #include "DetectorDriver.hpp"
+#include "EventSkimmer.hpp"
 #include "Places.hpp"
 #include "TreeCorrelator.hpp"
 #include "UtkScanInterface.hpp"
@@ -24,6 +25,7 @@ RawEvent rawev;
 UtkUnpacker::~UtkUnpacker() {
     //Call destructor for Detector Driver so that we close out Processors
     // properly
+    EventSkimmer::get()->Close();
     DetectorDriver::get()->~DetectorDriver();
 }
 
@@ -67,6 +69,8 @@ void UtkUnpacker::ProcessRawEvent(ScanInterface *addr_/*=NULL*/){
 	 * before processing data. SanityCheck function throws exception if
 	 * something went wrong. */
 	try{
+	    EventSkimmer::get()->Init(
+                Globals::get()->configuration().child("Skim"));
 	    driver->SanityCheck(); 
 	} catch(GeneralException &e){
 	    m.fail();
@@ -196,6 +200,7 @@ void UtkUnpacker::ProcessRawEvent(ScanInterface *addr_/*=NULL*/){
     }//for(deque<PixieData*>::iterator
 
     driver->ProcessEvent(rawev);
+    EventSkimmer::get()->Process(rawev, rawEvent);
     rawev.Zero(usedDetectors);
     usedDetectors.clear();
     counter++;
@@ -0,0 +1,32 @@
+///\file TestChecks.hpp
+///\brief The pass/fail checks shared by the tests of the core
+///\date October 19, 2026
+#ifndef __TESTCHECKS_HPP__
+#define __TESTCHECKS_HPP__
+
+#include <iostream>
+#include <string>
+
+///\return the number of checks that failed so far
+inline unsigned int &NumFailed(void) {
+    static unsigned int numFailed = 0;
+    return numFailed;
+}
+
+///Prints the result of a check and counts the failures
+inline void Check(const bool &result, const std::string &name) {
+    std::cout << (result ? "PASS : " : "FAIL : ") << name << std::endl;
+    if(!result)
+        NumFailed()++;
+}
+
+///Prints the number of failed checks, if any
+///\return the exit code of the test, 1 if a check failed
+inline int CheckSummary(void) {
+    if(NumFailed() == 0)
+        return 0;
+    std::cerr << NumFailed() << " checks failed!" << std::endl;
+    return 1;
+}
+
+#endif //__TESTCHECKS_HPP__
@@ -0,0 +1,548 @@
+///\file benchmark_utkscan.cpp
+///\brief Measures the throughput of the scan on synthetic Pixie16 list mode
+/// data.
+///
+/// The spills are made with a seeded random number generator, so every run
+/// with the same options sees exactly the same data. The raw stages (the
+/// decoding of the spill, the event building and the filling of the .his
+/// file) are measured without a configuration. When a configuration is given
+/// the spills are also sent through the UtkUnpacker and the DetectorDriver,
+/// the time spent in each processor and trace analyzer is then taken from
+/// the StageProfiler.
+///\date October 19, 2026
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "DetectorDriver.hpp"
+#include "DetectorLibrary.hpp"
+#include "Globals.hpp"
+#include "HisFile.hpp"
+#include "MersenneTwister.hpp"
+#include "StageProfiler.hpp"
+#include "UtkScanInterface.hpp"
+#include "UtkUnpacker.hpp"
+
+using namespace std;
+
+///The options of the benchmark
+struct Options {
+    unsigned int numModules;//!< the number of modules without a config
+    unsigned int numSpills;//!< the number of spills to scan
+    unsigned int hitsPerSpill;//!< the number of channel hits in a spill
+    unsigned int maxMultiplicity;//!< the largest number of hits in an event
+    unsigned int traceLength;//!< the number of samples in a trace
+    unsigned int numFills;//!< the number of fills of the .his file
+    double rate;//!< the event rate in Hz
+    double pileupFraction;//!< the fraction of hits with a second pulse
+    double eventWidth;//!< the event width in clock ticks
+    unsigned int seed;//!< the seed of the random numbers
+    string config;//!< the configuration file, raw stages only if empty
+    string output;//!< the prefix of the output files
+    bool isJson;//!< true to write JSON instead of CSV
+};
+
+///The timing of a stage and the work done in it
+struct StageResult {
+    string name;//!< the name of the stage
+    uint64_t calls;//!< the number of calls of the stage
+    double total;//!< the total time in seconds
+    double mean;//!< the mean time of a call in microseconds
+    double median;//!< the median time of a call in microseconds
+    double p99;//!< the 99th percentile of the calls in microseconds
+    double items;//!< the number of items processed
+    string unit;//!< what an item is
+};
+
+///Takes the results of a stage from its timer, the items are the calls
+StageResult MakeResult(const StageTimer &timer) {
+    StageResult r = {timer.GetName(), timer.GetCount(),
+                     timer.GetTotal() * 1e-9, timer.GetMean() * 1e-3,
+                     timer.GetPercentile(0.5) * 1e-3,
+                     timer.GetPercentile(0.99) * 1e-3,
+                     double(timer.GetCount()), "calls"};
+    return(r);
+}
+
+///Makes the spills of synthetic Pixie16 list mode data
+class SpillGenerator {
+public:
+    ///A channel that is hit in the data
+    struct Channel {
+        unsigned int module;//!< the module number
+        unsigned int channel;//!< the channel number
+    };
+
+    /** Constructor
+     * \param [in] opts : the options of the benchmark
+     * \param [in] channels : the channels to put hits into
+     * \param [in] numModules : the number of modules in the spill
+     * \param [in] clockInSeconds : the length of a clock tick */
+    SpillGenerator(const Options &opts, const vector<Channel> &channels,
+                   const unsigned int &numModules,
+                   const double &clockInSeconds) :
+        opts_(opts), channels_(channels), numModules_(numModules),
+        ticksPerEvent_(1. / (opts.rate * clockInSeconds)), rand_(opts.seed),
+        time_(0) {}
+
+    /** Starts over with the first spill */
+    void Reset(void) {
+        rand_.seed(opts_.seed);
+        time_ = 0;
+    }
+
+    /** Makes the next spill
+     * \param [out] spill : the words of the spill
+     * \return the number of channel hits in the spill */
+    unsigned int Next(vector<unsigned int> &spill) {
+        vector<vector<unsigned int> > buffers(numModules_);
+        unsigned int numHits = 0;
+        while (numHits < opts_.hitsPerSpill) {
+            time_ += -log(1. - rand_.randExc()) * ticksPerEvent_ + 1;
+            unsigned int mult = 1 + rand_.randInt(opts_.maxMultiplicity - 1);
+            for (unsigned int i = 0; i < mult; i++) {
+                const Channel &chan =
+                    channels_[rand_.randInt(channels_.size() - 1)];
+                AddHit(buffers[chan.module], chan,
+                       (uint64_t)time_ + rand_.randInt(3));
+            }
+            numHits += mult;
+        }
+
+        spill.clear();
+        for (unsigned int i = 0; i < numModules_; i++) {
+            spill.push_back(buffers[i].size() + 2);
+            spill.push_back(i);
+            spill.insert(spill.end(), buffers[i].begin(), buffers[i].end());
+        }
+        spill.push_back(2);
+        spill.push_back(9999);
+        return numHits;
+    }
+
+private:
+    /** Adds the words of a single channel hit to the buffer of a module
+     * \param [in,out] buf : the buffer of the module
+     * \param [in] chan : the channel that was hit
+     * \param [in] time : the time of the hit in clock ticks */
+    void AddHit(vector<unsigned int> &buf, const Channel &chan,
+                const uint64_t &time) {
+        const unsigned int headerLength = 4;
+        const double baseline = 400.;
+        unsigned int energy = 100 + rand_.randInt(8000);
+        bool isPileup = rand_.rand() < opts_.pileupFraction;
+
+        unsigned int word = chan.channel | (chan.module << 4) |
+            (headerLength << 12) |
+            ((headerLength + opts_.traceLength / 2) << 17);
+        if (isPileup)
+            word |= 0x80000000;
+        buf.push_back(word);
+        buf.push_back((unsigned int)(time & 0xFFFFFFFF));
+        buf.push_back((unsigned int)((time >> 32) & 0xFFFF) |
+                      (rand_.randInt(0xFFFF) << 16));
+        buf.push_back(energy | (opts_.traceLength << 16));
+
+        if (opts_.traceLength == 0)
+            return;
+
+        vector<unsigned short> trace(opts_.traceLength);
+        unsigned int start = opts_.traceLength / 4;
+        unsigned int second = start + 10 +
+            rand_.randInt(opts_.traceLength / 2);
+        for (unsigned int i = 0; i < opts_.traceLength; i++) {
+            double val = baseline + rand_.randNorm(0., 3.);
+            val += Pulse(i, start, 0.5 * energy);
+            if (isPileup)
+                val += Pulse(i, second, 0.25 * energy);
+            trace[i] = (unsigned short)min(max(val, 0.), 16383.);
+        }
+        size_t pos = buf.size();
+        buf.resize(pos + opts_.traceLength / 2);
+        memcpy(&buf[pos], &trace[0], opts_.traceLength * sizeof(short));
+    }
+
+    /** \return the value of a pulse in a sample of the trace
+     * \param [in] i : the sample
+     * \param [in] start : the sample where the pulse starts
+     * \param [in] amp : the amplitude of the pulse */
+    static double Pulse(const unsigned int &i, const unsigned int &start,
+                        const double &amp) {
+        if (i <= start)
+            return(0);
+        double diff = i - start;
+        return(amp * exp(-0.1 * diff) * (1 - exp(-pow(0.5 * diff, 4.))));
+    }
+
+    const Options &opts_;//!< the options of the benchmark
+    vector<Channel> channels_;//!< the channels to put hits into
+    unsigned int numModules_;//!< the number of modules in the spill
+    double ticksPerEvent_;//!< the mean time between events
+    MTRand rand_;//!< the random numbers
+    double time_;//!< the time of the last event in clock ticks
+};
+
+///An unpacker that only builds the events, the time up to the first event
+///of a spill is the decoding and the time between events the building
+class RawUnpacker : public Unpacker {
+public:
+    /** Default Constructor */
+    RawUnpacker() : Unpacker(), decodeTimer_(name_, "Decode"),
+                    buildTimer_(name_, "BuildEvent"), isFirst_(true) {}
+
+    /** Reads a spill and times the decoding and the event building
+     * \param [in] spill : the words of the spill
+     * \return true if the spill was read */
+    bool Read(vector<unsigned int> &spill) {
+        isFirst_ = true;
+        decodeTimer_.Start();
+        bool isGood = ReadSpill(&spill[0], spill.size(), false);
+        buildTimer_.Stop();
+        return(isGood);
+    }
+
+    /** \return the timer of the decoding */
+    StageTimer &GetDecodeTimer(void) {return decodeTimer_;}
+    /** \return the timer of the event building */
+    StageTimer &GetBuildTimer(void) {return buildTimer_;}
+
+private:
+    /** Counts the event and restarts the timer of the event building
+     * \param [in] addr_ : unused */
+    virtual void ProcessRawEvent(ScanInterface *addr_ = NULL) {
+        if (isFirst_)
+            decodeTimer_.Stop();
+        else
+            buildTimer_.Stop();
+        isFirst_ = false;
+        Unpacker::ProcessRawEvent(addr_);
+        buildTimer_.Start();
+    }
+
+    static const string name_;//!< the name of the stage timers
+    StageTimer decodeTimer_;//!< the decoding and sorting of the spill
+    StageTimer buildTimer_;//!< the building of each event
+    bool isFirst_;//!< true until the first event of the spill is built
+};
+
+const string RawUnpacker::name_ = "Unpacker";
+
+///The name of the stages that are timed by the benchmark itself
+static const string benchmarkName = "Benchmark";
+
+///Prints the usage of the benchmark
+void Usage(const char *name) {
+    cout << "usage: " << name << " [options]" << endl
+         << "  -c <file>  configuration, enables the DetectorDriver stages"
+         << endl
+         << "  -m <num>   number of modules without a configuration (2)"
+         << endl
+         << "  -n <num>   number of spills (100)" << endl
+         << "  -e <num>   channel hits per spill (2000)" << endl
+         << "  -k <num>   largest number of hits in an event (2)" << endl
+         << "  -r <hz>    event rate (10000)" << endl
+         << "  -t <num>   samples per trace, 0 for none (124)" << endl
+         << "  -p <frac>  fraction of hits with pileup (0.05)" << endl
+         << "  -w <ticks> event width (62)" << endl
+         << "  -f <num>   number of .his file fills (1000000)" << endl
+         << "  -s <seed>  seed of the random numbers (12345)" << endl
+         << "  -o <name>  prefix of the output files (benchmark)" << endl
+         << "  -j         write JSON instead of CSV" << endl;
+}
+
+///Reads the options from the command line
+bool ReadOptions(int argc, char *argv[], Options &opts) {
+    opts.numModules = 2;
+    opts.numSpills = 100;
+    opts.hitsPerSpill = 2000;
+    opts.maxMultiplicity = 2;
+    opts.traceLength = 124;
+    opts.numFills = 1000000;
+    opts.rate = 1e4;
+    opts.pileupFraction = 0.05;
+    opts.eventWidth = 62;
+    opts.seed = 12345;
+    opts.output = "benchmark";
+    opts.isJson = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:m:n:e:k:r:t:p:w:f:s:o:jh")) != -1) {
+        switch (opt) {
+            case 'c': opts.config = optarg; break;
+            case 'm': opts.numModules = atoi(optarg); break;
+            case 'n': opts.numSpills = atoi(optarg); break;
+            case 'e': opts.hitsPerSpill = atoi(optarg); break;
+            case 'k': opts.maxMultiplicity = atoi(optarg); break;
+            case 'r': opts.rate = atof(optarg); break;
+            case 't': opts.traceLength = atoi(optarg); break;
+            case 'p': opts.pileupFraction = atof(optarg); break;
+            case 'w': opts.eventWidth = atof(optarg); break;
+            case 'f': opts.numFills = atoi(optarg); break;
+            case 's': opts.seed = atoi(optarg); break;
+            case 'o': opts.output = optarg; break;
+            case 'j': opts.isJson = true; break;
+            default: return(false);
+        }
+    }
+
+    //!The trace is packed two samples to a word
+    opts.traceLength -= opts.traceLength % 2;
+    if (opts.numModules == 0 || opts.numModules > MAX_PIXIE_MOD + 1 ||
+        opts.maxMultiplicity == 0 || opts.rate <= 0 ||
+        opts.hitsPerSpill == 0) {
+        cerr << "The number of modules, hits, multiplicity and the rate "
+             << "have to be positive, and there are at most "
+             << MAX_PIXIE_MOD + 1 << " modules." << endl;
+        return(false);
+    }
+    return(true);
+}
+
+///Checks that the spill fits into the limits of the Unpacker
+bool CheckSpill(const vector<unsigned int> &spill) {
+    const unsigned int maxBuffer = 131072, maxSpill = 1000000;
+    if (spill.size() > maxSpill) {
+        cerr << "The spill has " << spill.size() << " words, the Unpacker "
+             << "reads at most " << maxSpill << ". Use fewer hits per spill "
+             << "or shorter traces." << endl;
+        return(false);
+    }
+    for (size_t i = 0; spill[i + 1] != 9999; i += spill[i]) {
+        if (spill[i] > maxBuffer) {
+            cerr << "The buffer of module " << spill[i + 1] << " has "
+                 << spill[i] << " words, the Unpacker reads at most "
+                 << maxBuffer << ". Use fewer hits per spill or shorter "
+                 << "traces." << endl;
+            return(false);
+        }
+    }
+    return(true);
+}
+
+///Decodes the spills and builds the events without any processing
+bool RunRawStages(const Options &opts, SpillGenerator &gen,
+                  vector<StageResult> &results) {
+    RawUnpacker unpacker;
+    unpacker.SetEventWidth(opts.eventWidth);
+    StageTimer timer(benchmarkName, "ReadSpill");
+
+    vector<unsigned int> spill;
+    double numWords = 0, numHits = 0;
+    gen.Reset();
+    for (unsigned int i = 0; i < opts.numSpills; i++) {
+        numHits += gen.Next(spill);
+        if (!CheckSpill(spill))
+            return(false);
+        numWords += spill.size();
+        timer.Start();
+        bool isGood = unpacker.Read(spill);
+        timer.Stop();
+        if (!isGood) {
+            cerr << "The Unpacker could not read spill " << i << endl;
+            return(false);
+        }
+    }
+
+    StageProfiler::get()->CommitAll();
+    StageResult r = MakeResult(unpacker.GetDecodeTimer());
+    r.items = numWords;
+    r.unit = "words";
+    results.push_back(r);
+    r = MakeResult(unpacker.GetBuildTimer());
+    r.unit = "events";
+    results.push_back(r);
+    r = MakeResult(timer);
+    r.items = numHits;
+    r.unit = "hits";
+    results.push_back(r);
+    return(true);
+}
+
+///Fills a 1D and a 2D histogram of the .his file with random values
+void RunFillStage(const Options &opts, vector<StageResult> &results) {
+    OutputHisFile his(opts.output + "_fill");
+    his.push_back(new drr_entry(1, 2, 16384, 16384, 0, 16383,
+                                "benchmark 1D"));
+    his.push_back(new drr_entry(2, 2, 512, 512, 0, 511, 512, 512, 0, 511,
+                                "benchmark 2D"));
+    his.Finalize();
+
+    MTRand rand(opts.seed);
+    vector<unsigned int> values(opts.numFills);
+    for (unsigned int i = 0; i < opts.numFills; i++)
+        values[i] = rand.randInt(16383);
+
+    StageTimer timer(benchmarkName, "Fill");
+    timer.Start();
+    for (unsigned int i = 0; i < opts.numFills; i++) {
+        if (i % 2)
+            his.Fill(2, values[i] % 512, values[i] / 32);
+        else
+            his.Fill(1, values[i], 0);
+    }
+    his.Flush();
+    timer.Stop();
+    timer.Commit();
+
+    StageResult r = MakeResult(timer);
+    r.items = opts.numFills;
+    r.unit = "fills";
+    results.push_back(r);
+}
+
+///Sends the spills through the UtkUnpacker and the DetectorDriver
+bool RunFullStages(const Options &opts, SpillGenerator &gen,
+                   vector<StageResult> &results, UtkUnpacker &unpacker) {
+    output_his = new OutputHisFile(opts.output);
+    output_his->SetDebugMode(false);
+    DetectorDriver::get()->DeclarePlots();
+    output_his->Finalize();
+
+    UtkScanInterface scanner;
+    unpacker.SetInterface(&scanner);
+    unpacker.SetEventWidth(opts.eventWidth);
+    StageTimer timer(benchmarkName, "EndToEnd");
+
+    vector<unsigned int> spill;
+    double numHits = 0;
+    gen.Reset();
+    for (unsigned int i = 0; i < opts.numSpills; i++) {
+        numHits += gen.Next(spill);
+        if (!CheckSpill(spill))
+            return(false);
+        timer.Start();
+        bool isGood = unpacker.ReadSpill(&spill[0], spill.size(), false);
+        timer.Stop();
+        if (!isGood) {
+            cerr << "The UtkUnpacker could not read spill " << i << endl;
+            return(false);
+        }
+    }
+    timer.Commit();
+    output_his->Flush();
+
+    //!The timers of the DetectorDriver, the processors and the analyzers
+    vector<StageTimer*> used = StageProfiler::get()->GetUsedTimers();
+    for (vector<StageTimer*>::iterator it = used.begin();
+         it != used.end(); it++) {
+        StageResult r = MakeResult(**it);
+        if (*it == &timer) {
+            r.items = numHits;
+            r.unit = "hits";
+        }
+        results.push_back(r);
+    }
+    unpacker.SetInterface(NULL);
+    return(true);
+}
+
+///Writes the results of all of the stages
+void WriteResults(const Options &opts, const vector<StageResult> &results) {
+    string name = opts.output + (opts.isJson ? ".json" : ".csv");
+    ofstream out(name.c_str());
+
+    if (opts.isJson)
+        out << "{" << endl << "  \"seed\": " << opts.seed
+            << ", \"spills\": " << opts.numSpills
+            << ", \"hitsPerSpill\": " << opts.hitsPerSpill
+            << ", \"traceLength\": " << opts.traceLength
+            << ", \"rate\": " << opts.rate
+            << ", \"pileupFraction\": " << opts.pileupFraction << ","
+            << endl << "  \"stages\": [" << endl;
+    else
+        out << "stage,calls,total_s,mean_us,p50_us,p99_us,items,unit,"
+            << "items_per_s" << endl;
+
+    for (vector<StageResult>::const_iterator it = results.begin();
+         it != results.end(); it++) {
+        double perSecond = it->total > 0 ? it->items / it->total : 0;
+        if (opts.isJson) {
+            out << (it == results.begin() ? "" : ",\n")
+                << "    {\"stage\": \"" << it->name
+                << "\", \"calls\": " << it->calls
+                << ", \"total_s\": " << it->total
+                << ", \"mean_us\": " << it->mean
+                << ", \"p50_us\": " << it->median
+                << ", \"p99_us\": " << it->p99
+                << ", \"items\": " << it->items
+                << ", \"unit\": \"" << it->unit
+                << "\", \"items_per_s\": " << perSecond << "}";
+        } else {
+            out << it->name << "," << it->calls << "," << it->total << ","
+                << it->mean << "," << it->median << "," << it->p99 << ","
+                << it->items << "," << it->unit << "," << perSecond << endl;
+        }
+    }
+    if (opts.isJson)
+        out << endl << "  ]" << endl << "}" << endl;
+    cout << "Wrote the results to " << name << endl;
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!ReadOptions(argc, argv, opts)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    double clockInSeconds = 8e-9;
+    unsigned int numModules = opts.numModules;
+    vector<SpillGenerator::Channel> channels;
+    if (!opts.config.empty()) {
+        Globals *globals = Globals::get(opts.config);
+        clockInSeconds = globals->clockInSeconds();
+        DetectorLibrary *modChan = DetectorLibrary::get();
+        numModules = min(modChan->GetPhysicalModules(),
+                         (unsigned int)MAX_PIXIE_MOD + 1);
+        for (unsigned int mod = 0; mod < numModules; mod++)
+            for (unsigned int ch = 0; ch <= MAX_PIXIE_CHAN; ch++)
+                if (modChan->HasValue(mod, ch) &&
+                    modChan->at(modChan->GetIndex(mod, ch)).GetType() !=
+                    "ignore") {
+                    SpillGenerator::Channel chan = {mod, ch};
+                    channels.push_back(chan);
+                }
+        if (channels.empty()) {
+            cerr << "There are no channels in the map of " << opts.config
+                 << endl;
+            return 1;
+        }
+    } else {
+        for (unsigned int mod = 0; mod < numModules; mod++)
+            for (unsigned int ch = 0; ch <= MAX_PIXIE_CHAN; ch++) {
+                SpillGenerator::Channel chan = {mod, ch};
+                channels.push_back(chan);
+            }
+    }
+
+    cout << "Scanning " << opts.numSpills << " synthetic spills of "
+         << opts.hitsPerSpill << " hits in " << channels.size()
+         << " channels" << endl;
+    SpillGenerator gen(opts, channels, numModules, clockInSeconds);
+    vector<StageResult> results;
+    if (!RunRawStages(opts, gen, results))
+        return 1;
+    RunFillStage(opts, results);
+
+    if (opts.config.empty()) {
+        WriteResults(opts, results);
+        return 0;
+    }
+
+    UtkUnpacker *unpacker = new UtkUnpacker();
+    bool isGood = RunFullStages(opts, gen, results, *unpacker);
+    if (isGood)
+        WriteResults(opts, results);
+    //!Deleting the UtkUnpacker closes out the DetectorDriver
+    delete unpacker;
+    delete output_his;
+    return isGood ? 0 : 1;
+}
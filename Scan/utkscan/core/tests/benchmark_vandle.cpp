@@ -0,0 +1,295 @@
+///\file benchmark_vandle.cpp
+///\brief Measures the time the VandleProcessor spends on an event in which
+/// every bar fired.
+///
+/// The benchmark writes a configuration with the requested number of small
+/// bars and beta starts, all calibrated, and builds a single event in which
+/// both ends of every bar and every start have a pulse in their trace. The
+/// event is sent once through the DetectorDriver, so that the traces are
+/// analyzed and the summaries are filled, and then the PreProcess and the
+/// Process of the VandleProcessor are timed on it over and over. The trace
+/// analysis is left out of the time since it does not depend on how the bars
+/// are built. Only the interface of the processors is used, so the benchmark
+/// builds against older versions of the VandleProcessor for a comparison.
+/// The mean includes the flushes of the histograms, which fill the same bins
+/// for every event here, so the median is the better measure of the
+/// processor itself.
+///\date October 19, 2026
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "ChanEvent.hpp"
+#include "DetectorDriver.hpp"
+#include "DetectorLibrary.hpp"
+#include "EventProcessor.hpp"
+#include "Globals.hpp"
+#include "HisFile.hpp"
+#include "MersenneTwister.hpp"
+#include "RawEvent.hpp"
+#include "Unpacker.hpp"
+
+using namespace std;
+
+///The options of the benchmark
+struct Options {
+    unsigned int numBars;//!< the number of bars
+    unsigned int numStarts;//!< the number of beta starts
+    unsigned int numEvents;//!< the number of timed events
+    unsigned int traceLength;//!< the number of samples in a trace
+    unsigned int seed;//!< the seed of the random numbers
+    string output;//!< the prefix of the output files
+};
+
+///Prints the usage of the benchmark
+void Usage(const char *name) {
+    cout << "usage: " << name << " [options]" << endl
+         << "  -b <num>   number of bars (48)" << endl
+         << "  -s <num>   number of beta starts (2)" << endl
+         << "  -n <num>   number of timed events (100000)" << endl
+         << "  -t <num>   samples per trace (124)" << endl
+         << "  -r <seed>  seed of the random numbers (12345)" << endl
+         << "  -o <name>  prefix of the output files (benchmark_vandle)"
+         << endl;
+}
+
+///Reads the options from the command line
+bool ReadOptions(int argc, char *argv[], Options &opts) {
+    opts.numBars = 48;
+    opts.numStarts = 2;
+    opts.numEvents = 100000;
+    opts.traceLength = 124;
+    opts.seed = 12345;
+    opts.output = "benchmark_vandle";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:s:n:t:r:o:h")) != -1) {
+        switch (opt) {
+            case 'b': opts.numBars = atoi(optarg); break;
+            case 's': opts.numStarts = atoi(optarg); break;
+            case 'n': opts.numEvents = atoi(optarg); break;
+            case 't': opts.traceLength = atoi(optarg); break;
+            case 'r': opts.seed = atoi(optarg); break;
+            case 'o': opts.output = optarg; break;
+            default: return(false);
+        }
+    }
+
+    //!The bars take two channels each and the starts a module of their own
+    if (opts.numBars == 0 || opts.numBars * 2 > 16 * MAX_PIXIE_MOD ||
+        opts.numStarts == 0 || opts.numStarts > 16 || opts.numEvents == 0 ||
+        opts.traceLength < 32) {
+        cerr << "There has to be at least one bar, one start, one event and "
+             << "32 samples in a trace, and at most " << 8 * MAX_PIXIE_MOD
+             << " bars and 16 starts." << endl;
+        return(false);
+    }
+    return(true);
+}
+
+///\return the module holding the starts, the one after the bars
+unsigned int StartModule(const Options &opts) {
+    return((opts.numBars * 2 + 15) / 16);
+}
+
+///Writes the configuration of the bars and the starts
+bool WriteConfig(const Options &opts, const string &name) {
+    ofstream out(name.c_str());
+    out << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << endl
+        << "<Configuration>" << endl
+        << "  <Description>VANDLE benchmark</Description>" << endl
+        << "  <Global>" << endl
+        << "    <Revision version=\"F\"/>" << endl
+        << "    <BitResolution value=\"12\"/>" << endl
+        << "    <EventWidth unit=\"s\" value=\"1e-6\"/>" << endl
+        << "    <NumOfTraces value=\"50\"/>" << endl
+        << "    <HasRaw value=\"true\"/>" << endl
+        << "  </Global>" << endl
+        << "  <DetectorDriver>" << endl
+        << "    <Analyzer name=\"WaveformAnalyzer\"/>" << endl
+        << "    <Analyzer name=\"FittingAnalyzer\" type=\"analytic\"/>" << endl
+        << "    <Processor name=\"VandleProcessor\" types=\"small\" NumStarts=\""
+        << opts.numStarts << "\"/>" << endl
+        << "  </DetectorDriver>" << endl
+        << "  <Map verbose_calibration=\"False\" verbose_map=\"False\" "
+        << "verbose_walk=\"False\">" << endl;
+
+    unsigned int startModule = StartModule(opts);
+    for (unsigned int mod = 0; mod <= startModule; mod++) {
+        out << "    <Module number=\"" << mod << "\">" << endl;
+        for (unsigned int ch = 0; ch < 16; ch++) {
+            unsigned int chan = mod * 16 + ch;
+            if (mod < startModule && chan < opts.numBars * 2)
+                out << "      <Channel number=\"" << ch << "\" type=\"vandle\" "
+                    << "subtype=\"small\" tags=\""
+                    << (chan % 2 ? "right" : "left") << "\"></Channel>"
+                    << endl;
+            else if (mod == startModule && ch < opts.numStarts)
+                out << "      <Channel number=\"" << ch << "\" "
+                    << "type=\"beta_scint\" subtype=\"beta\"></Channel>"
+                    << endl;
+        }
+        out << "    </Module>" << endl;
+    }
+
+    out << "  </Map>" << endl
+        << "  <TimeCalibration verbose_timing=\"False\">" << endl
+        << "    <Vandle>" << endl
+        << "      <small>" << endl;
+    for (unsigned int bar = 0; bar < opts.numBars; bar++) {
+        out << "        <Bar number=\"" << bar << "\" lroffset=\"1.0\" "
+            << "z0=\"100.2\" xoffset=\"0\" zoffset=\"0\">" << endl;
+        for (unsigned int start = 0; start < opts.numStarts; start++)
+            out << "          <TofOffset location=\"" << start
+                << "\" offset=\"" << 10.0 + 2.0 * start << "\"/>" << endl;
+        out << "        </Bar>" << endl;
+    }
+    out << "      </small>" << endl
+        << "    </Vandle>" << endl
+        << "  </TimeCalibration>" << endl
+        << "  <Physical>" << endl
+        << "    <NeutronMass unit=\"MeV/c/c\" value=\"939.565560\"/>" << endl
+        << "    <SpeedOfLight unit=\"cm/ns\" value=\"29.9792458\"/>" << endl
+        << "    <SpeedOfLightSmall unit=\"cm/ns\" value=\"12.65822\"/>" << endl
+        << "    <SpeedOfLightBig unit=\"cm/ns\" value=\"15.22998\"/>" << endl
+        << "    <SmallLength unit=\"cm\" value=\"60.0\"/>" << endl
+        << "    <MediumLength unit=\"cm\" value=\"120.0\"/>" << endl
+        << "    <BigLength unit=\"cm\" value=\"200.0\"/>" << endl
+        << "  </Physical>" << endl
+        << "  <Trace>" << endl
+        << "    <TraceDelay unit=\"ns\" value=\"200\"/>" << endl
+        << "    <TraceLength unit=\"ns\" value=\"" << opts.traceLength * 4
+        << "\"/>" << endl
+        << "  </Trace>" << endl
+        << "  <Fitting>" << endl
+        << "    <SigmaBaselineThresh value=\"30.0\"/>" << endl
+        << "    <SiPmtSigmaBaselineThresh value=\"25.0\"/>" << endl
+        << "    <Parameters>" << endl
+        << "      <Pars name=\"vandle:small\"><Beta value=\"0.1\"/>"
+        << "<Gamma value=\"0.5\"/></Pars>" << endl
+        << "      <Pars name=\"beta_scint:beta\"><Beta value=\"0.1\"/>"
+        << "<Gamma value=\"0.5\"/></Pars>" << endl
+        << "    </Parameters>" << endl
+        << "  </Fitting>" << endl
+        << "  <TreeCorrelator name=\"root\" verbose=\"False\">" << endl
+        << "  </TreeCorrelator>" << endl
+        << "</Configuration>" << endl;
+    return(out.good());
+}
+
+///\return a channel with a single pulse in its trace
+XiaData *MakeChannel(const Options &opts, MTRand &rand,
+                     const unsigned int &mod, const unsigned int &ch,
+                     const double &time) {
+    XiaData *data = new XiaData();
+    data->modNum = mod;
+    data->chanNum = ch;
+    data->energy = 1000 + rand.randInt(3000);
+    data->time = time;
+    data->eventTimeLo = (unsigned int)time;
+    data->eventTimeHi = 0;
+
+    const double baseline = 400.;
+    unsigned int start = opts.traceLength / 4;
+    for (unsigned int i = 0; i < opts.traceLength; i++) {
+        double val = baseline + rand.randNorm(0., 3.);
+        if (i > start) {
+            double diff = i - start;
+            val += 0.5 * data->energy * exp(-0.1 * diff) *
+                (1 - exp(-pow(0.5 * diff, 4.)));
+        }
+        data->adcTrace.push_back((int)min(max(val, 0.), 16383.));
+    }
+    return(data);
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!ReadOptions(argc, argv, opts)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    string config = opts.output + ".xml";
+    if (!WriteConfig(opts, config)) {
+        cerr << "Could not write the configuration " << config << endl;
+        return 1;
+    }
+    Globals::get(config);
+    DetectorLibrary *modChan = DetectorLibrary::get();
+    DetectorDriver *driver = DetectorDriver::get();
+
+    output_his = new OutputHisFile(opts.output);
+    output_his->SetDebugMode(false);
+    driver->DeclarePlots();
+    output_his->Finalize();
+
+    RawEvent rawev;
+    modChan->PrintUsedDetectors(rawev);
+    driver->Init(rawev);
+
+    //!Every bar and every start fires at the same time
+    MTRand rand(opts.seed);
+    vector<XiaData*> data;
+    set<string> usedDetectors;
+    unsigned int startModule = StartModule(opts);
+    for (unsigned int chan = 0; chan < opts.numBars * 2; chan++)
+        data.push_back(MakeChannel(opts, rand, chan / 16, chan % 16, 1000.));
+    for (unsigned int ch = 0; ch < opts.numStarts; ch++)
+        data.push_back(MakeChannel(opts, rand, startModule, ch, 990.));
+    for (vector<XiaData*>::iterator it = data.begin(); it != data.end();
+         it++) {
+        ChanEvent *event = new ChanEvent(**it);
+        usedDetectors.insert((*modChan)[event->GetID()].GetType());
+        rawev.AddChan(event);
+    }
+    driver->ProcessEvent(rawev);
+
+    EventProcessor *vandle = driver->GetProcessor("VandleProcessor");
+    if (!vandle) {
+        cerr << "The VandleProcessor is not in the analysis" << endl;
+        return 1;
+    }
+    if (!vandle->PreProcess(rawev) || !vandle->Process(rawev)) {
+        cerr << "The VandleProcessor did not process the event" << endl;
+        return 1;
+    }
+
+    vector<double> times(opts.numEvents);
+    for (unsigned int i = 0; i < opts.numEvents; i++) {
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        vandle->PreProcess(rawev);
+        vandle->Process(rawev);
+        times[i] = chrono::duration<double, micro>(
+            chrono::steady_clock::now() - begin).count();
+    }
+    output_his->Flush();
+
+    double total = 0;
+    for (unsigned int i = 0; i < times.size(); i++)
+        total += times[i];
+    sort(times.begin(), times.end());
+    cout << "VandleProcessor with " << opts.numBars << " bars and "
+         << opts.numStarts << " starts over " << opts.numEvents
+         << " events" << endl
+         << "  mean   " << total / times.size() << " us/event" << endl
+         << "  median " << times[times.size() / 2] << " us/event" << endl
+         << "  p99    " << times[times.size() * 99 / 100] << " us/event"
+         << endl;
+
+    //!Zeroing the event deletes its channels
+    rawev.Zero(usedDetectors);
+    for (unsigned int i = 0; i < data.size(); i++)
+        delete data[i];
+    delete output_his;
+    return 0;
+}
@@ -0,0 +1,153 @@
+///\file test_coincidencekernel.cpp
+///\brief Checks the window edges and the ordering of the coincidences found
+/// by the CoincidenceKernel.
+///\date October 19, 2026
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CoincidenceKernel.hpp"
+
+#include "TestChecks.hpp"
+
+using namespace std;
+
+///\return a hit at time t, the energy is used to identify the hit
+CoincidenceHit Hit(const double &t, const double &e, const int &group = -1) {
+    CoincidenceHit hit = {t, e, group};
+    return(hit);
+}
+
+///\return the (energy, energy) of all of the pairs found in the list
+vector<pair<double,double> > FindPairs(const CoincidenceKernel &kernel,
+                                       const vector<CoincidenceHit> &hits) {
+    vector<pair<double,double> > found;
+    kernel.Pairs(hits, [&found](const CoincidenceHit &a,
+                                const CoincidenceHit &b) {
+        found.push_back(make_pair(a.energy, b.energy));
+    });
+    return(found);
+}
+
+///\return the (energy, energy) of all of the pairs found between the lists
+vector<pair<double,double> > FindPairs(const CoincidenceKernel &kernel,
+                                       const vector<CoincidenceHit> &a,
+                                       const vector<CoincidenceHit> &b) {
+    vector<pair<double,double> > found;
+    kernel.Pairs(a, b, [&found](const CoincidenceHit &x,
+                                const CoincidenceHit &y) {
+        found.push_back(make_pair(x.energy, y.energy));
+    });
+    return(found);
+}
+
+int main(int argc, char* argv[]){
+    cout << "Testing the CoincidenceKernel" << endl;
+
+    CoincidenceKernel kernel(10.);
+    vector<pair<double,double> > found;
+
+    //A time difference equal to the window is a coincidence, anything
+    // larger is not.
+    vector<CoincidenceHit> hits;
+    hits.push_back(Hit(0., 1.));
+    hits.push_back(Hit(10., 2.));
+    hits.push_back(Hit(20.5, 3.));
+    found = FindPairs(kernel, hits);
+    Check(found.size() == 1 && found[0] == make_pair(1., 2.),
+          "Pairs includes the window edge and excludes beyond it");
+
+    //Pairs are given earliest first and in the order of the first hit.
+    hits.clear();
+    hits.push_back(Hit(0., 1.));
+    hits.push_back(Hit(3., 2.));
+    hits.push_back(Hit(6., 3.));
+    hits.push_back(Hit(12., 4.));
+    found = FindPairs(kernel, hits);
+    vector<pair<double,double> > expected;
+    expected.push_back(make_pair(1., 2.));
+    expected.push_back(make_pair(1., 3.));
+    expected.push_back(make_pair(2., 3.));
+    expected.push_back(make_pair(2., 4.));
+    expected.push_back(make_pair(3., 4.));
+    Check(found == expected, "Pairs are found in time order");
+
+    //A zero window only pairs hits with identical times.
+    CoincidenceKernel zero;
+    hits.clear();
+    hits.push_back(Hit(5., 1.));
+    hits.push_back(Hit(5., 2.));
+    hits.push_back(Hit(5.001, 3.));
+    found = FindPairs(zero, hits);
+    Check(found.size() == 1 && found[0] == make_pair(1., 2.),
+          "A zero window only pairs simultaneous hits");
+
+    //Between two lists the window applies on both sides of the hit in a.
+    vector<CoincidenceHit> a, b;
+    a.push_back(Hit(20., 1.));
+    a.push_back(Hit(40., 2.));
+    b.push_back(Hit(9.9, 10.));
+    b.push_back(Hit(10., 11.));
+    b.push_back(Hit(30., 12.));
+    b.push_back(Hit(50., 13.));
+    b.push_back(Hit(50.1, 14.));
+    found = FindPairs(kernel, a, b);
+    expected.clear();
+    expected.push_back(make_pair(1., 11.));
+    expected.push_back(make_pair(1., 12.));
+    expected.push_back(make_pair(2., 12.));
+    expected.push_back(make_pair(2., 13.));
+    Check(found == expected, "Pairs between lists respect both window edges");
+
+    //An empty list never produces a pair.
+    found = FindPairs(kernel, a, vector<CoincidenceHit>());
+    Check(found.empty(), "Pairs with an empty list");
+    found = FindPairs(kernel, vector<CoincidenceHit>());
+    Check(found.empty(), "Pairs of an empty list");
+
+    //The folds are measured from the earliest hit of the combination.
+    hits.clear();
+    hits.push_back(Hit(0., 1.));
+    hits.push_back(Hit(5., 2.));
+    hits.push_back(Hit(10., 3.));
+    hits.push_back(Hit(15., 4.));
+    vector<vector<double> > folds;
+    unsigned int numFolds = kernel.Folds(hits, 3,
+        [&folds](const vector<const CoincidenceHit*> &fold) {
+            vector<double> energies;
+            for(unsigned int i = 0; i < fold.size(); i++)
+                energies.push_back(fold[i]->energy);
+            folds.push_back(energies);
+        });
+    Check(numFolds == 2 && folds.size() == 2 &&
+          folds[0] == vector<double>({1., 2., 3.}) &&
+          folds[1] == vector<double>({2., 3., 4.}),
+          "Triples are found within the window of the earliest hit");
+    Check(kernel.Folds(hits, 2, [](const vector<const CoincidenceHit*> &){})
+          == FindPairs(kernel, hits).size(),
+          "Folds of two are the same as the pairs");
+    Check(kernel.Folds(hits, 5, [](const vector<const CoincidenceHit*> &){})
+          == 0, "Folds larger than the number of hits");
+
+    //Sorting puts the hits in time order and keeps the order of hits that
+    // have the same time.
+    hits.clear();
+    hits.push_back(Hit(30., 1.));
+    hits.push_back(Hit(10., 2.));
+    hits.push_back(Hit(20., 3.));
+    hits.push_back(Hit(10., 4.));
+    CoincidenceKernel::Sort(hits);
+    Check(hits[0].energy == 2. && hits[1].energy == 4. &&
+          hits[2].energy == 3. && hits[3].energy == 1.,
+          "Sort orders by time and is stable");
+    found = FindPairs(kernel, hits);
+    expected.clear();
+    expected.push_back(make_pair(2., 4.));
+    expected.push_back(make_pair(2., 3.));
+    expected.push_back(make_pair(4., 3.));
+    expected.push_back(make_pair(3., 1.));
+    Check(found == expected, "Pairs of the sorted hits");
+
+    return(CheckSummary());
+}
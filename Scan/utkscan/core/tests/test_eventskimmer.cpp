@@ -0,0 +1,143 @@
+///\file test_eventskimmer.cpp
+///\brief Checks that the channels encoded by the EventSkimmer are read back
+/// unchanged by the Unpacker.
+///\date October 19, 2026
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "EventSkimmer.hpp"
+#include "Unpacker.hpp"
+#include "XiaData.hpp"
+
+#include "TestChecks.hpp"
+
+using namespace std;
+
+///Gives access to the buffer reading and the event list of the Unpacker
+class TestUnpacker : public Unpacker {
+public:
+    ///\return the number of channels read from the module buffer
+    int Read(vector<uint32_t> &buffer) {
+        unsigned long bufLen;
+        return(ReadBuffer(&buffer[0], bufLen));
+    }
+
+    ///\return the channels read for a module
+    const deque<XiaData*> &GetEvents(const unsigned int &mod) {
+        return(eventList.at(mod));
+    }
+};
+
+///\return a channel with every field that the list mode words hold
+XiaData *MakeChannel(const unsigned int &mod, const unsigned int &ch,
+                     const unsigned int &traceLength, const bool &hasQdc) {
+    XiaData *chan = new XiaData();
+    chan->modNum = mod;
+    chan->chanNum = ch;
+    chan->energy = 1234 + ch;
+    chan->eventTimeLo = 0x89ABCDEF + ch;
+    chan->eventTimeHi = 0x1234;
+    chan->cfdTime = 0x7FFF - ch;
+    for(unsigned int i = 0; i < traceLength; i++)
+        chan->push_back(400 + 10 * i + ch);
+    for(int i = 0; i < XiaData::numQdcs; i++)
+        chan->qdcValue[i] = hasQdc ? 1000 * (i + 1) + ch : 0;
+    return(chan);
+}
+
+///\return true if the channel read back is the same as the one encoded
+bool IsSame(const XiaData &in, const XiaData &out) {
+    bool same = in.chanNum == out.chanNum && in.modNum == out.modNum &&
+        in.eventTimeLo == out.eventTimeLo &&
+        in.eventTimeHi == out.eventTimeHi && in.cfdTime == out.cfdTime &&
+        in.virtualChannel == out.virtualChannel &&
+        in.pileupBit == out.pileupBit &&
+        in.saturatedBit == out.saturatedBit &&
+        in.adcTrace == out.adcTrace;
+    if(!in.saturatedBit)
+        same = same && in.energy == out.energy;
+    for(int i = 0; i < XiaData::numQdcs; i++)
+        same = same && in.qdcValue[i] == out.qdcValue[i];
+    return(same);
+}
+
+///\return a module buffer holding the encoded channels, as it is written
+/// in a spill of the skim
+vector<uint32_t> MakeBuffer(const unsigned int &mod,
+                            const vector<XiaData*> &channels) {
+    vector<uint32_t> buffer(2, 0);
+    for(unsigned int i = 0; i < channels.size(); i++)
+        EventSkimmer::Encode(*channels[i], buffer);
+    buffer[0] = buffer.size();
+    buffer[1] = mod;
+    return(buffer);
+}
+
+int main(int argc, char* argv[]){
+    cout << "Testing the encoding of the EventSkimmer" << endl;
+
+    //Channels with and without traces and onboard QDCs, and with the flags
+    vector<XiaData*> channels;
+    channels.push_back(MakeChannel(2, 0, 0, false));
+    channels.push_back(MakeChannel(2, 1, 124, false));
+    channels.push_back(MakeChannel(2, 5, 0, true));
+    channels.push_back(MakeChannel(2, 15, 250, true));
+    channels[1]->pileupBit = true;
+    channels[2]->virtualChannel = true;
+    channels[3]->saturatedBit = true;
+
+    vector<uint32_t> words;
+    EventSkimmer::Encode(*channels[0], words);
+    Check(words.size() == 4 && (words[0] & 0x0001F000) >> 12 == 4,
+          "A channel without QDCs has a header of 4 words");
+    words.clear();
+    EventSkimmer::Encode(*channels[3], words);
+    Check(words.size() == 12 + 125 && (words[0] & 0x0001F000) >> 12 == 12,
+          "A channel with QDCs has a header of 12 words and the trace");
+    Check((words[0] & 0xF0) >> 4 == 4, "The slot is the module plus two");
+
+    TestUnpacker unpacker;
+    vector<uint32_t> buffer = MakeBuffer(2, channels);
+    int numRead = unpacker.Read(buffer);
+    Check(numRead == int(channels.size()),
+          "Every encoded channel is read by the Unpacker");
+
+    const deque<XiaData*> &events = unpacker.GetEvents(2);
+    bool isSame = events.size() == channels.size();
+    for(unsigned int i = 0; isSame && i < channels.size(); i++) {
+        bool same = IsSame(*channels[i], *events[i]);
+        if(!same)
+            cout << "Channel " << channels[i]->chanNum
+                 << " differs after the round trip" << endl;
+        isSame = isSame && same;
+    }
+    Check(isSame, "The channels read back are the ones encoded");
+    Check(events.size() == channels.size() &&
+          events[3]->energy == 16383,
+          "A saturated channel is read with the largest energy");
+    Check(events.size() == channels.size() &&
+          events[1]->time == 0x1234 * 4294967296. + 0x89ABCDF0,
+          "The 48 bit time is rebuilt");
+
+    //An odd trace is padded with a zero sample to fill the last word
+    XiaData *odd = MakeChannel(0, 3, 7, false);
+    vector<XiaData*> oddChannels(1, odd);
+    buffer = MakeBuffer(0, oddChannels);
+    numRead = unpacker.Read(buffer);
+    const deque<XiaData*> &oddEvents = unpacker.GetEvents(0);
+    vector<int> padded = odd->adcTrace;
+    padded.push_back(0);
+    Check(numRead == 1 && oddEvents.size() == 1 &&
+          oddEvents[0]->adcTrace == padded,
+          "An odd trace is padded with a zero sample");
+
+    for(unsigned int i = 0; i < channels.size(); i++)
+        delete channels[i];
+    delete odd;
+
+    return(CheckSummary());
+}
@@ -0,0 +1,245 @@
+///\file test_hisserver.cpp
+///\brief Checks the snapshots and the delta transfers of the HisServer as
+/// they are seen by a HisClient.
+///\date October 19, 2026
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "HisClient.hpp"
+#include "HisFile.hpp"
+#include "HisServer.hpp"
+
+#include "TestChecks.hpp"
+
+using namespace std;
+
+///A DELTA reply for a single histogram as it was sent on the socket
+struct RawDelta {
+    bool isGood; ///< true if the reply was read and holds one histogram
+    HisDelta delta; ///< the header of the histogram
+    vector<uint32_t> values; ///< the bin values or the (bin, value) pairs
+};
+
+///\return a socket connected to the server, or -1 on failure
+int Connect(const string &path) {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(sock >= 0 && connect(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        sock = -1;
+    }
+    return(sock);
+}
+
+///Sends a DELTA request for one histogram on a socket of its own, so that
+/// the form of the transfer can be checked and not only its result
+RawDelta RequestDelta(const string &path, const unsigned int &hisID,
+                      const uint64_t &sequence) {
+    RawDelta raw;
+    raw.isGood = false;
+
+    int sock = Connect(path);
+    if(sock < 0)
+        return(raw);
+
+    HisRequest request;
+    request.command = HIS_DELTA;
+    request.hisID = hisID;
+    request.sequence = sequence;
+    HisReply reply;
+    vector<char> payload;
+    bool good = write(sock, &request, sizeof(request)) == sizeof(request) &&
+        recv(sock, &reply, sizeof(reply), MSG_WAITALL) == sizeof(reply) &&
+        reply.status == HIS_OK;
+    if(good && reply.length > 0) {
+        payload.resize(reply.length);
+        good = recv(sock, &payload[0], payload.size(), MSG_WAITALL) ==
+            (ssize_t)payload.size();
+    }
+    close(sock);
+
+    size_t header = sizeof(HisInfo) + sizeof(HisDelta);
+    if(!good || payload.size() < header)
+        return(raw);
+    memcpy(&raw.delta, &payload[sizeof(HisInfo)], sizeof(HisDelta));
+    raw.values.resize((payload.size() - header) / sizeof(uint32_t));
+    if(!raw.values.empty())
+        memcpy(&raw.values[0], &payload[header],
+               raw.values.size() * sizeof(uint32_t));
+    raw.isGood = raw.values.size() ==
+        raw.delta.count * (raw.delta.full ? 1 : 2);
+    return(raw);
+}
+
+int main(int argc, char* argv[]){
+    cout << "Testing the snapshots of the HisServer" << endl;
+
+    //A 1d histogram over three pages, a 16 bit one and a 2d one
+    drr_entry wide(100, 2, 10000, 10000, 0, 9999, "Wide");
+    drr_entry narrow(101, 1, 64, 64, 0, 63, "Narrow");
+    drr_entry square(200, 2, 32, 32, 0, 31, 16, 16, 0, 15, "Square");
+
+    HisServer server;
+    server.Add(&wide);
+    server.Add(&narrow);
+    server.Add(&square);
+
+    stringstream path;
+    path << "/tmp/test_hisserver_" << getpid() << ".sock";
+    if(!server.Start(path.str())) {
+        cerr << "Could not start the server on " << path.str() << endl;
+        return 1;
+    }
+
+    server.Fill(100, 0, 1);
+    server.Fill(100, 4095, 2);
+    server.Fill(100, 4096, 3);
+    server.Fill(100, 9999, 4);
+    server.Fill(100, 4096, 3);
+    server.Fill(101, 10, 5);
+    for(unsigned int y = 0; y < 16; y++)
+        for(unsigned int x = 0; x < 32; x++)
+            server.Fill(200, y * 32 + x, x + 100 * y);
+    Check(server.GetSequence() == 0, "Fills are not seen before a publish");
+    server.Publish();
+    Check(server.GetSequence() == 1, "A publish makes a new snapshot");
+
+    HisClient client;
+    if(!client.Connect(path.str())) {
+        cerr << "Could not connect to the server" << endl;
+        return 1;
+    }
+
+    vector<HisInfo> list;
+    Check(client.List(list) && list.size() == 3 &&
+          list[0].hisID == 100 && list[0].xbins == 10000 &&
+          list[0].ybins == 1 && list[1].halfWords == 1 &&
+          list[2].dim == 2 && list[2].xbins == 32 && list[2].ybins == 16 &&
+          string(list[2].title) == "Square",
+          "The list describes every histogram");
+
+    HisSnapshot his;
+    Check(client.Get(100, his) && his.sequence == 1 &&
+          his.info.sequence == 1 && his.Get(0) == 1 &&
+          his.Get(4095) == 2 && his.Get(4096) == 6 && his.Get(9999) == 4 &&
+          his.Get(1) == 0, "A histogram is read across its pages");
+    Check(!client.Get(999, his) && client.GetStatus() == HIS_UNKNOWN_ID,
+          "An unknown histogram is refused");
+    client.Get(100, his);
+
+    map<unsigned int, HisSnapshot> hists;
+    uint64_t sequence = 0;
+    Check(client.Update(hists, sequence) && sequence == 1 &&
+          hists.size() == 3 && hists[101].Get(10) == 5 &&
+          hists[200].Get(31, 15) == 31 + 1500,
+          "An empty map is filled with everything that changed");
+
+    //A few fills of one histogram are sent as the bins that changed
+    server.Fill(100, 4096, 10);
+    server.Fill(100, 5000, 7);
+    server.Publish();
+    RawDelta raw = RequestDelta(path.str(), 100, 1);
+    Check(raw.isGood && !raw.delta.full && raw.delta.count == 2 &&
+          raw.values[0] == 4096 && raw.values[1] == 16 &&
+          raw.values[2] == 5000 && raw.values[3] == 7,
+          "A delta from the last snapshot holds only the changed bins");
+    raw = RequestDelta(path.str(), 100, 0);
+    Check(raw.isGood && raw.delta.full && raw.delta.count == 10000,
+          "A delta from an older snapshot holds every bin");
+
+    Check(client.Update(his) && his.sequence == 2 &&
+          his.info.sequence == 2 && his.Get(4096) == 16 &&
+          his.Get(5000) == 7 && his.Get(9999) == 4,
+          "A histogram is brought up to date from the delta");
+    Check(client.Update(hists, sequence) && sequence == 2 &&
+          hists[100].Get(4096) == 16 && hists[100].Get(0) == 1 &&
+          hists[101].info.sequence == 1 && hists[200].info.sequence == 1,
+          "Only the changed histograms of a map are updated");
+
+    //Zeroing drops the earlier fills of the snapshot and sends every bin
+    server.Fill(101, 20, 1);
+    server.Zero(101);
+    server.Fill(101, 30, 70000);
+    server.Publish();
+    raw = RequestDelta(path.str(), 101, 2);
+    Check(raw.isGood && raw.delta.full && raw.delta.count == 64,
+          "A zeroed histogram is sent whole");
+    Check(client.Update(hists, sequence) && sequence == 3 &&
+          hists[101].Get(10) == 0 && hists[101].Get(20) == 0 &&
+          hists[101].Get(30) == (70000 & 0xFFFF),
+          "A zeroed 16 bit histogram keeps only the later fills");
+    Check(client.Update(hists, sequence) && sequence == 3,
+          "An update without changes keeps the sequence");
+
+    //The projections of the 2d histogram over a range of the other axis
+    HisInfo info;
+    vector<uint64_t> values;
+    Check(client.Project(200, 0, 2, 3, info, values) && values.size() == 32 &&
+          values[0] == 200 + 300 && values[31] == 2 * 31 + 500,
+          "The x projection sums the requested rows");
+    Check(client.Project(200, 1, 0, 1000, info, values) &&
+          values.size() == 16 && values[0] == 31 * 32 / 2 &&
+          values[15] == 31 * 32 / 2 + 32 * 1500,
+          "The y projection is clipped to the histogram");
+    Check(!client.Project(100, 0, 0, 0, info, values) &&
+          client.GetStatus() == HIS_NOT_2D,
+          "A 1d histogram has no projection");
+    Check(!client.Project(200, 0, 16, 20, info, values) &&
+          client.GetStatus() == HIS_BAD_RANGE,
+          "A range outside of the histogram is refused");
+
+    //A viewer which stops halfway through a request and one which never
+    //reads its replies must not hold up the others or the scan
+    int partial = Connect(path.str());
+    HisRequest request;
+    request.command = HIS_LIST;
+    Check(partial >= 0 && write(partial, &request, sizeof(request) / 2) ==
+          (ssize_t)sizeof(request) / 2, "A viewer sends half a request");
+    int greedy = Connect(path.str());
+    request.command = HIS_GET;
+    request.hisID = 100;
+    bool isSent = greedy >= 0;
+    for(unsigned int i = 0; i < 64 && isSent; i++)
+        isSent = write(greedy, &request, sizeof(request)) ==
+            (ssize_t)sizeof(request);
+    Check(isSent, "A viewer asks for many replies without reading them");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    Check(client.Get(100, his) && his.Get(4096) == 16 && client.List(list),
+          "Other viewers are answered while they stall");
+
+    client.Close();
+    atomic<bool> isStopped(false);
+    thread stopper([&server, &isStopped]() {
+        server.Stop();
+        isStopped = true;
+    });
+    for(unsigned int i = 0; i < 50 && !isStopped; i++)
+        this_thread::sleep_for(chrono::milliseconds(100));
+    Check(isStopped, "The server stops while viewers stall");
+    if(!isStopped) {
+        stopper.detach();
+        _exit(CheckSummary());
+    }
+    stopper.join();
+    close(partial);
+    close(greedy);
+    Check(access(path.str().c_str(), F_OK) != 0,
+          "Stopping the server removes the socket");
+
+    return(CheckSummary());
+}
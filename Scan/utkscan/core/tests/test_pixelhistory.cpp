@@ -0,0 +1,111 @@
+///\file test_pixelhistory.cpp
+///\brief Checks that a PixelHistory keeps the pinned implant of a decay chain
+/// that is longer than its depth, and that its handles never refer to an
+/// event that has been replaced.
+///\date October 19, 2026
+#include <iostream>
+#include <string>
+
+#include "PixelHistory.hpp"
+
+#include "TestChecks.hpp"
+
+using namespace std;
+
+///A simple event of a chain, the implant has a generation of 0
+struct ChainEvent {
+    double time; ///< the time of the event
+    int generation; ///< the position of the event in the chain
+};
+
+///\return an event of the chain
+ChainEvent Event(const double &time, const int &generation) {
+    ChainEvent event = {time, generation};
+    return(event);
+}
+
+///Tells if an event is older than the given time
+struct IsBefore {
+    double time; ///< the earliest time that is kept
+    ///\return true if the event happened before the time
+    bool operator()(const ChainEvent &event) const {
+        return(event.time < time);
+    }
+};
+
+int main(int argc, char* argv[]){
+    cout << "Testing the PixelHistory" << endl;
+
+    const size_t depth = 4;
+    const size_t pixel = 1;
+    const int chainLength = 3 * depth;
+
+    //A chain longer than the depth keeps the implant and the newest decays.
+    PixelHistory<ChainEvent> history(3, depth);
+    history.push_back(pixel, Event(0., 0));
+    history.pin(pixel);
+    PixelHistory<ChainEvent>::Handle implant = history.handle(pixel, 0);
+    PixelHistory<ChainEvent>::Handle firstDecay;
+    for(int i = 1; i <= chainLength; i++) {
+        history.push_back(pixel, Event(i, i));
+        if(i == 1)
+            firstDecay = history.handle(pixel, 1);
+    }
+    Check(history.size(pixel) == depth, "The chain is limited to the depth");
+    Check(history.front(pixel).generation == 0,
+          "The implant is kept by a full chain");
+    bool isNewest = true;
+    for(size_t i = 1; i < depth; i++)
+        if(history.at(pixel, i).generation !=
+           chainLength - int(depth) + 1 + int(i))
+            isNewest = false;
+    Check(isNewest, "The newest decays are kept in order");
+    Check(history.GetOverflows(pixel) == chainLength + 1 - depth &&
+          history.GetOverflows() == chainLength + 1 - depth,
+          "The dropped decays are counted");
+    Check(history.empty(0) && history.empty(2),
+          "The other pixels are untouched");
+
+    //The handles follow the pinned implant and forget the dropped decays.
+    Check(history.get(implant) != NULL &&
+          history.get(implant)->generation == 0,
+          "The handle of the implant follows it");
+    Check(history.get(firstDecay) == NULL,
+          "The handle of a dropped decay is empty");
+    Check(history.get(PixelHistory<ChainEvent>::Handle()) == NULL,
+          "A default handle is empty");
+
+    //The time window does not remove the implant either.
+    IsBefore window = {chainLength - 0.5};
+    size_t expired = history.pop_front_while(pixel, window);
+    Check(expired == depth - 2 && history.size(pixel) == 2 &&
+          history.front(pixel).generation == 0 &&
+          history.back(pixel).generation == chainLength,
+          "The time window keeps the implant");
+
+    //A new chain in the same slots does not revive the old handles.
+    history.clear(pixel);
+    history.push_back(pixel, Event(100., 0));
+    history.pin(pixel);
+    Check(history.get(implant) == NULL && history.pinned(pixel) == 1,
+          "The handle of a cleared implant is empty");
+
+    //When every event is pinned the new one is dropped.
+    PixelHistory<ChainEvent> pinned(1, 2);
+    pinned.push_back(0, Event(0., 0));
+    pinned.push_back(0, Event(1., 1));
+    pinned.pin(0);
+    Check(!pinned.push_back(0, Event(2., 2)) &&
+          pinned.back(0).generation == 1,
+          "A fully pinned pixel drops the new event");
+
+    //Without overwrite a full chain keeps its first generations.
+    PixelHistory<ChainEvent> keep(1, depth, false);
+    for(int i = 0; i < chainLength; i++)
+        keep.push_back(0, Event(i, i));
+    Check(keep.size(0) == depth && keep.front(0).generation == 0 &&
+          keep.back(0).generation == int(depth) - 1,
+          "Without overwrite the first generations are kept");
+
+    return(CheckSummary());
+}
@@ -8,6 +8,7 @@
 #define __ANL1471PROCESSOR_HPP_
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 #include "VandleProcessor.hpp"
 
 /// Class to process VANDLE related events
@@ -29,12 +30,18 @@ public:
                     const double &res, const double &offset,
                     const double &numStarts);
 
+    /** Initializes the processor and resolves its places
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
+
     /** Process the event
     * \param [in] event : the event to process
     * \return Returns true if the processing was successful */
     virtual bool Process(RawEvent &event);
 private:
     std::string fileName_; //!< name of the his file
+    PlaceHandle<> cyclePlace_; //!< the Cycle place, resolved once in Init
     std::vector<std::string> fileNames_; //!< vector of output file names
 };
 #endif
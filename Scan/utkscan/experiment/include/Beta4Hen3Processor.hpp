@@ -8,15 +8,24 @@
 
 #include "BetaScintProcessor.hpp"
 
+class LogicProcessor;
+
 ///Class to handle Beta events for the 3Hen detector
 class Beta4Hen3Processor : public BetaScintProcessor {
 public:
     /** Constructor taking two arguments */
     Beta4Hen3Processor(double gammaBetaLimit, double energyContracion);
+    /** Initializes the processor and finds the LogicProcessor
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
     /** Process the events */
     virtual bool Process(RawEvent &event);
     /** Declare the plots */
     virtual void DeclarePlots(void);
+private:
+    LogicProcessor *logic_; //!< the LogicProcessor, NULL if it is not used
+    PlaceHandle<PlaceCounter> neutronsPlace_; //!< the Neutrons place
 };
 
 #endif // __BETA4HEN3PROCSSEOR_HPP_
@@ -5,9 +5,12 @@
 #ifndef __DSSD4SHE_PROCESSOR_HPP_
 #define __DSSD4SHE_PROCESSOR_HPP_
 
+#include <string>
 #include <vector>
 #include <utility>
 #include "EventProcessor.hpp"
+#include "Messenger.hpp"
+#include "PlaceHandle.hpp"
 #include "RawEvent.hpp"
 #include "SheCorrelator.hpp"
 
@@ -69,6 +72,10 @@ public:
                       double fisisonEnergyCut, 
                       int numFrontStrips, 
                       int numBackStrips);
+    /** Finds the places used by the processor
+     * \param [in] event : the event to initialize with
+     * \return true if the init was successful */
+    virtual bool Init(RawEvent &event);
     /** Declare plots */
     virtual void DeclarePlots();
     /** Perform preprocess */
@@ -108,6 +115,22 @@ protected:
         bool pileup; //!< if we had a pileup
     };
 
+    /** \return true if the strip event a happened before b */
+    static bool CompareStripTime(const std::pair<StripEvent, bool> &a,
+                                 const std::pair<StripEvent, bool> &b) {
+        return a.first.t < b.first.t;
+    }
+
+    /** Fills the strip events of one side of the detector, including the
+     * additional pulses found in the traces, and sorts them by time.
+     * \param [in] events : the channels that fired on this side
+     * \param [out] strips : the strip events that were found
+     * \param [in] side : the name of the side for the messages
+     * \param [in] correlatedId : the dE vs. dPos self correlation plot */
+    void FillStrips(const std::vector<ChanEvent*> &events,
+                    std::vector<std::pair<StripEvent, bool> > &strips,
+                    const std::string &side, int correlatedId);
+
     SheCorrelator correlator_; //!< instance of the Correlator 
 
     /** Events matched based on energy (MaxEvent) **/
@@ -116,6 +139,16 @@ protected:
     /** Events matched based on timing correlation  **/
     std::vector<std::pair<StripEvent, StripEvent> > xyEventsTMatch_; 
 
+    /** Strip events of the X and Y sides with their matched flag, these
+     * are kept between events to reuse the memory **/
+    std::vector<std::pair<StripEvent, bool> > xStrips_;
+    std::vector<std::pair<StripEvent, bool> > yStrips_;
+    /** Index of the strips that fired (not the pileup pulses) **/
+    std::vector<size_t> primaries_;
+
+    Messenger messenger_; //!< reports the additional pulses
+    PlaceHandle<> beamPlace_; //!< the Beam place, resolved in Init
+
     /**Limit in seconds for the time difference between front and
      * back to be correlated. Also to find Si Side detectors correlated
      * events (escapes)*/
@@ -21,10 +21,19 @@ public:
                 double gammaBetaLimit, double gammaGammaLimit,
                 double cycle_gate1_min, double cycle_gate1_max,
                 double cycle_gate2_min, double cycle_gate2_max);
+    /** Finds the neutron places in addition to the GeProcessor ones
+     * \param [in] event : the event to initialize with
+     * \return true if the init was successful */
+    virtual bool Init(RawEvent &event);
     /** Process the event */
     virtual bool Process(RawEvent &event);
     /** Declare the plots */
     virtual void DeclarePlots(void);
+private:
+    static const int numNeutronLocations_ = 48; //!< the number of 3Hen tubes
+
+    PlaceHandle<PlaceCounter> neutronsPlace_; //!< counts the neutrons
+    PlaceFamily<> neutronPlaces_; //!< Neutron_N for each 3Hen tube
 };
 
 #endif // __GE4HEN3PROCESSOR_HPP_
@@ -10,6 +10,9 @@
 #include <fstream>
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
+
+class LogicProcessor;
 
 #ifdef useroot
 #include <TFile.h>
@@ -28,6 +31,12 @@ public:
     /** Declare the plots used in the analysis */
     virtual void DeclarePlots(void);
 
+    /** Initializes the processor, finds the LogicProcessor and resolves
+     * the places
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
+
     /** PreProcess does nothing since this is solely dependent on results
      from other Processors*/
     virtual bool PreProcess(RawEvent &event);
@@ -44,5 +53,9 @@ private:
     TH1D *vsize_; //!< a 1D histogram in root
 #endif
     std::ofstream *outstream; //!< filestream to output to text file
+    LogicProcessor *logic_; //!< the LogicProcessor, NULL if it is not used
+    PlaceHandle<> protonPlace_; //!< the logic_t1_0 place, resolved in Init
+    PlaceHandle<> tapeMovePlace_; //!< the TapeMove place, resolved in Init
+    PlaceHandle<> betaPlace_; //!< the Beta place, resolved once in Init
 };
 #endif
@@ -8,6 +8,7 @@
 #include <fstream>
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 
 #ifdef useroot
 #include <TFile.h>
@@ -28,6 +29,11 @@ public:
     /** Declare the plots used in the analysis */
     virtual void DeclarePlots(void);
 
+    /** Initializes the processor and resolves its places
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
+
     /** PreProcess does nothing since this is solely dependent on results
      from other Processors*/
     virtual bool PreProcess(RawEvent &event);
@@ -47,6 +53,8 @@ private:
     std::string fileName_; //!< String to hold the file name from command line
     std::ofstream *poutstream_; //!< Pointer to ouptut ASCII file stream.
     double gCutoff_; //!< Variable used to set gamma cutoff energy
+    PlaceHandle<> tapeMovePlace_; //!< the TapeMove place, resolved in Init
+    PlaceHandle<> betaPlace_; //!< the Beta place, resolved once in Init
 
 #ifdef useroot
     /** Method to setup the ROOT output, tree and histograms */
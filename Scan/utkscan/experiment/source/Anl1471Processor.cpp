@@ -82,20 +82,26 @@ Anl1471Processor::Anl1471Processor(const std::vector<std::string> &typeList,
     fileNames_.push_back(fileName_ + "-tof-04Plus.dat");
 }
 
+bool Anl1471Processor::Init(RawEvent &event) {
+    if (!VandleProcessor::Init(event))
+        return(false);
+    cyclePlace_.Resolve("Cycle");
+    return(true);
+}
+
 bool Anl1471Processor::Process(RawEvent &event) {
     if (!EventProcessor::Process(event))
         return(false);
     if(!VandleProcessor::Process(event))
         return(false);
 
-    for (BarMap::iterator it = bars_.begin(); it !=  bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
+    for (BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
         if(!bar.GetHasEvent())
             continue;
 
-        unsigned int barLoc = barId.first;
-        TimingCalibration cal = bar.GetCalibration();
+        unsigned int barLoc = bar.GetNumber();
+        const TimingCalibration &cal = bar.GetCalibration();
 
         int bananaNum;
 	if(bar.GetType() == "small")
@@ -103,11 +109,11 @@ bool Anl1471Processor::Process(RawEvent &event) {
 	if(bar.GetType() == "medium")
 	    bananaNum = 1;
 
-        for(BarMap::iterator itStart = barStarts_.begin();
+        for(BarList::const_iterator itStart = barStarts_.begin();
         itStart != barStarts_.end(); itStart++) {
-            BarDetector start = (*itStart).second;
+            const BarDetector &start = *itStart;
             
-            unsigned int startLoc = (*itStart).first.first;
+            unsigned int startLoc = start.GetNumber();
             unsigned int barPlusStartLoc = numStarts_*barLoc+startLoc;
 	    
             double tofOffset = cal.GetTofOffset(startLoc);
@@ -132,7 +138,7 @@ bool Anl1471Processor::Process(RawEvent &event) {
 		data.close();
             }
 
-            double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+            double cycleTime = cyclePlace_->last().time;
             cycleTime *= (Globals::get()->clockInSeconds()*1.e9);
 
             double decayTime = (bar.GetTimeAverage() - cycleTime)/0.01;
@@ -10,6 +10,8 @@
 #include "ChanEvent.hpp"
 #include "BetaScintProcessor.hpp"
 #include "Beta4Hen3Processor.hpp"
+#include "DetectorDriver.hpp"
+#include "LogicProcessor.hpp"
 
 using namespace std;
 using namespace dammIds::beta_scint;
@@ -41,6 +43,16 @@ namespace dammIds {
 Beta4Hen3Processor::Beta4Hen3Processor(double gammaBetaLimit,
                                        double energyContraction) :
     BetaScintProcessor(gammaBetaLimit, energyContraction) {
+    logic_ = NULL;
+}
+
+bool Beta4Hen3Processor::Init(RawEvent &event) {
+    if (!BetaScintProcessor::Init(event))
+        return false;
+    logic_ = dynamic_cast<LogicProcessor*>(
+        DetectorDriver::get()->GetProcessor("LogicProcessor"));
+    neutronsPlace_.Resolve("Neutrons");
+    return true;
 }
 
 void Beta4Hen3Processor::DeclarePlots(void) {
@@ -138,9 +150,7 @@ bool Beta4Hen3Processor::Process(RawEvent &event)
 
     /* Number of neutrons as selected by gates on 3hen spectrum.
      * See DetectorDriver::InitCorrelator for gates. */
-    int neutron_count = 
-        dynamic_cast<PlaceCounter*>(
-                TreeCorrelator::get()->place("Neutrons"))->getCounter();
+    int neutron_count = neutronsPlace_->getCounter();
 
     /** All non-neutron related spectra are processed in the base class 
      * Here we are interested in neutron spectra only so there is no need
@@ -153,11 +163,16 @@ bool Beta4Hen3Processor::Process(RawEvent &event)
 
     double clockInSeconds = Globals::get()->clockInSeconds();
 
-    /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    /** Place Cycle is activated by BeamOn event and deactivated by TapeMove,
+     * the LogicProcessor keeps the same cycles when it is used */
+    bool tapeMove;
+    if (logic_ != NULL && logic_->GetCycleTimeline().GetStarts() > 0)
+        tapeMove = !logic_->GetCycleTimeline().IsOn();
+    else
+        tapeMove = !(cyclePlace_->status());
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = cyclePlace_->last().time;
 
     for (vector<ChanEvent*>::const_iterator it = scintBetaEvents.begin(); 
 	 it != scintBetaEvents.end(); it++) {
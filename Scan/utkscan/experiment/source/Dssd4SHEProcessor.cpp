@@ -54,6 +54,13 @@ Dssd4SHEProcessor::Dssd4SHEProcessor(double timeWindow,
 }
 
 
+bool Dssd4SHEProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+    beamPlace_.Resolve("Beam");
+    return(true);
+}
+
 void Dssd4SHEProcessor::DeclarePlots(void)
 {
     using namespace dammIds::dssd;
@@ -142,204 +149,153 @@ void Dssd4SHEProcessor::DeclarePlots(void)
 }
 
 
-bool Dssd4SHEProcessor::PreProcess(RawEvent &event) {
-    if (!EventProcessor::PreProcess(event))
-        return false;
+void Dssd4SHEProcessor::FillStrips(const std::vector<ChanEvent*> &events,
+                                   std::vector<std::pair<StripEvent, bool> >
+                                   &strips, const std::string &side,
+                                   int correlatedId) {
+    strips.clear();
+    primaries_.clear();
 
-    xyEventsTMatch_.clear();
-    xyEventsEMatch_.clear();
-
-    vector<ChanEvent*> xEvents = 
-        event.GetSummary("dssd_back:dssd_back", true)->GetList();
-    vector<ChanEvent*> yEvents = 
-        event.GetSummary("dssd_front:dssd_front", true)->GetList();
-
-    /**
-     * Matching the front-back by the time correlations
-     */
-    vector< pair<StripEvent, bool> > xEventsTMatch;
-    vector< pair<StripEvent, bool> > yEventsTMatch;
-
-    for (vector<ChanEvent*>::iterator itx = xEvents.begin();
-         itx != xEvents.end();
-         ++itx) {
-        StripEvent ev((*itx)->GetCalEnergy(), 
-                      (*itx)->GetTime(),
-                      (*itx)->GetChanID().GetLocation(),
-                      (*itx)->IsSaturated());
-        pair<StripEvent, bool> match(ev, false);
-        xEventsTMatch.push_back(match);
-
-        const Trace& trace = (*itx)->GetTrace();
+    for (vector<ChanEvent*>::const_iterator it = events.begin();
+         it != events.end(); ++it) {
+        StripEvent ev((*it)->GetCalEnergy(),
+                      (*it)->GetTime(),
+                      (*it)->GetChanID().GetLocation(),
+                      (*it)->IsSaturated());
+        primaries_.push_back(strips.size());
+        strips.push_back(make_pair(ev, false));
 
         /** Handle additional pulses (no. 2, 3, ...) */
-        int pulses = trace.GetValue("numPulses");
-        for (int i = 1; i < pulses; ++i) {
-            stringstream energyCalName;
-            energyCalName << "filterEnergy" << i + 1 << "Cal";
-            stringstream timeName;
-            timeName << "filterTime" << i + 1;
-
-            ev.pileup = true;
-
-            StripEvent ev2;
-            ev2.E = trace.GetValue(energyCalName.str());
-            ev2.t = (trace.GetValue(timeName.str()) - 
-                     trace.GetValue("filterTime") + ev.t);
-            ev2.pos = ev.pos;
-            ev2.sat = false;
+        const vector<Trace::Pulse> &pulses = (*it)->GetTrace().GetPulses();
+        if (pulses.size() > 1)
+            strips[primaries_.back()].first.pileup = true;
+        for (size_t i = 1; i < pulses.size(); ++i) {
+            StripEvent ev2(pulses[i].calEnergy,
+                           pulses[i].time - pulses[0].time + ev.t,
+                           ev.pos, false);
             ev2.pileup = true;
-            pair<StripEvent, bool> match2(ev2, false);
-            xEventsTMatch.push_back(match2);
+            strips.push_back(make_pair(ev2, false));
 
             if (i > 1) {
                 stringstream ss;
-                ss << "DSSD X, " << i + 1 << " pulse"
-                << ", E = " << ev2.E
-                << ", dt = " << ev2.t - ev.t;
-                Messenger m;
-                m.run_message(ss.str());
+                ss << "DSSD " << side << ", " << i + 1 << " pulse"
+                   << ", E = " << ev2.E
+                   << ", dt = " << ev2.t - ev.t;
+                messenger_.run_message(ss.str());
             }
         }
+    }
 
-        for (vector<ChanEvent*>::iterator itx2 = itx;
-            itx2 != xEvents.end();
-            ++itx2) {
-            int dx = abs( ev.pos -
-                          (*itx2)->GetChanID().GetLocation());
-            double dE = abs( ev.E -
-                             (*itx2)->GetCalEnergy());
-            plot(DD_DENERGY__DPOS_X_CORRELATED, dE, dx);
+    /** Self correlations of the strips that fired */
+    for (vector<size_t>::const_iterator it = primaries_.begin();
+         it != primaries_.end(); ++it) {
+        const StripEvent &ev = strips[*it].first;
+        for (vector<size_t>::const_iterator it2 = it;
+             it2 != primaries_.end(); ++it2) {
+            const StripEvent &ev2 = strips[*it2].first;
+            plot(correlatedId, abs(ev.E - ev2.E), abs(ev.pos - ev2.pos));
         }
     }
 
-    for (vector<ChanEvent*>::iterator ity = yEvents.begin();
-         ity != yEvents.end();
-         ++ity) {
-        StripEvent ev((*ity)->GetCalEnergy(), 
-                      (*ity)->GetTime(),
-                      (*ity)->GetChanID().GetLocation(),
-                      (*ity)->IsSaturated());
-        pair<StripEvent, bool> match(ev, false);
-        yEventsTMatch.push_back(match);
-
-        const Trace& trace = (*ity)->GetTrace();
-
-        int pulses = trace.GetValue("numPulses");
-        for (int i = 1; i < pulses; ++i) {
-            stringstream energyCalName;
-            energyCalName << "filterEnergy" << i + 1 << "Cal";
-            stringstream timeName;
-            timeName << "filterTime" << i + 1;
-
-            ev.pileup = true;
-
-            StripEvent ev2;
-            ev2.E = trace.GetValue(energyCalName.str());
-            ev2.t = (trace.GetValue(timeName.str()) - 
-                     trace.GetValue("filterTime") + ev.t);
-            ev2.pos = ev.pos;
-            ev2.sat = false;
-            ev2.pileup = true;
-            pair<StripEvent, bool> match2(ev2, false);
-            yEventsTMatch.push_back(match2);
+    sort(strips.begin(), strips.end(), CompareStripTime);
+}
 
-            if (i > 1) {
-                stringstream ss;
-                ss << "DSSD Y, " << i + 1 << " pulse"
-                << ", E = " << ev2.E
-                << ", dt = " << ev2.t - ev.t;
-                Messenger m;
-                m.run_message(ss.str());
-            }
-        }
+bool Dssd4SHEProcessor::PreProcess(RawEvent &event) {
+    if (!EventProcessor::PreProcess(event))
+        return false;
 
-        for (vector<ChanEvent*>::iterator ity2 = ity;
-            ity2 != yEvents.end();
-            ++ity2) {
-            int dy = abs( ev.pos -
-                          (*ity2)->GetChanID().GetLocation());
-            double dE = abs( ev.E -
-                             (*ity2)->GetCalEnergy());
-            plot(DD_DENERGY__DPOS_Y_CORRELATED, dE, dy);
-        }
-    }
+    xyEventsTMatch_.clear();
+    xyEventsEMatch_.clear();
+
+    const vector<ChanEvent*> &xEvents =
+        event.GetSummary("dssd_back:dssd_back", true)->GetList();
+    const vector<ChanEvent*> &yEvents =
+        event.GetSummary("dssd_front:dssd_front", true)->GetList();
+
+    /**
+     * Matching the front-back by the time correlations. Both sides are
+     * sorted by time so that for each X strip only the Y strips inside of
+     * the search window are considered.
+     */
+    FillStrips(xEvents, xStrips_, "X", DD_DENERGY__DPOS_X_CORRELATED);
+    FillStrips(yEvents, yStrips_, "Y", DD_DENERGY__DPOS_Y_CORRELATED);
 
-    for (vector< pair<StripEvent, bool> >::iterator itx = xEventsTMatch.begin();
-         itx != xEventsTMatch.end();
+    double clockInSeconds = Globals::get()->clockInSeconds();
+    /** Anything further away than this can neither be matched nor change
+     * the D_DTIME bin, which saturates at S8 - 1 */
+    double searchWindow = max(timeWindow_, S8 * 1.0e-8) / clockInSeconds;
+
+    vector< pair<StripEvent, bool> >::iterator first = yStrips_.begin();
+    for (vector< pair<StripEvent, bool> >::iterator itx = xStrips_.begin();
+         itx != xStrips_.end();
          ++itx) {
+        const StripEvent &x = (*itx).first;
+        while (first != yStrips_.end() &&
+               (*first).first.t < x.t - searchWindow)
+            ++first;
+
+        /** If energies are in lower range and/or not satured
+         *  check if delta energy condition is not met,
+         *  if not, skip this event
+         *
+         *  For high energy events and satured set 20 MeV
+         *  energy for difference check. The calibration in this
+         *  range is most likely imprecise, so one cannot correlate
+         *  by energy difference.
+         **/
+        double energyX = x.E;
+        if (x.sat || energyX > highEnergyCut_)
+            energyX = 20000.0;
+
         double bestDtime = numeric_limits<double>::max();
         vector< pair<StripEvent, bool> >::iterator bestMatch =
-            yEventsTMatch.end();
-        for (vector< pair<StripEvent, bool> >::iterator ity = 
-                                                     yEventsTMatch.begin();
-            ity != yEventsTMatch.end();
-            ++ity) 
-        {
+            yStrips_.end();
+        for (vector< pair<StripEvent, bool> >::iterator ity = first;
+             ity != yStrips_.end() && (*ity).first.t <= x.t + searchWindow;
+             ++ity) {
             // If already matched, skip
             if ((*ity).second)
                 continue;
 
-            double energyX = (*itx).first.E;
             double energyY = (*ity).first.E;
-
-            /** If energies are in lower range and/or not satured
-             *  check if delta energy condition is not met, 
-             *  if not, skip this event
-             *
-             *  For high energy events and satured set 20 MeV
-             *  energy for difference check. The calibration in this
-             *  range is most likely imprecise, so one cannot correlate
-             *  by energy difference.
-             **/
-            if ( (*itx).first.sat || energyX > highEnergyCut_ )
-                energyX = 20000.0;
-            if ( (*ity).first.sat || energyY > highEnergyCut_ )
+            if ((*ity).first.sat || energyY > highEnergyCut_)
                 energyY = 20000.0;
-            if ( abs(energyX - energyY) > deltaEnergy_)
+            if (abs(energyX - energyY) > deltaEnergy_)
                 continue;
 
-            double dTime = abs((*itx).first.t - (*ity).first.t) *
-                                Globals::get()->clockInSeconds();
+            double dTime = abs(x.t - (*ity).first.t) * clockInSeconds;
             if (dTime < bestDtime) {
                 bestDtime = dTime;
                 bestMatch = ity;
             }
         }
+
         if (bestDtime < timeWindow_) {
             xyEventsTMatch_.push_back(
-                pair<StripEvent, StripEvent>((*itx).first, (*bestMatch).first));
+                pair<StripEvent, StripEvent>(x, (*bestMatch).first));
             (*itx).second = true;
             (*bestMatch).second = true;
             plot(D_DTIME, int(bestDtime / 1.0e-8) + 1);
         } else {
-            bestDtime = int(bestDtime / 1.0e-8);
-            if (bestDtime > S8)
-                bestDtime = S8 - 1;
-            else if (bestDtime < 0)
-                bestDtime = 0;
-            plot(D_DTIME, bestDtime);
+            int bin = S8 - 1;
+            if (bestDtime / 1.0e-8 < S8)
+                bin = int(bestDtime / 1.0e-8);
+            plot(D_DTIME, bin);
         }
     }
 
-    for (vector< pair<StripEvent, bool> >::iterator itx = xEventsTMatch.begin();
-         itx != xEventsTMatch.end();
-         ++itx) {
+    for (vector< pair<StripEvent, bool> >::const_iterator itx =
+            xStrips_.begin(); itx != xStrips_.end(); ++itx) {
         if ((*itx).second)
             continue;
-        int position = (*itx).first.pos;
-        double energy = (*itx).first.E;
-        plot(DD_ENERGY__POSX_T_MISSING, energy, position);
+        plot(DD_ENERGY__POSX_T_MISSING, (*itx).first.E, (*itx).first.pos);
     }
 
-    for (vector< pair<StripEvent, bool> >::iterator ity = yEventsTMatch.begin();
-         ity != yEventsTMatch.end();
-         ++ity) {
+    for (vector< pair<StripEvent, bool> >::const_iterator ity =
+            yStrips_.begin(); ity != yStrips_.end(); ++ity) {
         if ((*ity).second)
             continue;
-        int position = (*ity).first.pos;
-        double energy = (*ity).first.E;
-        plot(DD_ENERGY__POSY_T_MISSING, energy, position);
+        plot(DD_ENERGY__POSY_T_MISSING, (*ity).first.E, (*ity).first.pos);
     }
 
     /**
@@ -373,15 +329,15 @@ bool Dssd4SHEProcessor::Process(RawEvent &event)
     if (!EventProcessor::Process(event))
         return false;
 
-    vector<ChanEvent*> vetoEvents = 
+    const vector<ChanEvent*> &vetoEvents =
         event.GetSummary("si:veto", true)->GetList();
-    vector<ChanEvent*> sideEvents = 
+    const vector<ChanEvent*> &sideEvents =
         event.GetSummary("si:si", true)->GetList();
-    vector<ChanEvent*> mwpcEvents = 
+    const vector<ChanEvent*> &mwpcEvents =
         event.GetSummary("si:si", true)->GetList();
     int mwpc = event.GetSummary("mcp", true)->GetMult();
 
-    bool hasBeam = TreeCorrelator::get()->place("Beam")->status();
+    bool hasBeam = beamPlace_->status();
 
     plot(D_MWPC_MULTI, mwpc); 
 
@@ -417,7 +373,7 @@ bool Dssd4SHEProcessor::Process(RawEvent &event)
         plot(DD_EVENT_POSITION, xPosition, yPosition);
 
         double mwpcTime = numeric_limits<double>::max();
-        for (vector<ChanEvent*>::iterator itm = mwpcEvents.begin();
+        for (vector<ChanEvent*>::const_iterator itm = mwpcEvents.begin();
             itm != mwpcEvents.end();
             ++itm) {
             double dt = abs(time - (*itm)->GetTime()) *
@@ -434,7 +390,7 @@ bool Dssd4SHEProcessor::Process(RawEvent &event)
         }
 
         if (vetoEvents.size() > 0) {
-            for (vector<ChanEvent*>::iterator itv = vetoEvents.begin();
+            for (vector<ChanEvent*>::const_iterator itv = vetoEvents.begin();
                 itv != vetoEvents.end();
                 ++itv) {
                 double vetoEnergy = (*itv)->GetCalEnergy();
@@ -447,7 +403,7 @@ bool Dssd4SHEProcessor::Process(RawEvent &event)
         ChanEvent* correlatedSide = 0;
         bool hasEscape = false;
         double escapeEnergy = 0.0;
-        for (vector<ChanEvent*>::iterator its = sideEvents.begin();
+        for (vector<ChanEvent*>::const_iterator its = sideEvents.begin();
             its != sideEvents.end();
             ++its) {
             double dt = abs(time - (*its)->GetTime()) *
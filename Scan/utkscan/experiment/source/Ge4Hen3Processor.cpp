@@ -95,6 +95,18 @@ Ge4Hen3Processor::Ge4Hen3Processor(double gammaThreshold, double lowRatio,
 {
 }
 
+bool Ge4Hen3Processor::Init(RawEvent &event) {
+    if (!GeProcessor::Init(event))
+        return(false);
+
+    neutronsPlace_.Resolve("Neutrons");
+    set<int> locations;
+    for (int l = 0; l < numNeutronLocations_; ++l)
+        locations.insert(l);
+    neutronPlaces_.Resolve("Neutron", locations);
+    return(true);
+}
+
 /** Declare plots including many for decay/implant/neutron gated analysis  */
 void Ge4Hen3Processor::DeclarePlots(void) 
 {
@@ -202,9 +214,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
 
     /* Number of neutrons as selected by gates on 3hen spectrum.
      * See DetectorDriver::InitCorrelator for gates. */
-    int neutron_count = 
-        dynamic_cast<PlaceCounter*>(
-                TreeCorrelator::get()->place("Neutrons"))->getCounter();
+    int neutron_count = neutronsPlace_->getCounter();
 
     /** All non-neutron related spectra are processed in the base class 
      * Here we are interested in neutron spectra only so there is no need
@@ -216,7 +226,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
      *  This condition will therefore skip events registered during 
      *  tape movement period and before the end of move and the beam start
      */
-    if (!TreeCorrelator::get()->place("Cycle")->status()) {
+    if (!cyclePlace_->status()) {
         for (vector<ChanEvent*>::iterator it = geEvents_.begin(); 
         it != geEvents_.end(); ++it) {
             ChanEvent* chan = *it;
@@ -231,15 +241,15 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = cyclePlace_->last().time;
     
     // beamOn is true for beam on and false for beam off
-    bool beamOn =  TreeCorrelator::get()->place("Beam")->status();
+    bool beamOn =  beamPlace_->status();
 
     plot(neutron::D_MULT, geEvents_.size());
 
     /* Beta places are activated with threshold in ScintProcessor. */
-    bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
+    bool hasBeta = betaPlace_->status();
 
     for (vector<ChanEvent*>::iterator it1 = geEvents_.begin(); 
 	 it1 != geEvents_.end(); ++it1) {
@@ -259,8 +269,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
             granploty(neutron::DD_ENERGY__TIMEX_GROW, 
                     gEnergy, decayTime, timeResolution);
         } else {
-            double decayTimeOff = (gTime - 
-                    TreeCorrelator::get()->place("Beam")->last().time) *
+            double decayTimeOff = (gTime - beamPlace_->last().time) *
                     clockInSeconds;
             granploty(neutron::DD_ENERGY__TIMEX_DECAY, 
                     gEnergy, decayTimeOff, timeResolution);
@@ -278,10 +287,8 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
             }
 		}
 
-        for (unsigned l = 0; l < 48; ++l) {
-            stringstream neutron;
-            neutron << "Neutron_" << l;
-            if (TreeCorrelator::get()->place(neutron.str())->status()) {
+        for (int l = 0; l < numNeutronLocations_; ++l) {
+            if (neutronPlaces_[l]->status()) {
                 plot(neutron::DD_ENERGY_NEUTRON_LOC, gEnergy, l);
             }
         }
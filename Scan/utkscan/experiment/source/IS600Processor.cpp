@@ -18,6 +18,7 @@
 #include "GetArguments.hpp"
 #include "Globals.hpp"
 #include "IS600Processor.hpp"
+#include "LogicProcessor.hpp"
 #include "RawEvent.hpp"
 #include "TimingMapBuilder.hpp"
 #include "VandleProcessor.hpp"
@@ -70,6 +71,7 @@ IS600Processor::IS600Processor() : EventProcessor(OFFSET, RANGE, "IS600PRocessor
     associatedTypes.insert("labr3");
     associatedTypes.insert("beta");
     associatedTypes.insert("ge");
+    logic_ = NULL;
 
     char hisFileName[32];
     GetArgument(1, hisFileName, 32);
@@ -100,6 +102,17 @@ IS600Processor::~IS600Processor() {
 #endif
 }
 
+bool IS600Processor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+    logic_ = dynamic_cast<LogicProcessor*>(
+        DetectorDriver::get()->GetProcessor("LogicProcessor"));
+    protonPlace_.Resolve("logic_t1_0");
+    tapeMovePlace_.Resolve("TapeMove");
+    betaPlace_.Resolve("Beta");
+    return(true);
+}
+
 ///We do nothing here since we're completely dependent on the resutls of others
 bool IS600Processor::PreProcess(RawEvent &event){
     if (!EventProcessor::PreProcess(event))
@@ -141,9 +154,12 @@ bool IS600Processor::Process(RawEvent &event) {
 #endif
 
     //Obtain some useful logic statuses
-    double lastProtonTime =
-	TreeCorrelator::get()->place("logic_t1_0")->last().time;
-    bool isTapeMoving = TreeCorrelator::get()->place("TapeMove")->status();
+    double lastProtonTime = protonPlace_->last().time;
+    bool isTapeMoving;
+    if (logic_ != NULL && logic_->GetTapeMoveTimeline().GetStarts() > 0)
+        isTapeMoving = logic_->GetTapeMoveTimeline().IsOn();
+    else
+        isTapeMoving = tapeMovePlace_->status();
 
     int bananaNum = 2;
     bool hasMultOne = vbars.size() == 1;
@@ -270,7 +286,7 @@ bool IS600Processor::Process(RawEvent &event) {
 
 
     //----------------- GE Processing -------------------
-    bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
+    bool hasBeta = betaPlace_->status();
     double clockInSeconds = Globals::get()->clockInSeconds();
     // plot with 10 ms bins
     const double plotResolution = 10e-3 / clockInSeconds;
@@ -12,6 +12,8 @@
 #include "SheCorrelator.hpp"
 #include "DetectorDriver.hpp"
 #include "Exceptions.hpp"
+#include "Globals.hpp"
+#include "Messenger.hpp"
 #include "Notebook.hpp"
 
 
@@ -40,21 +42,51 @@ SheEvent::SheEvent(double energy, double time, int mwpc,
 }
 
 
-SheCorrelator::SheCorrelator(int size_x, int size_y) {
-    size_x_ = size_x + 1;
-    size_y_ = size_y + 1;
-    pixels_ = new deque<SheEvent>*[size_x_];
-    for(int i = 0; i < size_x_; ++i)
-        pixels_[i] = new deque<SheEvent>[size_y_];
+namespace {
+    /// Tells if an event is older than the given time
+    class IsBefore {
+    public:
+        /** Constructor
+         * \param [in] time : the earliest time that is kept */
+        IsBefore(double time) : time_(time) {}
+        /** \return true if the event happened before the time */
+        bool operator()(const SheEvent &event) const {
+            return event.get_time() < time_;
+        }
+    private:
+        double time_; //!< the earliest time that is kept
+    };
+}
+
+SheCorrelator::SheCorrelator(int size_x, int size_y) :
+    size_x_(size_x + 1), size_y_(size_y + 1),
+    pixels_((size_x + 1) * (size_y + 1),
+            Globals::get()->configuration().child("SheCorrelator").
+            attribute("depth").as_uint(32))
+{
+    pugi::xml_node node =
+        Globals::get()->configuration().child("SheCorrelator");
+    timeWindow_ = node.attribute("window").as_double(0) /
+        Globals::get()->clockInSeconds();
+    expired_ = 0;
+
+    stringstream ss;
+    ss << "SheCorrelator: keeping " << pixels_.GetDepth()
+       << " events per pixel";
+    Messenger m;
+    m.detail(ss.str());
 }
 
 
 SheCorrelator::~SheCorrelator() {
-    for(int i = 0; i < size_y_; ++i) {
-        pixels_[i]->clear();
-        delete[] pixels_[i];
+    if (pixels_.GetOverflows() > 0 || expired_ > 0) {
+        stringstream ss;
+        ss << "SheCorrelator: " << pixels_.GetOverflows()
+           << " events were dropped from full chains and " << expired_
+           << " events were older than the time window.";
+        Messenger m;
+        m.detail(ss.str());
     }
-    delete[] pixels_;
 }
 
 
@@ -74,7 +106,14 @@ bool SheCorrelator::add_event(SheEvent& event, int x, int y) {
     if (event.get_type() == heavyIon)
         flush_chain(x, y);
 
-    pixels_[x][y].push_back(event);
+    if (timeWindow_ > 0)
+        expired_ += pixels_.pop_front_while(
+            pixel(x, y), IsBefore(event.get_time() - timeWindow_));
+
+    pixels_.push_back(pixel(x, y), event);
+    /** The heavy ion starts the chain, it is never dropped */
+    if (event.get_type() == heavyIon)
+        pixels_.pin(pixel(x, y));
 
     if (event.get_type() == fission)
         flush_chain(x, y);
@@ -83,15 +122,16 @@ bool SheCorrelator::add_event(SheEvent& event, int x, int y) {
 }
 
 bool SheCorrelator::flush_chain(int x, int y) {
-    unsigned chain_size = pixels_[x][y].size();
+    size_t p = pixel(x, y);
+    unsigned chain_size = pixels_.size(p);
 
     /** If chain too short just clear it */
     if (chain_size < 2) {
-        pixels_[x][y].clear();
+        pixels_.clear(p);
         return false;
     }
 
-    SheEvent first = pixels_[x][y].front();
+    const SheEvent &first = pixels_.front(p);
 
     /** Conditions for interesing chain:
      *      * starts with heavy ion implantation
@@ -101,14 +141,14 @@ bool SheCorrelator::flush_chain(int x, int y) {
 
     /** If it doesn't start with hevayIon, clear and exit**/
     if (first.get_type() != heavyIon) {
-        pixels_[x][y].clear();
+        pixels_.clear(p);
         return false;
     }
 
     /** If it is 2 elements long, check if the second is fission,
      *  if not - clear and exit**/
-    if (chain_size == 2 && pixels_[x][y].back().get_type() != fission) {
-        pixels_[x][y].clear();
+    if (chain_size == 2 && pixels_.back(p).get_type() != fission) {
+        pixels_.clear(p);
         return false;
     }
 
@@ -120,18 +160,17 @@ bool SheCorrelator::flush_chain(int x, int y) {
     ss << humanTime << "\t X = " << x <<  " Y = " << y << endl;
 
     int alphas = 0;
-    for (deque<SheEvent>::iterator it = pixels_[x][y].begin();
-         it != pixels_[x][y].end();
-         ++it)
-    {
-        if ((*it).get_type() == alpha) {
+    double clockStart = first.get_time();
+    for (size_t i = 0; i < chain_size; ++i) {
+        SheEvent &event = pixels_.at(p, i);
+        if (event.get_type() == alpha) {
             alphas += 1;
         }
-        human_event_info((*it), ss, first.get_time());
+        human_event_info(event, ss, clockStart);
         ss << endl;
     }
 
-    pixels_[x][y].clear();
+    pixels_.clear(p);
 
     if (alphas >= 2) {
         Notebook::get()->report(ss.str());
@@ -106,6 +106,16 @@ void TemplateExpProcessor::ObtainHisName(void) {
     fileName_ = temp.substr(0, temp.find_first_of(" "));
 }
 
+///Resolves the places used in every event
+bool TemplateExpProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+    ///The places are looked up once here instead of in every event
+    tapeMovePlace_.Resolve("TapeMove");
+    betaPlace_.Resolve("Beta");
+    return(true);
+}
+
 ///We do nothing here since we're completely dependent on the resutls of others
 bool TemplateExpProcessor::PreProcess(RawEvent &event){
     if (!EventProcessor::PreProcess(event))
@@ -144,8 +154,8 @@ bool TemplateExpProcessor::Process(RawEvent &event) {
 #endif
 
     ///Obtain some useful logic statuses
-    bool isTapeMoving = TreeCorrelator::get()->place("TapeMove")->status();
-    bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
+    bool isTapeMoving = tapeMovePlace_->status();
+    bool hasBeta = betaPlace_->status();
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     ///Begin loop over template events
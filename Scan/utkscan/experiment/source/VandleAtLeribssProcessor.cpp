@@ -82,29 +82,35 @@ VandleAtLeribssProcessor::VandleAtLeribssProcessor(const std::vector<std::string
     fileNames_.push_back(fileName_ + "-tof-04Plus.dat");
 }
 
+bool VandleAtLeribssProcessor::Init(RawEvent &event) {
+    if (!VandleProcessor::Init(event))
+        return(false);
+    cyclePlace_.Resolve("Cycle");
+    return(true);
+}
+
 bool VandleAtLeribssProcessor::Process(RawEvent &event) {
     if (!EventProcessor::Process(event))
         return(false);
     if(!VandleProcessor::Process(event))
         return(false);
 
-    for (BarMap::iterator it = bars_.begin(); it !=  bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
+    for (BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
         if(!bar.GetHasEvent())
             continue;
 
-        unsigned int barLoc = barId.first;
-        TimingCalibration cal = bar.GetCalibration();
+        unsigned int barLoc = bar.GetNumber();
+        const TimingCalibration &cal = bar.GetCalibration();
 
         bool isLower = barLoc > 6 && barLoc < 16;
         bool isUpper = barLoc > 29 && barLoc < 39;
         bool isCleared = isLower;
         int bananaNum = 1;
 
-        for(TimingMap::iterator itStart = starts_.begin();
+        for(TimingList::const_iterator itStart = starts_.begin();
         itStart != starts_.end(); itStart++) {
-            HighResTimingData start = (*itStart).second;
+            const HighResTimingData &start = (*itStart).second;
             if(!start.GetIsValidData())
                 continue;
 
@@ -172,7 +178,7 @@ bool VandleAtLeribssProcessor::Process(RawEvent &event) {
                 plot(DEBUGGING_OFFSET+25,
                     corTof*plotMult_+plotOffset_, bar.GetQdc());
 
-            double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+            double cycleTime = cyclePlace_->last().time;
             cycleTime *= (Globals::get()->clockInSeconds()*1.e9);
 
             double decayTime = (bar.GetTimeAverage() - cycleTime)/0.01;
@@ -62,18 +62,17 @@ bool WalkVandleBetaProcessor::Process(RawEvent &event) {
     if (!VandleProcessor::Process(event))
         return(false);
 
-    for (BarMap::iterator it = bars_.begin(); it !=  bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
+    for (BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
         if(!bar.GetHasEvent())
             continue;
 
-        unsigned int barLoc = barId.first;
+        unsigned int barLoc = bar.GetNumber();
         bool isLower = barLoc > 6 && barLoc < 16;
         if(!isLower)
             continue;
 
-        TimingCalibration cal = bar.GetCalibration();
+        const TimingCalibration &cal = bar.GetCalibration();
 
         if(barLoc == 12) {
             plot(DD_DEBUGGING4, bar.GetLeftSide().GetTraceQdc(), 0);
@@ -95,9 +94,9 @@ bool WalkVandleBetaProcessor::Process(RawEvent &event) {
         }
 
 
-        for(TimingMap::iterator itStart = starts_.begin();
+        for(TimingList::const_iterator itStart = starts_.begin();
         itStart != starts_.end(); itStart++) {
-            HighResTimingData start = (*itStart).second;
+            const HighResTimingData &start = (*itStart).second;
             if(!start.GetIsValidData())
                 continue;
 
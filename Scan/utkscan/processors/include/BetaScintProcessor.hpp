@@ -8,6 +8,7 @@
 #define __BETASCINTPROCESSOR_HPP_
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 
 namespace dammIds {
     /*! Namespace containing plot numbers for beta_scint */
@@ -42,6 +43,10 @@ public:
      * \param [in] gammaBetaLimit : the maximum time diff between beta and gamma events
      * \param [in] energyContraction : the number to contract the energy by */
     BetaScintProcessor(double gammaBetaLimit, double energyContraction);
+    /*! \brief Initializes the processor and resolves its places
+    * \param [in] event : The RawEvent
+    * \return bool : true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
     /*! \brief PreProcessing for the class
     * \param [in] event : The RawEvent
     * \return bool : Status of processing */
@@ -65,6 +70,10 @@ protected:
     /** Contraction of beta energy for 2d plots (time-energy and gamma-beta
      * energy */
     double energyContraction_;
+
+    PlaceHandle<> cyclePlace_; //!< the Cycle place, resolved once in Init
+    PlaceHandle<PlaceOR> betaPlace_; //!< the Beta place, resolved in Init
+    PlaceHandle<PlaceOR> gammaPlace_; //!< the Gamma place, resolved in Init
 };
 
 #endif // __BETASCINTPROCSSEOR_HPP_
@@ -8,9 +8,8 @@
 #include <set>
 #include <string>
 
-#include <sys/times.h>
-
 #include "Plots.hpp"
+#include "StageProfiler.hpp"
 #include "TreeCorrelator.hpp"
 
 // forward declarations
@@ -45,11 +44,20 @@ public:
         return(associatedTypes);
     }
 
-    /** \return The status of the Processor */
+    /** \return True if Process succeeded on the current event */
     virtual bool DidProcess(void) const {
         return(didProcess);
     }
 
+    /** Sets the status of the Processor for the current event. The
+     * DetectorDriver sets it from the return of Process, and to false when
+     * the processor had no event, so it does not depend on the derived
+     * classes calling the base class.
+     * \param [in] a : true if Process succeeded */
+    void SetDidProcess(const bool &a) {
+        didProcess = a;
+    }
+
     /** See if the detectors of interest have any events
      * \return True if there was an event */
     virtual bool HasEvent(void) const;
@@ -71,14 +79,26 @@ public:
 
     /** Process an event. PreProcess function should fill correlation tree and
     * all processors should have basic parameters calculated during
-    * PreProccessing. This also starts the processing timer.
+    * PreProccessing.
     * \param[in] event : The Event to be processed
     * \return True if success */
     virtual bool Process(RawEvent &event);
 
-    /** Wrap up the processing and update the time spent by this processor */
+    /** Wrap up the processing. The DetectorDriver times PreProcess and
+    * Process around the calls, so the time spent no longer depends on the
+    * derived classes calling this on every return. */
     void EndProcess(void);
 
+    /** \return the timer of PreProcess, started and stopped by the caller */
+    StageTimer &GetPreProcessTimer(void) {
+        return(preProcessTimer_);
+    }
+
+    /** \return the timer of Process, started and stopped by the caller */
+    StageTimer &GetProcessTimer(void) {
+        return(processTimer_);
+    }
+
     /** Get the name of the processor
     * \return Name of the processor */
     std::string GetName(void) const {
@@ -147,9 +167,7 @@ protected:
     }
 
 private:
-    tms tmsBegin; //!< The beginning processor time
-    double userTime;//!< The user time spent in the processor
-    double systemTime;//!< The system time spent in the processor
-    double clocksPerSecond;//!< The number of clock cycles per second
+    StageTimer preProcessTimer_; //!< The time spent in PreProcess
+    StageTimer processTimer_; //!< The time spent in Process
 };
 #endif // __EVENTPROCESSOR_HPP_
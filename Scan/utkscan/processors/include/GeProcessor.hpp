@@ -9,7 +9,9 @@
 #include <utility>
 #include <cmath>
 
+#include "CoincidenceKernel.hpp"
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 #include "RawEvent.hpp"
 
 namespace dammIds {
@@ -51,6 +53,9 @@ namespace dammIds {
 
         const int DD_ADD_ENERGY__TIMEX = 170;//!< Addback Energy vs. Time
 
+        const int DD_COINCIDENCE_MIN = 200;//!< First id for configured matrices
+        const int DD_COINCIDENCE_MAX = 499;//!< Last id for configured matrices
+
         //! Namespace for the beta gated Ge histograms
         namespace betaGated {
             const int D_ENERGY = 10;//!< Beta Gated Energy
@@ -191,6 +196,10 @@ public:
                 double gammaBetaLimit, double gammaGammaLimit,
                 double cycle_gate1_min, double cycle_gate1_max,
                 double cycle_gate2_min, double cycle_gate2_max);
+    /** Initializes the processor and resolves the correlator places
+     * \param [in] event : the event to initialize with
+     * \return True on success */
+    virtual bool Init(RawEvent &event);
     /** Preprocess the event
      * \param [in] event : the event to preprocess
      * \return true if successful */
@@ -202,6 +211,13 @@ public:
     /** Declare the plots for the processor */
     virtual void DeclarePlots(void);
 
+    /** Adds a gamma-gamma matrix that was declared in the configuration.
+     * Pairs of gammas within the window of the matrix are found with the
+     * CoincidenceKernel and plotted symmetrically. This must be called before
+     * DeclarePlots.
+     * \param [in] matrix : the matrix to add */
+    void AddCoincidenceMatrix(const CoincidenceMatrix &matrix);
+
     /** Returns the events that were added to the geEvents_ vector */
     std::vector<ChanEvent*> GetGeEvents(void) {return(geEvents_);}
     /** Returns the events that were added to the addbackEvents_ */
@@ -212,6 +228,7 @@ protected:
     static const unsigned int chansPerClover = 4; /*!< number of channels per clover */
 
     std::map<int, int> leafToClover;   /*!< Translate a leaf location to a clover number */
+    std::vector<int> locationToClover_; /*!< leafToClover indexed by location, -1 if not a leaf */
     std::vector<float> timeResolution; /*!< Contatin time resolutions used */
     unsigned int numClovers;           /*!< number of clovers in map */
 
@@ -230,6 +247,15 @@ protected:
     /** Preprocessed good ge events, filled in PreProcess.*/
     std::vector<ChanEvent*> geEvents_;
 
+    /** \return the clover number of the leaf at the given location, or -1
+     * if the location is not part of a clover.
+     * \param [in] location : the location of the leaf */
+    int GetClover(const unsigned int &location) const {
+        if (location >= locationToClover_.size())
+            return(-1);
+        return(locationToClover_[location]);
+    }
+
     /** Declares a histogram with a range of granularities
      * \param [in] dammId : the dammID to plot
      * \param [in] xsize : the size in the x range
@@ -287,5 +313,22 @@ protected:
     double cycle_gate1_max_;//!< high value for first cycle gate
     double cycle_gate2_min_;//!< low value for second cycle gate
     double cycle_gate2_max_;//!< high value for second cycle gate
+
+    PlaceHandle<> cyclePlace_; //!< the Cycle place, resolved once in Init
+    PlaceHandle<> beamPlace_; //!< the Beam place, resolved once in Init
+    PlaceHandle<PlaceOR> betaPlace_; //!< the Beta place, resolved in Init
+private:
+    /** Fills the gamma-gamma matrices that were declared in the
+     * configuration
+     * \param [in] hasBeta : true if there was a beta in the event */
+    void FillCoincidenceMatrices(const bool &hasBeta);
+
+    /** The good gammas above threshold in time order, the group of each hit
+     * is its clover number. They are kept in a flat array so that the
+     * gamma-gamma loops do not go back to the ChanEvents for every pair. */
+    std::vector<CoincidenceHit> gammas_;
+    std::vector<CoincidenceMatrix> matrices_; //!< matrices from the configuration
+    CoincidenceKernel kernel_; //!< finds the pairs for the configured matrices
+    std::vector<ChanEvent*> lowByLocation_; //!< low gain events indexed by location
 };
 #endif // __GEPROCESSOR_HPP_
@@ -6,6 +6,7 @@
 #define __HEN3PROCESSOR_HPP_
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 
 /// Processor to handle 3Hen detector
 class Hen3Processor : public EventProcessor {
@@ -14,6 +15,10 @@ public:
     Hen3Processor();
     /** Default Destructor */
     ~Hen3Processor(){};
+    /** Finds the places used by the processor
+     * \param [in] event : the event to initialize with
+     * \return true if the init was successful */
+    virtual bool Init(RawEvent &event);
     /** Preprocess the event
      * \param [in] event : the event to preprocess
      * \return true if successful */
@@ -29,5 +34,11 @@ protected:
      * \param [in] nTime : the neutron time
      * \return the Event data for the bet matching neutron to beta */
     EventData BestBetaForNeutron(double nTime);
+
+    PlaceHandle<PlaceCounter> hen3Place_; //!< counts the 3Hen hits
+    PlaceHandle<PlaceCounter> neutronsPlace_; //!< counts the neutrons
+    PlaceHandle<> cyclePlace_; //!< the measurement cycle
+    PlaceHandle<PlaceOR> betaPlace_; //!< the betas
+    PlaceFamily<> neutronPlaces_; //!< Neutron_N for each 3Hen location
 };
 #endif // __HEN3PROCESSOR_H_
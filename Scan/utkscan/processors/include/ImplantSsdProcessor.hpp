@@ -4,8 +4,11 @@
 #ifndef __IMPLANT_SSD_PROCESSOR_HPP_
 #define __IMPLANT_SSD_PROCESSOR_HPP_
 
+#include "Correlator.hpp"
 #include "EventProcessor.hpp"
 
+class DetectorSummary;
+class LogicProcessor;
 class RawEvent;
 
 //! Handles detectors of type ssd:implant
@@ -18,9 +21,29 @@ private:
 
     static const unsigned int numTraces = 100;//!< number of traces
 
+    static const int maxTof = 5; //!< number of TAC locations
+
     unsigned int fastTracesWritten;//!< Number of fast traces written
     unsigned int highTracesWritten;//!< Number of high traces written
 
+    Correlator corr_; //!< the implant-decay correlator
+
+    /** The processors and summaries used for every event, found once in
+     * Init. The summaries are NULL if the detectors are not in the map. */
+    LogicProcessor *logProc_; //!< the logic processor, NULL if not used
+    DetectorSummary *impSummary_; //!< the ssd:sum detectors
+    const DetectorSummary *tacSummary_; //!< the generic:tac detectors
+    const DetectorSummary *mcpSummary_; //!< the logic:mcp detectors
+    const DetectorSummary *vetoSummary_; //!< the ssd:veto detectors
+    const DetectorSummary *boxSummary_; //!< the ssd:box detectors
+
+    double tof_[maxTof + 1]; //!< the TAC energy by location, NAN if no hit
+
+    /** Finds the first TAC energy of each location in the event, the time
+     * of flight of the event is the one of location 2. The TOF plots still
+     * use every TAC hit of the event. */
+    void FillTofs(void);
+
     /** Sets the event type
      * \param [in] info : the event information to set
      * \return The event types that were set */
@@ -42,6 +65,10 @@ public:
     ImplantSsdProcessor();
     /** Default Destructor */
     ~ImplantSsdProcessor(){};
+    /** Finds the processors and summaries used for the correlation
+     * \param [in] event : the event to use for init
+     * \return true if init was successful */
+    virtual bool Init(RawEvent &event);
     /** Declares the plots */
     virtual void DeclarePlots(void);
     /** Process an event
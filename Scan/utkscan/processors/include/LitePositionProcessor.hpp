@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "EventProcessor.hpp"
+#include "StripEdgeTable.hpp"
 
 class ChanEvent;
 
@@ -43,14 +44,15 @@ protected:
     std::vector<float> minNormQdc; //!< the minimum normalized qdc observed for a location
     std::vector<float> maxNormQdc; //!< the maximum normalized qdc observed for a location
 
-    /** Find the matching edge of the SSD
-    * \param [in] match : the matching edge
-    * \param [in] begin : an iterator to the beginning of the event
-    * \param [in] end : an iterator to the end of the event
-    * \return a pointer to the matching ChanEvent */
-    ChanEvent* FindMatchingEdge(ChanEvent *match,
-				std::vector<ChanEvent*>::const_iterator begin,
-				std::vector<ChanEvent*>::const_iterator end) const;
+    std::vector<float> posSlope;   //!< posScale / (max - min) for a location
+    float baselineScale[numQdcs];  //!< qdcLen[i] / qdcLen[0], scales the baseline to QDC i
+
+    StripEdgeTable tops_;    //!< the top edges of the event by location
+    StripEdgeTable bottoms_; //!< the bottom edges of the event by location
+
+    /** Matches the edges to the sum channels and calculates the positions
+    * \param [in] sums : the sum channels of the event */
+    void ProcessSums(const std::vector<ChanEvent*> &sums);
 };
 
 #endif // __LITEPOSITIONPROCESSOR_HPP_
@@ -5,9 +5,13 @@
 #ifndef __LOGICPROCESSOR_HPP_
 #define __LOGICPROCESSOR_HPP_
 
+#include <string>
 #include <vector>
 
 #include "EventProcessor.hpp"
+#include "LogicTimeline.hpp"
+
+class Place;
 
 //! Class to handle logic signals
 class LogicProcessor : public EventProcessor {
@@ -23,6 +27,12 @@ public:
     LogicProcessor(int offset, int range, bool doubleStop = false,
 		   bool doubleStart = false);
 
+    /** Decides what each of the logic channels does and finds the
+     * summaries
+     * \param [in] event : the raw event to initialize with
+     * \return true if the init was successful */
+    virtual bool Init(RawEvent &event);
+
     /** Declare plots used in the analysis */
     virtual void DeclarePlots(void);
 
@@ -38,7 +48,31 @@ public:
 
     /** \return The logic status for a given location
      * \param [in] loc : the location to get the status from */
-    virtual bool LogicStatus(size_t loc) const { return logicStatus.at(loc); };
+    virtual bool LogicStatus(size_t loc) const {
+        return timelines_.at(loc).IsOn();
+    }
+
+    /** \return The logic status for a given location at a given time
+     * \param [in] loc : the location to get the status from
+     * \param [in] t : the time to look at */
+    bool LogicStatus(size_t loc, double t) const {
+        return timelines_.at(loc).IsOn(t);
+    }
+
+    /** \return The history of the start/stop signal at a given location
+     * \param [in] loc : the location to get the history of */
+    const LogicTimeline &GetTimeline(size_t loc) const {
+        return timelines_.at(loc);
+    }
+
+    /** \return The history of the beam, driven by the beam start/stop and
+     * the beam toggle signals */
+    const LogicTimeline &GetBeamTimeline(void) const {return beam_;}
+    /** \return The history of the tape moves of the MTC */
+    const LogicTimeline &GetTapeMoveTimeline(void) const {return tapeMove_;}
+    /** \return The history of the measurement cycles, a cycle starts with
+     * the beam and ends when the tape moves */
+    const LogicTimeline &GetCycleTimeline(void) const {return cycle_;}
 
     /** \param [in] a : true if we have cloned the starts in the map */
     void SetDoubleStart(const bool &a) {doubleStart_ = a;};
@@ -47,35 +81,70 @@ public:
 
     /** \return The stop count for a given location
      * \param [in] loc : the location to get the count from */
-    unsigned long StopCount(size_t loc) const { return stopCount.at(loc);};
+    unsigned long StopCount(size_t loc) const {
+        return timelines_.at(loc).GetStops();
+    }
 
     /** \return The start count for a given location
      * \param [in] loc : the location to get the status from */
-    unsigned long StartCount(size_t loc) const { return startCount.at(loc); };
+    unsigned long StartCount(size_t loc) const {
+        return timelines_.at(loc).GetStarts();
+    }
 
     /** \return The time since the last off
      * \param [in] loc : the location to get the status from
      * \param [in] t : the current time to compare with the last one */
     double TimeOff(size_t loc, double t) const {
-        return (!LogicStatus(loc) ? (t-lastStopTime.at(loc)) : 0.);
+        return timelines_.at(loc).TimeOff(t);
     }
 
     /** \return The time since the last on
      * \param [in] loc : the location to get the status from
      * \param [in] t : the current time to compare with the last one */
     double TimeOn(size_t loc, double t) const {
-        return (LogicStatus(loc) ? (t-lastStartTime.at(loc)) : 0.);
+        return timelines_.at(loc).TimeOn(t);
     }
 
 protected:
-    std::vector<double> lastStartTime; //!< time of last leading edge
-    std::vector<double> lastStopTime;  //!< time of last trailing edge
-    std::vector<bool>   logicStatus;   //!< current level of the logic signal
-
-    std::vector<unsigned long> stopCount;  //!< number of stops received
-    std::vector<unsigned long> startCount; //!< number of starts received
+    std::vector<LogicTimeline> timelines_; //!< the start/stop signals
+    LogicTimeline beam_; //!< the beam on periods
+    LogicTimeline tapeMove_; //!< the tape move periods
+    LogicTimeline cycle_; //!< the measurement cycles
 
 private:
+    /** What a logic channel does when it fires */
+    enum LogicRole {ROLE_UNUSED, ROLE_START, ROLE_STOP, ROLE_MTC_START,
+                    ROLE_MTC_STOP, ROLE_BEAM_START, ROLE_BEAM_STOP, ROLE_T1,
+                    ROLE_SUPERCYCLE, ROLE_BEAM_TOGGLE, ROLE_BEAM_ANALOG,
+                    ROLE_BEAM_NONE};
+
+    /** The places that are changed by the logic signals */
+    enum PlaceIndex {TAPE_MOVE_PLACE, CYCLE_PLACE, BEAM_PLACE,
+                     SUPERCYCLE_PLACE, MTC_START_PLACE, BEAM_START_PLACE,
+                     BEAM_STOP_PLACE, NUM_PLACES};
+
+    /** The information about a logic channel that is needed for each hit */
+    struct ChannelInfo {
+        ChannelInfo() : role(ROLE_UNUSED), location(0), place(NULL) {}
+        LogicRole role; //!< what the channel does
+        unsigned int location; //!< the location of the channel
+        std::string placeName; //!< the name of the place of the channel
+        Place *place; //!< the place of the channel, found on first use
+    };
+
+    /** \return The place, it is looked up on the first use only
+     * \param [in] idx : the place to get */
+    Place *GetPlace(const PlaceIndex &idx);
+
+    /** \return The place of the channel, looked up on the first use only
+     * \param [in] info : the channel to get the place for */
+    Place *GetPlace(ChannelInfo &info);
+
+    std::vector<ChannelInfo> channels_; //!< channels by DetectorLibrary index
+    std::vector<Place *> places_; //!< the places by PlaceIndex
+    const std::vector<ChanEvent*> *logicEvents_; //!< the logic events
+    double t0_; //!< the time of the first logic signal
+
     /** Basic Processing of the event
     * \param [in] event : the even to process */
     void BasicProcessing(RawEvent &event);
@@ -7,6 +7,7 @@
 #define __NEUTRONPROCESSOR_HPP_
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 
 //! Processor for handling scintillator neutron detectors -  Deprecated
 class NeutronProcessor : public EventProcessor {
@@ -15,6 +16,10 @@ public:
     NeutronProcessor();
     /** Default Destructor */
     ~NeutronProcessor();
+    /** Initializes the processor and resolves its places
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
     /** Performs the preprocessing, which cannot depend on other processors
     * \param [in] event : the event to process
     * \return true if preprocessing was successful */
@@ -25,6 +30,10 @@ public:
     virtual bool Process(RawEvent &event);
     /** Declare plots for processor */
     virtual void DeclarePlots(void);
+private:
+    PlaceHandle<> betaPlace_; //!< the Beta place, resolved once in Init
+    PlaceHandle<> gammaPlace_; //!< the Gamma place, resolved once in Init
+    PlaceHandle<> gammaBetaPlace_; //!< the GammaBeta place, resolved in Init
 };
 
 #endif // __NEUTRONPROCSSEOR_HPP_
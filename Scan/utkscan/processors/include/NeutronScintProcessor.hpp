@@ -7,12 +7,17 @@
 #define __NEUTRONSCINTPROCESSOR_HPP_
 
 #include "EventProcessor.hpp"
+#include "PlaceHandle.hpp"
 
 //! Class to handle Neutron Scintillators (that are not VANDLE)
 class NeutronScintProcessor : public EventProcessor {
 public:
     /** Default Constructor */
     NeutronScintProcessor();
+    /** Initializes the processor and resolves its places
+     * \param [in] event : the event to initialize with
+     * \return true if the initialization was successful */
+    virtual bool Init(RawEvent &event);
     /** Preprocess the event
      * \param [in] event : the event to preprocess
      * \return true if successful */
@@ -23,5 +28,9 @@ public:
     virtual bool Process(RawEvent &event);
     /** Declare the plots for the processor */
     virtual void DeclarePlots(void);
+private:
+    PlaceHandle<> betaPlace_; //!< the Beta place, resolved once in Init
+    PlaceHandle<> gammaPlace_; //!< the Gamma place, resolved once in Init
+    PlaceHandle<> gammaBetaPlace_; //!< the GammaBeta place, resolved in Init
 };
 #endif // __NEUTRONSCINTPROCSSEOR_HPP_
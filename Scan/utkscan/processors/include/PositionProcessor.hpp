@@ -10,6 +10,7 @@
 
 #include "EventProcessor.hpp"
 #include "RawEvent.hpp"
+#include "StripEdgeTable.hpp"
 
 class ChanEvent;
 
@@ -26,25 +27,35 @@ private:
     static const int maxNumLocations = 12; //!< maximum number of locations
     int numLocations; //!< number of locations in the processor
     float posScale;        //!< an arbitrary scale for the position parameter to physical units
-    std::vector<float> minNormQdc; //!< the minimum normalized qdc observed for a location
-    std::vector<float> maxNormQdc; //!< the maximum normalized qdc observed for a location
+    float minNormQdc[maxNumLocations]; //!< the minimum normalized qdc observed for a location
+    float maxNormQdc[maxNumLocations]; //!< the maximum normalized qdc observed for a location
+    float posSlope[maxNumLocations]; //!< posScale / (max - min) for a location
+    float baselineScale[numQdcs]; //!< qdcLen[i] / qdcLen[0], scales the baseline to QDC i
 
-    /** Find the matching edge of the SSD
-    * \param [in] match : the matching edge
-    * \param [in] begin : an iterator to the beginning of the event
-    * \param [in] end : an iterator to the end of the event
-    * \return a pointer to the matching ChanEvent */
-    ChanEvent* FindMatchingEdge(ChanEvent *match,
-				std::vector<ChanEvent*>::const_iterator begin,
-				std::vector<ChanEvent*>::const_iterator end) const;
-    /** Find the matching edge of the SSD
-    * \param [in] match : the matching edge
-    * \param [in] begin : an iterator to the beginning of the event
-    * \param [in] end : an iterator to the end of the event
-    * \return a pointer to the matching ChanEvent */
-    ChanEvent* FindMatchingEdge(ChanEvent *match,
-				std::vector<ChanEvent*>::const_reverse_iterator begin,
-				std::vector<ChanEvent*>::const_reverse_iterator end) const;
+    StripEdgeTable tops_; //!< the top edges of the event by location
+    StripEdgeTable bottoms_; //!< the bottom edges of the event by location
+
+    /** The strips of the event with a good top and bottom pair, kept as one
+     * array per quantity so that the QDC math runs over all of the strips
+     * of the event at once. */
+    std::vector<ChanEvent*> pairSums_; //!< the sum channel of each strip
+    std::vector<int> pairLocations_; //!< the location of each strip
+    std::vector<float> topQdc_[numQdcs]; //!< the top QDCs of each strip
+    std::vector<float> bottomQdc_[numQdcs]; //!< the bottom QDCs of each strip
+    std::vector<float> frac_[numQdcs]; //!< top / (top + bottom) per mil of each strip
+    std::vector<float> topQdcTot_; //!< the total top QDC of each strip
+    std::vector<float> bottomQdcTot_; //!< the total bottom QDC of each strip
+    std::vector<float> position_; //!< the position in each strip
+
+    /** Matches the edges to the sum channels, plots the info spectra and
+     * adds the raw QDCs of the good pairs to the strips of the event
+     * \param [in] sums : the sum channels of the event */
+    void AddPairs(const std::vector<ChanEvent*> &sums);
+    /** Baseline subtracts and normalizes the QDCs of all strips of the
+     * event and calculates their positions */
+    void CalculatePositions(void);
+    /** Plots the QDCs and positions of all strips of the event */
+    void PlotPairs(void);
 public:
     PositionProcessor(); // no virtual c'tors
     /*! \brief Reads in QDC parameters from an input file
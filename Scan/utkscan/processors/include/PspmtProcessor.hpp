@@ -7,32 +7,129 @@
 #ifndef __PSPMTPROCESSOR_HPP__
 #define __PSPMTPROCESSOR_HPP__
 
+#include <string>
+#include <vector>
+
 #include "RawEvent.hpp"
 #include "EventProcessor.hpp"
 
+///Anger logic positions of a four anode PSPMT. The positions of a batch of
+///anode sets are calculated in one loop, the pixels are then taken from a
+///precomputed correction map instead of being calculated each time. The
+///PspmtProcessor passes the raw, trace and qdc sets of one event as a batch.
+class PspmtPositionMap {
+public:
+    static const unsigned int numAnodes = 4; //!< the number of anodes
+    static const int rawOffset = 100; //!< the offset of the raw positions
+    static const int rawBins = 512; //!< the range of the raw positions
+
+    ///The position of a single event
+    struct Position {
+        double sum; //!< half of the sum of the anodes
+        double xRight; //!< the raw position from the right side
+        double xLeft; //!< the raw position from the left side
+        double yTop; //!< the raw position from the top side
+        double yBottom; //!< the raw position from the bottom side
+        int pixelX1; //!< the x pixel of (xRight, yTop)
+        int pixelY1; //!< the y pixel of (xRight, yTop)
+        int pixelX2; //!< the x pixel of (xLeft, yBottom)
+        int pixelY2; //!< the y pixel of (xLeft, yBottom)
+    };
+
+    /** Constructor, the map starts out as the linear relation
+     * pixel = trunc(slope * raw - intercept) in both directions
+     * \param [in] slope : the slope of the linear map
+     * \param [in] intercept : the intercept of the linear map */
+    PspmtPositionMap(const double &slope, const double &intercept);
+
+    /** Default Destructor */
+    ~PspmtPositionMap() {}
+
+    /** Replaces entries of the map with the ones from a file. Each line
+     * holds "xRaw yRaw xPixel yPixel", lines starting with # are comments
+     * and raw positions that are not in the file keep the linear map.
+     * \param [in] fileName : the name of the file to read
+     * \throw GeneralException if the file cannot be read */
+    void LoadCorrection(const std::string &fileName);
+
+    /** Calculates the positions of a batch of events
+     * \param [in] anodes : the anode signals, numAnodes values per event
+     * \param [in] num : the number of events in the batch
+     * \param [out] positions : the positions, num of them */
+    void Calculate(const double *anodes, const size_t &num,
+                   Position *positions) const;
+
+    /** Looks up the pixel of a raw position
+     * \param [in] x : the raw x position
+     * \param [in] y : the raw y position
+     * \param [out] px : the x pixel
+     * \param [out] py : the y pixel */
+    void Lookup(const double &x, const double &y, int &px, int &py) const {
+        unsigned int i = Bin(y) * rawBins + Bin(x);
+        px = pixelX_[i];
+        py = pixelY_[i];
+    }
+
+private:
+    /** \return the bin of the map for a raw position, positions outside
+     * the map (or NaN) end up in the edge bins
+     * \param [in] raw : the raw position */
+    static unsigned int Bin(const double &raw) {
+        double bin = raw - rawOffset;
+        if (!(bin >= 0))
+            return(0);
+        if (bin > rawBins - 1)
+            return(rawBins - 1);
+        return((unsigned int)bin);
+    }
+
+    std::vector<short> pixelX_; //!< the x pixel of each raw (x, y) bin
+    std::vector<short> pixelY_; //!< the y pixel of each raw (x, y) bin
+};
+
 ///Class to handle processing of position sensitive pmts
 class PspmtProcessor : public EventProcessor {
 public:
-    /** Default Constructor */
-    PspmtProcessor(void);
+    /** Constructor
+     * \param [in] correctionFile : the file holding the pixel correction
+     * map, the linear map is used if it is empty */
+    PspmtProcessor(const std::string &correctionFile = "");
     /** Default Destructor */
     ~PspmtProcessor() {};
-    
+
+    /** Resolves the anode of each channel of the map
+     * \param [in] event : the event to use for init
+     * \return true if init was successful */
+    virtual bool Init(RawEvent &event);
     /** Declare the plots used in the analysis */
     virtual void DeclarePlots(void);
-    /** Preprocess the VANDLE data
+    /** Preprocess the PSPMT data
      * \param [in] event : the event to preprocess
      * \return true if successful */
     virtual bool PreProcess(RawEvent &event);
-    /** Process the event for VANDLE stuff
+    /** Process the event for PSPMT stuff
      * \param [in] event : the event to process
      * \return Returns true if the processing was successful */
     virtual bool Process(RawEvent &event);
 private:
-    ///Structure defining what data we're storing
-    struct PspmtData {
-	///Clears the data from the processor 
-        void Clear(void);
-    } data_; //!< instance of structure to hold the data 
+    ///The anodes and the dynode, the location of the channel is its slot
+    enum Slot {SLOT_DYNODE = 4, NUM_SLOTS = 5};
+
+    ///The last signal seen by an anode in the event
+    struct AnodeSlot {
+        const ChanEvent *chan; //!< the channel, NULL if there was no hit
+        double energy; //!< the calibrated energy
+        double traceEnergy; //!< the filter energy of the first pulse
+        double qdc; //!< the qdc of the waveform
+    };
+
+    /** Plots the positions of the event */
+    void PlotPositions(void);
+
+    PspmtPositionMap positionMap_; //!< the pixel map for the positions
+    std::vector<int> slotOfId_; //!< the slot of each channel, -1 if none
+    AnodeSlot slots_[NUM_SLOTS]; //!< the signals of the current event
+    const ChanEvent *lastChan_; //!< the last channel of the current event
+    int traceNum_; //!< the number of traces with a filter energy
 };
 #endif // __PSPMTPROCESSOR_HPP__
@@ -18,9 +18,11 @@
 #ifndef __VANDLEPROCESSOR_HPP_
 #define __VANDLEPROCESSOR_HPP_
 
+#include "BarBuilder.hpp"
 #include "BarDetector.hpp"
 #include "EventProcessor.hpp"
 #include "HighResTimingData.hpp"
+#include "TimingMapBuilder.hpp"
 
 /// Class to process VANDLE related events
 class VandleProcessor : public EventProcessor {
@@ -62,7 +64,22 @@ public:
     }
     
     /** \return the map of the build VANDLE bars */
-    BarMap GetBars(void) {return(bars_);}
+    BarMap GetBars(void) {
+        BarMap bars;
+        for(BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++)
+            bars.insert(bars.end(), std::make_pair(it->GetKey(), *it));
+        return(bars);
+    }
+    /** \return the flat list of the built VANDLE bars ordered by bar number */
+    const BarList &GetBarList(void) const {return(bars_);}
+    /** \return the built VANDLE bar with the given number, NULL if the bar
+     * was not built in this event
+     * \param [in] barNum : the number of the bar */
+    const BarDetector *GetBar(const unsigned int &barNum) const {
+        if(barNum >= barIndex_.size() || barIndex_[barNum] < 0)
+            return(NULL);
+        return(&bars_[barIndex_[barNum]]);
+    }
     /** \return true if we requested small bars in the xml */
     bool GetHasSmall(void) {return(hasSmall_);}
     /** \return true if we requested medium bars in the xml  */
@@ -71,9 +88,11 @@ public:
     bool GetHasBig(void) {return(hasBig_);}
 
 protected:
-    BarMap bars_;//!< A map to hold all the bars
-    TimingMap starts_;//!< A map to to hold all the starts
-    BarMap barStarts_;//!< A map that holds all of the bar starts
+    BarList bars_;//!< A list to hold all the bars ordered by bar number
+    TimingList starts_;//!< A list to to hold all the starts
+    std::vector<int> barIndex_;//!< Position in bars_ of each bar number, -1 if none
+    BarList barStarts_;//!< A list that holds all of the bar starts
+    std::vector<int> barStartIndex_;//!< Position in barStarts_ of each bar start
     DetectorSummary *geSummary_;//!< The Detector Summary for Ge Events
 
     bool hasDecay_; //!< True if there was a correlated beta decay
@@ -88,6 +107,11 @@ protected:
 
     unsigned int numStarts_; //!< The number of starts set in the Config File
 private:
+    BarBuilder barBuilder_; //!< Builds the VANDLE bars, reused every event
+    BarBuilder startBarBuilder_; //!< Builds the bar starts every event
+    TimingMapBuilder startBuilder_; //!< Builds the single sided starts
+    std::vector<ChanEvent*> startEvents_; //!< The single sided start events
+
     /** Analyze the data for scenarios with Bar Starts; e.g. Double Beta
      * detectors */
     void AnalyzeBarStarts(void);
@@ -29,9 +29,20 @@ BetaScintProcessor::BetaScintProcessor(double gammaBetaLimit,
     energyContraction_ = energyContraction;
 }
 
+bool BetaScintProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+
+    /** The places are looked up once here instead of by name in every
+     * event. */
+    cyclePlace_.Resolve("Cycle");
+    betaPlace_.Resolve("Beta");
+    gammaPlace_.Resolve("Gamma");
+    return(true);
+}
+
 EventData BetaScintProcessor::BestGammaForBeta(double bTime) {
-    PlaceOR* gammas =
-        dynamic_cast<PlaceOR*>(TreeCorrelator::get()->place("Gamma"));
+    PlaceOR* gammas = gammaPlace_.get();
     unsigned sz = gammas->info_.size();
 
     if (sz == 0)
@@ -152,10 +163,10 @@ bool BetaScintProcessor::Process(RawEvent &event) {
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    bool tapeMove = !(cyclePlace_->status());
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = cyclePlace_->last().time;
 
     /** True if gammas were recorded during the event */
     int multiplicityThres = 0;
@@ -167,8 +178,7 @@ bool BetaScintProcessor::Process(RawEvent &event) {
         double time = (*it)->GetTime();
         int location = (*it)->GetChanID().GetLocation();
 
-        PlaceOR* betas =
-            dynamic_cast<PlaceOR*>(TreeCorrelator::get()->place("Beta"));
+        PlaceOR* betas = betaPlace_.get();
         /* Beta events gated by "Beta" place are plotted here
          * Energy-time spectra are gated
          * */
@@ -12,9 +12,6 @@
 #include <sstream>
 #include <vector>
 
-#include <unistd.h>
-#include <sys/times.h>
-
 #include "DetectorLibrary.hpp"
 #include "EventProcessor.hpp"
 #include "RawEvent.hpp"
@@ -24,22 +21,16 @@ using namespace std;
 
 EventProcessor::EventProcessor() :
   name("generic"), initDone(false), didProcess(false), histo(0, 0, "generic"),
-  userTime(0.), systemTime(0.) {
-    clocksPerSecond = sysconf(_SC_CLK_TCK);
+  preProcessTimer_(name, "PreProcess"), processTimer_(name, "Process") {
 }
 
 EventProcessor::EventProcessor(int offset, int range, std::string proc_name) :
   name(proc_name), initDone(false), didProcess(false),
-  histo(offset, range, proc_name), userTime(0.), systemTime(0.) {
-    clocksPerSecond = sysconf(_SC_CLK_TCK);
+  histo(offset, range, proc_name),
+  preProcessTimer_(name, "PreProcess"), processTimer_(name, "Process") {
 }
 
-EventProcessor::~EventProcessor() {
-    if (initDone)
-        cout << name << " : "
-	     << userTime << " user time, "
-	     << systemTime << " system time" << endl;
-}
+EventProcessor::~EventProcessor() {}
 
 bool EventProcessor::HasEvent(void) const {
     for (map<string, const DetectorSummary*>::const_iterator it = sumMap.begin();
@@ -86,24 +77,10 @@ bool EventProcessor::PreProcess(RawEvent &event) {
 bool EventProcessor::Process(RawEvent &event) {
     if (!initDone)
         return (didProcess = false);
-
-    times(&tmsBegin);
-
-    EndProcess();
     return (didProcess = true);
 }
 
 void EventProcessor::EndProcess(void) {
-    tms tmsEnd;
-
-    times(&tmsEnd);
-
-    userTime += (tmsEnd.tms_utime - tmsBegin.tms_utime) / clocksPerSecond;
-    systemTime += (tmsEnd.tms_stime - tmsBegin.tms_stime) / clocksPerSecond;
-
-    //! Reset the beginning time so multiple calls of EndProcess from
-    //! derived classes work properly
-    times(&tmsBegin);
 }
 
 
@@ -236,7 +236,7 @@ bool GeCalibProcessor::Process(RawEvent &event) {
     if (!EventProcessor::Process(event))
         return false;
     
-    bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
+    bool hasBeta = betaPlace_->status();
     
     plot(D_MULT, geEvents_.size());
     
@@ -258,7 +258,7 @@ bool GeCalibProcessor::Process(RawEvent &event) {
         if (hasBeta) {
             plot(calib::DD_E_DETX_BETA_GATED, gEnergy, det);
 	    
-            EventData beta = TreeCorrelator::get()->place("Beta")->last();
+            EventData beta = betaPlace_->last();
             double gb_dtime = (gTime - beta.time);
             double betaEnergy = beta.energy;
             int betaLocation = beta.location;
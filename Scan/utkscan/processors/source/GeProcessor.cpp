@@ -30,8 +30,7 @@ using namespace std;
 using namespace dammIds::ge;
 
 EventData GeProcessor::BestBetaForGamma(double gTime) {
-    PlaceOR* betas = dynamic_cast<PlaceOR*>(
-                        TreeCorrelator::get()->place("Beta"));
+    PlaceOR* betas = betaPlace_.get();
     unsigned sz = betas->info_.size();
 
     if (sz == 0)
@@ -97,17 +96,8 @@ GeProcessor::GeProcessor(double gammaThreshold, double lowRatio,
     Messenger m;
     m.detail("Loading Gamma-gamma gates", 1);
 
-    string cfg = Globals::get()->configfile();
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(cfg.c_str());
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file " << cfg;
-        ss << " : " << result.description();
-        throw IOException(ss.str());
-    }
-
-    pugi::xml_node gamma_gates = doc.child("Configuration").child("GammaGates");
+    pugi::xml_node gamma_gates =
+        Globals::get()->configuration().child("GammaGates");
     for (pugi::xml_node gate = gamma_gates.child("Gate"); gate;
          gate = gate.next_sibling("Gate")) {
         vector<LineGate> vg;
@@ -172,6 +162,9 @@ void GeProcessor::DeclarePlots(void) {
     for ( set<int>::const_iterator it = cloverLocations.begin();
 	  it != cloverLocations.end(); it++) {
         leafToClover[*it] = int(cloverChans / 4);
+        if ((unsigned int)*it >= locationToClover_.size())
+            locationToClover_.resize(*it + 1, -1);
+        locationToClover_[*it] = int(cloverChans / 4);
         cloverChans++;
     }
 
@@ -282,6 +275,10 @@ void GeProcessor::DeclarePlots(void) {
     }
 
     DeclareHistogram2D(DD_ENERGY, energyBins2, energyBins2, "Gamma gamma");
+    for (vector<CoincidenceMatrix>::const_iterator it = matrices_.begin();
+         it != matrices_.end(); it++)
+        DeclareHistogram2D(it->id, energyBins2, energyBins2,
+                           it->title.c_str());
     DeclareHistogram2D(DD_ENERGY_PROMPT, energyBins2, energyBins2,
                        "Gamma gamma prompt");
     DeclareHistogram2D(DD_ENERGY_CGATE1,
@@ -381,12 +378,24 @@ void GeProcessor::DeclarePlots(void) {
                           2, timeResolution, "s");
 }
 
+bool GeProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+
+    /** The places are looked up once here instead of by name in every
+     * event. */
+    cyclePlace_.Resolve("Cycle");
+    beamPlace_.Resolve("Beam");
+    betaPlace_.Resolve("Beta");
+    return(true);
+}
 
 bool GeProcessor::PreProcess(RawEvent &event) {
     if (!EventProcessor::PreProcess(event))
         return false;
 
     geEvents_.clear();
+    gammas_.clear();
     for (unsigned i = 0; i < numClovers; ++i)
         addbackEvents_[i].clear();
     tas_.clear();
@@ -396,29 +405,42 @@ bool GeProcessor::PreProcess(RawEvent &event) {
     static const vector<ChanEvent*> &lowEvents  =
         event.GetSummary("ge:clover_low", true)->GetList();
 
+    /** The low gain events are put in a table indexed by location so that
+     * each high gain event finds its partner directly. The first low gain
+     * event at a location is the one that is used. */
+    for (vector<ChanEvent*>::const_iterator itLow = lowEvents.begin();
+	 itLow != lowEvents.end(); itLow++) {
+        unsigned int location = (*itLow)->GetChanID().GetLocation();
+        if (location >= lowByLocation_.size())
+            lowByLocation_.resize(location + 1, NULL);
+        if (lowByLocation_[location] == NULL)
+            lowByLocation_[location] = *itLow;
+    }
+
     /** Only the high gain events are going to be used. The events where
      * low/high gain mismatches, saturation or pileup is marked are rejected
      */
     for (vector<ChanEvent*>::const_iterator itHigh = highEvents.begin();
 	 itHigh != highEvents.end(); itHigh++) {
-        int location = (*itHigh)->GetChanID().GetLocation();
+        unsigned int location = (*itHigh)->GetChanID().GetLocation();
         if ( (*itHigh)->IsSaturated() || (*itHigh)->IsPileup() )
             continue;
 
-        vector <ChanEvent*>::const_iterator itLow = lowEvents.begin();
-        for (; itLow != lowEvents.end(); itLow++) {
-            if ( (*itLow)->GetChanID().GetLocation() == location ) {
-                break;
-            }
-        }
-        if ( itLow != lowEvents.end() ) {
-            double ratio = (*itHigh)->GetEnergy() / (*itLow)->GetEnergy();
+        if (location < lowByLocation_.size() &&
+            lowByLocation_[location] != NULL) {
+            double ratio = (*itHigh)->GetEnergy() /
+                lowByLocation_[location]->GetEnergy();
             if (ratio < lowRatio_ || ratio > highRatio_)
                 continue;
         }
         geEvents_.push_back(*itHigh);
     }
 
+    // Only the entries that we filled need to be cleared for the next event
+    for (vector<ChanEvent*>::const_iterator itLow = lowEvents.begin();
+	 itLow != lowEvents.end(); itLow++)
+        lowByLocation_[(*itLow)->GetChanID().GetLocation()] = NULL;
+
     // now we sort the germanium events according to their corrected time
     sort(geEvents_.begin(), geEvents_.end(), CompareCorrectedTime);
 
@@ -437,7 +459,7 @@ bool GeProcessor::PreProcess(RawEvent &event) {
         ChanEvent *chan = *it;
         double energy = chan->GetCalEnergy();
         double time = chan->GetCorrectedTime();
-        int clover = leafToClover[chan->GetChanID().GetLocation()];
+        int clover = GetClover(chan->GetChanID().GetLocation());
 
         /**
         * Do not take into account events with too low energy
@@ -446,11 +468,17 @@ bool GeProcessor::PreProcess(RawEvent &event) {
         if (energy < gammaThreshold_)
             continue;
 
+        CoincidenceHit hit;
+        hit.energy = energy;
+        hit.time = time;
+        hit.group = clover;
+        gammas_.push_back(hit);
+
         // entries in map are sorted by time
         // if event time is outside of subEventWindow, we start new
         //   events for all clovers and "tas"
         double dtime = abs(time - refTime) * Globals::get()->clockInSeconds();
-        if (dtime > subEventWindow_) {
+        if (dtime > subEventWindow_ || tas_.empty()) {
             for (unsigned i = 0; i < numClovers; ++i) {
                 addbackEvents_[i].push_back(AddBackEvent());
             }
@@ -479,23 +507,20 @@ bool GeProcessor::Process(RawEvent &event) {
     double clockInSeconds = Globals::get()->clockInSeconds();
     
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = cyclePlace_->last().time;
     
     // beamOn is true for beam on and false for beam off
-    bool beamOn =  TreeCorrelator::get()->place("Beam")->status();
-    bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
+    bool beamOn =  beamPlace_->status();
+    bool hasBeta = betaPlace_->status();
     
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove
      *  This condition will therefore skip events registered during
      *  tape movement period and before the end of move and the beam start
      */
-    if (!TreeCorrelator::get()->place("Cycle")->status()) {
-        for (vector<ChanEvent*>::iterator it = geEvents_.begin();
-	     it != geEvents_.end(); ++it) {
-            ChanEvent* chan = *it;
-            double gEnergy = chan->GetCalEnergy();
-            if (gEnergy < gammaThreshold_)
-                continue;
+    if (!cyclePlace_->status()) {
+        for (vector<CoincidenceHit>::const_iterator it = gammas_.begin();
+	     it != gammas_.end(); ++it) {
+            double gEnergy = it->energy;
             plot(D_ENERGY_MOVE, gEnergy);
             if (hasBeta)
                 plot(betaGated::D_ENERGY_MOVE, gEnergy);
@@ -506,19 +531,16 @@ bool GeProcessor::Process(RawEvent &event) {
     
     plot(D_MULT, geEvents_.size());
     
-    // Note that geEvents_ vector holds only good events (matched
-    // low & high gain). See PreProcess
-    for (vector<ChanEvent*>::iterator it1 = geEvents_.begin();
-	 it1 != geEvents_.end(); ++it1) {
-        ChanEvent* chan = *it1;
-	
-        double gEnergy = chan->GetCalEnergy();
-        if (gEnergy < gammaThreshold_)
-            continue;
-	
-        double gTime = chan->GetCorrectedTime();
+    // Note that gammas_ vector holds only good events (matched
+    // low & high gain) above the threshold. See PreProcess
+    // The fixed matrices below take every pair of the event, not only the
+    // ones in a time window, so they do not go through the kernel_.
+    for (vector<CoincidenceHit>::const_iterator it1 = gammas_.begin();
+	 it1 != gammas_.end(); ++it1) {
+        double gEnergy = it1->energy;
+        double gTime = it1->time;
         double decayTime = (gTime - cycleTime) * clockInSeconds;
-        int det = leafToClover[chan->GetChanID().GetLocation()];
+        int det = it1->group;
 	
         plot(D_ENERGY, gEnergy);
         plot(D_ENERGY_CLOVERX + det, gEnergy);
@@ -552,8 +574,7 @@ bool GeProcessor::Process(RawEvent &event) {
                     * (t = 0 is time beam went off)
                     */
                     double decayTimeOff = (gTime -
-                         TreeCorrelator::get()->place("Beam")->last().time) *
-                         clockInSeconds;
+                         beamPlace_->last().time) * clockInSeconds;
                     granploty(betaGated::DD_ENERGY__TIMEX_DECAY,
                             gEnergy, decayTimeOff, timeResolution);
                 }
@@ -569,16 +590,11 @@ bool GeProcessor::Process(RawEvent &event) {
             }
         }
 
-        for (vector<ChanEvent*>::const_iterator it2 = it1 + 1;
-                it2 != geEvents_.end(); it2++) {
-            ChanEvent* chan2 = *it2;
-
-            double gEnergy2 = chan2->GetCalEnergy();
-            int det2 = leafToClover[chan2->GetChanID().GetLocation()];
-            double gTime2 = chan2->GetCorrectedTime();
-
-            if (gEnergy2 < gammaThreshold_)
-                continue;
+        for (vector<CoincidenceHit>::const_iterator it2 = it1 + 1;
+                it2 != gammas_.end(); it2++) {
+            double gEnergy2 = it2->energy;
+            int det2 = it2->group;
+            double gTime2 = it2->time;
 
             double gg_dtime = (gTime2 - gTime) * clockInSeconds;
 
@@ -681,11 +697,9 @@ bool GeProcessor::Process(RawEvent &event) {
                             plot(betaGated::DD_ANGLE__GATEX, 2, ig);
                     }
 
-                    for (vector<ChanEvent*>::const_iterator it3 = it2 + 1;
-                            it3 != geEvents_.end(); it3++) {
-                        double gEnergy3 = (*it3)->GetCalEnergy();
-                        if (gEnergy3 < gammaThreshold_)
-                            continue;
+                    for (vector<CoincidenceHit>::const_iterator it3 = it2 + 1;
+                            it3 != gammas_.end(); it3++) {
+                        double gEnergy3 = it3->energy;
                         plot(DD_ENERGY__GATEX, gEnergy3, ig);
                         if (hasBeta && GoodGammaBeta(gb_dtime))
                             plot(betaGated::DD_ENERGY__GATEX, gEnergy3, ig);
@@ -697,6 +711,8 @@ bool GeProcessor::Process(RawEvent &event) {
         } // iteration over other gammas
     }
 
+    FillCoincidenceMatrices(hasBeta);
+
     // Vectors tas and addbackEvents should have the same size
     unsigned nEvents = tas_.size();
 
@@ -796,6 +812,49 @@ bool GeProcessor::Process(RawEvent &event) {
     return true;
 }
 
+void GeProcessor::AddCoincidenceMatrix(const CoincidenceMatrix &matrix) {
+    if (matrix.id < DD_COINCIDENCE_MIN || matrix.id > DD_COINCIDENCE_MAX) {
+        stringstream ss;
+        ss << "GeProcessor::AddCoincidenceMatrix : The id " << matrix.id
+           << " of the matrix \"" << matrix.title << "\" is outside of the "
+           << "range " << DD_COINCIDENCE_MIN << " - " << DD_COINCIDENCE_MAX;
+        throw GeneralException(ss.str());
+    }
+    for (vector<CoincidenceMatrix>::const_iterator it = matrices_.begin();
+         it != matrices_.end(); it++) {
+        if (it->id == matrix.id) {
+            stringstream ss;
+            ss << "GeProcessor::AddCoincidenceMatrix : The id " << matrix.id
+               << " of the matrix \"" << matrix.title << "\" is already "
+               << "used by the matrix \"" << it->title << "\"";
+            throw GeneralException(ss.str());
+        }
+    }
+    matrices_.push_back(matrix);
+}
+
+void GeProcessor::FillCoincidenceMatrices(const bool &hasBeta) {
+    if (matrices_.empty())
+        return;
+
+    double clockInSeconds = Globals::get()->clockInSeconds();
+    for (vector<CoincidenceMatrix>::const_iterator it = matrices_.begin();
+         it != matrices_.end(); it++) {
+        if (it->isBetaGated && !hasBeta)
+            continue;
+
+        const int id = it->id;
+        const bool isCrossGroup = it->isCrossGroup;
+        kernel_.SetWindow(it->window / clockInSeconds);
+        kernel_.Pairs(gammas_, [this, id, isCrossGroup]
+                      (const CoincidenceHit &a, const CoincidenceHit &b) {
+                          if (isCrossGroup && a.group == b.group)
+                              return;
+                          symplot(id, a.energy, b.energy);
+                      });
+    }
+}
+
 /**
  * Declare a 2D plot with a range of granularites on the Y axis
  */
@@ -3,10 +3,13 @@
  * implementation for scintillator processor
  */
 #include <iostream>
+#include <set>
+
 #include <cmath>
 #include <limits>
 
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
 #include "RawEvent.hpp"
 #include "ChanEvent.hpp"
 #include "Hen3Processor.hpp"
@@ -44,9 +47,27 @@ Hen3Processor::Hen3Processor() : EventProcessor(OFFSET, RANGE, "Hen3Processor")
     associatedTypes.insert("3hen");
 }
 
+bool Hen3Processor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+
+    hen3Place_.Resolve("Hen3");
+    neutronsPlace_.Resolve("Neutrons");
+    cyclePlace_.Resolve("Cycle");
+    betaPlace_.Resolve("Beta");
+
+    /** One Neutron_N place is needed for each of the 3Hen locations */
+    set<int> locations;
+    DetectorLibrary *lib = DetectorLibrary::get();
+    for (DetectorLibrary::size_type i = 0; i < lib->size(); i++)
+        if (lib->HasValue(i) && lib->at(i).GetType() == "3hen")
+            locations.insert(lib->at(i).GetLocation());
+    neutronPlaces_.Resolve("Neutron", locations);
+    return(true);
+}
+
 EventData Hen3Processor::BestBetaForNeutron(double nTime) {
-    PlaceOR* betas = dynamic_cast<PlaceOR*>(
-                        TreeCorrelator::get()->place("Beta"));
+    PlaceOR* betas = betaPlace_.get();
     unsigned sz = betas->info_.size();
 
     if (sz == 0)
@@ -114,9 +135,7 @@ bool Hen3Processor::PreProcess(RawEvent &event) {
             int location = (*it)->GetChanID().GetLocation();
 
             EventData data(time, energy, location, true);
-            stringstream neutron;
-            neutron << "Neutron_" << location;
-            TreeCorrelator::get()->place(neutron.str())->activate(data);
+            neutronPlaces_[location]->activate(data);
     }
 
     return true;
@@ -128,16 +147,14 @@ bool Hen3Processor::Process(RawEvent &event) {
 
     static const DetectorSummary *hen3Summary = event.GetSummary("3hen", true);
 
-    int hen3_count = dynamic_cast<PlaceCounter*>(
-            TreeCorrelator::get()->place("Hen3"))->getCounter();
-    int neutron_count = dynamic_cast<PlaceCounter*>(
-            TreeCorrelator::get()->place("Neutrons"))->getCounter();
+    int hen3_count = hen3Place_->getCounter();
+    int neutron_count = neutronsPlace_->getCounter();
 
     double clockInSeconds = Globals::get()->clockInSeconds();
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    bool tapeMove = !(cyclePlace_->status());
     /** Cycle time is measured from the beginning of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = cyclePlace_->last().time;
 
     if (tapeMove) {
         for (vector<ChanEvent*>::const_iterator it =
@@ -153,6 +170,7 @@ bool Hen3Processor::Process(RawEvent &event) {
     plot(D_MULT_NEUTRON, neutron_count);
 
     int beta_gated_neutron_multi = 0;
+    bool hasBeta = betaPlace_->status();
     for (vector<ChanEvent*>::const_iterator it = hen3Summary->GetList().begin();
         it != hen3Summary->GetList().end(); it++) {
             ChanEvent *chan = *it;
@@ -162,28 +180,24 @@ bool Hen3Processor::Process(RawEvent &event) {
 
             plot(D_ENERGY_HEN3, energy);
 
-            stringstream neutron_name;
-            neutron_name << "Neutron_" << location;
-            if (TreeCorrelator::get()->place(neutron_name.str())->status()) {
+            bool isNeutron = neutronPlaces_[location]->status();
+            if (isNeutron) {
                 plot(D_ENERGY_NEUTRON, energy);
                 double decayTime = (time - cycleTime) * clockInSeconds;
                 int decayTimeBin = int(decayTime / cycleTimePlotResolution_);
                 plot(D_TIME_NEUTRON, decayTimeBin);
             }
 
-            string place = chan->GetChanID().GetPlaceName();
-            if (TreeCorrelator::get()->place("Beta")->status()) {
+            if (hasBeta) {
                 EventData bestBeta = BestBetaForNeutron(time);
                 double nb_dtime = (time - bestBeta.time) * clockInSeconds;
-                             TreeCorrelator::get()->place("Beta")->last().time;
                 double dt = 100 + nb_dtime / diffTimePlotResolution_;
                 if (dt > S8)
                     dt = S8 - 1;
                 if (dt < 0) {
                     dt = 0;
                 }
-                if (TreeCorrelator::get()->
-                                    place(neutron_name.str())->status()) {
+                if (isNeutron) {
                     plot(beta::D_TDIFF_NEUTRON_BETA, dt);
                     plot(beta::D_ENERGY_NEUTRON, energy);
                     ++beta_gated_neutron_multi;
@@ -224,7 +238,7 @@ bool Hen3Processor::Process(RawEvent &event) {
             }
 
             plot(DD_DISTR_HEN3, xpos, ypos);
-            if (TreeCorrelator::get()->place(neutron_name.str())->status())
+            if (isNeutron)
                 plot(DD_DISTR_NEUTRON, xpos, ypos);
     }
     plot(beta::D_MULT_NEUTRON, beta_gated_neutron_multi);
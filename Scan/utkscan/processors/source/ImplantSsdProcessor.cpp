@@ -15,11 +15,12 @@
 
 #include "DetectorDriver.hpp"
 #include "ImplantSsdProcessor.hpp"
-#include "TriggerLogicProcessor.hpp"
+#include "LogicProcessor.hpp"
 #include "RawEvent.hpp"
 
 using std::cout;
 using std::endl;
+using std::isnan;
 using std::min;
 using std::stringstream;
 using std::vector;
@@ -71,6 +72,44 @@ namespace dammIds {
 ImplantSsdProcessor::ImplantSsdProcessor() : 
     EventProcessor(OFFSET, RANGE, "ImplantSsdProcessor") {
     associatedTypes.insert("ssd");
+    fastTracesWritten = highTracesWritten = 0;
+    logProc_ = NULL;
+    impSummary_ = NULL;
+    tacSummary_ = mcpSummary_ = vetoSummary_ = boxSummary_ = NULL;
+}
+
+bool ImplantSsdProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return false;
+
+    logProc_ = dynamic_cast<LogicProcessor *>(
+        DetectorDriver::get()->GetProcessor("LogicProcessor"));
+    if (logProc_)
+        cout << "Implant SSD processor grabbed logic processor" << endl;
+
+    impSummary_  = event.GetSummary("ssd:sum", true);
+    tacSummary_  = event.GetSummary("generic:tac", true);
+    mcpSummary_  = event.GetSummary("logic:mcp", true);
+    vetoSummary_ = event.GetSummary("ssd:veto", true);
+    boxSummary_  = event.GetSummary("ssd:box", true);
+
+    corr_.Init(event);
+    return true;
+}
+
+void ImplantSsdProcessor::FillTofs(void) {
+    for (int i = 0; i <= maxTof; i++)
+        tof_[i] = NAN;
+    if (!tacSummary_)
+        return;
+
+    const vector<ChanEvent*> &events = tacSummary_->GetList();
+    for (vector<ChanEvent*>::const_iterator it = events.begin();
+         it != events.end(); it++) {
+        int loc = (*it)->GetChanID().GetLocation();
+        if (loc >= 0 && loc <= maxTof && isnan(tof_[loc]))
+            tof_[loc] = (*it)->GetCalEnergy();
+    }
 }
 
 void ImplantSsdProcessor::DeclarePlots(void)
@@ -214,35 +253,16 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
 	return false;
     }
 
-    static bool firstTime = true;
-    static LogicProcessor *logProc = NULL;
+    Correlator &corr = corr_;
 
-    static Correlator &corr = event.GetCorrelator();
-    static const DetectorSummary *tacSummary  = event.GetSummary("generic:tac", true);
-    static DetectorSummary *impSummary  = event.GetSummary("ssd:sum", true);
-    static const DetectorSummary *mcpSummary  = event.GetSummary("logic:mcp", true);
-    static const DetectorSummary *vetoSummary = event.GetSummary("ssd:veto", true);
-    static const DetectorSummary *boxSummary  = event.GetSummary("ssd:box", true);
-    DetectorDriver* driver = DetectorDriver::get();
-
-    if (impSummary->GetMult() == 0) {
+    if (impSummary_->GetMult() == 0) {
       EndProcess();
       return false;
     }
-    if (firstTime) {
-      vector<EventProcessor *> vecProc = driver->GetProcessors("logic");
-      for (vector< EventProcessor * >::iterator it = vecProc.begin(); it != vecProc.end(); it++) {
-	if ( (*it)->GetName() == "triggerlogic" || (*it)->GetName() == "logic" ) {
-	  logProc = reinterpret_cast < LogicProcessor * >(*it);
-  	  cout << "Implant SSD processor grabbed logic processor" << endl;
-        }
-      }
-      firstTime=false;
-    }
 
     EventInfo info;
-    ChanEvent *ch  = impSummary->GetMaxEvent(true);
-    info.hasVeto = ( vetoSummary && vetoSummary->GetMult() > 0 );
+    ChanEvent *ch  = impSummary_->GetMaxEvent(true);
+    info.hasVeto = ( vetoSummary_ && vetoSummary_->GetMult() > 0 );
 
     int location = ch->GetChanID().GetLocation();
     if (ch->IsSaturated()) {
@@ -263,32 +283,31 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
 	return true;
     }
 
-    if (logProc) {
-	info.clockCount = logProc->StartCount(2);
-	if (logProc->LogicStatus(3) || logProc->LogicStatus(4) || logProc->LogicStatus(5)) {
+    if (logProc_) {
+	info.clockCount = logProc_->StartCount(2);
+	const LogicTimeline &beam3 = logProc_->GetTimeline(3);
+	const LogicTimeline &beam4 = logProc_->GetTimeline(4);
+	const LogicTimeline &beam5 = logProc_->GetTimeline(5);
+	if (beam3.IsOn() || beam4.IsOn() || beam5.IsOn()) {
 	    info.beamOn = true;
 	    info.offTime = 0;
 	} else {
 	    info.beamOn = false;
-	    if (!logProc->LogicStatus(3))
-		info.offTime = logProc->TimeOff(3, info.time);
-	    else if (!logProc->LogicStatus(4))
-		info.offTime = logProc->TimeOff(4, info.time) + 300e-6;
-	    else if (!logProc->LogicStatus(5))
-		info.offTime = logProc->TimeOff(5, info.time) + 600e-6;
+	    info.offTime = beam3.TimeOff(info.time);
 	}
-	for (int i=0; i < dammIds::logic::MAX_LOGIC; i++) {
-	    info.logicBits[i] = (logProc->LogicStatus(i) ? '1' : '0');
+	for (unsigned int i=0; i < dammIds::logic::MAX_LOGIC; i++) {
+	    info.logicBits[i] =
+		(logProc_->GetTimeline(i).IsOn() ? '1' : '0');
 	}
     }
     double digitalTof = NAN;
-    if (mcpSummary) {
-	info.mcpMult = mcpSummary->GetMult();
-	vector<ChanEvent*> mcpEvents = mcpSummary->GetList();
+    if (mcpSummary_) {
+	info.mcpMult = mcpSummary_->GetMult();
+	const vector<ChanEvent*> &mcpEvents = mcpSummary_->GetList();
 
 	double dtMin = DBL_MAX;
 
-	for (vector<ChanEvent*>::iterator it = mcpEvents.begin();
+	for (vector<ChanEvent*>::const_iterator it = mcpEvents.begin();
 	     it != mcpEvents.end(); it++) {
 	    double dt = info.time - (*it)->GetTime();
 
@@ -305,16 +324,16 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
 	info.mcpMult  = 0;
 	info.foilTime = NAN;
     }
-    if (impSummary) {
-	info.impMult = impSummary->GetMult();
+    if (impSummary_) {
+	info.impMult = impSummary_->GetMult();
     } else {
 	info.impMult = 0;
     }
-    if (boxSummary) {
-	info.boxMult = boxSummary->GetMult();
+    if (boxSummary_) {
+	info.boxMult = boxSummary_->GetMult();
 
 	if (info.boxMult > 0) {
-	    const ChanEvent *boxCh = boxSummary->GetMaxEvent();
+	    const ChanEvent *boxCh = boxSummary_->GetMaxEvent();
 
 	    info.energyBox = boxCh->GetCalEnergy(); //raw?
 	    info.boxMax = boxCh->GetChanID().GetLocation();
@@ -325,23 +344,15 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
     } else {
 	info.boxMult = 0;
     }
-    info.tof = NAN;
-    if (tacSummary) {
-	const vector<ChanEvent*> events = tacSummary->GetList();
-	for (vector<ChanEvent*>::const_iterator it = events.begin(); it != events.end(); it++) {
-	    int loc = (*it)->GetChanID().GetLocation();
-	    if (loc == 2) {
-		info.tof = (*it)->GetCalEnergy();
-		info.hasTof = true;
-		break;
-	    }
-	}
-    } else {
-	info.hasTof = true;
-    }
+    FillTofs();
+    info.tof = tof_[2];
+    info.hasTof = (!tacSummary_ || !isnan(info.tof));
 
+    /** The pulses of the trace were already calibrated by the
+     * DetectorDriver, the first one is the trigger. */
     Trace &trace = ch->GetTrace();
-    if (trace.HasValue("filterEnergy2")) {
+    const vector<Trace::Pulse> &pulses = trace.GetPulses();
+    if (pulses.size() > 1) {
 	info.pileUp = true;
     }
 
@@ -349,8 +360,8 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
     Correlate(corr, info, location);
 
     // TOF spectra update
-    if (tacSummary) {
-	const vector<ChanEvent*> events = tacSummary->GetList();
+    if (tacSummary_) {
+	const vector<ChanEvent*> &events = tacSummary_->GetList();
 	for (vector<ChanEvent*>::const_iterator it = events.begin();
 	     it != events.end(); it++) {
 	    double tof  = (*it)->GetCalEnergy();
@@ -377,7 +388,7 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
     }
 
     if (info.type == EventInfo::PROTON_EVENT) {
-        const ChanEvent *chVeto = vetoSummary->GetMaxEvent();
+        const ChanEvent *chVeto = vetoSummary_->GetMaxEvent();
 
         unsigned int posVeto = chVeto->GetChanID().GetLocation();
         double vetoEnergy = chVeto->GetCalEnergy();
@@ -389,29 +400,23 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
     if (info.pileUp) {
         double trigTime = info.time;
 
-        info.energy = driver->cali.GetCalEnergy(ch->GetChanID(),
-                                              trace.GetValue("filterEnergy2"));
-        info.time = trigTime + trace.GetValue("filterTime2") - trace.GetValue("filterTime");
+        info.energy = pulses[1].calEnergy;
+        info.time = trigTime + pulses[1].time - pulses[0].time;
 
         SetType(info);
         Correlate(corr, info, location);
 
-        int numPulses = trace.GetValue("numPulses");
+        size_t numPulses = pulses.size();
 
         if ( numPulses > 2 ) {
             corr.Flag(location, 1);
             cout << "Flagging triple event" << endl;
-            for (int i=3; i <= numPulses; i++) {
-            stringstream str;
-            str << "filterEnergy" << i;
-            info.energy = driver->cali.GetCalEnergy(ch->GetChanID(),
-                                              trace.GetValue(str.str()));
-            str.str(""); // clear it
-            str << "filterTime" << i;
-            info.time   = trigTime + trace.GetValue(str.str()) - trace.GetValue("filterTime");
-
-            SetType(info);
-            Correlate(corr, info, location);
+            for (size_t i = 2; i < numPulses; i++) {
+                info.energy = pulses[i].calEnergy;
+                info.time   = trigTime + pulses[i].time - pulses[0].time;
+
+                SetType(info);
+                Correlate(corr, info, location);
             }
         }
         // corr.Flag(location, 1);
@@ -419,8 +424,8 @@ bool ImplantSsdProcessor::Process(RawEvent &event)
         cout << "Flagging for pileup" << endl;
 
         cout << "fast trace " << fastTracesWritten << " in strip " << location
-            << " : " << trace.GetValue("filterEnergy") << " " << trace.GetValue("filterTime")
-            << " , " << trace.GetValue("filterEnergy2") << " " << trace.GetValue("filterTime2") << endl;
+            << " : " << pulses[0].energy << " " << pulses[0].time
+            << " , " << pulses[1].energy << " " << pulses[1].time << endl;
         cout << "  mcp mult " << info.mcpMult << endl;
 #endif // VERBOSE
 
@@ -8,7 +8,7 @@
 #include <sstream>
 #include <vector>
 
-#include "PositionProcessor.hpp"
+#include "LitePositionProcessor.hpp"
 #include "DetectorLibrary.hpp"
 #include "RawEvent.hpp"
 #include "Messenger.hpp"
@@ -34,10 +34,10 @@ namespace dammIds {
 using namespace dammIds::position;
 
 //! @cond
-const string PositionProcessor::configFile("qdc.txt");
+const string LitePositionProcessor::configFile("qdc.txt");
 
 //! Initialize the qdc to handle ssd events
-LitePositionProcessor::PositionProcessor() :
+LitePositionProcessor::LitePositionProcessor() :
     EventProcessor(OFFSET, RANGE, "LitePositionProcessor") {
     associatedTypes.insert("ssd");
 }
@@ -74,6 +74,9 @@ bool LitePositionProcessor::Init(RawEvent& event) {
     numLocations = numLocationsTop;
     minNormQdc.resize(numLocations);
     maxNormQdc.resize(numLocations);
+    posSlope.resize(numLocations);
+    tops_.Resize(numLocations);
+    bottoms_.Resize(numLocations);
 
     ifstream in(configFile.c_str());
     if (!in) {
@@ -97,6 +100,8 @@ bool LitePositionProcessor::Init(RawEvent& event) {
 	in >> qdcLen[i];
     partial_sum(qdcLen, qdcLen + numQdcs, qdcPos);
     totLen = qdcPos[numQdcs - 1]  - qdcLen[0];
+    for (int i=0; i < numQdcs; i++)
+	baselineScale[i] = qdcLen[i] / qdcLen[0];
 
     in >> whichQdc >> posScale;
 
@@ -108,7 +113,15 @@ bool LitePositionProcessor::Init(RawEvent& event) {
 	    // place this here so a trailing newline is okay in the scan file
 	    break;
 	}
+	if (location < 0 || location >= numLocations) {
+	    cerr << "Location " << location << " in " << configFile
+		 << " is outside of the map!" << endl;
+	    cerr << "  Disabling position processor." << endl;
+	    return (initDone = false);
+	}
 	in >> minNormQdc[location] >> maxNormQdc[location];
+	posSlope[location] = posScale /
+	    (maxNormQdc[location] - minNormQdc[location]);
 	numLocationsRead++;
     }
 
@@ -216,13 +229,22 @@ bool LitePositionProcessor::Process(RawEvent &event)
     static const vector<ChanEvent*> &bottomEvents =
 	event.GetSummary("ssd:bottom", true)->GetList();
 
-    vector<ChanEvent *> allEvents;
+    tops_.Fill(topEvents);
+    bottoms_.Fill(bottomEvents);
+
     // just add in the digisum events for now
-    allEvents.insert(allEvents.begin(), digisumEvents.begin(), digisumEvents.end());
-    allEvents.insert(allEvents.begin(), sumEvents.begin(), sumEvents.end());
+    ProcessSums(sumEvents);
+    ProcessSums(digisumEvents);
 
-    for (vector<ChanEvent*>::const_iterator it=allEvents.begin();
-	 it != allEvents.end(); it++) {
+    EndProcess();
+
+    return true;
+}
+
+void LitePositionProcessor::ProcessSums(const vector<ChanEvent*> &sums)
+{
+    for (vector<ChanEvent*>::const_iterator it=sums.begin();
+	 it != sums.end(); it++) {
 	ChanEvent *sumchan   = *it;
 
 	int location = sumchan->GetChanID().GetLocation();
@@ -236,9 +258,9 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	  continue;
 	}
 
-	const ChanEvent *top    = FindMatchingEdge(sumchan, topEvents.begin(), topEvents.end());
-	const ChanEvent *bottom = FindMatchingEdge(sumchan, bottomEvents.begin(), bottomEvents.end());
-
+	bool isMultipleTop, isMultipleBottom;
+	const ChanEvent *top    = tops_.Match(sumchan, 5., isMultipleTop);
+	const ChanEvent *bottom = bottoms_.Match(sumchan, 5., isMultipleBottom);
 
 	if (top == NULL || bottom == NULL) {
 	    using namespace dammIds::position;
@@ -255,15 +277,10 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	    continue;
 	}
 
-	/* Make sure we get the same match going backwards to insure there is only one in the vector */
-	/* Isn't working due to some C++ STL mumbo jumbo -- normal iterators and reverse iterators not interchangeable
-	if ( FindMatchingEdge(sumchan, topEvents.rbegin(), topEvents.rend()) != top) {
-	    cout << "Multiple top edges found for sum location " << location << endl;
-	}
-	if ( FindMatchingEdge(sumchan, bottomEvents.rbegin(), bottomEvents.rend()) != bottom) {
-	    cout << "Multiple top edges found for sum location " << location << endl;
-	}
-	*/
+#ifdef VERBOSE
+	if (isMultipleTop || isMultipleBottom)
+	    cout << "Multiple edges found for sum location " << location << endl;
+#endif
 	using namespace dammIds::position;
 
 	float topQdc[numQdcs];
@@ -313,7 +330,7 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	      topQdc[i] = top->GetQdcValue(i);
 	    }
 
-	    topQdc[i] -= topQdc[0] * qdcLen[i] / qdcLen[0];
+	    topQdc[i] -= topQdc[0] * baselineScale[i];
 	    topQdcTot += topQdc[i];
 	    topQdc[i] /= qdcLen[i];
 
@@ -324,7 +341,7 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	      bottomQdc[i] = bottom->GetQdcValue(i);
 	    }
 
-	    bottomQdc[i] -= bottomQdc[0] * qdcLen[i] / qdcLen[0];
+	    bottomQdc[i] -= bottomQdc[0] * baselineScale[i];
 	    bottomQdcTot += bottomQdc[i];
 	    bottomQdc[i] /= qdcLen[i];
 
@@ -335,8 +352,7 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	    plot(D_QDCNORMN_LOCX + QDC_JUMP * i + location, frac);
 	    plot(D_QDCNORMN_LOCX + QDC_JUMP * i + LOC_SUM, frac);
 	    if (i == whichQdc) {
-		position = posScale * (frac - minNormQdc[location]) /
-		    (maxNormQdc[location] - minNormQdc[location]);
+		position = (frac - minNormQdc[location]) * posSlope[location];
 		sumchan->GetTrace().InsertValue("position", position);
 		// plot(DD_POSITION, location, position);
 		plot(DD_POSITION__ENERGY_LOCX + location, position, sumchan->GetCalEnergy());
@@ -362,24 +378,4 @@ bool LitePositionProcessor::Process(RawEvent &event)
 	plot(DD_QDCTOT__QDCTOT_LOCX + location, topQdcTot, bottomQdcTot);
 	plot(DD_QDCTOT__QDCTOT_LOCX + LOC_SUM , topQdcTot, bottomQdcTot);
     } // end iteration over sum events
-
-    EndProcess();
-
-    return true;
 }
-
-ChanEvent* LitePositionProcessor::FindMatchingEdge(ChanEvent *match,
-						   vector<ChanEvent*>::const_iterator begin,
-						   vector<ChanEvent*>::const_iterator end) const
-{
-    const float timeCut = 5.; // maximum difference between edge and sum timestamps
-
-    for (;begin < end; begin++) {
-	if ( (*begin)->GetChanID().GetLocation() == match->GetChanID().GetLocation() &&
-	     abs( (*begin)->GetTime() - match->GetTime() ) < timeCut ) {
-	    return *begin;
-	}
-    }
-    return NULL;
-}
-
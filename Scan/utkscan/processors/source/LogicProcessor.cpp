@@ -6,13 +6,18 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
+#include "Exceptions.hpp"
 #include "Globals.hpp"
+#include "Messenger.hpp"
 #include "RawEvent.hpp"
 #include "LogicProcessor.hpp"
+#include "TreeCorrelator.hpp"
 
 using namespace std;
 using namespace dammIds::logic;
@@ -22,8 +27,6 @@ static const double doubleTimeLimit_ = 10e-6;
 
 namespace dammIds {
     namespace logic {
-	static const unsigned int MAX_LOGIC = 10; //!<Maximum Number of Logic Signals
-
 	///Original Logic Processor
         const int D_COUNTER_START  = 0;//!< Counter for the starts
         const int D_COUNTER_STOP   = 1;//!< Counter for the stops
@@ -60,24 +63,102 @@ namespace dammIds {
 
 LogicProcessor::LogicProcessor(void) :
     EventProcessor(dammIds::logic::OFFSET, dammIds::logic::RANGE, "LogicProcessor"),
-    lastStartTime(MAX_LOGIC, NAN), lastStopTime(MAX_LOGIC, NAN),
-    logicStatus(MAX_LOGIC), stopCount(MAX_LOGIC), startCount(MAX_LOGIC) {
+    timelines_(MAX_LOGIC) {
     associatedTypes.insert("logic");
     associatedTypes.insert("timeclass"); // old detector type
     associatedTypes.insert("mtc");
+
+    doubleStop_ = doubleStart_ = false;
+    logicEvents_ = NULL;
+    t0_ = NAN;
 }
 
 LogicProcessor::LogicProcessor(int offset, int range, bool doubleStop/*=false*/,
 			       bool doubleStart/*=false*/) :
     EventProcessor(offset, range, "LogicProcessor"),
-    lastStartTime(MAX_LOGIC, NAN), lastStopTime(MAX_LOGIC, NAN),
-    logicStatus(MAX_LOGIC), stopCount(MAX_LOGIC), startCount(MAX_LOGIC) {
+    timelines_(MAX_LOGIC) {
     associatedTypes.insert("logic");
     associatedTypes.insert("timeclass"); // old detector type
     associatedTypes.insert("mtc");
 
     doubleStop_ = doubleStop;
     doubleStart_ = doubleStart;
+    logicEvents_ = NULL;
+    t0_ = NAN;
+}
+
+bool LogicProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+
+    if (sumMap.find("logic") != sumMap.end())
+        logicEvents_ = &sumMap["logic"]->GetList();
+
+    /** What each channel does is decided here once from its subtype and
+     * place name instead of comparing the strings for every hit. */
+    DetectorLibrary *lib = DetectorLibrary::get();
+    channels_.assign(lib->size(), ChannelInfo());
+    for (DetectorLibrary::size_type i = 0; i < lib->size(); i++) {
+        if (!lib->HasValue(i) || lib->at(i).GetType() != "logic")
+            continue;
+        const Identifier &id = lib->at(i);
+        ChannelInfo &info = channels_[i];
+        info.location = id.GetLocation();
+        info.placeName = id.GetPlaceName();
+        info.place = NULL;
+
+        string subtype = id.GetSubtype();
+        if (subtype == "start")
+            info.role = ROLE_START;
+        else if (subtype == "stop")
+            info.role = ROLE_STOP;
+        else if (info.placeName == "logic_mtc_start_0")
+            info.role = ROLE_MTC_START;
+        else if (info.placeName == "logic_mtc_stop_0")
+            info.role = ROLE_MTC_STOP;
+        else if (info.placeName == "logic_beam_start_0")
+            info.role = ROLE_BEAM_START;
+        else if (info.placeName == "logic_beam_stop_0")
+            info.role = ROLE_BEAM_STOP;
+        else if (info.placeName == "logic_t1_0")
+            info.role = ROLE_T1;
+        else if (info.placeName == "logic_supercycle_0")
+            info.role = ROLE_SUPERCYCLE;
+        else if (info.placeName == "logic_beam_0")
+            info.role = ROLE_BEAM_TOGGLE;
+        else if (info.placeName == "logic_analog_0")
+            info.role = ROLE_BEAM_ANALOG;
+        else if (info.placeName == "logic_none_0")
+            info.role = ROLE_BEAM_NONE;
+
+        if ((info.role == ROLE_START || info.role == ROLE_STOP) &&
+            info.location >= MAX_LOGIC) {
+            stringstream ss;
+            ss << "LogicProcessor::Init : The location " << info.location
+               << " of a logic start/stop is larger than the maximum of "
+               << MAX_LOGIC - 1;
+            throw GeneralException(ss.str());
+        }
+    }
+
+    places_.assign(NUM_PLACES, NULL);
+    return(true);
+}
+
+Place *LogicProcessor::GetPlace(const PlaceIndex &idx) {
+    static const char *names[NUM_PLACES] = {"TapeMove", "Cycle", "Beam",
+                                            "Supercycle", "logic_mtc_start_0",
+                                            "logic_beam_start_0",
+                                            "logic_beam_stop_0"};
+    if (places_[idx] == NULL)
+        places_[idx] = TreeCorrelator::get()->place(names[idx]);
+    return(places_[idx]);
+}
+
+Place *LogicProcessor::GetPlace(ChannelInfo &info) {
+    if (info.place == NULL)
+        info.place = TreeCorrelator::get()->place(info.placeName);
+    return(info.place);
 }
 
 void LogicProcessor::DeclarePlots(void) {
@@ -117,134 +198,140 @@ void LogicProcessor::DeclarePlots(void) {
 bool LogicProcessor::PreProcess(RawEvent &event) {
     if (!EventProcessor::PreProcess(event))
         return false;
+    if (logicEvents_ == NULL)
+        return(true);
 
     static double clockInSeconds = Globals::get()->clockInSeconds(); //!< clock in seconds
     const double logicPlotResolution =
         10e-6 / Globals::get()->clockInSeconds(); //!<Resolution for Logic Plots
     const double mtcPlotResolution = 10e-3 / clockInSeconds; //!<Res. for MTC Plots
 
-    static const vector<ChanEvent*> &events = sumMap["logic"]->GetList();
-
-    for (vector<ChanEvent*>::const_iterator it = events.begin();
-	 it != events.end(); it++) {
+    // for 2d plot of events 100ms / bin
+    const double eventsResolution = 100e-3 / clockInSeconds;
+    const unsigned MTC_START = 0;
+    const unsigned MTC_STOP = 1;
+    const unsigned BEAM_START = 2;
+    const unsigned BEAM_STOP = 3;
+    // for 2d plot of events 1s / bin
+    // Bins in plot
+    const unsigned BEAM_TOGGLE = 0;
+    const unsigned BEAM_ANALOG = 1;
+    const unsigned BEAM_NONE = 2;
+
+    for (vector<ChanEvent*>::const_iterator it = logicEvents_->begin();
+	 it != logicEvents_->end(); it++) {
 	ChanEvent *chan = *it;
-
-	string place = (*it)->GetChanID().GetPlaceName();
-	string subtype   = chan->GetChanID().GetSubtype();
-	unsigned int loc = chan->GetChanID().GetLocation();
+	ChannelInfo &info = channels_[chan->GetID()];
+	unsigned int loc = info.location;
 	double time = chan->GetTime();
 
-	static double t0 = time;
-
-	// for 2d plot of events 100ms / bin
-	const double eventsResolution = 100e-3 / clockInSeconds;
-	const unsigned MTC_START = 0;
-	const unsigned MTC_STOP = 1;
-	const unsigned BEAM_START = 2;
-	const unsigned BEAM_STOP = 3;
-        // for 2d plot of events 1s / bin
-        // Bins in plot
-        const unsigned BEAM_TOGGLE = 0;
-        const unsigned BEAM_ANALOG = 1;
-        const unsigned BEAM_NONE = 2;
-	double time_x = int((time - t0) / eventsResolution);
-
-	if(subtype == "start") {
-	    if (!std::isnan(lastStartTime.at(loc))) {
-		double timediff = time - lastStartTime.at(loc);
+	if (std::isnan(t0_))
+	    t0_ = time;
+	double time_x = int((time - t0_) / eventsResolution);
+
+	switch (info.role) {
+	case ROLE_START: {
+	    LogicTimeline &timeline = timelines_[loc];
+	    if (!std::isnan(timeline.GetLastStart())) {
+		double timediff = time - timeline.GetLastStart();
 		plot(DD_TDIFF_START, timediff / logicPlotResolution, loc);
 		plot(DD_TDIFF_SUM, timediff / logicPlotResolution, loc);
 	    }
-
-	    lastStartTime.at(loc) = time;
-	    logicStatus.at(loc) = true;
-
-	    startCount.at(loc)++;
+	    timeline.Start(time);
 	    plot(D_COUNTER_START, loc);
-	} else if (subtype == "stop") {
-	    if (!std::isnan(lastStopTime.at(loc))) {
-                double timediff = time - lastStopTime.at(loc);
+	    break;
+	}
+	case ROLE_STOP: {
+	    LogicTimeline &timeline = timelines_[loc];
+	    if (!std::isnan(timeline.GetLastStop())) {
+                double timediff = time - timeline.GetLastStop();
                 plot(DD_TDIFF_STOP, timediff / logicPlotResolution, loc);
                 plot(DD_TDIFF_SUM, timediff / logicPlotResolution, loc);
-                if (!std::isnan(lastStartTime.at(loc))) {
-                    double moveTime = time - lastStartTime.at(loc);
+                if (!std::isnan(timeline.GetLastStart())) {
+                    double moveTime = time - timeline.GetLastStart();
                     plot(DD_TDIFF_LENGTH, moveTime / logicPlotResolution, loc);
                 }
             }
-
-            lastStopTime.at(loc) = time;
-            logicStatus.at(loc) = false;
-
-            stopCount.at(loc)++;
+            timeline.Stop(time);
             plot(D_COUNTER_STOP, loc);
-        } else if(place == "logic_mtc_start_0") {
-	    double dt_start = time -
-		TreeCorrelator::get()->place(place)->secondlast().time;
-	    TreeCorrelator::get()->place("TapeMove")->activate(time);
-	    TreeCorrelator::get()->place("Cycle")->deactivate(time);
+	    break;
+	}
+	case ROLE_MTC_START: {
+	    double dt_start = time - GetPlace(info)->secondlast().time;
+	    GetPlace(TAPE_MOVE_PLACE)->activate(time);
+	    GetPlace(CYCLE_PLACE)->deactivate(time);
+	    tapeMove_.Start(time);
+	    cycle_.Stop(time);
 
 	    plot(D_TDIFF_MOVE_START, dt_start / mtcPlotResolution);
 	    plot(D_COUNTER, MOVE_START_BIN);
 	    plot(DD_TIME_DET_MTCEVENTS, time_x, MTC_START);
-	} else if (place == "logic_mtc_stop_0") {
-	    double dt_stop = time -
-		TreeCorrelator::get()->place(place)->secondlast().time;
-	    double dt_move = time -
-		TreeCorrelator::get()->place("logic_mtc_start_0")->last().time;
-	    TreeCorrelator::get()->place("TapeMove")->deactivate(time);
+	    break;
+	}
+	case ROLE_MTC_STOP: {
+	    double dt_stop = time - GetPlace(info)->secondlast().time;
+	    double dt_move = time - GetPlace(MTC_START_PLACE)->last().time;
+	    GetPlace(TAPE_MOVE_PLACE)->deactivate(time);
+	    tapeMove_.Stop(time);
 
 	    plot(D_TDIFF_MOVE_STOP, dt_stop / mtcPlotResolution);
 	    plot(D_MOVETIME, dt_move / mtcPlotResolution);
 	    plot(D_COUNTER, MOVE_STOP_BIN);
 	    plot(DD_TIME_DET_MTCEVENTS, time_x, MTC_STOP);
-	} else if (place == "logic_beam_start_0") {
-	    double dt_start = time -
-		TreeCorrelator::get()->place(place)->secondlast().time;
+	    break;
+	}
+	case ROLE_BEAM_START: {
+	    double dt_start = time - GetPlace(info)->secondlast().time;
 	    //Remove double starts
 	    if (doubleStart_) {
 		double dt_stop =
-		    abs(time -
-			TreeCorrelator::get()->place("logic_beam_stop_0")->last().time);
+		    abs(time - GetPlace(BEAM_STOP_PLACE)->last().time);
 		if (abs(dt_start * clockInSeconds) < doubleTimeLimit_ ||
 		    abs(dt_stop * clockInSeconds) < doubleTimeLimit_)
 		    continue;
 	    }
-	    TreeCorrelator::get()->place("Beam")->activate(time);
-	    TreeCorrelator::get()->place("Cycle")->activate(time);
+	    GetPlace(BEAM_PLACE)->activate(time);
+	    GetPlace(CYCLE_PLACE)->activate(time);
+	    beam_.Start(time);
+	    cycle_.Start(time);
 
 	    plot(D_TDIFF_BEAM_START, dt_start / mtcPlotResolution);
 	    plot(D_COUNTER, BEAM_START_BIN);
 	    plot(DD_TIME_DET_MTCEVENTS, time_x, BEAM_START);
-	} else if (place == "logic_beam_stop_0") {
-	    double dt_stop = time -
-		TreeCorrelator::get()->place(place)->secondlast().time;
-	    double dt_beam = time -
-		TreeCorrelator::get()->place("logic_beam_start_0")->last().time;
+	    break;
+	}
+	case ROLE_BEAM_STOP: {
+	    double dt_stop = time - GetPlace(info)->secondlast().time;
+	    double dt_beam = time - GetPlace(BEAM_START_PLACE)->last().time;
 	    //Remove double stops
 	    if (doubleStop_) {
 		if (abs(dt_stop * clockInSeconds) < doubleTimeLimit_ ||
 		    abs(dt_beam * clockInSeconds) < doubleTimeLimit_)
 		    continue;
 	    }
-	    TreeCorrelator::get()->place("Beam")->deactivate(time);
+	    GetPlace(BEAM_PLACE)->deactivate(time);
+	    beam_.Stop(time);
 
 	    plot(D_TDIFF_BEAM_STOP, dt_stop / mtcPlotResolution);
 	    plot(D_BEAMTIME, dt_beam / mtcPlotResolution);
 	    plot(D_COUNTER, BEAM_STOP_BIN);
 	    plot(DD_TIME_DET_MTCEVENTS, time_x, BEAM_STOP);
-	} else if (place == "logic_t1_0") {
+	    break;
+	}
+	case ROLE_T1: {
 	    //TreeCorrelator::get()->place("Protons")->activate(time);
-	    double dt_t1 = time -
-		TreeCorrelator::get()->place("logic_t1_0")->last().time;
+	    double dt_t1 = time - GetPlace(info)->last().time;
 	    plot(D_TDIFF_T1, dt_t1 / mtcPlotResolution);
-	} else if (place == "logic_supercycle_0") {
-	    TreeCorrelator::get()->place("Supercycle")->activate(time);
-	    double dt_supercycle = time -
-		TreeCorrelator::get()->place("logic_supercycle_0")->last().time;
+	    break;
+	}
+	case ROLE_SUPERCYCLE: {
+	    GetPlace(SUPERCYCLE_PLACE)->activate(time);
+	    double dt_supercycle = time - GetPlace(info)->last().time;
 	    plot(D_TDIFF_SUPERCYCLE, dt_supercycle / mtcPlotResolution);
-	}else if (place == "logic_beam_0") {
-            double last_time =
-                TreeCorrelator::get()->place(place)->secondlast().time;
+	    break;
+	}
+	case ROLE_BEAM_TOGGLE: {
+            double last_time = GetPlace(info)->secondlast().time;
             double dt_beam_stop = abs(time - last_time);
 
             Messenger m;
@@ -257,31 +344,37 @@ bool LogicProcessor::PreProcess(RawEvent &event) {
             }
 
             // If beam was stopped, activate place and plot stop length
-            if (!TreeCorrelator::get()->place("Beam")->status()) {
-                double clockInSeconds = Globals::get()->clockInSeconds();
+            Place *beam = GetPlace(BEAM_PLACE);
+            if (!beam->status()) {
                 double resolution = 1.0 / clockInSeconds;
 
                 plot(D_TIME_STOP_LENGTH, dt_beam_stop / resolution);
 
-                TreeCorrelator::get()->place("Beam")->activate(time);
+                beam->activate(time);
+                beam_.Start(time);
                 ss << "Beam started after: " << dt_beam_stop / resolution
                    << " s ";
                 m.run_message(ss.str());
             }
             else {
-                TreeCorrelator::get()->place("Beam")->deactivate(time);
+                beam->deactivate(time);
+                beam_.Stop(time);
                 ss << "Beam stopped";
                 m.run_message(ss.str());
             }
             plot(D_COUNTER_BEAM, BEAM_TOGGLE);
-
+	    break;
         }
-        else if (place == "logic_analog_0") {
+	case ROLE_BEAM_ANALOG:
             plot(D_COUNTER_BEAM, BEAM_ANALOG);
-        }
-        else if (place == "logic_none_0") {
+	    break;
+	case ROLE_BEAM_NONE:
             plot(D_COUNTER_BEAM, BEAM_NONE);
-        }
+	    break;
+	case ROLE_UNUSED:
+	default:
+	    break;
+	}
     }//events loop
     return(true);
 }
@@ -313,8 +406,8 @@ bool LogicProcessor::NiftyGraph(RawEvent &event) {
         int timeBin = int(chan->GetTime() / logicPlotResolution);
         int startTimeBin = 0;
 
-        if(!std::isnan(lastStartTime.at(loc))) {
-            startTimeBin = int(lastStartTime.at(loc) / logicPlotResolution);
+        if(!std::isnan(timelines_[loc].GetLastStart())) {
+            startTimeBin = int(timelines_[loc].GetLastStart() / logicPlotResolution);
             if(firstTimeBin == -1) {
                 firstTimeBin = startTimeBin;
             }
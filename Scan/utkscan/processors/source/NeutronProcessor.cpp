@@ -49,6 +49,18 @@ void NeutronProcessor::DeclarePlots(void)
 	DeclareHistogram1D(betaGammaGated::D_ENERGY_DETX + 2, SE, "beta-gamma gated 3Hen");
 }
 
+bool NeutronProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return false;
+
+    /** The places are looked up once here instead of by name for every
+     * hit. */
+    betaPlace_.Resolve("Beta");
+    gammaPlace_.Resolve("Gamma");
+    gammaBetaPlace_.Resolve("GammaBeta");
+    return true;
+}
+
 bool NeutronProcessor::PreProcess(RawEvent &event){
     if (!EventProcessor::PreProcess(event))
         return false;
@@ -70,13 +82,13 @@ bool NeutronProcessor::Process(RawEvent &event)
         int loc = chan->GetChanID().GetLocation();
         double neutronEnergy = chan->GetCalEnergy();
 
-        if (TreeCorrelator::get()->place("Beta")->status()) {
+        if (betaPlace_->status()) {
             plot(betaGated::D_ENERGY_DETX + loc, neutronEnergy);
         }
-        if (TreeCorrelator::get()->place("Gamma")->status()) {
+        if (gammaPlace_->status()) {
             plot(gammaGated::D_ENERGY_DETX + loc, neutronEnergy);
         }
-        if (TreeCorrelator::get()->place("GammaBeta")->status()) {
+        if (gammaBetaPlace_->status()) {
             plot(betaGammaGated::D_ENERGY_DETX + loc, neutronEnergy);
         }
     }
@@ -82,8 +82,8 @@ bool PositionProcessor::Init(RawEvent& rawev)
         cerr << "  Disabling QDC processor." << endl;
         return (initDone = false);
     }
-    minNormQdc.resize(numLocations);
-    maxNormQdc.resize(numLocations);
+    tops_.Resize(numLocations);
+    bottoms_.Resize(numLocations);
 
     //This functionality is deprecated and should be implemented in the XML file
     //string configFile = Globals::get()->configPath("qdc.txt");
@@ -112,6 +112,8 @@ bool PositionProcessor::Init(RawEvent& rawev)
     partial_sum(qdcLen, qdcLen + numQdcs, qdcPos);
     totLen = qdcPos[numQdcs - 1]  - qdcLen[0];
     // totLen = accumulate(qdcLen + 1, qdcLen + 8, 0);
+    for (int i = 0; i < numQdcs; i++)
+        baselineScale[i] = qdcLen[i] / qdcLen[0];
 
     in >> whichQdc >> posScale;
 
@@ -123,7 +125,15 @@ bool PositionProcessor::Init(RawEvent& rawev)
             // place this here so a trailing newline is okay in the scan file
             break;
         }
+        if (location < 0 || location >= numLocations) {
+            cerr << "Location " << location << " in " << configFile
+                << " is outside of the map!" << endl;
+            cerr << "  Disabling position processor." << endl;
+            return (initDone = false);
+        }
         in >> minNormQdc[location] >> maxNormQdc[location];
+        posSlope[location] = posScale /
+            (maxNormQdc[location] - minNormQdc[location]);
         numLocationsRead++;
     }
 
@@ -242,33 +252,49 @@ bool PositionProcessor::Process(RawEvent &event) {
     static const vector<ChanEvent*> &bottomEvents =
 	event.GetSummary("ssd:bottom", true)->GetList();
 
-    vector<ChanEvent *> allEvents;
+    tops_.Fill(topEvents);
+    bottoms_.Fill(bottomEvents);
+
+    pairSums_.clear();
+    pairLocations_.clear();
+    for (int i = 0; i < numQdcs; ++i) {
+        topQdc_[i].clear();
+        bottomQdc_[i].clear();
+    }
+
     // just add in the digisum events for now
-    allEvents.insert(allEvents.begin(), digisumEvents.begin(), digisumEvents.end());
-    allEvents.insert(allEvents.begin(), sumEvents.begin(), sumEvents.end());
+    AddPairs(sumEvents);
+    AddPairs(digisumEvents);
+
+    CalculatePositions();
+    PlotPairs();
 
-    for (vector<ChanEvent*>::const_iterator it = allEvents.begin();
-	     it != allEvents.end(); ++it) {
-         ChanEvent *sumchan   = *it;
+    EndProcess();
+
+    return true;
+}
+
+void PositionProcessor::AddPairs(const vector<ChanEvent*> &sums) {
+    for (vector<ChanEvent*>::const_iterator it = sums.begin();
+	     it != sums.end(); ++it) {
+        ChanEvent *sumchan = *it;
 
         int location = sumchan->GetChanID().GetLocation();
 
         // Don't waste our time with noise events
-        if ( (*it)->GetEnergy() < 10. || (*it)->GetEnergy() > 16374 ) {
-            using namespace dammIds::position;
-
+        if ( sumchan->GetEnergy() < 10. || sumchan->GetEnergy() > 16374 ) {
             plot(D_INFO_LOCX + location, INFO_NOISE);
             plot(D_INFO_LOCX + LOC_SUM , INFO_NOISE);
             continue;
         }
 
-        const ChanEvent *top    = FindMatchingEdge(sumchan, topEvents.begin(), topEvents.end());
-        const ChanEvent *bottom = FindMatchingEdge(sumchan, bottomEvents.begin(), bottomEvents.end());
-
+        bool isMultipleTop, isMultipleBottom;
+        const ChanEvent *top =
+            tops_.Match(sumchan, matchingTimeCut, isMultipleTop);
+        const ChanEvent *bottom =
+            bottoms_.Match(sumchan, matchingTimeCut, isMultipleBottom);
 
         if (top == NULL || bottom == NULL) {
-            using namespace dammIds::position;
-
             if (top == NULL) {
                 // [6] -> Missing top
                 plot(D_INFO_LOCX + location, INFO_MISSING_TOP);
@@ -283,61 +309,50 @@ bool PositionProcessor::Process(RawEvent &event) {
             continue;
         }
 
-        /* Make sure we get the same match going backwards to insure there is only one in the vector */
-        if ( FindMatchingEdge(sumchan, topEvents.rbegin(), topEvents.rend()) != top) {
-            using namespace dammIds::position;
+        if (isMultipleTop) {
             // [4] -> Multiple top
             plot(D_INFO_LOCX + location, INFO_MULTIPLE_TOP);
             plot(D_INFO_LOCX + LOC_SUM, INFO_MULTIPLE_TOP);
             continue;
         }
-        if ( FindMatchingEdge(sumchan, bottomEvents.rbegin(), bottomEvents.rend()) != bottom) {
-            using namespace dammIds::position;
+        if (isMultipleBottom) {
             // [3] -> Multiple bottom
             plot(D_INFO_LOCX + location, INFO_MULTIPLE_BOTTOM);
             plot(D_INFO_LOCX + LOC_SUM, INFO_MULTIPLE_BOTTOM);
             continue;
         }
 
-        using namespace dammIds::position;
-
-        float topQdc[numQdcs];
-        float bottomQdc[numQdcs];
-        float topQdcTot = 0;
-        float bottomQdcTot = 0;
-        float position = NAN;
-
-        topQdc[0] = top->GetQdcValue(0);
-        bottomQdc[0] = bottom->GetQdcValue(0);
-        if (bottomQdc[0] == pixie::U_DELIMITER || topQdc[0] == pixie::U_DELIMITER) {
+        float topQdc0 = top->GetQdcValue(0);
+        float bottomQdc0 = bottom->GetQdcValue(0);
+        if (bottomQdc0 == pixie::U_DELIMITER || topQdc0 == pixie::U_DELIMITER) {
             // This happens naturally for traces which have double triggers
             //   Onboard DSP does not write QDCs in this case
 #ifdef VERBOSE
             cout << "SSD strip edges are missing QDC information for location " << location << endl;
 #endif
-            if (topQdc[0] == pixie::U_DELIMITER) {
+            if (topQdc0 == pixie::U_DELIMITER) {
                 // [2] -> Missing top QDC
                 plot(D_INFO_LOCX + location, INFO_MISSING_TOP_QDC);
                 plot(D_INFO_LOCX + LOC_SUM, INFO_MISSING_TOP_QDC);
                 // Recreate qdc from trace
                 if ( !top->GetTrace().empty() ) {
-                    topQdc[0] = accumulate(top->GetTrace().begin(), top->GetTrace().begin() + qdcLen[0], 0);
+                    topQdc0 = accumulate(top->GetTrace().begin(), top->GetTrace().begin() + qdcLen[0], 0);
                 } else {
-                    topQdc[0] = 0;
+                    topQdc0 = 0;
                 }
             }
-            if (bottomQdc[0] == pixie::U_DELIMITER) {
+            if (bottomQdc0 == pixie::U_DELIMITER) {
                 // [1] -> Missing bottom QDC
                 plot(D_INFO_LOCX + location, INFO_MISSING_BOTTOM_QDC);
                 plot(D_INFO_LOCX + LOC_SUM, INFO_MISSING_BOTTOM_QDC);
                 // Recreate qdc from trace
                 if ( !bottom->GetTrace().empty() ) {
-                    bottomQdc[0] = accumulate(bottom->GetTrace().begin(), bottom->GetTrace().begin() + qdcLen[0], 0);
+                    bottomQdc0 = accumulate(bottom->GetTrace().begin(), bottom->GetTrace().begin() + qdcLen[0], 0);
                 } else {
-                    bottomQdc[0] = 0;
+                    bottomQdc0 = 0;
                 }
             }
-            if ( topQdc[0] == 0 || bottomQdc[0] == 0 ) {
+            if ( topQdc0 == 0 || bottomQdc0 == 0 ) {
                 continue;
             }
         }
@@ -345,63 +360,117 @@ bool PositionProcessor::Process(RawEvent &event) {
         plot(D_INFO_LOCX + location, INFO_OKAY);
         plot(D_INFO_LOCX + LOC_SUM, INFO_OKAY);
 
-
+        pairSums_.push_back(sumchan);
+        pairLocations_.push_back(location);
+        topQdc_[0].push_back(topQdc0);
+        bottomQdc_[0].push_back(bottomQdc0);
         for (int i = 1; i < numQdcs; ++i) {
             if (top->GetQdcValue(i) == pixie::U_DELIMITER) {
                 // Recreate qdc from trace
-                topQdc[i] = accumulate(top->GetTrace().begin() + qdcPos[i-1],
-                top->GetTrace().begin() + qdcPos[i], 0);
+                topQdc_[i].push_back(accumulate(top->GetTrace().begin() + qdcPos[i-1],
+                                                top->GetTrace().begin() + qdcPos[i], 0));
             } else {
-                topQdc[i] = top->GetQdcValue(i);
+                topQdc_[i].push_back(top->GetQdcValue(i));
             }
 
-            topQdc[i] -= topQdc[0] * qdcLen[i] / qdcLen[0];
-            topQdcTot += topQdc[i];
-            topQdc[i] /= qdcLen[i];
-
             if (bottom->GetQdcValue(i) == pixie::U_DELIMITER) {
                 // Recreate qdc from trace
-                bottomQdc[i] = accumulate(bottom->GetTrace().begin() + qdcPos[i-1],
-                                          bottom->GetTrace().begin() + qdcPos[i], 0);
+                bottomQdc_[i].push_back(accumulate(bottom->GetTrace().begin() + qdcPos[i-1],
+                                                   bottom->GetTrace().begin() + qdcPos[i], 0));
             } else {
-                bottomQdc[i] = bottom->GetQdcValue(i);
+                bottomQdc_[i].push_back(bottom->GetQdcValue(i));
             }
+        }
+    } // end iteration over sum events
+}
+
+void PositionProcessor::CalculatePositions(void) {
+    const size_t numPairs = pairSums_.size();
+    topQdcTot_.assign(numPairs, 0);
+    bottomQdcTot_.assign(numPairs, 0);
+    position_.assign(numPairs, NAN);
+    if (numPairs == 0)
+        return;
+
+    const float *top0 = &topQdc_[0][0];
+    const float *bottom0 = &bottomQdc_[0][0];
+    float *topTot = &topQdcTot_[0];
+    float *bottomTot = &bottomQdcTot_[0];
+
+    // The loops over the strips have no branches, so that the compiler
+    // can vectorize them
+    for (int i = 1; i < numQdcs; ++i) {
+        const float scale = baselineScale[i];
+        const float len = qdcLen[i];
+        frac_[i].resize(numPairs);
+        float *top = &topQdc_[i][0];
+        float *bottom = &bottomQdc_[i][0];
+        float *frac = &frac_[i][0];
+
+        for (size_t p = 0; p < numPairs; ++p) {
+            top[p] -= top0[p] * scale;
+            topTot[p] += top[p];
+            top[p] /= len;
+
+            bottom[p] -= bottom0[p] * scale;
+            bottomTot[p] += bottom[p];
+            bottom[p] /= len;
+
+            frac[p] = top[p] / (top[p] + bottom[p]) * 1000.; // per mil
+        }
+    }
+
+    for (size_t p = 0; p < numPairs; ++p) {
+        topTot[p] /= totLen;
+        bottomTot[p] /= totLen;
+    }
 
-            bottomQdc[i] -= bottomQdc[0] * qdcLen[i] / qdcLen[0];
-            bottomQdcTot += bottomQdc[i];
-            bottomQdc[i] /= qdcLen[i];
+    if (whichQdc < 1 || whichQdc >= numQdcs)
+        return;
+    const float *frac = &frac_[whichQdc][0];
+    const int *location = &pairLocations_[0];
+    for (size_t p = 0; p < numPairs; ++p)
+        position_[p] = (frac[p] - minNormQdc[location[p]]) *
+            posSlope[location[p]];
+}
 
-            plot(DD_QDCN__QDCN_LOCX + QDC_JUMP * i + location, topQdc[i] + 10, bottomQdc[i] + 10);
-            plot(DD_QDCN__QDCN_LOCX + QDC_JUMP * i + LOC_SUM, topQdc[i], bottomQdc[i]);
+void PositionProcessor::PlotPairs(void) {
+    for (size_t p = 0; p < pairSums_.size(); ++p) {
+        ChanEvent *sumchan = pairSums_[p];
+        int location = pairLocations_[p];
+        float position = position_[p];
 
-            float frac = topQdc[i] / (topQdc[i] + bottomQdc[i]) * 1000.; // per mil
+        for (int i = 1; i < numQdcs; ++i) {
+            float topQdc = topQdc_[i][p];
+            float bottomQdc = bottomQdc_[i][p];
+            float frac = frac_[i][p];
+
+            plot(DD_QDCN__QDCN_LOCX + QDC_JUMP * i + location, topQdc + 10, bottomQdc + 10);
+            plot(DD_QDCN__QDCN_LOCX + QDC_JUMP * i + LOC_SUM, topQdc, bottomQdc);
 
             plot(D_QDCNORMN_LOCX + QDC_JUMP * i + location, frac);
             plot(D_QDCNORMN_LOCX + QDC_JUMP * i + LOC_SUM, frac);
             if (i == whichQdc) {
-                position = posScale * (frac - minNormQdc[location]) /
-                    (maxNormQdc[location] - minNormQdc[location]);
                 sumchan->GetTrace().InsertValue("position", position);
                 plot(DD_POSITION__ENERGY_LOCX + location, position, sumchan->GetCalEnergy());
                 plot(DD_POSITION__ENERGY_LOCX + LOC_SUM, position, sumchan->GetCalEnergy());
             }
             if (i == 6 && !sumchan->IsSaturated()) {
                 // compare the long qdc to the energy
-                int qdcSum = topQdc[i] + bottomQdc[i];
+                int qdcSum = topQdc + bottomQdc;
 
                 // MAGIC NUMBERS HERE, move to qdc.txt
                 if (qdcSum < 1000 && sumchan->GetCalEnergy() > 15000) {
                     sumchan->GetTrace().InsertValue("badqdc", 1);
-                } else if ( !isnan(position) ) {
+                } else if ( !isnan(position) && whichQdc <= i ) {
                     plot(DD_POSITION, location, position);
                 }
             }
         } // end loop over qdcs
         // KM QDC - QDC correlations
         double ratio[4] = {0};
-        for (int i = 1; i < 5; ++i) {
-                ratio[i - 1] = topQdc[i] / (bottomQdc[i] + topQdc[i]) * 1000.0;
-        }
+        for (int i = 1; i < 5; ++i)
+            ratio[i - 1] = frac_[i][p];
 
         plot(DD_QDCR2__QDCR1_LOCX + location, ratio[1], ratio[0]);
         plot(DD_QDCR2__QDCR3_LOCX + location, ratio[1], ratio[2]);
@@ -412,38 +481,7 @@ bool PositionProcessor::Process(RawEvent &event) {
         plot(DD_QDC3R__POS_LOCX + location, ratio[2], position * 10.0 + 200.0);
         plot(DD_QDC4R__POS_LOCX + location, ratio[3], position * 10.0 + 200.0);
 
-        topQdcTot    /= totLen;
-        bottomQdcTot /= totLen;
-
-        plot(DD_QDCTOT__QDCTOT_LOCX + location, topQdcTot, bottomQdcTot);
-        plot(DD_QDCTOT__QDCTOT_LOCX + LOC_SUM, topQdcTot, bottomQdcTot);
-    } // end iteration over sum events
-
-    EndProcess();
-
-    return true;
-}
-
-ChanEvent* PositionProcessor::FindMatchingEdge(ChanEvent *match,
-					  vector<ChanEvent*>::const_iterator begin,
-					  vector<ChanEvent*>::const_iterator end) const {
-    for (;begin < end; ++begin) {
-        if ( (*begin)->GetChanID().GetLocation() == match->GetChanID().GetLocation() &&
-            abs( (*begin)->GetTime() - match->GetTime() ) < matchingTimeCut ) {
-            return *begin;
-        }
-    }
-    return NULL;
-}
-
-ChanEvent* PositionProcessor::FindMatchingEdge(ChanEvent *match,
-					  vector<ChanEvent*>::const_reverse_iterator begin,
-					  vector<ChanEvent*>::const_reverse_iterator end) const {
-    for (;begin < end; ++begin) {
-        if ( (*begin)->GetChanID().GetLocation() == match->GetChanID().GetLocation() &&
-            abs( (*begin)->GetTime() - match->GetTime() ) < matchingTimeCut ) {
-            return *begin;
-        }
+        plot(DD_QDCTOT__QDCTOT_LOCX + location, topQdcTot_[p], bottomQdcTot_[p]);
+        plot(DD_QDCTOT__QDCTOT_LOCX + LOC_SUM, topQdcTot_[p], bottomQdcTot_[p]);
     }
-    return NULL;
 }
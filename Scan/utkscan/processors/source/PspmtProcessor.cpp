@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <limits>
@@ -9,6 +10,8 @@
 
 #include "PspmtProcessor.hpp"
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
+#include "Exceptions.hpp"
 #include "Globals.hpp"
 #include "Messenger.hpp"
 
@@ -61,11 +64,113 @@ namespace dammIds{
     }
 }
 
-void PspmtProcessor::PspmtData::Clear(void) {    
+namespace {
+    // tentatively local params //
+    const double threshold = 260;
+    const double slope = 0.0606;
+    const double intercept = 10.13;
+    //////////////////////////////
+    const double f = 0.1;
+
+    //! Histograms for the energies of each slot, the dynode is last
+    const int rawIds[] = {D_RAW1, D_RAW2, D_RAW3, D_RAW4, D_RAWD};
+    const int traceEnergyIds[] = {D_ENERGY_TRACE1, D_ENERGY_TRACE2,
+                                  D_ENERGY_TRACE3, D_ENERGY_TRACE4,
+                                  D_ENERGY_TRACED};
+    const int qdcIds[] = {D_QDC_TRACE1, D_QDC_TRACE2, D_QDC_TRACE3,
+                          D_QDC_TRACE4, D_QDC_TRACED};
+}
+
+PspmtPositionMap::PspmtPositionMap(const double &slope,
+                                   const double &intercept) {
+    pixelX_.resize(rawBins * rawBins);
+    pixelY_.resize(rawBins * rawBins);
+    for (int iy = 0; iy < rawBins; iy++) {
+        short py = (short)trunc(slope * (rawOffset + iy) - intercept);
+        for (int ix = 0; ix < rawBins; ix++) {
+            pixelX_[iy * rawBins + ix] =
+                (short)trunc(slope * (rawOffset + ix) - intercept);
+            pixelY_[iy * rawBins + ix] = py;
+        }
+    }
+}
+
+void PspmtPositionMap::LoadCorrection(const std::string &fileName) {
+    ifstream in(fileName.c_str());
+    if (!in)
+        throw GeneralException("PspmtPositionMap::LoadCorrection : Could "
+                               "not open the correction map " + fileName);
+
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        istringstream ss(line);
+        double x, y;
+        int px, py;
+        if (!(ss >> x >> y >> px >> py))
+            throw GeneralException("PspmtPositionMap::LoadCorrection : "
+                                   "Could not read the line \"" + line +
+                                   "\" of " + fileName);
+        unsigned int i = Bin(y) * rawBins + Bin(x);
+        pixelX_[i] = px;
+        pixelY_[i] = py;
+    }
 }
 
-PspmtProcessor::PspmtProcessor(void) : EventProcessor(OFFSET, RANGE, "PspmtProcessor") {
+void PspmtPositionMap::Calculate(const double *anodes, const size_t &num,
+                                 Position *positions) const {
+    // The raw positions first, this loop has no branches
+    for (size_t i = 0; i < num; i++) {
+        const double *q = anodes + i * numAnodes;
+        Position &pos = positions[i];
+        pos.sum = (q[0] + q[1] + q[2] + q[3]) / 2;
+        double scale = 512 / pos.sum;
+        pos.yTop    = (q[0] + q[1]) / 2 * scale + rawOffset;
+        pos.xLeft   = (q[1] + q[2]) / 2 * scale + rawOffset;
+        pos.yBottom = (q[2] + q[3]) / 2 * scale + rawOffset;
+        pos.xRight  = (q[3] + q[0]) / 2 * scale + rawOffset;
+    }
+
+    for (size_t i = 0; i < num; i++) {
+        Position &pos = positions[i];
+        Lookup(pos.xRight, pos.yTop, pos.pixelX1, pos.pixelY1);
+        Lookup(pos.xLeft, pos.yBottom, pos.pixelX2, pos.pixelY2);
+    }
+}
+
+PspmtProcessor::PspmtProcessor(const std::string &correctionFile) :
+    EventProcessor(OFFSET, RANGE, "PspmtProcessor"),
+    positionMap_(slope, intercept) {
     associatedTypes.insert("pspmt");
+    if (!correctionFile.empty())
+        positionMap_.LoadCorrection(correctionFile);
+    lastChan_ = NULL;
+    traceNum_ = 0;
+}
+
+bool PspmtProcessor::Init(RawEvent &event) {
+    if (!EventProcessor::Init(event))
+        return(false);
+
+    /** The slot of each channel is its location, found once here so that
+     * the events are sorted into the slots by their index. */
+    DetectorLibrary *lib = DetectorLibrary::get();
+    slotOfId_.assign(lib->size(), -1);
+    for (DetectorLibrary::size_type i = 0; i < lib->size(); i++) {
+        if (!lib->HasValue(i) || lib->at(i).GetType() != "pspmt")
+            continue;
+        int location = lib->at(i).GetLocation();
+        if (location < 0 || location >= NUM_SLOTS) {
+            stringstream ss;
+            ss << "PspmtProcessor::Init : The location " << location
+               << " of a pspmt channel is larger than the maximum of "
+               << NUM_SLOTS - 1;
+            throw GeneralException(ss.str());
+        }
+        slotOfId_[i] = location;
+    }
+    return(true);
 }
 
 void PspmtProcessor::DeclarePlots(void) {
@@ -129,188 +234,110 @@ void PspmtProcessor::DeclarePlots(void) {
 bool PspmtProcessor::PreProcess(RawEvent &event){
     if (!EventProcessor::PreProcess(event))
         return false;
-    
+
     static const vector<ChanEvent*> &pspmtEvents = sumMap["pspmt"]->GetList();
-    
-    data_.Clear();
-    
-    double q1=0,q2=0,q3=0,q4=0,qd=0;
-    double qdc1=0,qdc2=0,qdc3=0,qdc4=0,qdcd=0;
-    double tre1=0,tre2=0,tre3=0,tre4=0,tred=0;
-    
-    double qright=0,qleft=0,qtop=0,qbottom=0,qsum=0;
-    double xright=0,xleft=0,ytop=0,ybottom=0;
-    
-    double qtre_r=0,qtre_l=0,qtre_t=0,qtre_b=0,qtre_s=0;
-    double xtre_r=0,xtre_l=0,ytre_t=0,ytre_b=0;
-    
-    double qqdc_r=0,qqdc_l=0,qqdc_t=0,qqdc_b=0,qqdc_s=0;
-    double xqdc_r=0,xqdc_l=0,yqdc_t=0,yqdc_b=0;
-    
-    double pxright=0,pxleft=0,pytop=0,pybottom=0;
-    double pxtre_r=0,pxtre_l=0,pytre_t=0,pytre_b=0;
-    
-    // tentatively local params //
-    double threshold=260;
-    double slope=0.0606;
-    double intercept=10.13;
-    //////////////////////////////
-    static int traceNum;
-    
-    double f=0.1;
-    
+
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        AnodeSlot &slot = slots_[i];
+        slot.chan = NULL;
+        slot.energy = slot.traceEnergy = slot.qdc = 0;
+    }
+    lastChan_ = NULL;
+
     for (vector<ChanEvent*>::const_iterator it = pspmtEvents.begin();
          it != pspmtEvents.end(); it++) {
-        
-        ChanEvent *chan   = *it;
-        string subtype    = chan->GetChanID().GetSubtype();
-        int    ch         = chan->GetChanID().GetLocation();
-        double calEnergy  = chan->GetCalEnergy();
-        //double pspmtTime  = chan->GetTime();
-        Trace trace       = chan->GetTrace();
-        
-        double trace_energy;
-        //double trace_time;
-        double baseline;
-        double qdc;
-        //int    num        = trace.GetValue("numPulses");
-        
-        if(trace.HasValue("filterEnergy")){
-            traceNum++;   	  
-            //trace_time      = trace.GetValue("filterTime");
-            trace_energy  = trace.GetValue("filterEnergy");
-            baseline         = trace.GetValue("baseline");
-            qdc                 = trace.GetValue("qdc");
-            
-            if(ch==0){
-                qdc1 = qdc;
-                tre1 = trace_energy;
-                plot(D_QDC_TRACE1,qdc1);
-                plot(D_ENERGY_TRACE1,tre1);
-            }else if(ch==1){
-                qdc2 = qdc;
-                tre2 = trace_energy; 
-                plot(D_QDC_TRACE2,qdc2);
-                plot(D_ENERGY_TRACE2,tre2);
-            }else if(ch==2){
-                qdc3 = qdc;
-                tre3 = trace_energy; 
-                plot(D_QDC_TRACE3,qdc3);
-                plot(D_ENERGY_TRACE3,tre3);
-            }else if(ch==3){
-                qdc4 = qdc;
-                tre4 = trace_energy; 	  
-                plot(D_QDC_TRACE4,qdc4);
-                plot(D_ENERGY_TRACE4,tre4);
-            }else if(ch==4){
-                qdcd = qdc;
-                tred = trace_energy; 
-                plot(D_QDC_TRACED,qdcd);
-                plot(D_ENERGY_TRACED,tred);
-            }
-        }
+        const ChanEvent *chan = *it;
+        int id = chan->GetID();
+        if (id < 0 || (size_t)id >= slotOfId_.size() || slotOfId_[id] < 0)
+            continue;
+        int ch = slotOfId_[id];
+        AnodeSlot &slot = slots_[ch];
+        slot.chan = chan;
+        lastChan_ = chan;
 
-        if(ch==0){
-            q1= calEnergy;
-            plot(D_RAW1,q1);
-        }else if(ch==1){
-            q2= calEnergy;
-            plot(D_RAW2,q2);
-        }else if(ch==2){
-            q3= calEnergy;
-            plot(D_RAW3,q3);
-        }else if(ch==3){
-            q4= calEnergy;
-            plot(D_RAW4,q4);
-        }else if(ch==4){
-            qd= calEnergy;
-            plot(D_RAWD,qd);
-        }
-        
-        if(q1>0 && q2>0 && q3>0 && q4>0){
-            qtop    = (q1+q2)/2;
-            qleft   = (q2+q3)/2;
-            qbottom = (q3+q4)/2;
-            qright  = (q4+q1)/2;
-            
-            qsum    = (q1+q2+q3+q4)/2;
-            xright  = (qright/qsum)*512+100;
-            xleft   = (qleft/qsum)*512+100;
-            ytop    = (qtop/qsum)*512+100;
-            ybottom = (qbottom/qsum)*512+100;
-            plot(D_SUM,qsum);
-        }
-        
-        if(tre1>0 && tre2>0 && tre3>0 && tre4>0 ){
-            qtre_t=(tre1+tre2)/2;
-            qtre_l=(tre2+tre3)/2;
-            qtre_b=(tre3+tre4)/2;
-            qtre_r=(tre4+tre1)/2;
-            qtre_s=(tre1+tre2+tre3+tre4)/2;
-            
-            xtre_r=(qtre_r/qtre_s)*512+100;
-            xtre_l=(qtre_l/qtre_s)*512+100;
-            ytre_t=(qtre_t/qtre_s)*512+100;
-            ytre_b=(qtre_b/qtre_s)*512+100;
-            
-            pxtre_r = trunc(slope*xtre_l-intercept);
-            pxtre_l = trunc(slope*xtre_r-intercept);
-            pytre_t = trunc(slope*ytre_t-intercept);
-            pytre_b = trunc(slope*ytre_b-intercept);
-                        
-            plot(D_ENERGY_TRACESUM,qtre_s);
-            
-            if(tre1>threshold && tre2>threshold && tre3>threshold && tre4>threshold ){
-                plot(DD_POS1_RAW_TRACE,xtre_r,ytre_t);
-                plot(DD_POS2_RAW_TRACE,xtre_l,ytre_b);
-                plot(DD_POS1_TRACE,pxtre_r,pytre_t);
-                plot(DD_POS2_TRACE,pxtre_l,pytre_b);
-            }    
-        }
-        
-        if(qdc1>0 && qdc2>0 && qdc3>0 && qdc4>0 ){
-            qqdc_t=(qdc1+qdc2)/2;
-            qqdc_l=(qdc2+qdc3)/2;
-            qqdc_b=(qdc3+qdc4)/2;
-            qqdc_r=(qdc4+qdc1)/2;
-            qqdc_s=(qqdc_t+qqdc_l+qqdc_b+qqdc_r)/2;
-            
-            xqdc_r=(qqdc_r/qqdc_s)*512+100;
-            xqdc_l=(qqdc_l/qqdc_s)*512+100;
-            yqdc_t=(qqdc_t/qqdc_s)*512+100;
-            yqdc_b=(qqdc_b/qqdc_s)*512+100;
-            
-            plot(D_ENERGY_TRACESUM,qqdc_s);
-        }
-        
-        if(q1>threshold && q2>threshold && q3>threshold && q4>threshold ){
-            pxleft   = trunc(slope*xleft-intercept);
-            pxright  = trunc(slope*xright-intercept);
-            pytop    = trunc(slope*ytop-intercept);
-            pybottom = trunc(slope*ybottom-intercept);
-            
-            plot(DD_POS1_RAW,xright,ytop);
-            plot(DD_POS2_RAW,xleft,ybottom);
-            plot(DD_POS1,pxright,pytop);
-            plot(DD_POS2,pxleft,pybottom);
-                        
-            if(xright>341 && xright < 356 && ytop>200 && ytop<211){
-                plot(D_TEMP0,f*q1);
-                plot(D_TEMP1,f*q2);
-                plot(D_TEMP2,f*q3);
-                plot(D_TEMP3,f*q4);
-                plot(D_TEMP4,f*qd);
-            }
-            
-            for(vector<int>::iterator ittr = trace.begin();ittr != trace.end();ittr++)
-                plot(DD_SINGLE_TRACE,ittr-trace.begin(),traceNum,*ittr);
+        /** The filter energy and the qdc were already found by the trace
+         * analyzers, the first pulse holds the filter energy. */
+        const Trace &trace = chan->GetTrace();
+        const vector<Trace::Pulse> &pulses = trace.GetPulses();
+        if (!pulses.empty()) {
+            traceNum_++;
+            slot.traceEnergy = pulses.front().energy;
+            slot.qdc = trace.GetValue("qdc");
+            plot(qdcIds[ch], slot.qdc);
+            plot(traceEnergyIds[ch], slot.traceEnergy);
         }
+
+        slot.energy = chan->GetCalEnergy();
+        plot(rawIds[ch], slot.energy);
     } // end of channel event
-    
+
+    PlotPositions();
+
     EndProcess();
     return(true);
 }
 
+void PspmtProcessor::PlotPositions(void) {
+    //The raw energies, the trace energies and the qdcs of this event are
+    //one batch, the batches do not span several events
+    enum {RAW, TRACE, QDC, NUM_ROWS};
+    double anodes[NUM_ROWS * PspmtPositionMap::numAnodes];
+    bool isPositive[NUM_ROWS] = {true, true, true};
+    bool isAboveThreshold[NUM_ROWS] = {true, true, true};
+    for (unsigned int a = 0; a < PspmtPositionMap::numAnodes; a++) {
+        double values[NUM_ROWS] = {slots_[a].energy, slots_[a].traceEnergy,
+                                   slots_[a].qdc};
+        for (int row = 0; row < NUM_ROWS; row++) {
+            anodes[row * PspmtPositionMap::numAnodes + a] = values[row];
+            isPositive[row] = isPositive[row] && values[row] > 0;
+            isAboveThreshold[row] = isAboveThreshold[row] &&
+                values[row] > threshold;
+        }
+    }
+    if (!isPositive[RAW] && !isPositive[TRACE] && !isPositive[QDC])
+        return;
+
+    PspmtPositionMap::Position pos[NUM_ROWS];
+    positionMap_.Calculate(anodes, NUM_ROWS, pos);
+
+    if (isPositive[RAW])
+        plot(D_SUM, pos[RAW].sum);
+
+    if (isPositive[TRACE]) {
+        plot(D_ENERGY_TRACESUM, pos[TRACE].sum);
+        if (isAboveThreshold[TRACE]) {
+            plot(DD_POS1_RAW_TRACE, pos[TRACE].xRight, pos[TRACE].yTop);
+            plot(DD_POS2_RAW_TRACE, pos[TRACE].xLeft, pos[TRACE].yBottom);
+            plot(DD_POS1_TRACE, pos[TRACE].pixelX1, pos[TRACE].pixelY1);
+            plot(DD_POS2_TRACE, pos[TRACE].pixelX2, pos[TRACE].pixelY2);
+        }
+    }
+
+    //The qdc sum is half of the sum of the anodes, as for the energies
+    if (isPositive[QDC])
+        plot(D_ENERGY_TRACESUM, pos[QDC].sum);
+
+    if (isAboveThreshold[RAW]) {
+        plot(DD_POS1_RAW, pos[RAW].xRight, pos[RAW].yTop);
+        plot(DD_POS2_RAW, pos[RAW].xLeft, pos[RAW].yBottom);
+        plot(DD_POS1, pos[RAW].pixelX1, pos[RAW].pixelY1);
+        plot(DD_POS2, pos[RAW].pixelX2, pos[RAW].pixelY2);
+
+        if (pos[RAW].xRight > 341 && pos[RAW].xRight < 356 &&
+            pos[RAW].yTop > 200 && pos[RAW].yTop < 211) {
+            plot(D_TEMP0, f * slots_[0].energy);
+            plot(D_TEMP1, f * slots_[1].energy);
+            plot(D_TEMP2, f * slots_[2].energy);
+            plot(D_TEMP3, f * slots_[3].energy);
+            plot(D_TEMP4, f * slots_[SLOT_DYNODE].energy);
+        }
+
+        const Trace &trace = lastChan_->GetTrace();
+        for (unsigned int i = 0; i < trace.size(); i++)
+            plot(DD_SINGLE_TRACE, i, traceNum_, trace[i]);
+    }
+}
+
 bool PspmtProcessor::Process(RawEvent &event){
     if (!EventProcessor::Process(event))
         return false;
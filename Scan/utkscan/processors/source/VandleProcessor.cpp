@@ -184,9 +184,9 @@ bool VandleProcessor::PreProcess(RawEvent &event) {
         return(false);
     }
 
-    BarBuilder billy(events);
-    billy.BuildBars();
-    bars_ = billy.GetBarMap();
+    barBuilder_.SetChannelList(events);
+    barBuilder_.BuildBars();
+    barBuilder_.SwapBarList(bars_, barIndex_);
 
     if(bars_.empty()) {
         plot(D_DEBUGGING, 25);
@@ -216,20 +216,20 @@ bool VandleProcessor::Process(RawEvent &event) {
     static const vector<ChanEvent*> &liquidStarts =
         event.GetSummary("liquid:scint:start")->GetList();
 
-    vector<ChanEvent*> startEvents;
-    startEvents.insert(startEvents.end(),
+    startEvents_.clear();
+    startEvents_.insert(startEvents_.end(),
 		       betaStarts.begin(), betaStarts.end());
-    startEvents.insert(startEvents.end(),
+    startEvents_.insert(startEvents_.end(),
 		       liquidStarts.begin(), liquidStarts.end());
 
-    TimingMapBuilder bldStarts(startEvents);
-    starts_ = bldStarts.GetMap();
+    startBuilder_.Build(startEvents_);
+    startBuilder_.SwapList(starts_);
 
     static const vector<ChanEvent*> &doubleBetaStarts =
         event.GetSummary("beta:double:start")->GetList();
-    BarBuilder startBars(doubleBetaStarts);
-    startBars.BuildBars();
-    barStarts_ = startBars.GetBarMap();
+    startBarBuilder_.SetChannelList(doubleBetaStarts);
+    startBarBuilder_.BuildBars();
+    startBarBuilder_.SwapBarList(barStarts_, barStartIndex_);
 
     if(!doubleBetaStarts.empty())
         AnalyzeBarStarts();
@@ -241,39 +241,40 @@ bool VandleProcessor::Process(RawEvent &event) {
 }
 
 void VandleProcessor::AnalyzeBarStarts(void) {
-    for (BarMap::iterator it = bars_.begin(); it !=  bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
+    for (BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
 
         if(!bar.GetHasEvent())
             continue;
 
         unsigned int histTypeOffset = ReturnOffset(bar.GetType());
-        unsigned int barLoc = barId.first;
-        const TimingCalibration cal = bar.GetCalibration();
+        unsigned int barLoc = bar.GetNumber();
+        const TimingCalibration &cal = bar.GetCalibration();
 
-        for(BarMap::iterator itStart = barStarts_.begin();
+        //These only depend on the bar, so we do not redo them for each start
+        double barTime = bar.GetCorTimeAve();
+        double flightPath = bar.GetFlightPath();
+        double barQdc = bar.GetQdc();
+
+        for(BarList::const_iterator itStart = barStarts_.begin();
         itStart != barStarts_.end(); itStart++) {
-            unsigned int startLoc = (*itStart).first.first;
+            unsigned int startLoc = itStart->GetNumber();
             unsigned int barPlusStartLoc = barLoc*numStarts_ + startLoc;
+            double tofOffset = cal.GetTofOffset(startLoc);
 
-            BarDetector start = (*itStart).second;
-
-            double tof = bar.GetCorTimeAve() -
-                start.GetCorTimeAve() + cal.GetTofOffset(startLoc);
+            double tof = barTime - itStart->GetCorTimeAve() + tofOffset;
 
-            double corTof =
-                CorrectTOF(tof, bar.GetFlightPath(), cal.GetZ0());
+            double corTof = CorrectTOF(tof, flightPath, cal.GetZ0());
 
             plot(DD_TOFBARS+histTypeOffset, tof*plotMult_+plotOffset_,
                  barPlusStartLoc);
             plot(DD_CORTOFBARS, corTof*plotMult_+plotOffset_, barPlusStartLoc);
 
-            if(cal.GetTofOffset(startLoc) != 0) {
+            if(tofOffset != 0) {
                 plot(DD_TQDCAVEVSTOF+histTypeOffset, tof*plotMult_+plotOffset_,
-                     bar.GetQdc());
+                     barQdc);
                 plot(DD_TQDCAVEVSCORTOF+histTypeOffset,
-                     corTof*plotMult_+plotOffset_, bar.GetQdc());
+                     corTof*plotMult_+plotOffset_, barQdc);
             }
 
             if (geSummary_) {
@@ -285,47 +286,48 @@ void VandleProcessor::AnalyzeBarStarts(void) {
                         plot(DD_GAMMAENERGYVSTOF+histTypeOffset, calEnergy, tof);
                     }
                 } else {
-                    plot(DD_TQDCAVEVSTOF_VETO+histTypeOffset, tof, bar.GetQdc());
+                    plot(DD_TQDCAVEVSTOF_VETO+histTypeOffset, tof, barQdc);
                     plot(DD_TOFBARS_VETO+histTypeOffset, tof, barPlusStartLoc);
                 }
             }
-        } // for(TimingMap::iterator itStart
-    } //(BarMap::iterator itBar
+        } // for(BarList::const_iterator itStart
+    } //(BarList::const_iterator itBar
 } //void VandleProcessor::AnalyzeData
 
 void VandleProcessor::AnalyzeStarts(void) {
-    for (BarMap::iterator it = bars_.begin(); it !=  bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
+    for (BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
 
         if(!bar.GetHasEvent())
             continue;
 
         unsigned int histTypeOffset = ReturnOffset(bar.GetType());
-        unsigned int barLoc = barId.first;
-        const TimingCalibration cal = bar.GetCalibration();
+        unsigned int barLoc = bar.GetNumber();
+        const TimingCalibration &cal = bar.GetCalibration();
 
-        for(TimingMap::iterator itStart = starts_.begin();
-        itStart != starts_.end(); itStart++) {
-            if(!(*itStart).second.GetIsValid())
-                continue;
+        //These only depend on the bar, so we do not redo them for each start
+        double barTime = bar.GetCorTimeAve();
+        double flightPath = bar.GetFlightPath();
+        double barQdc = bar.GetQdc();
 
-            unsigned int startLoc = (*itStart).first.first;
+        //The TimingMapBuilder only keeps the starts that are valid.
+        for(TimingList::const_iterator itStart = starts_.begin();
+        itStart != starts_.end(); itStart++) {
+            unsigned int startLoc = itStart->first.first;
             unsigned int barPlusStartLoc = barLoc*numStarts_ + startLoc;
-            HighResTimingData start = (*itStart).second;
+            const HighResTimingData &start = itStart->second;
 
-            double tof = bar.GetCorTimeAve() -
-                start.GetCorrectedTime() + cal.GetTofOffset(startLoc);
+            double tof = barTime - start.GetCorrectedTime() +
+                cal.GetTofOffset(startLoc);
 
-            double corTof =
-                CorrectTOF(tof, bar.GetFlightPath(), cal.GetZ0());
+            double corTof = CorrectTOF(tof, flightPath, cal.GetZ0());
 
             plot(DD_TOFBARS+histTypeOffset, tof*plotMult_+plotOffset_, barPlusStartLoc);
-            plot(DD_TQDCAVEVSTOF+histTypeOffset, tof*plotMult_+plotOffset_, bar.GetQdc());
+            plot(DD_TQDCAVEVSTOF+histTypeOffset, tof*plotMult_+plotOffset_, barQdc);
 
             plot(DD_CORTOFBARS, corTof*plotMult_+plotOffset_, barPlusStartLoc);
             plot(DD_TQDCAVEVSCORTOF+histTypeOffset, corTof*plotMult_+plotOffset_,
-                 bar.GetQdc());
+                 barQdc);
 
             if (geSummary_) {
                 if (geSummary_->GetMult() > 0) {
@@ -336,35 +338,38 @@ void VandleProcessor::AnalyzeStarts(void) {
                         plot(DD_GAMMAENERGYVSTOF+histTypeOffset, calEnergy, tof);
                     }
                 } else {
-                    plot(DD_TQDCAVEVSTOF_VETO+histTypeOffset, tof, bar.GetQdc());
+                    plot(DD_TQDCAVEVSTOF_VETO+histTypeOffset, tof, barQdc);
                     plot(DD_TOFBARS_VETO+histTypeOffset, tof, barPlusStartLoc);
                 }
             }
-        } // for(TimingMap::iterator itStart
-    } //(BarMap::iterator itBar
+        } // for(TimingList::const_iterator itStart
+    } //(BarList::const_iterator itBar
 } //void VandleProcessor::AnalyzeData
 
 void VandleProcessor::ClearMaps(void) {
     bars_.clear();
+    barIndex_.clear();
     starts_.clear();
+    barStarts_.clear();
+    barStartIndex_.clear();
 }
 
 void VandleProcessor::FillVandleOnlyHists(void) {
-    for(BarMap::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
-        TimingDefs::TimingIdentifier barId = (*it).first;
-        BarDetector bar = (*it).second;
-        unsigned int OFFSET = ReturnOffset(barId.second);
+    for(BarList::const_iterator it = bars_.begin(); it != bars_.end(); it++) {
+        const BarDetector &bar = *it;
+        unsigned int barNum = bar.GetNumber();
+        unsigned int OFFSET = ReturnOffset(bar.GetType());
 
         plot(DD_TQDCBARS + OFFSET,
-             bar.GetLeftSide().GetTraceQdc(), barId.first*2);
+             bar.GetLeftSide().GetTraceQdc(), barNum*2);
         plot(DD_MAXIMUMBARS + OFFSET,
-             bar.GetLeftSide().GetMaximumValue(), barId.first*2);
+             bar.GetLeftSide().GetMaximumValue(), barNum*2);
         plot(DD_TQDCBARS + OFFSET,
-             bar.GetRightSide().GetTraceQdc(), barId.first*2+1);
+             bar.GetRightSide().GetTraceQdc(), barNum*2+1);
         plot(DD_MAXIMUMBARS + OFFSET,
-             bar.GetRightSide().GetMaximumValue(), barId.first*2+1);
+             bar.GetRightSide().GetMaximumValue(), barNum*2+1);
         plot(DD_TIMEDIFFBARS+OFFSET,
-            bar.GetTimeDifference()*plotMult_+plotOffset_, barId.first);
+            bar.GetTimeDifference()*plotMult_+plotOffset_, barNum);
     }
 }
 
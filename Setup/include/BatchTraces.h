@@ -0,0 +1,46 @@
+/** \file BatchTraces.h
+  *
+  * \brief The layout of the binary trace file written by the batch mode of get_traces
+  *
+  * The file starts with a BatchHeader, followed by the traces as unsigned short[traceLength]
+  * in the order they finished, then numEntries BatchIndexEntry records at indexOffset.
+  * Everything is written in the byte order of the machine, which is little endian.
+  *
+  * \date Oct. 19th, 2026
+*/
+
+#ifndef BATCHTRACES_H
+#define BATCHTRACES_H
+
+#include <stdint.h>
+
+/// The magic at the start of a batch trace file.
+#define BATCH_TRACES_MAGIC "PXTRACE1"
+
+/// Status of a channel in the batch trace file.
+enum BatchChannelStatus {WAITING = 0, TRIGGERED = 1, MAX_ATTEMPTS = 2, TRIGGERLESS = 3, READ_ERROR = 4};
+
+/// Header at the start of the file.
+struct BatchHeader{
+	char magic[8]; /// BATCH_TRACES_MAGIC without the terminating null.
+	uint32_t numModules; /// Number of modules in the file.
+	uint32_t numChannels; /// Channels per module.
+	uint32_t traceLength; /// Samples per trace.
+	uint32_t numEntries; /// Number of index entries.
+	uint64_t indexOffset; /// Byte offset of the index.
+};
+
+/// Index entry of a single channel.
+struct BatchIndexEntry{
+	uint16_t mod; /// Module number.
+	uint16_t ch; /// Channel number.
+	uint16_t status; /// One of BatchChannelStatus.
+	uint16_t attempts; /// Number of traces read for the channel.
+	int32_t trigger; /// Sample of the trigger, -1 if none.
+	float baseline; /// Average of the first 10% of the trace.
+	float baselineRms; /// RMS of the first 10% of the trace.
+	float tau; /// Decay time in samples, NAN if not fitted.
+	uint64_t offset; /// Byte offset of the trace, 0 if not stored.
+};
+
+#endif
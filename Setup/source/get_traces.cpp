@@ -3,12 +3,18 @@
 /*	KM 01/12/2012 */	
 /*			       					    */
 /********************************************************************/
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -19,6 +25,7 @@
 
 // pixie includes
 #include "utilities.h"
+#include "BatchTraces.h"
 #include "PixieInterface.h"
 #include "Utility.h"
 
@@ -231,6 +238,359 @@ bool TraceGrabber::operator()(PixieFunctionParms<> &par)
     }
 }
 
+/** Grabs the traces of every channel of one or more modules at once.
+ *
+ * Each round acquires the traces of every module which still has channels
+ * waiting and reads all of them, then the baselines, trigger positions and
+ * decay times of the new traces are computed in parallel, one channel per
+ * job. A channel is done when its trace crosses the trigger level or after
+ * the maximum number of attempts. Finished traces are streamed to a binary
+ * file as soon as they are done and an index of all channels is appended
+ * when the file is closed.
+ *
+ * The layout of the file is described in BatchTraces.h.
+ */
+class BatchTraceGrabber
+{
+public:
+    BatchTraceGrabber(PixieInterface &pif_, int mod_, int trigger_, int maxTries_,
+                      bool doFit_, unsigned int numThreads_);
+
+    void EnableBaselineUpdate(void) {updateBaselines = true;}
+    void EnableBidirectionalTrigger(void) {isBidirectional = true;}
+
+    /** Open the output file and write the header */
+    bool Open(const char *filename);
+    /** Acquire until every channel is done, return the number of rounds */
+    int Run(void);
+    /** Write the index and close the file */
+    bool Close(void);
+    /** Print a line for every channel */
+    void PrintSummary(void) const;
+
+private:
+    /** The state of a channel between rounds */
+    struct Channel {
+        BatchIndexEntry entry;
+        bool fresh;             ///< A new trace was read this round
+    };
+
+    PixieInterface &pif;
+    /** Modules to read */
+    std::vector<unsigned int> modules;
+    /** Trigger level */
+    int trigger;
+    /** Number of attempts to get trace above trigger level */
+    int maxTries;
+    /** Tau fitting on/off */
+    bool doFit;
+    /** Whether the trigger responds to negative signals */
+    bool isBidirectional;
+    /** Whether to continuously update baselines */
+    bool updateBaselines;
+    /** Number of analysis threads */
+    unsigned int numThreads;
+    /** Samples per trace */
+    size_t traceLength;
+    /** The traces of every channel of every module */
+    std::vector<unsigned short> traces;
+    /** The state of every channel */
+    std::vector<Channel> channels;
+    /** Output file */
+    std::ofstream fout;
+    /** Number of traces written */
+    uint64_t written;
+
+    unsigned short *Trace(size_t index) {return &traces[index * traceLength];}
+    /** Acquire and read the waiting channels of a module */
+    bool ReadModule(size_t m);
+    /** Analyze the fresh trace of a channel */
+    void Analyze(size_t index);
+    /** Append the trace of a channel to the file */
+    void StoreTrace(size_t index);
+};
+
+/** Average and RMS of trace[b0, b1) */
+static void MeanRms(const unsigned short *trace, size_t b0, size_t b1,
+                    float &mean, float &rms)
+{
+    uint64_t sum = 0, sum2 = 0;
+    for (size_t i = b0; i < b1; ++i) {
+        uint32_t v = trace[i];
+        sum += v;
+        sum2 += v * v;
+    }
+    double n = double(b1 - b0);
+    mean = sum / n;
+    rms = sqrt(std::max(0.0, sum2 / n - double(mean) * mean));
+}
+
+/** First sample above high (or below low if bidirectional), size if none.
+ *  Blocks are tested without branching and only a block with a hit is
+ *  searched sample by sample. */
+static size_t FindTrigger(const unsigned short *trace, size_t size,
+                          int high, int low, bool bidirectional)
+{
+    const size_t block = 64;
+    for (size_t start = 0; start < size; start += block) {
+        size_t end = std::min(start + block, size);
+        int hit = 0;
+        for (size_t i = start; i < end; ++i)
+            hit |= (trace[i] > high) | (bidirectional & (trace[i] < low));
+        if (!hit)
+            continue;
+        for (size_t i = start; i < end; ++i) {
+            if (trace[i] > high || (bidirectional && trace[i] < low))
+                return i;
+        }
+    }
+    return size;
+}
+
+/** Fit log(trace - baseline) with a line in [x0, x1) in a single pass
+ *  and return the decay time in samples, NAN if it cannot be found. */
+static float FitDecay(const unsigned short *trace, size_t x0, size_t x1,
+                      double baseline, double polarity)
+{
+    double S = 0, Sx = 0, Sy = 0, Sxx = 0, Sxy = 0;
+    for (size_t i = x0; i < x1; ++i) {
+        double val = polarity * (trace[i] - baseline);
+        if (val <= 0)
+            continue;
+        double x = double(i - x0);
+        double y = log(val);
+        S += 1;
+        Sx += x;
+        Sy += y;
+        Sxx += x * x;
+        Sxy += x * y;
+    }
+    double D = S * Sxx - Sx * Sx;
+    if (S < 10 || D == 0)
+        return NAN;
+    double a1 = (S * Sxy - Sx * Sy) / D;
+    if (a1 >= 0)
+        return NAN;
+    return -1.0 / a1;
+}
+
+BatchTraceGrabber::BatchTraceGrabber(PixieInterface &pif_, int mod_, int trigger_,
+                                     int maxTries_, bool doFit_,
+                                     unsigned int numThreads_) :
+    pif(pif_), trigger(trigger_), maxTries(maxTries_), doFit(doFit_),
+    isBidirectional(false), updateBaselines(false),
+    numThreads(std::max(1u, numThreads_)),
+    traceLength(PixieInterface::GetTraceLength()), written(0)
+{
+    if (mod_ < 0) {
+        for (unsigned int m = 0; m < pif.GetNumberCards(); ++m)
+            modules.push_back(m);
+    } else {
+        modules.push_back(mod_);
+    }
+
+    const size_t nch = pif.GetNumberChannels();
+    traces.resize(modules.size() * nch * traceLength);
+    channels.resize(modules.size() * nch);
+    for (size_t i = 0; i < channels.size(); ++i) {
+        BatchIndexEntry &e = channels[i].entry;
+        e.mod = modules[i / nch];
+        e.ch = i % nch;
+        e.status = WAITING;
+        e.attempts = 0;
+        e.trigger = -1;
+        e.baseline = NAN;
+        e.baselineRms = NAN;
+        e.tau = NAN;
+        e.offset = 0;
+        channels[i].fresh = false;
+    }
+}
+
+bool BatchTraceGrabber::Open(const char *filename)
+{
+    fout.open(filename, std::ios::binary);
+    if (!fout.good())
+        return false;
+    BatchHeader header;
+    memcpy(header.magic, BATCH_TRACES_MAGIC, sizeof(header.magic));
+    header.numModules = modules.size();
+    header.numChannels = pif.GetNumberChannels();
+    header.traceLength = traceLength;
+    header.numEntries = channels.size();
+    header.indexOffset = 0;
+    fout.write((char*)&header, sizeof(header));
+    return fout.good();
+}
+
+bool BatchTraceGrabber::ReadModule(size_t m)
+{
+    const size_t nch = pif.GetNumberChannels();
+    bool waiting = false;
+    for (size_t ch = 0; ch < nch; ++ch)
+        waiting |= (channels[m * nch + ch].entry.status == WAITING);
+    if (!waiting)
+        return true;
+
+    if (!pif.AcquireTraces(modules[m]))
+        return false;
+
+    for (size_t ch = 0; ch < nch; ++ch) {
+        size_t index = m * nch + ch;
+        Channel &c = channels[index];
+        if (c.entry.status != WAITING)
+            continue;
+        usleep(10);
+        if (pif.ReadSglChanTrace(Trace(index), traceLength, modules[m], ch)) {
+            c.entry.attempts++;
+            c.fresh = true;
+        } else {
+            c.entry.status = READ_ERROR;
+        }
+    }
+    return true;
+}
+
+void BatchTraceGrabber::Analyze(size_t index)
+{
+    Channel &c = channels[index];
+    BatchIndexEntry &e = c.entry;
+    const unsigned short *trace = Trace(index);
+    const size_t size = traceLength;
+    const size_t baselineSamples = size / 10;
+
+    if (e.attempts == 1 || updateBaselines)
+        MeanRms(trace, 0, baselineSamples, e.baseline, e.baselineRms);
+
+    if (trigger <= 0) {
+        e.status = TRIGGERLESS;
+        return;
+    }
+
+    int triggerHigh = e.baseline + trigger;
+    int triggerLow = e.baseline - trigger;
+    size_t x0 = FindTrigger(trace, size, triggerHigh, triggerLow, isBidirectional);
+    if (x0 == size) {
+        if (e.attempts >= maxTries)
+            e.status = MAX_ATTEMPTS;
+        return;
+    }
+    e.trigger = x0;
+    e.status = TRIGGERED;
+    if (!doFit)
+        return;
+
+    double polarity = (trace[x0] > triggerHigh) ? 1.0 : -1.0;
+    // Start at the extremum after the trigger and stop at the last
+    // sample above half the trigger level
+    size_t peak = x0;
+    for (size_t i = x0; i < size; ++i) {
+        if (polarity * trace[i] > polarity * trace[peak])
+            peak = i;
+        else if (polarity * (trace[i] - e.baseline) < trigger / 2)
+            break;
+    }
+    size_t x1 = peak;
+    for (size_t i = size - 1; i > peak; --i) {
+        if (polarity * (trace[i] - e.baseline) > trigger / 2) {
+            x1 = i;
+            break;
+        }
+    }
+
+    // If the pulse starts within the baseline samples use the end
+    // of the trace for the baseline of the fit
+    float baseline = e.baseline, rms;
+    if (x0 < baselineSamples)
+        MeanRms(trace, size - baselineSamples, size, baseline, rms);
+    e.tau = FitDecay(trace, peak, x1, baseline, polarity);
+}
+
+void BatchTraceGrabber::StoreTrace(size_t index)
+{
+    channels[index].entry.offset = sizeof(BatchHeader) + written * traceLength * sizeof(unsigned short);
+    fout.write((char*)Trace(index), traceLength * sizeof(unsigned short));
+    written++;
+}
+
+int BatchTraceGrabber::Run(void)
+{
+    const size_t nch = pif.GetNumberChannels();
+    int rounds = 0;
+    while (true) {
+        bool waiting = false;
+        for (size_t i = 0; i < channels.size(); ++i)
+            waiting |= (channels[i].entry.status == WAITING);
+        if (!waiting)
+            break;
+
+        for (size_t m = 0; m < modules.size(); ++m) {
+            if (!ReadModule(m)) {
+                cout << "Unable to acquire traces of module " << modules[m] << endl;
+                for (size_t ch = 0; ch < nch; ++ch) {
+                    if (channels[m * nch + ch].entry.status == WAITING)
+                        channels[m * nch + ch].entry.status = READ_ERROR;
+                }
+            }
+        }
+
+        std::vector<size_t> jobs;
+        for (size_t i = 0; i < channels.size(); ++i) {
+            if (channels[i].fresh)
+                jobs.push_back(i);
+        }
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t j;
+            while ((j = next++) < jobs.size())
+                Analyze(jobs[j]);
+        };
+        std::vector<std::thread> pool;
+        unsigned int n = std::min<size_t>(numThreads, jobs.size());
+        for (unsigned int t = 1; t < n; ++t)
+            pool.push_back(std::thread(worker));
+        worker();
+        for (size_t t = 0; t < pool.size(); ++t)
+            pool[t].join();
+
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            Channel &c = channels[jobs[j]];
+            c.fresh = false;
+            if (c.entry.status != WAITING)
+                StoreTrace(jobs[j]);
+        }
+
+        cout << "|" << ++rounds << " |\r" << flush;
+    }
+    cout << endl;
+    return rounds;
+}
+
+bool BatchTraceGrabber::Close(void)
+{
+    uint64_t indexOffset = sizeof(BatchHeader) + written * traceLength * sizeof(unsigned short);
+    for (size_t i = 0; i < channels.size(); ++i)
+        fout.write((char*)&channels[i].entry, sizeof(BatchIndexEntry));
+    fout.seekp(offsetof(BatchHeader, indexOffset));
+    fout.write((char*)&indexOffset, sizeof(indexOffset));
+    fout.close();
+    return !fout.fail();
+}
+
+void BatchTraceGrabber::PrintSummary(void) const
+{
+    static const char *names[] = {"waiting", "triggered", "max attempts",
+                                  "triggerless", "read error"};
+    cout << "MOD\tCH\tBASELINE\tRMS\tTRIGGER\tTAU\tATTEMPTS\tSTATUS" << endl;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        const BatchIndexEntry &e = channels[i].entry;
+        cout << e.mod << "\t" << e.ch << "\t" << e.baseline << "\t\t"
+             << e.baselineRms << "\t" << e.trigger << "\t" << e.tau << "\t"
+             << e.attempts << "\t\t" << names[e.status] << endl;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     int mod = -1;
@@ -241,8 +601,12 @@ int main(int argc, char *argv[])
     bool bidirectionalTrigger = false;
     bool updateBaselines = false;
     bool callGnuplot = false;
+    bool batch = false;
+    const char *output = "traces.bin";
+    unsigned int threads = std::thread::hardware_concurrency();
 
     const option longOptions[] = {
+	{"all", no_argument, 0, 'a'},
 	{"bidirectional", no_argument, 0, 'b'},
 	{"ch", required_argument, 0, 'c'},
 	{"level", required_argument, 0, 'l'},
@@ -251,18 +615,23 @@ int main(int argc, char *argv[])
 	{"update", no_argument, 0, 'u'},
 	{"help", no_argument, 0, 'h'},
         {"gnuplot", no_argument, 0, 'g'},
+	{"output", required_argument, 0, 'o'},
+	{"threads", required_argument, 0, 'j'},
 	{0, 0, 0, 0}
     };
     int flag, optionsIndex;
 
     // getopt_long returns -1 when all is done
-    while ( (flag = getopt_long (argc, argv, "bm:c:l:n:tuhg1", longOptions, &optionsIndex)) != -1) {
+    while ( (flag = getopt_long (argc, argv, "abm:c:l:n:tuhg1o:j:", longOptions, &optionsIndex)) != -1) {
         switch (flag) {
 	case '1':
 	    // allow -1 (minus one) option as all channels 
 	    //   this is the default anyway but has a similar behavior
 	    //   as other programs' syntax in the suite
 	    break;
+	case 'a':
+	    batch = true;
+	    break;
 	case 'b':
 	    bidirectionalTrigger = true;
 	    break;
@@ -287,17 +656,28 @@ int main(int argc, char *argv[])
         case 'g':
             callGnuplot = true;
             break;
+	case 'o':
+	    output = optarg;
+	    break;
+	case 'j':
+	    threads = atoi(optarg);
+	    break;
 	case 'h':	    
 	case '?':
 	    ;
 	    cout << "Usage: " << argv[0] << " -m <module_number> [-c <ch_number> -t <trig_level> -n <number_of_attempts>] " << endl;
+	    cout << "       " << argv[0] << " -a [-m <module_number> -l <trig_level> -o <file>] " << endl;
 	    cout << "Flags: " << endl;
+	    cout << " -a, --all           - batch mode, all channels of all modules (or of -m) to a binary file with an index" << endl;
 	    cout << " -b, --bidirectional - allow triggers of either direction (useful for logic signals)" << endl;
 	    cout << " -m, --mod           - module number (required) " << endl;
 	    cout << " -c, --ch            - channel number (0-15 or -1), -1 (default) = all channels " << endl;
 	    cout << " -l, --level          - trigger level in number of samples above baseline, default = 0 (no trigger) " << endl;
 	    cout << " -n                  -  number of attempts to catch good trigger, default = 100" << endl;
 	    cout << " -u, --update        - update baselines each iteration" << endl;
+	    cout << " -t, --tau           - fit the decay time of the traces" << endl;
+	    cout << " -o, --output        - output file of the batch mode, default = traces.bin" << endl;
+	    cout << " -j, --threads       - analysis threads of the batch mode, default = number of cores" << endl;
 	    cout << " -h, --help          - shows this help " << endl;
 	    if (flag == 'h')
 		exit(EXIT_SUCCESS);
@@ -315,8 +695,8 @@ int main(int argc, char *argv[])
     PixieInterface pif("pixie.cfg");
     pif.GetSlots();
 
-    // Only one module supported
-    if (!inRange(mod, (int)pif.GetNumberCards()) ) {
+    // Only one module supported, except in batch mode
+    if (!inRange(mod, (int)pif.GetNumberCards()) && !(batch && mod == -1)) {
         cout << "Wrong module number" << endl;
         cout << "See " << argv[0] << " -h  for help" << endl;
         exit(EXIT_FAILURE);
@@ -335,6 +715,31 @@ int main(int argc, char *argv[])
 	     PixieInterface::ProgramFPGA |
 	     PixieInterface::SetDAC, true);
 
+    if (batch) {
+	BatchTraceGrabber grabber(pif, mod, trig, maxAttempts, tau, threads);
+	if (bidirectionalTrigger)
+	    grabber.EnableBidirectionalTrigger();
+	if (updateBaselines)
+	    grabber.EnableBaselineUpdate();
+	if (!grabber.Open(output)) {
+	    fprintf(stderr, "Could not open %s\n", output);
+	    exit(EXIT_FAILURE);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	int rounds = grabber.Run();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (!grabber.Close()) {
+	    fprintf(stderr, "Could not write %s\n", output);
+	    exit(EXIT_FAILURE);
+	}
+	grabber.PrintSummary();
+	cout << "Rounds : " << rounds << " in " << elapsed.count() << " s" << endl;
+	cout << "Traces data are in '" << output << "' file." << endl;
+	return EXIT_SUCCESS;
+    }
+
     const unsigned int size = 2 * pif.GetNumberChannels() * PixieInterface::GetTraceLength();
     unsigned short *data = new unsigned short[size];
     memset(data, 0, sizeof(unsigned short)*size);